@@ -0,0 +1,125 @@
+
+#include "thunar/thunar-gio-extensions.h"
+#include "thunar/thunar-io-copy.h"
+
+#include <glib/gstdio.h>
+
+/* size of the generated file */
+#define FILE_SIZE (256 * 1024 * 1024)
+
+static gchar *
+create_file (const gchar *directory)
+{
+  gchar  *path = g_build_filename (directory, "source", NULL);
+  gchar  *data = g_malloc (1024 * 1024);
+  FILE   *fp;
+
+  for (gsize i = 0; i < 1024 * 1024; i++)
+    data[i] = g_random_int_range (0, 256);
+
+  fp = g_fopen (path, "wb");
+  g_assert_nonnull (fp);
+  for (guint i = 0; i < FILE_SIZE / (1024 * 1024); i++)
+    g_assert_cmpuint (fwrite (data, 1, 1024 * 1024, fp), ==, 1024 * 1024);
+  fclose (fp);
+
+  g_free (data);
+
+  return path;
+}
+
+static void
+run_copy (const gchar *name,
+          GFile       *source,
+          GFile       *destination,
+          gint         reflink_mode,
+          gboolean     verify)
+{
+  g_autoptr (GError) error = NULL;
+  g_autoptr (GFileInfo) info = NULL;
+  gboolean success;
+  gint64   start;
+  gdouble  seconds;
+  goffset  size;
+
+  g_file_delete (destination, NULL, NULL);
+
+  start = g_get_monotonic_time ();
+  if (reflink_mode < 0)
+    {
+      /* verification by reading both files again after the copy */
+      success = g_file_copy (source, destination, G_FILE_COPY_NOFOLLOW_SYMLINKS, NULL, NULL, NULL, &error);
+      if (success && verify)
+        success = thunar_g_file_compare_contents (source, destination, NULL, &error);
+    }
+  else
+    success = thunar_io_copy_local_file (source, destination, G_FILE_COPY_NOFOLLOW_SYMLINKS, reflink_mode, verify,
+                                         NULL, NULL, NULL, NULL, &error);
+  seconds = (g_get_monotonic_time () - start) / (gdouble) G_USEC_PER_SEC;
+
+  if (!success)
+    {
+      g_print ("%-16s %s\n", name, error != NULL ? error->message : "Contents differ");
+      return;
+    }
+
+  info = g_file_query_info (destination, G_FILE_ATTRIBUTE_STANDARD_SIZE, G_FILE_QUERY_INFO_NONE, NULL, NULL);
+  size = g_file_info_get_size (info);
+
+  g_print ("%-16s %10.3f %10.1f\n", name, seconds, size / seconds / (1024 * 1024));
+}
+
+int
+main (int    argc,
+      char **argv)
+{
+  g_autofree gchar *tmpdir = NULL;
+  g_autofree gchar *source_path = NULL;
+  g_autofree gchar *destination_path = NULL;
+  g_autoptr (GFile) source = NULL;
+  g_autoptr (GFile) destination = NULL;
+
+  /* copy the given file (or a generated one for "-") into a temporary folder,
+   * created in the folder given as second argument (e.g. on a Btrfs volume) */
+  tmpdir = g_dir_make_tmp ("thunar-bench-copy-XXXXXX", NULL);
+  if (argc > 2)
+    {
+      g_rmdir (tmpdir);
+      g_free (tmpdir);
+      tmpdir = g_build_filename (argv[2], "thunar-bench-copy-XXXXXX", NULL);
+      g_assert_nonnull (g_mkdtemp (tmpdir));
+    }
+  g_assert_nonnull (tmpdir);
+
+  if (argc > 1 && g_strcmp0 (argv[1], "-") != 0)
+    source = g_file_new_for_commandline_arg (argv[1]);
+  else
+    {
+      source_path = create_file (tmpdir);
+      source = g_file_new_for_path (source_path);
+    }
+
+  destination_path = g_build_filename (tmpdir, "destination", NULL);
+  destination = g_file_new_for_path (destination_path);
+
+  /* warm up the page cache */
+  g_file_copy (source, destination, G_FILE_COPY_NONE, NULL, NULL, NULL, NULL);
+
+  g_print ("%-16s %10s %10s\n", "method", "seconds", "MiB/s");
+  run_copy ("g_file_copy", source, destination, -1, FALSE);
+  run_copy ("reflink=never", source, destination, THUNAR_REFLINK_MODE_NEVER, FALSE);
+  run_copy ("reflink=auto", source, destination, THUNAR_REFLINK_MODE_AUTO, FALSE);
+  run_copy ("reflink=always", source, destination, THUNAR_REFLINK_MODE_ALWAYS, FALSE);
+
+  /* verified copies */
+  run_copy ("g_file_copy+cmp", source, destination, -1, TRUE);
+  run_copy ("verify,never", source, destination, THUNAR_REFLINK_MODE_NEVER, TRUE);
+  run_copy ("verify,auto", source, destination, THUNAR_REFLINK_MODE_AUTO, TRUE);
+
+  g_file_delete (destination, NULL, NULL);
+  if (source_path != NULL)
+    g_unlink (source_path);
+  g_rmdir (tmpdir);
+
+  return 0;
+}
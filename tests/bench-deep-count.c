@@ -0,0 +1,96 @@
+
+#include "thunar/thunar-deep-count-job.h"
+#include "thunar/thunar-file.h"
+#include "tests/test-util.h"
+
+#include <glib/gstdio.h>
+
+/* size of the generated tree: N_TOPLEVEL * N_SUBDIRS directories with N_FILES files each */
+#define N_TOPLEVEL 32
+#define N_SUBDIRS  32
+#define N_FILES    32
+
+static guint n_files_counted;
+
+static void
+status_update (ThunarJob *job,
+               guint64    total_size,
+               guint64    total_size_on_disk,
+               guint      file_count,
+               guint      directory_count,
+               guint      unreadable_directory_count,
+               gpointer   user_data)
+{
+  n_files_counted = file_count;
+}
+
+static gdouble
+run_deep_count (ThunarFile *file,
+                guint       n_threads)
+{
+  g_autoptr (GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+  ThunarDeepCountJob *job;
+  GList               files = { file, NULL, NULL };
+  gint64              start;
+
+  job = thunar_deep_count_job_new (&files, G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS);
+  thunar_deep_count_job_set_max_threads (job, n_threads);
+  g_signal_connect (job, "status-update", G_CALLBACK (status_update), NULL);
+  g_signal_connect_swapped (job, "finished", G_CALLBACK (g_main_loop_quit), loop);
+
+  start = g_get_monotonic_time ();
+  thunar_job_launch (THUNAR_JOB (job));
+  g_main_loop_run (loop);
+
+  g_object_unref (job);
+
+  return (g_get_monotonic_time () - start) / (gdouble) G_USEC_PER_SEC;
+}
+
+int
+main (int    argc,
+      char **argv)
+{
+  g_autofree gchar  *tmpdir = NULL;
+  g_autoptr (GFile)  gfile = NULL;
+  ThunarFile        *file;
+  guint              n_processors = g_get_num_processors ();
+  gdouble            baseline = 0.0;
+  gdouble            seconds;
+
+  /* count the given folder, or a generated tree */
+  if (argc > 1)
+    gfile = g_file_new_for_commandline_arg (argv[1]);
+  else
+    {
+      tmpdir = test_util_create_tree ("thunar-bench-deep-count-XXXXXX", N_TOPLEVEL, N_SUBDIRS, N_FILES);
+      gfile = g_file_new_for_path (tmpdir);
+    }
+
+  file = thunar_file_get (gfile, NULL);
+  g_assert_nonnull (file);
+
+  /* warm up the caches, the walk with a single thread must not be
+   * penalized for reading from disk first */
+  run_deep_count (file, n_processors);
+
+  g_print ("%8s %10s %8s %10s\n", "threads", "seconds", "speedup", "files");
+  for (guint n_threads = 1;; n_threads = MIN (n_threads * 2, n_processors))
+    {
+      seconds = run_deep_count (file, n_threads);
+      if (n_threads == 1)
+        baseline = seconds;
+
+      g_print ("%8u %10.3f %7.2fx %10u\n", n_threads, seconds, baseline / seconds, n_files_counted);
+
+      if (n_threads >= n_processors)
+        break;
+    }
+
+  g_object_unref (file);
+
+  if (tmpdir != NULL)
+    test_util_remove_tree (gfile);
+
+  return 0;
+}
@@ -0,0 +1,78 @@
+
+#include "thunar/thunar-gio-extensions.h"
+#include "thunar/thunar-io-delete.h"
+#include "thunar/thunar-job.h"
+#include "thunar/thunar-simple-job.h"
+#include "tests/test-util.h"
+
+#include <glib/gstdio.h>
+#include <unistd.h> // for sync()
+
+/* size of the generated tree: N_TOPLEVEL * N_SUBDIRS directories with N_FILES files each */
+#define N_TOPLEVEL 32
+#define N_SUBDIRS  32
+#define N_FILES    64
+
+static gboolean
+delete_files (ThunarJob *job,
+              GArray    *param_values,
+              GError   **error)
+{
+  thunar_io_delete_local_files (job,
+                                g_value_get_boxed (&g_array_index (param_values, GValue, 0)),
+                                g_value_get_uint (&g_array_index (param_values, GValue, 1)));
+  return TRUE;
+}
+
+static gdouble
+run_delete (guint n_threads)
+{
+  g_autoptr (GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+  g_autofree gchar *tmpdir = test_util_create_tree ("thunar-bench-delete-XXXXXX", N_TOPLEVEL, N_SUBDIRS, N_FILES);
+  g_autoptr (GFile) file = g_file_new_for_path (tmpdir);
+  GList             files = { file, NULL, NULL };
+  ThunarJob        *job;
+  gint64            start;
+
+  /* the files are on the disk for all runs alike */
+  sync ();
+
+  job = thunar_simple_job_new (delete_files, 2,
+                               THUNAR_TYPE_G_FILE_LIST, &files,
+                               G_TYPE_UINT, n_threads);
+  g_signal_connect_swapped (job, "finished", G_CALLBACK (g_main_loop_quit), loop);
+
+  start = g_get_monotonic_time ();
+  thunar_job_launch (job);
+  g_main_loop_run (loop);
+
+  g_object_unref (job);
+
+  g_assert_false (g_file_test (tmpdir, G_FILE_TEST_EXISTS));
+
+  return (g_get_monotonic_time () - start) / (gdouble) G_USEC_PER_SEC;
+}
+
+int
+main (int    argc,
+      char **argv)
+{
+  guint   n_processors = g_get_num_processors ();
+  gdouble baseline = 0.0;
+  gdouble seconds;
+
+  g_print ("%8s %10s %8s\n", "threads", "seconds", "speedup");
+  for (guint n_threads = 1;; n_threads = MIN (n_threads * 2, n_processors))
+    {
+      seconds = run_delete (n_threads);
+      if (n_threads == 1)
+        baseline = seconds;
+
+      g_print ("%8u %10.3f %7.2fx\n", n_threads, seconds, baseline / seconds);
+
+      if (n_threads >= n_processors)
+        break;
+    }
+
+  return 0;
+}
@@ -0,0 +1,130 @@
+
+#include "thunar/thunar-job.h"
+#include "thunar/thunar-transfer-job.h"
+#include "tests/test-util.h"
+
+#include <glib/gstdio.h>
+#include <unistd.h> // for link()
+
+/* size of the generated tree: N_SNAPSHOTS folders with the same N_FILES files
+ * of FILE_SIZE bytes each, all hard linked to the files of the first folder */
+#define N_SNAPSHOTS 16
+#define N_FILES     256
+#define FILE_SIZE   (64 * 1024)
+
+static gchar *
+create_tree (void)
+{
+  g_autofree gchar *contents = g_malloc (FILE_SIZE);
+  gchar            *tmpdir = g_dir_make_tmp ("thunar-bench-hard-links-XXXXXX", NULL);
+
+  g_assert_nonnull (tmpdir);
+
+  for (gsize i = 0; i < FILE_SIZE; i++)
+    contents[i] = g_random_int_range (0, 256);
+
+  for (guint i = 0; i < N_SNAPSHOTS; i++)
+    {
+      g_autofree gchar *name_i = g_strdup_printf ("snapshot%u", i);
+      g_autofree gchar *dir = g_build_filename (tmpdir, "source", name_i, NULL);
+      g_assert_cmpint (g_mkdir_with_parents (dir, 0700), ==, 0);
+
+      for (guint j = 0; j < N_FILES; j++)
+        {
+          g_autofree gchar *name_j = g_strdup_printf ("f%u", j);
+          g_autofree gchar *path = g_build_filename (dir, name_j, NULL);
+          g_autofree gchar *first = g_build_filename (tmpdir, "source", "snapshot0", name_j, NULL);
+
+          if (i == 0)
+            g_assert_true (g_file_set_contents (path, contents, FILE_SIZE, NULL));
+          else
+            g_assert_cmpint (link (first, path), ==, 0);
+        }
+    }
+
+  return tmpdir;
+}
+
+/* the space allocated for the files below @path, hard linked files are counted once */
+static guint64
+disk_usage (const gchar *path,
+            GHashTable  *inodes)
+{
+  GStatBuf     statbuf;
+  GDir        *dir;
+  const gchar *name;
+  guint64      size = 0;
+
+  if (g_lstat (path, &statbuf) != 0)
+    return 0;
+
+  if (!g_hash_table_add (inodes, g_memdup2 (&statbuf.st_ino, sizeof (statbuf.st_ino))))
+    return 0;
+
+  size = (guint64) statbuf.st_blocks * 512;
+
+  dir = g_dir_open (path, 0, NULL);
+  if (dir != NULL)
+    {
+      while ((name = g_dir_read_name (dir)) != NULL)
+        {
+          g_autofree gchar *child = g_build_filename (path, name, NULL);
+          size += disk_usage (child, inodes);
+        }
+      g_dir_close (dir);
+    }
+
+  return size;
+}
+
+static void
+run_copy (const gchar *name,
+          const gchar *tmpdir,
+          gboolean     hard_links)
+{
+  g_autoptr (GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+  g_autoptr (GHashTable) inodes = g_hash_table_new_full (g_int64_hash, g_int64_equal, g_free, NULL);
+  g_autofree gchar *source_path = g_build_filename (tmpdir, "source", NULL);
+  g_autofree gchar *target_path = g_build_filename (tmpdir, "target", NULL);
+  g_autoptr (GFile) source = g_file_new_for_path (source_path);
+  g_autoptr (GFile) target = g_file_new_for_path (target_path);
+  GList             source_list = { source, NULL, NULL };
+  GList             target_list = { target, NULL, NULL };
+  ThunarJob        *job;
+  gint64            start;
+  gdouble           seconds;
+
+  test_util_remove_tree (target);
+
+  job = thunar_transfer_job_new (&source_list, &target_list, THUNAR_TRANSFER_JOB_COPY);
+  g_object_set (job,
+                "transfer-hard-links", hard_links,
+                "transfer-journal", FALSE,
+                NULL);
+  g_signal_connect_swapped (job, "finished", G_CALLBACK (g_main_loop_quit), loop);
+
+  start = g_get_monotonic_time ();
+  thunar_job_launch (job);
+  g_main_loop_run (loop);
+  seconds = (g_get_monotonic_time () - start) / (gdouble) G_USEC_PER_SEC;
+
+  g_object_unref (job);
+
+  g_print ("%-12s %10.3f %12.1f\n", name, seconds, disk_usage (target_path, inodes) / (1024.0 * 1024.0));
+}
+
+int
+main (int    argc,
+      char **argv)
+{
+  g_autofree gchar *tmpdir = create_tree ();
+  g_autoptr (GFile) gfile = g_file_new_for_path (tmpdir);
+
+  g_print ("%-12s %10s %12s\n", "hard links", "seconds", "MiB on disk");
+  run_copy ("copied", tmpdir, FALSE);
+  run_copy ("preserved", tmpdir, TRUE);
+
+  test_util_remove_tree (gfile);
+
+  return 0;
+}
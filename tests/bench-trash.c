@@ -0,0 +1,103 @@
+
+#include "thunar/thunar-io-trash.h"
+#include "tests/test-util.h"
+
+#include <glib/gstdio.h>
+
+/* number of files trashed per run, all in the same folder */
+#define N_FILES 4096
+
+static GList *
+create_files (const gchar *tmpdir,
+              const gchar *name)
+{
+  g_autofree gchar *dir = g_build_filename (tmpdir, name, NULL);
+  GList            *files = NULL;
+
+  g_assert_cmpint (g_mkdir_with_parents (dir, 0700), ==, 0);
+
+  for (guint i = 0; i < N_FILES; i++)
+    {
+      g_autofree gchar *name_i = g_strdup_printf ("%s-%u", name, i);
+      g_autofree gchar *path = g_build_filename (dir, name_i, NULL);
+      g_assert_true (g_file_set_contents (path, "thunar", -1, NULL));
+      files = g_list_prepend (files, g_file_new_for_path (path));
+    }
+
+  return g_list_reverse (files);
+}
+
+static guint
+count_trash_info (const gchar *tmpdir)
+{
+  g_autofree gchar *path = g_build_filename (tmpdir, "Trash", "info", NULL);
+  GDir             *dir = g_dir_open (path, 0, NULL);
+  guint             n = 0;
+
+  g_assert_nonnull (dir);
+  while (g_dir_read_name (dir) != NULL)
+    n++;
+  g_dir_close (dir);
+
+  return n;
+}
+
+static gdouble
+run_trash (const gchar *tmpdir,
+           const gchar *name,
+           gboolean     batched)
+{
+  GList         *files = create_files (tmpdir, name);
+  ThunarIoTrash *trash = NULL;
+  gint64         start;
+
+  start = g_get_monotonic_time ();
+
+  if (batched)
+    trash = thunar_io_trash_new ();
+
+  for (GList *lp = files; lp != NULL; lp = lp->next)
+    {
+      if (trash != NULL)
+        g_assert_true (thunar_io_trash_file (trash, lp->data));
+      else
+        g_assert_true (g_file_trash (lp->data, NULL, NULL));
+    }
+
+  if (trash != NULL)
+    thunar_io_trash_free (trash);
+
+  g_list_free_full (files, g_object_unref);
+
+  return (g_get_monotonic_time () - start) / (gdouble) G_USEC_PER_SEC;
+}
+
+int
+main (int    argc,
+      char **argv)
+{
+  g_autofree gchar *tmpdir = g_dir_make_tmp ("thunar-bench-trash-XXXXXX", NULL);
+  g_autoptr (GFile) gfile = NULL;
+  gdouble           baseline;
+  gdouble           seconds;
+
+  /* keep the trash of the user out of it, GLib reads these on first use */
+  g_assert_nonnull (tmpdir);
+  g_setenv ("HOME", tmpdir, TRUE);
+  g_setenv ("XDG_DATA_HOME", tmpdir, TRUE);
+  gfile = g_file_new_for_path (tmpdir);
+
+  g_print ("%-12s %10s %8s\n", "trash", "seconds", "speedup");
+
+  baseline = run_trash (tmpdir, "per-file", FALSE);
+  g_print ("%-12s %10.3f %7.2fx\n", "per-file", baseline, 1.0);
+
+  seconds = run_trash (tmpdir, "batched", TRUE);
+  g_print ("%-12s %10.3f %7.2fx\n", "batched", seconds, baseline / seconds);
+
+  g_assert_cmpuint (count_trash_info (tmpdir), ==, 2 * N_FILES);
+
+  test_util_remove_tree (gfile);
+
+  return 0;
+}
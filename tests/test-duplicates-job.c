@@ -0,0 +1,132 @@
+#include "thunar/thunar-duplicates-job.h"
+
+#include <glib/gstdio.h>
+#include <string.h>
+#include <unistd.h> // for link()
+
+/* larger than the blocks hashed at both ends of a file, so only the
+ * complete hash tells the files apart */
+#define LARGE_SIZE (64 * 1024)
+
+static gint
+compare_names (gconstpointer a,
+               gconstpointer b)
+{
+  return g_strcmp0 (*(const gchar *const *) a, *(const gchar *const *) b);
+}
+
+static void
+duplicates_found (ThunarJob *job,
+                  GList     *files,
+                  guint64    size,
+                  GPtrArray *sets)
+{
+  GPtrArray *names = g_ptr_array_new_with_free_func (g_free);
+
+  for (GList *lp = files; lp != NULL; lp = lp->next)
+    g_ptr_array_add (names, g_file_get_basename (lp->data));
+  g_ptr_array_sort (names, compare_names);
+  g_ptr_array_add (names, NULL);
+
+  g_ptr_array_add (sets, g_strjoinv (",", (gchar **) names->pdata));
+  g_ptr_array_unref (names);
+}
+
+static gchar *
+large_contents (gchar middle)
+{
+  gchar *contents = g_malloc (LARGE_SIZE);
+
+  memset (contents, 'x', LARGE_SIZE);
+  contents[LARGE_SIZE / 2] = middle;
+
+  return contents;
+}
+
+static void
+write_file (const gchar *dir,
+            const gchar *name,
+            const gchar *contents,
+            gssize       length)
+{
+  g_autofree gchar *path = g_build_filename (dir, name, NULL);
+  g_assert_true (g_file_set_contents (path, contents, length, NULL));
+}
+
+static void
+test_find_duplicates (void)
+{
+  /* generated file structure for testing:
+  - tmp/a           "thunar"
+  - tmp/sub/b       "thunar"      duplicate of a
+  - tmp/c --> a     hard link, no duplicate
+  - tmp/d           "thunas"      same size as a
+  - tmp/e, tmp/sub/f               large, identical
+  - tmp/g                          large, differs from e in the middle
+  - tmp/empty1, tmp/empty2         empty files are ignored
+  */
+
+  g_autofree gchar *tmpdir = g_dir_make_tmp ("thunar-test-duplicates-XXXXXX", NULL);
+  g_assert_nonnull (tmpdir);
+  g_autofree gchar *subdir = g_build_filename (tmpdir, "sub", NULL);
+  g_assert_cmpint (g_mkdir (subdir, 0700), ==, 0);
+
+  g_autofree gchar *large = large_contents ('x');
+  g_autofree gchar *large_other = large_contents ('y');
+
+  write_file (tmpdir, "a", "thunar", -1);
+  write_file (subdir, "b", "thunar", -1);
+  write_file (tmpdir, "d", "thunas", -1);
+  write_file (tmpdir, "e", large, LARGE_SIZE);
+  write_file (subdir, "f", large, LARGE_SIZE);
+  write_file (tmpdir, "g", large_other, LARGE_SIZE);
+  write_file (tmpdir, "empty1", "", 0);
+  write_file (tmpdir, "empty2", "", 0);
+
+  g_autofree gchar *path_a = g_build_filename (tmpdir, "a", NULL);
+  g_autofree gchar *path_c = g_build_filename (tmpdir, "c", NULL);
+  g_assert_cmpint (link (path_a, path_c), ==, 0);
+
+  g_autoptr (GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+  g_autoptr (GFile) folder = g_file_new_for_path (tmpdir);
+  g_autoptr (GPtrArray) sets = g_ptr_array_new_with_free_func (g_free);
+  GList files = { folder, NULL, NULL };
+
+  ThunarDuplicatesJob *job = thunar_duplicates_job_new (&files);
+  thunar_duplicates_job_set_max_threads (job, 2);
+  g_signal_connect (job, "duplicates-found", G_CALLBACK (duplicates_found), sets);
+  g_signal_connect_swapped (job, "finished", G_CALLBACK (g_main_loop_quit), loop);
+  thunar_job_launch (THUNAR_JOB (job));
+  g_main_loop_run (loop);
+  g_object_unref (job);
+
+  /* sets are reported as soon as they are confirmed, in any order, and
+   * either link of a may be picked */
+  g_ptr_array_sort (sets, compare_names);
+  g_assert_cmpuint (sets->len, ==, 2);
+  g_assert_true (g_strcmp0 (g_ptr_array_index (sets, 0), "a,b") == 0
+                 || g_strcmp0 (g_ptr_array_index (sets, 0), "b,c") == 0);
+  g_assert_cmpstr (g_ptr_array_index (sets, 1), ==, "e,f");
+
+  /* Delete testfiles */
+  const gchar *names[] = { "a", "c", "d", "e", "g", "empty1", "empty2", "sub/b", "sub/f" };
+  for (guint n = 0; n < G_N_ELEMENTS (names); n++)
+    {
+      g_autofree gchar *path = g_build_filename (tmpdir, names[n], NULL);
+      g_remove (path);
+    }
+  g_rmdir (subdir);
+  g_rmdir (tmpdir);
+}
+
+
+
+int
+main (int argc, char **argv)
+{
+  g_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/duplicates-job/test_find_duplicates", test_find_duplicates);
+
+  return g_test_run ();
+}
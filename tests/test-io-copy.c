@@ -0,0 +1,164 @@
+#include "thunar/thunar-io-copy.h"
+
+#include <fcntl.h>
+#include <glib/gstdio.h>
+#include <string.h>
+#include <unistd.h> // for pwrite() and ftruncate()
+
+/* a 64 MiB file with a few bytes of data at both ends and in the middle */
+#define SPARSE_SIZE (64 * 1024 * 1024)
+
+static void
+progress (goffset  current_num_bytes,
+          goffset  total_num_bytes,
+          gpointer user_data)
+{
+  goffset *last_num_bytes = user_data;
+
+  g_assert_cmpint (current_num_bytes, >=, *last_num_bytes);
+  g_assert_cmpint (current_num_bytes, <=, total_num_bytes);
+  *last_num_bytes = current_num_bytes;
+}
+
+static guint64
+allocated_size (GFile *file)
+{
+  g_autoptr (GFileInfo) info = g_file_query_info (file, G_FILE_ATTRIBUTE_STANDARD_ALLOCATED_SIZE,
+                                                  G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS, NULL, NULL);
+  g_assert_nonnull (info);
+  return g_file_info_get_attribute_uint64 (info, G_FILE_ATTRIBUTE_STANDARD_ALLOCATED_SIZE);
+}
+
+static void
+assert_same_contents (GFile *file_a,
+                      GFile *file_b)
+{
+  g_autofree gchar *contents_a = NULL;
+  g_autofree gchar *contents_b = NULL;
+  gsize             length_a;
+  gsize             length_b;
+
+  g_assert_true (g_file_load_contents (file_a, NULL, &contents_a, &length_a, NULL, NULL));
+  g_assert_true (g_file_load_contents (file_b, NULL, &contents_b, &length_b, NULL, NULL));
+  g_assert_cmpuint (length_a, ==, length_b);
+  g_assert_true (memcmp (contents_a, contents_b, length_a) == 0);
+}
+
+static void
+test_sparse_copy (gconstpointer data)
+{
+  ThunarReflinkMode reflink_mode = GPOINTER_TO_INT (data);
+  g_autoptr (GError) error = NULL;
+  g_autofree gchar *checksum = NULL;
+  g_autofree gchar *contents = NULL;
+  g_autofree gchar *expected = NULL;
+  gsize   length;
+  goffset last_num_bytes = 0;
+  gint    fd;
+
+  g_autofree gchar *tmpdir = g_dir_make_tmp ("thunar-test-io-copy-XXXXXX", NULL);
+  g_assert_nonnull (tmpdir);
+  g_autofree gchar *source_path = g_build_filename (tmpdir, "source", NULL);
+  g_autofree gchar *target_path = g_build_filename (tmpdir, "target", NULL);
+  g_autoptr (GFile) source = g_file_new_for_path (source_path);
+  g_autoptr (GFile) target = g_file_new_for_path (target_path);
+
+  fd = g_open (source_path, O_WRONLY | O_CREAT | O_EXCL, 0600);
+  g_assert_cmpint (fd, >=, 0);
+  g_assert_cmpint (pwrite (fd, "thunar", 6, 0), ==, 6);
+  g_assert_cmpint (pwrite (fd, "thunar", 6, SPARSE_SIZE / 2), ==, 6);
+  g_assert_cmpint (pwrite (fd, "thunar", 6, SPARSE_SIZE - 6), ==, 6);
+  g_assert_cmpint (close (fd), ==, 0);
+
+  if (allocated_size (source) >= SPARSE_SIZE / 2)
+    {
+      g_test_skip ("The file system does not support sparse files");
+    }
+  else
+    {
+      g_assert_true (thunar_io_copy_local_file (source, target, G_FILE_COPY_NOFOLLOW_SYMLINKS, reflink_mode, TRUE,
+                                                NULL, progress, &last_num_bytes, &checksum, &error));
+      g_assert_no_error (error);
+
+      /* the progress counts the holes, the allocated size doesn't */
+      g_assert_cmpint (last_num_bytes, ==, SPARSE_SIZE);
+      g_assert_cmpuint (allocated_size (target), <=, allocated_size (source));
+      assert_same_contents (source, target);
+
+      /* the checksum includes the holes */
+      g_assert_true (g_file_get_contents (source_path, &contents, &length, NULL));
+      expected = g_compute_checksum_for_data (THUNAR_IO_COPY_CHECKSUM_TYPE, (const guchar *) contents, length);
+      g_assert_cmpstr (checksum, ==, expected);
+    }
+
+  /* Delete testfiles */
+  g_remove (target_path);
+  g_remove (source_path);
+  g_rmdir (tmpdir);
+}
+
+static void
+test_copy_existing (void)
+{
+  g_autoptr (GError) error = NULL;
+  g_autoptr (GCancellable) cancellable = g_cancellable_new ();
+  g_autofree gchar *contents = NULL;
+  GDir             *dir;
+  guint             n_files = 0;
+
+  g_autofree gchar *tmpdir = g_dir_make_tmp ("thunar-test-io-copy-XXXXXX", NULL);
+  g_assert_nonnull (tmpdir);
+  g_autofree gchar *source_path = g_build_filename (tmpdir, "source", NULL);
+  g_autofree gchar *target_path = g_build_filename (tmpdir, "target", NULL);
+  g_autoptr (GFile) source = g_file_new_for_path (source_path);
+  g_autoptr (GFile) target = g_file_new_for_path (target_path);
+
+  g_assert_true (g_file_set_contents (source_path, "thunar", -1, NULL));
+  g_assert_true (g_file_set_contents (target_path, "xfce", -1, NULL));
+
+  /* like g_file_copy(), an existing file is only replaced if asked to */
+  g_assert_false (thunar_io_copy_local_file (source, target, G_FILE_COPY_NONE, THUNAR_REFLINK_MODE_AUTO, FALSE,
+                                             NULL, NULL, NULL, NULL, &error));
+  g_assert_error (error, G_IO_ERROR, G_IO_ERROR_EXISTS);
+  g_clear_error (&error);
+
+  /* a cancelled copy leaves the file to overwrite, and nothing else, behind */
+  g_cancellable_cancel (cancellable);
+  g_assert_false (thunar_io_copy_local_file (source, target, G_FILE_COPY_OVERWRITE, THUNAR_REFLINK_MODE_NEVER, FALSE,
+                                             cancellable, NULL, NULL, NULL, &error));
+  g_assert_error (error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+  g_clear_error (&error);
+  g_assert_true (g_file_get_contents (target_path, &contents, NULL, NULL));
+  g_assert_cmpstr (contents, ==, "xfce");
+
+  dir = g_dir_open (tmpdir, 0, NULL);
+  g_assert_nonnull (dir);
+  while (g_dir_read_name (dir) != NULL)
+    n_files++;
+  g_dir_close (dir);
+  g_assert_cmpuint (n_files, ==, 2);
+
+  g_assert_true (thunar_io_copy_local_file (source, target, G_FILE_COPY_OVERWRITE, THUNAR_REFLINK_MODE_AUTO, FALSE,
+                                            NULL, NULL, NULL, NULL, &error));
+  g_assert_no_error (error);
+  assert_same_contents (source, target);
+
+  /* Delete testfiles */
+  g_remove (target_path);
+  g_remove (source_path);
+  g_rmdir (tmpdir);
+}
+
+
+
+int
+main (int argc, char **argv)
+{
+  g_test_init (&argc, &argv, NULL);
+
+  g_test_add_data_func ("/io-copy/test_sparse_copy_never", GINT_TO_POINTER (THUNAR_REFLINK_MODE_NEVER), test_sparse_copy);
+  g_test_add_data_func ("/io-copy/test_sparse_copy_auto", GINT_TO_POINTER (THUNAR_REFLINK_MODE_AUTO), test_sparse_copy);
+  g_test_add_func ("/io-copy/test_copy_existing", test_copy_existing);
+
+  return g_test_run ();
+}
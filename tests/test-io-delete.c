@@ -0,0 +1,121 @@
+#include "thunar/thunar-gio-extensions.h"
+#include "thunar/thunar-io-delete.h"
+#include "thunar/thunar-job.h"
+#include "thunar/thunar-simple-job.h"
+#include "tests/test-util.h"
+
+#include <glib/gstdio.h>
+#include <unistd.h> // for symlink()
+
+/* deeper than the folders a thread keeps open, see MAX_OPEN_DEPTH */
+#define DEEP_LEVELS 40
+
+static gboolean
+delete_files (ThunarJob *job,
+              GArray    *param_values,
+              GError   **error)
+{
+  thunar_io_delete_local_files (job,
+                                g_value_get_boxed (&g_array_index (param_values, GValue, 0)),
+                                g_value_get_uint (&g_array_index (param_values, GValue, 1)));
+  return TRUE;
+}
+
+static void
+run_delete (const gchar *path,
+            guint        n_threads)
+{
+  g_autoptr (GMainLoop) loop = g_main_loop_new (NULL, FALSE);
+  g_autoptr (GFile) file = g_file_new_for_path (path);
+  GList      files = { file, NULL, NULL };
+  ThunarJob *job;
+
+  job = thunar_simple_job_new (delete_files, 2,
+                               THUNAR_TYPE_G_FILE_LIST, &files,
+                               G_TYPE_UINT, n_threads);
+  g_signal_connect_swapped (job, "finished", G_CALLBACK (g_main_loop_quit), loop);
+
+  thunar_job_launch (job);
+  g_main_loop_run (loop);
+
+  g_object_unref (job);
+}
+
+
+
+static void
+test_delete_tree (gconstpointer data)
+{
+  guint             n_threads = GPOINTER_TO_UINT (data);
+  g_autofree gchar *tmpdir = test_util_create_tree ("thunar-test-io-delete-XXXXXX", 4, 8, 16);
+
+  run_delete (tmpdir, n_threads);
+
+  g_assert_false (g_file_test (tmpdir, G_FILE_TEST_EXISTS));
+}
+
+
+
+static void
+test_delete_deep_tree (void)
+{
+  g_autofree gchar *tmpdir = g_dir_make_tmp ("thunar-test-io-delete-XXXXXX", NULL);
+  g_autofree gchar *path = g_strdup (tmpdir);
+
+  /* the deepest folders are walked once the open ones are closed */
+  for (guint n = 0; n < DEEP_LEVELS; n++)
+    {
+      g_autofree gchar *file_path = g_build_filename (path, "file", NULL);
+      gchar            *child = g_build_filename (path, "d", NULL);
+
+      g_assert_cmpint (g_mkdir (child, 0700), ==, 0);
+      g_assert_true (g_file_set_contents (file_path, "thunar", -1, NULL));
+      g_free (path);
+      path = child;
+    }
+
+  run_delete (tmpdir, 1);
+
+  g_assert_false (g_file_test (tmpdir, G_FILE_TEST_EXISTS));
+}
+
+
+
+static void
+test_delete_keeps_symlink_target (void)
+{
+  g_autofree gchar *tmpdir = g_dir_make_tmp ("thunar-test-io-delete-XXXXXX", NULL);
+  g_autofree gchar *outside = g_build_filename (tmpdir, "outside", NULL);
+  g_autofree gchar *outside_file = g_build_filename (outside, "file", NULL);
+  g_autofree gchar *folder = g_build_filename (tmpdir, "folder", NULL);
+  g_autofree gchar *link_path = g_build_filename (folder, "link", NULL);
+  g_autoptr (GFile) gfile = g_file_new_for_path (tmpdir);
+
+  g_assert_cmpint (g_mkdir (outside, 0700), ==, 0);
+  g_assert_true (g_file_set_contents (outside_file, "thunar", -1, NULL));
+  g_assert_cmpint (g_mkdir (folder, 0700), ==, 0);
+  g_assert_cmpint (symlink (outside, link_path), ==, 0);
+
+  run_delete (folder, 2);
+
+  /* only the link is deleted, not what it points to */
+  g_assert_false (g_file_test (folder, G_FILE_TEST_EXISTS));
+  g_assert_true (g_file_test (outside_file, G_FILE_TEST_IS_REGULAR));
+
+  test_util_remove_tree (gfile);
+}
+
+
+
+int
+main (int argc, char **argv)
+{
+  g_test_init (&argc, &argv, NULL);
+
+  g_test_add_data_func ("/io-delete/test_delete_tree_single_thread", GUINT_TO_POINTER (1), test_delete_tree);
+  g_test_add_data_func ("/io-delete/test_delete_tree_threads", GUINT_TO_POINTER (4), test_delete_tree);
+  g_test_add_func ("/io-delete/test_delete_deep_tree", test_delete_deep_tree);
+  g_test_add_func ("/io-delete/test_delete_keeps_symlink_target", test_delete_keeps_symlink_target);
+
+  return g_test_run ();
+}
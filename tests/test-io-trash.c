@@ -0,0 +1,146 @@
+#include "thunar/thunar-io-trash.h"
+#include "tests/test-util.h"
+
+#include <glib/gstdio.h>
+#include <string.h>
+
+static gchar *tmpdir;
+
+/* creates @name in the folder @dir_name of the temporary folder */
+static GFile *
+create_file (const gchar *dir_name,
+             const gchar *name)
+{
+  g_autofree gchar *dir = g_build_filename (tmpdir, dir_name, NULL);
+  g_autofree gchar *path = g_build_filename (dir, name, NULL);
+
+  g_assert_cmpint (g_mkdir_with_parents (dir, 0700), ==, 0);
+  g_assert_true (g_file_set_contents (path, "thunar", -1, NULL));
+
+  return g_file_new_for_path (path);
+}
+
+static GKeyFile *
+load_trash_info (const gchar *name)
+{
+  g_autoptr (GError) error = NULL;
+  g_autofree gchar *info_name = g_strconcat (name, ".trashinfo", NULL);
+  g_autofree gchar *path = g_build_filename (tmpdir, "Trash", "info", info_name, NULL);
+  GKeyFile         *key_file = g_key_file_new ();
+
+  g_assert_true (g_key_file_load_from_file (key_file, path, G_KEY_FILE_NONE, &error));
+  g_assert_no_error (error);
+
+  return key_file;
+}
+
+static gboolean
+is_trashed (const gchar *name)
+{
+  g_autofree gchar *path = g_build_filename (tmpdir, "Trash", "files", name, NULL);
+
+  return g_file_test (path, G_FILE_TEST_IS_REGULAR);
+}
+
+
+
+static void
+test_trash_info (void)
+{
+  g_autoptr (GFile) file = create_file ("info", "my photo.jpg");
+  g_autoptr (GKeyFile) key_file = NULL;
+  g_autoptr (GTimeZone) time_zone = g_time_zone_new_local ();
+  g_autoptr (GDateTime) now = g_date_time_new_now (time_zone);
+  g_autoptr (GDateTime) deletion_date = NULL;
+  g_autofree gchar *escaped_path = NULL;
+  g_autofree gchar *path = NULL;
+  g_autofree gchar *date = NULL;
+  ThunarIoTrash    *trash;
+
+  trash = thunar_io_trash_new ();
+  g_assert_nonnull (trash);
+  g_assert_true (thunar_io_trash_file (trash, file));
+  thunar_io_trash_free (trash);
+
+  g_assert_false (g_file_query_exists (file, NULL));
+  g_assert_true (is_trashed ("my photo.jpg"));
+
+  /* the original location is an escaped absolute path */
+  key_file = load_trash_info ("my photo.jpg");
+  escaped_path = g_key_file_get_string (key_file, "Trash Info", "Path", NULL);
+  g_assert_nonnull (escaped_path);
+  g_assert_null (strchr (escaped_path, ' '));
+  path = g_uri_unescape_string (escaped_path, NULL);
+  g_assert_cmpstr (path, ==, g_file_peek_path (file));
+
+  /* the deletion date is in local time, without time zone */
+  date = g_key_file_get_string (key_file, "Trash Info", "DeletionDate", NULL);
+  g_assert_nonnull (date);
+  deletion_date = g_date_time_new_from_iso8601 (date, time_zone);
+  g_assert_nonnull (deletion_date);
+  g_assert_cmpint (ABS (g_date_time_difference (now, deletion_date)), <, 60 * G_TIME_SPAN_SECOND);
+}
+
+
+
+static void
+test_trash_collisions (void)
+{
+  const gchar *names[] = { "photo.jpg", "backup.tar.gz", "README" };
+  const gchar *renamed[] = { "photo.2.jpg", "backup.2.tar.gz", "README.2" };
+  ThunarIoTrash *trash;
+
+  trash = thunar_io_trash_new ();
+  g_assert_nonnull (trash);
+
+  for (guint n = 0; n < G_N_ELEMENTS (names); n++)
+    {
+      g_autoptr (GFile) first = create_file ("first", names[n]);
+      g_autoptr (GFile) second = create_file ("second", names[n]);
+      g_autoptr (GKeyFile) key_file = NULL;
+      g_autofree gchar *escaped_path = NULL;
+      g_autofree gchar *path = NULL;
+
+      g_assert_true (thunar_io_trash_file (trash, first));
+      g_assert_true (thunar_io_trash_file (trash, second));
+
+      /* the number goes in front of the extension */
+      g_assert_true (is_trashed (names[n]));
+      g_assert_true (is_trashed (renamed[n]));
+
+      key_file = load_trash_info (renamed[n]);
+      escaped_path = g_key_file_get_string (key_file, "Trash Info", "Path", NULL);
+      path = g_uri_unescape_string (escaped_path, NULL);
+      g_assert_cmpstr (path, ==, g_file_peek_path (second));
+    }
+
+  thunar_io_trash_free (trash);
+}
+
+
+
+int
+main (int argc, char **argv)
+{
+  g_autoptr (GFile) gfile = NULL;
+  gint result;
+
+  /* keep the trash of the user out of it, GLib reads these on first use */
+  tmpdir = g_dir_make_tmp ("thunar-test-io-trash-XXXXXX", NULL);
+  g_assert_nonnull (tmpdir);
+  g_setenv ("HOME", tmpdir, TRUE);
+  g_setenv ("XDG_DATA_HOME", tmpdir, TRUE);
+
+  g_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/io-trash/test_trash_info", test_trash_info);
+  g_test_add_func ("/io-trash/test_trash_collisions", test_trash_collisions);
+
+  result = g_test_run ();
+
+  gfile = g_file_new_for_path (tmpdir);
+  test_util_remove_tree (gfile);
+  g_free (tmpdir);
+
+  return result;
+}
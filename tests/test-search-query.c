@@ -0,0 +1,180 @@
+#include "thunar/thunar-search-query.h"
+
+#define DAY (24 * 60 * 60)
+
+static GFileInfo *
+file_info_new (GFileType type,
+               guint64   size,
+               gint64    mtime)
+{
+  GFileInfo *info = g_file_info_new ();
+
+  g_file_info_set_name (info, type == G_FILE_TYPE_DIRECTORY ? "folder" : "file.txt");
+  g_file_info_set_file_type (info, type);
+  g_file_info_set_attribute_uint64 (info, G_FILE_ATTRIBUTE_STANDARD_SIZE, size);
+  g_file_info_set_attribute_uint64 (info, G_FILE_ATTRIBUTE_TIME_MODIFIED, mtime);
+
+  return info;
+}
+
+/* whether a file modified @age seconds ago passes the filters of @query */
+static gboolean
+match_age (const gchar *query,
+           gint64       age)
+{
+  g_autoptr (GError) error = NULL;
+  g_autoptr (GFileInfo) info = file_info_new (G_FILE_TYPE_REGULAR, 0, g_get_real_time () / G_USEC_PER_SEC - age);
+  ThunarSearchQuery *search_query;
+  gboolean           matched;
+
+  search_query = thunar_search_query_new (query, THUNAR_SEARCH_MODE_SUBSTRING, &error);
+  g_assert_no_error (error);
+  g_assert_nonnull (search_query);
+
+  matched = thunar_search_query_match_info (search_query, info);
+  thunar_search_query_unref (search_query);
+
+  return matched;
+}
+
+static gboolean
+match_size (const gchar *query,
+            GFileType    type,
+            guint64      size)
+{
+  g_autoptr (GError) error = NULL;
+  g_autoptr (GFileInfo) info = file_info_new (type, size, 0);
+  ThunarSearchQuery *search_query;
+  gboolean           matched;
+
+  search_query = thunar_search_query_new (query, THUNAR_SEARCH_MODE_SUBSTRING, &error);
+  g_assert_no_error (error);
+  g_assert_nonnull (search_query);
+
+  matched = thunar_search_query_match_info (search_query, info);
+  thunar_search_query_unref (search_query);
+
+  return matched;
+}
+
+
+
+static void
+test_mtime_filter (void)
+{
+  /* relative points in time */
+  g_assert_true (match_age ("modified:>7d", 1 * DAY));
+  g_assert_false (match_age ("modified:>7d", 10 * DAY));
+  g_assert_true (match_age ("modified:<7d", 10 * DAY));
+  g_assert_false (match_age ("modified:<7d", 1 * DAY));
+  g_assert_true (match_age ("modified:7d", 1 * DAY));
+  g_assert_false (match_age ("modified:7d", 10 * DAY));
+
+  /* well-known periods are bounded by now minus the period */
+  g_assert_true (match_age ("modified:>week", 1 * DAY));
+  g_assert_false (match_age ("modified:>week", 10 * DAY));
+  g_assert_true (match_age ("modified:<week", 10 * DAY));
+  g_assert_false (match_age ("modified:<week", 1 * DAY));
+  g_assert_true (match_age ("modified:week", 1 * DAY));
+  g_assert_true (match_age ("modified:>month", 20 * DAY));
+  g_assert_false (match_age ("modified:>month", 40 * DAY));
+  g_assert_true (match_age ("modified:>=year", 200 * DAY));
+  g_assert_false (match_age ("modified:>year", 400 * DAY));
+  g_assert_true (match_age ("modified:<year", 400 * DAY));
+
+  /* "today" covers the calendar day */
+  g_assert_true (match_age ("modified:today", 0));
+  g_assert_false (match_age ("modified:today", 2 * DAY));
+  g_assert_true (match_age ("modified:<today", 2 * DAY));
+  g_assert_false (match_age ("modified:<today", 0));
+
+  /* ranges */
+  g_assert_true (match_age ("modified:30d..7d", 10 * DAY));
+  g_assert_false (match_age ("modified:30d..7d", 1 * DAY));
+  g_assert_false (match_age ("modified:30d..7d", 40 * DAY));
+}
+
+
+
+static void
+test_size_filter (void)
+{
+  g_assert_true (match_size ("size:>1M", G_FILE_TYPE_REGULAR, 2 * 1024 * 1024));
+  g_assert_false (match_size ("size:>1M", G_FILE_TYPE_REGULAR, 1024 * 1024));
+  g_assert_true (match_size ("size:>=1M", G_FILE_TYPE_REGULAR, 1024 * 1024));
+  g_assert_true (match_size ("size:<4KiB", G_FILE_TYPE_REGULAR, 100));
+  g_assert_false (match_size ("size:<4KiB", G_FILE_TYPE_REGULAR, 4096));
+  g_assert_true (match_size ("size:1KB", G_FILE_TYPE_REGULAR, 1000));
+  g_assert_true (match_size ("size:1M..10M", G_FILE_TYPE_REGULAR, 5 * 1024 * 1024));
+  g_assert_false (match_size ("size:1M..10M", G_FILE_TYPE_REGULAR, 20 * 1024 * 1024));
+
+  /* folders never match a size filter */
+  g_assert_false (match_size ("size:>=0", G_FILE_TYPE_DIRECTORY, 4096));
+}
+
+
+
+static void
+test_type_filter (void)
+{
+  g_assert_true (match_size ("type:folder", G_FILE_TYPE_DIRECTORY, 0));
+  g_assert_false (match_size ("type:folder", G_FILE_TYPE_REGULAR, 0));
+  g_assert_true (match_size ("type:file", G_FILE_TYPE_REGULAR, 0));
+  g_assert_false (match_size ("type:image", G_FILE_TYPE_REGULAR, 0));
+}
+
+
+
+static void
+test_invalid_filter (void)
+{
+  const gchar *queries[] = { "size:abc", "size:<0", "modified:", "modified:7x", "modified:2024-13-45", "type:" };
+
+  for (guint n = 0; n < G_N_ELEMENTS (queries); n++)
+    {
+      g_autoptr (GError) error = NULL;
+
+      g_assert_null (thunar_search_query_new (queries[n], THUNAR_SEARCH_MODE_SUBSTRING, &error));
+      g_assert_error (error, G_FILE_ERROR, G_FILE_ERROR_INVAL);
+    }
+}
+
+
+
+static void
+test_regex_keeps_filters (void)
+{
+  g_autoptr (GError) error = NULL;
+  ThunarSearchQuery *search_query;
+
+  /* "key:value" is part of the expression in regex mode */
+  search_query = thunar_search_query_new ("^type:(a|b)$", THUNAR_SEARCH_MODE_REGEX, &error);
+  g_assert_no_error (error);
+  g_assert_nonnull (search_query);
+  g_assert_null (thunar_search_query_get_attributes (search_query));
+  g_assert_true (thunar_search_query_match (search_query, "type:a", NULL));
+  g_assert_false (thunar_search_query_match (search_query, "a", NULL));
+  thunar_search_query_unref (search_query);
+
+  search_query = thunar_search_query_new ("size:\\d+", THUNAR_SEARCH_MODE_REGEX, &error);
+  g_assert_no_error (error);
+  g_assert_nonnull (search_query);
+  g_assert_true (thunar_search_query_match (search_query, "size:42", NULL));
+  thunar_search_query_unref (search_query);
+}
+
+
+
+int
+main (int argc, char **argv)
+{
+  g_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/search-query/test_mtime_filter", test_mtime_filter);
+  g_test_add_func ("/search-query/test_size_filter", test_size_filter);
+  g_test_add_func ("/search-query/test_type_filter", test_type_filter);
+  g_test_add_func ("/search-query/test_invalid_filter", test_invalid_filter);
+  g_test_add_func ("/search-query/test_regex_keeps_filters", test_regex_keeps_filters);
+
+  return g_test_run ();
+}
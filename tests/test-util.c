@@ -0,0 +1,55 @@
+#include "tests/test-util.h"
+
+#include <glib/gstdio.h>
+
+/* creates a temporary folder named after @tmpl with @n_toplevel * @n_subdirs
+ * folders "d<i>/d<j>" of @n_files small files "f<k>" each */
+gchar *
+test_util_create_tree (const gchar *tmpl,
+                       guint        n_toplevel,
+                       guint        n_subdirs,
+                       guint        n_files)
+{
+  gchar *tmpdir = g_dir_make_tmp (tmpl, NULL);
+  g_assert_nonnull (tmpdir);
+
+  for (guint i = 0; i < n_toplevel; i++)
+    for (guint j = 0; j < n_subdirs; j++)
+      {
+        g_autofree gchar *name_i = g_strdup_printf ("d%u", i);
+        g_autofree gchar *name_j = g_strdup_printf ("d%u", j);
+        g_autofree gchar *dir = g_build_filename (tmpdir, name_i, name_j, NULL);
+        g_assert_cmpint (g_mkdir_with_parents (dir, 0700), ==, 0);
+
+        for (guint k = 0; k < n_files; k++)
+          {
+            g_autofree gchar *name_k = g_strdup_printf ("f%u", k);
+            g_autofree gchar *path = g_build_filename (dir, name_k, NULL);
+            g_assert_true (g_file_set_contents (path, "thunar", -1, NULL));
+          }
+      }
+
+  return tmpdir;
+}
+
+/* deletes @file and everything below it, without following symlinks */
+void
+test_util_remove_tree (GFile *file)
+{
+  GFileEnumerator *enumerator;
+  GFileInfo       *info;
+
+  enumerator = g_file_enumerate_children (file, G_FILE_ATTRIBUTE_STANDARD_NAME, G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS, NULL, NULL);
+  if (enumerator != NULL)
+    {
+      while ((info = g_file_enumerator_next_file (enumerator, NULL, NULL)) != NULL)
+        {
+          g_autoptr (GFile) child = g_file_get_child (file, g_file_info_get_name (info));
+          test_util_remove_tree (child);
+          g_object_unref (info);
+        }
+      g_object_unref (enumerator);
+    }
+
+  g_file_delete (file, NULL, NULL);
+}
@@ -0,0 +1,18 @@
+#ifndef __TEST_UTIL_H__
+#define __TEST_UTIL_H__
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+gchar *
+test_util_create_tree (const gchar *tmpl,
+                       guint        n_toplevel,
+                       guint        n_subdirs,
+                       guint        n_files);
+void
+test_util_remove_tree (GFile *file);
+
+G_END_DECLS
+
+#endif /* !__TEST_UTIL_H__ */
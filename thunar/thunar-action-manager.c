@@ -2050,7 +2050,7 @@ thunar_action_manager_sendto_device (ThunarActionManager *action_mgr,
     {
       /* copy the files onto the specified device */
       application = thunar_application_get ();
-      thunar_application_copy_into (application, action_mgr->widget, files, mount_point, THUNAR_OPERATION_LOG_OPERATIONS, NULL);
+      thunar_application_copy_into (application, action_mgr->widget, files, mount_point, THUNAR_OPERATION_LOG_OPERATIONS, NULL, NULL);
       g_object_unref (application);
       g_object_unref (mount_point);
     }
@@ -2387,7 +2387,7 @@ thunar_action_manager_action_duplicate (ThunarActionManager *action_mgr)
        */
       application = thunar_application_get ();
       thunar_application_copy_into (application, action_mgr->widget, files_to_process,
-                                    thunar_file_get_file (action_mgr->current_directory), THUNAR_OPERATION_LOG_OPERATIONS, action_mgr->new_files_created_closure);
+                                    thunar_file_get_file (action_mgr->current_directory), THUNAR_OPERATION_LOG_OPERATIONS, action_mgr->new_files_created_closure, NULL);
       g_object_unref (G_OBJECT (application));
 
       /* clean up */
@@ -58,6 +58,7 @@
 #include "thunar/thunar-gobject-extensions.h"
 #include "thunar/thunar-gtk-extensions.h"
 #include "thunar/thunar-io-jobs.h"
+#include "thunar/thunar-io-recent.h"
 #include "thunar/thunar-job-operation-history.h"
 #include "thunar/thunar-preferences.h"
 #include "thunar/thunar-private.h"
@@ -161,21 +162,24 @@ thunar_application_dbus_register (GApplication    *application,
 static void
 thunar_application_load_css (void);
 static void
+thunar_application_recent_changed (GtkRecentManager *recent_manager);
+static void
 thunar_application_accel_map_changed (ThunarApplication *application);
 static gboolean
 thunar_application_accel_map_save (gpointer user_data);
 static void
-thunar_application_collect_and_launch (ThunarApplication     *application,
-                                       gpointer               parent,
-                                       const gchar           *icon_name,
-                                       const gchar           *title,
-                                       Launcher               launcher,
-                                       GList                 *source_file_list,
-                                       GFile                 *target_file,
-                                       gboolean               update_source_folders,
-                                       gboolean               update_target_folders,
-                                       ThunarOperationLogMode log_mode,
-                                       GClosure              *new_files_closure);
+thunar_application_collect_and_launch (ThunarApplication          *application,
+                                       gpointer                    parent,
+                                       const gchar                *icon_name,
+                                       const gchar                *title,
+                                       Launcher                    launcher,
+                                       GList                      *source_file_list,
+                                       GFile                      *target_file,
+                                       gboolean                    update_source_folders,
+                                       gboolean                    update_target_folders,
+                                       ThunarOperationLogMode      log_mode,
+                                       GClosure                   *new_files_closure,
+                                       const ThunarTransferLimits *limits);
 
 #ifdef HAVE_LIBCANBERRA
 static void
@@ -188,6 +192,9 @@ static void
 thunar_application_launch_finished (ThunarJob *job,
                                     GList     *containing_folders);
 static void
+thunar_application_apply_limits (ThunarJob                  *job,
+                                 const ThunarTransferLimits *limits);
+static void
 thunar_application_launch (ThunarApplication     *application,
                            gpointer               parent,
                            const gchar           *icon_name,
@@ -199,6 +206,18 @@ thunar_application_launch (ThunarApplication     *application,
                            gboolean               update_target_folders,
                            ThunarOperationLogMode log_mode,
                            GClosure              *new_files_closure);
+static void
+thunar_application_launch_job (ThunarApplication     *application,
+                               gpointer               parent,
+                               const gchar           *icon_name,
+                               const gchar           *title,
+                               ThunarJob             *job,
+                               GList                 *source_path_list,
+                               GList                 *target_path_list,
+                               gboolean               update_source_folders,
+                               gboolean               update_target_folders,
+                               ThunarOperationLogMode log_mode,
+                               GClosure              *new_files_closure);
 #ifdef HAVE_GUDEV
 static void
 thunar_application_uevent (GUdevClient       *client,
@@ -226,6 +245,8 @@ static GtkWidget *
 thunar_application_get_progress_dialog (ThunarApplication *application);
 static void
 thunar_application_process_files (ThunarApplication *application);
+static gboolean
+thunar_application_resume_transfers (gpointer user_data);
 
 
 
@@ -257,6 +278,9 @@ struct _ThunarApplication
   guint show_progress_dialog_n_jobs_before;
   guint show_progress_dialog_timer_id;
 
+  /* asks to resume the copies interrupted the last time */
+  guint resume_transfers_id;
+
 #ifdef HAVE_GUDEV
   GUdevClient *udev_client;
 
@@ -350,6 +374,7 @@ thunar_application_init (ThunarApplication *application)
   application->process_file_action = THUNAR_APPLICATION_SELECT_FILES;
   application->progress_dialog = NULL;
   application->preferences = NULL;
+  application->resume_transfers_id = 0;
 
   g_application_set_flags (G_APPLICATION (application), G_APPLICATION_HANDLES_COMMAND_LINE);
   g_application_add_main_option_entries (G_APPLICATION (application), option_entries);
@@ -457,6 +482,10 @@ thunar_application_startup (GApplication *gapp)
 
   G_APPLICATION_CLASS (thunar_application_parent_class)->startup (gapp);
 
+  /* drop the cached targets of recent:/// whenever the list of recent files changes */
+  g_signal_connect (gtk_recent_manager_get_default (), "changed",
+                    G_CALLBACK (thunar_application_recent_changed), NULL);
+
   /* connect to the session manager */
   application->session_client = thunar_session_client_new (opt_sm_client_id);
 
@@ -464,6 +493,18 @@ thunar_application_startup (GApplication *gapp)
   application->accel_map = NULL;
 
   thunar_application_load_css ();
+
+  /* offer to resume the copies interrupted when Thunar died, once the
+   * windows requested on the command line are shown */
+  application->resume_transfers_id = g_idle_add_full (G_PRIORITY_LOW, thunar_application_resume_transfers, application, NULL);
+}
+
+
+
+static void
+thunar_application_recent_changed (GtkRecentManager *recent_manager)
+{
+  thunar_io_recent_invalidate ();
 }
 
 
@@ -514,6 +555,10 @@ thunar_application_shutdown (GApplication *gapp)
   if (G_UNLIKELY (application->show_progress_dialog_timer_id != 0))
     g_source_remove (application->show_progress_dialog_timer_id);
 
+  /* the interrupted copies are offered again the next time */
+  if (G_UNLIKELY (application->resume_transfers_id != 0))
+    g_source_remove (application->resume_transfers_id);
+
   /* drop ref on the thumbnailer */
   if (application->thumbnailer != NULL)
     g_object_unref (application->thumbnailer);
@@ -522,6 +567,10 @@ thunar_application_shutdown (GApplication *gapp)
   if (application->thumbnail_cache != NULL)
     g_object_unref (G_OBJECT (application->thumbnail_cache));
 
+  /* release the cached targets of recent:/// */
+  g_signal_handlers_disconnect_by_func (gtk_recent_manager_get_default (), thunar_application_recent_changed, NULL);
+  thunar_io_recent_invalidate ();
+
   /* disconnect from the preferences */
   g_object_unref (G_OBJECT (application->preferences));
 
@@ -951,23 +1000,25 @@ thunar_application_drop_descendant_files_from_list (GList *list)
 }
 
 static void
-thunar_application_collect_and_launch (ThunarApplication     *application,
-                                       gpointer               parent,
-                                       const gchar           *icon_name,
-                                       const gchar           *title,
-                                       Launcher               launcher,
-                                       GList                 *source_file_list,
-                                       GFile                 *target_file,
-                                       gboolean               update_source_folders,
-                                       gboolean               update_target_folders,
-                                       ThunarOperationLogMode log_mode,
-                                       GClosure              *new_files_closure)
-{
-  GFile  *file;
-  GError *err = NULL;
-  GList  *target_file_list = NULL;
-  GList  *lp;
-  gchar  *base_name;
+thunar_application_collect_and_launch (ThunarApplication          *application,
+                                       gpointer                    parent,
+                                       const gchar                *icon_name,
+                                       const gchar                *title,
+                                       Launcher                    launcher,
+                                       GList                      *source_file_list,
+                                       GFile                      *target_file,
+                                       gboolean                    update_source_folders,
+                                       gboolean                    update_target_folders,
+                                       ThunarOperationLogMode      log_mode,
+                                       GClosure                   *new_files_closure,
+                                       const ThunarTransferLimits *limits)
+{
+  ThunarJob *job;
+  GFile     *file;
+  GError    *err = NULL;
+  GList     *target_file_list = NULL;
+  GList     *lp;
+  gchar     *base_name;
 
   /* check if we have anything to operate on */
   if (G_UNLIKELY (source_file_list == NULL))
@@ -1028,8 +1079,11 @@ thunar_application_collect_and_launch (ThunarApplication     *application,
   else
     {
       /* launch the operation */
-      thunar_application_launch (application, parent, icon_name, title, launcher,
-                                 source_file_list, target_file_list, update_source_folders, update_target_folders, log_mode, new_files_closure);
+      job = (*launcher) (source_file_list, target_file_list);
+      if (limits != NULL)
+        thunar_application_apply_limits (job, limits);
+      thunar_application_launch_job (application, parent, icon_name, title, job,
+                                     source_file_list, target_file_list, update_source_folders, update_target_folders, log_mode, new_files_closure);
     }
 
   /* release the target path list */
@@ -1113,6 +1167,22 @@ thunar_application_launch_finished (ThunarJob *job,
 
 
 
+/* sets the limits of a single transfer on the @job */
+static void
+thunar_application_apply_limits (ThunarJob                  *job,
+                                 const ThunarTransferLimits *limits)
+{
+  if (THUNAR_IS_TRANSFER_JOB (job))
+    {
+      g_object_set (job,
+                    "bandwidth-limit", limits->bandwidth_limit,
+                    "io-priority", limits->io_priority,
+                    NULL);
+    }
+}
+
+
+
 static void
 thunar_application_launch (ThunarApplication     *application,
                            gpointer               parent,
@@ -1126,15 +1196,40 @@ thunar_application_launch (ThunarApplication     *application,
                            ThunarOperationLogMode log_mode,
                            GClosure              *new_files_closure)
 {
-  GtkWidget *dialog;
   ThunarJob *job;
-  GList     *parent_folder_list = NULL;
 
   _thunar_return_if_fail (parent == NULL || GDK_IS_SCREEN (parent) || GTK_IS_WIDGET (parent));
 
   /* try to allocate a new job for the operation */
   job = (*launcher) (source_file_list, target_file_list);
 
+  thunar_application_launch_job (application, parent, icon_name, title, job,
+                                 source_file_list, target_file_list, update_source_folders, update_target_folders,
+                                 log_mode, new_files_closure);
+}
+
+
+
+/* shows the progress of the @job and takes over the reference on it */
+static void
+thunar_application_launch_job (ThunarApplication     *application,
+                               gpointer               parent,
+                               const gchar           *icon_name,
+                               const gchar           *title,
+                               ThunarJob             *job,
+                               GList                 *source_file_list,
+                               GList                 *target_file_list,
+                               gboolean               update_source_folders,
+                               gboolean               update_target_folders,
+                               ThunarOperationLogMode log_mode,
+                               GClosure              *new_files_closure)
+{
+  GtkWidget *dialog;
+  GList     *parent_folder_list = NULL;
+
+  _thunar_return_if_fail (parent == NULL || GDK_IS_SCREEN (parent) || GTK_IS_WIDGET (parent));
+  _thunar_return_if_fail (THUNAR_IS_JOB (job));
+
   if (update_source_folders)
     parent_folder_list = g_list_concat (parent_folder_list, thunar_g_file_list_get_parents (source_file_list));
   if (update_target_folders)
@@ -1186,6 +1281,94 @@ thunar_application_launch (ThunarApplication     *application,
 
 
 
+/* asks whether to resume the copies of a Thunar which died meanwhile */
+static gboolean
+thunar_application_resume_transfers (gpointer user_data)
+{
+  ThunarApplication     *application = THUNAR_APPLICATION (user_data);
+  ThunarTransferJournal *journal;
+  ThunarJob             *job;
+  GtkWidget             *dialog;
+  GList                 *source_file_list;
+  GList                 *target_file_list;
+  GFile                 *target_folder;
+  gchar                 *display_name;
+  gchar                **paths;
+  guint                  n_files;
+  guint                  n;
+  gint                   response;
+
+  application->resume_transfers_id = 0;
+
+  /* keep the application alive while the user is asked */
+  g_application_hold (G_APPLICATION (application));
+
+  paths = thunar_transfer_journal_list_interrupted ();
+  for (n = 0; paths[n] != NULL; n++)
+    {
+      journal = thunar_transfer_journal_load (paths[n], NULL);
+      if (journal == NULL)
+        continue;
+
+      /* the top level files are usually copied into the same folder */
+      thunar_transfer_journal_get_plan (journal, &source_file_list, &target_file_list);
+      target_folder = g_file_get_parent (target_file_list->data);
+      display_name = g_file_get_parse_name (target_folder != NULL ? target_folder : target_file_list->data);
+      n_files = g_list_length (source_file_list);
+
+      dialog = gtk_message_dialog_new (NULL, GTK_DIALOG_MODAL, GTK_MESSAGE_QUESTION, GTK_BUTTONS_NONE,
+                                       "%s", _("Thunar was closed while copying files"));
+      gtk_message_dialog_format_secondary_text (GTK_MESSAGE_DIALOG (dialog),
+                                                ngettext ("The copy of %u file to “%s” can be resumed. "
+                                                          "The files copied completely are not copied again.",
+                                                          "The copy of %u files to “%s” can be resumed. "
+                                                          "The files copied completely are not copied again.",
+                                                          n_files),
+                                                n_files, display_name);
+      gtk_window_set_title (GTK_WINDOW (dialog), _("Resume Copy"));
+      gtk_dialog_add_buttons (GTK_DIALOG (dialog),
+                              _("_Discard"), GTK_RESPONSE_REJECT,
+                              _("_Resume"), GTK_RESPONSE_ACCEPT,
+                              NULL);
+      gtk_dialog_set_default_response (GTK_DIALOG (dialog), GTK_RESPONSE_ACCEPT);
+      thunar_gtk_dialog_wrap_long_text (GTK_DIALOG (dialog));
+      response = gtk_dialog_run (GTK_DIALOG (dialog));
+      gtk_widget_destroy (dialog);
+
+      if (response == GTK_RESPONSE_ACCEPT)
+        {
+          /* the job takes over the journal */
+          job = thunar_io_jobs_copy_files (source_file_list, target_file_list);
+          thunar_transfer_job_set_journal (THUNAR_TRANSFER_JOB (job), journal);
+          thunar_application_launch_job (application, NULL, "edit-copy",
+                                         _("Copying files..."), job,
+                                         source_file_list, target_file_list, FALSE, TRUE,
+                                         THUNAR_OPERATION_LOG_OPERATIONS, NULL);
+        }
+      else if (response == GTK_RESPONSE_REJECT)
+        {
+          thunar_transfer_journal_discard (journal);
+        }
+      else
+        {
+          /* asked again the next time Thunar starts */
+          thunar_transfer_journal_close (journal);
+        }
+
+      g_free (display_name);
+      if (target_folder != NULL)
+        g_object_unref (target_folder);
+    }
+
+  g_strfreev (paths);
+
+  g_application_release (G_APPLICATION (application));
+
+  return G_SOURCE_REMOVE;
+}
+
+
+
 #ifdef HAVE_GUDEV
 static gboolean
 thunar_application_update_media_fs_uuids (GUdevDevice       *device,
@@ -2368,6 +2551,7 @@ thunar_application_create_file_from_template (ThunarApplication     *application
  *                      which will be emitted when the job finishes with the
  *                      list of #GFile<!---->s created by the job, or
  *                      %NULL if you're not interested in the signal.
+ * @limits            : (nullable): the #ThunarTransferLimits of the copy.
  *
  * Copies all files from @source_file_list to their locations specified in
  * @target_file_list.
@@ -2375,21 +2559,27 @@ thunar_application_create_file_from_template (ThunarApplication     *application
  * @source_file_list and @target_file_list must be of the same length.
  **/
 void
-thunar_application_copy_to (ThunarApplication     *application,
-                            gpointer               parent,
-                            GList                 *source_file_list,
-                            GList                 *target_file_list,
-                            ThunarOperationLogMode log_mode,
-                            GClosure              *new_files_closure)
+thunar_application_copy_to (ThunarApplication          *application,
+                            gpointer                    parent,
+                            GList                      *source_file_list,
+                            GList                      *target_file_list,
+                            ThunarOperationLogMode      log_mode,
+                            GClosure                   *new_files_closure,
+                            const ThunarTransferLimits *limits)
 {
+  ThunarJob *job;
+
   _thunar_return_if_fail (g_list_length (source_file_list) == g_list_length (target_file_list));
   _thunar_return_if_fail (parent == NULL || GDK_IS_SCREEN (parent) || GTK_IS_WIDGET (parent));
   _thunar_return_if_fail (THUNAR_IS_APPLICATION (application));
 
   /* launch the operation */
-  thunar_application_launch (application, parent, "edit-copy",
-                             _("Copying files..."), thunar_io_jobs_copy_files,
-                             source_file_list, target_file_list, FALSE, TRUE, log_mode, new_files_closure);
+  job = thunar_io_jobs_copy_files (source_file_list, target_file_list);
+  if (limits != NULL)
+    thunar_application_apply_limits (job, limits);
+  thunar_application_launch_job (application, parent, "edit-copy",
+                                 _("Copying files..."), job,
+                                 source_file_list, target_file_list, FALSE, TRUE, log_mode, new_files_closure);
 }
 
 
@@ -2405,17 +2595,19 @@ thunar_application_copy_to (ThunarApplication     *application,
  *                      which will be emitted when the job finishes with the
  *                      list of #GFile<!---->s created by the job, or
  *                      %NULL if you're not interested in the signal.
+ * @limits            : (nullable): the #ThunarTransferLimits of the copy.
  *
  * Copies all files referenced by the @source_file_list to the directory
  * referenced by @target_file. This method takes care of all user interaction.
  **/
 void
-thunar_application_copy_into (ThunarApplication     *application,
-                              gpointer               parent,
-                              GList                 *source_file_list,
-                              GFile                 *target_file,
-                              ThunarOperationLogMode log_mode,
-                              GClosure              *new_files_closure)
+thunar_application_copy_into (ThunarApplication          *application,
+                              gpointer                    parent,
+                              GList                      *source_file_list,
+                              GFile                      *target_file,
+                              ThunarOperationLogMode      log_mode,
+                              GClosure                   *new_files_closure,
+                              const ThunarTransferLimits *limits)
 {
   ThunarFile *target_folder;
   GVolume    *volume = NULL;
@@ -2460,7 +2652,8 @@ thunar_application_copy_into (ThunarApplication     *application,
                                          source_file_list, target_file,
                                          FALSE, TRUE,
                                          log_mode,
-                                         new_files_closure);
+                                         new_files_closure,
+                                         limits);
 
   /* free */
   g_free (title);
@@ -2519,7 +2712,8 @@ thunar_application_link_into (ThunarApplication     *application,
                                          source_file_list, target_file,
                                          FALSE, TRUE,
                                          log_mode,
-                                         new_files_closure);
+                                         new_files_closure,
+                                         NULL);
 
   /* free the title */
   g_free (title);
@@ -2538,18 +2732,20 @@ thunar_application_link_into (ThunarApplication     *application,
  *                      which will be emitted when the job finishes with the
  *                      list of #GFile<!---->s created by the job, or
  *                      %NULL if you're not interested in the signal.
+ * @limits            : (nullable): the #ThunarTransferLimits of the move.
  *
  * Moves all files referenced by the @source_file_list to the directory
  * referenced by @target_file. This method takes care of all user
  * interaction.
  **/
 void
-thunar_application_move_into (ThunarApplication     *application,
-                              gpointer               parent,
-                              GList                 *source_file_list,
-                              GFile                 *target_file,
-                              ThunarOperationLogMode log_mode,
-                              GClosure              *new_files_closure)
+thunar_application_move_into (ThunarApplication          *application,
+                              gpointer                    parent,
+                              GList                      *source_file_list,
+                              GFile                      *target_file,
+                              ThunarOperationLogMode      log_mode,
+                              GClosure                   *new_files_closure,
+                              const ThunarTransferLimits *limits)
 {
   ThunarFile *thunar_file;
   GList      *source_thunar_file_list = NULL;
@@ -2607,7 +2803,8 @@ thunar_application_move_into (ThunarApplication     *application,
                                              source_file_list, target_file,
                                              TRUE, TRUE,
                                              log_mode,
-                                             new_files_closure);
+                                             new_files_closure,
+                                             limits);
 
       /* free the title */
       g_free (title);
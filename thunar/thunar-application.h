@@ -40,6 +40,14 @@ typedef enum
   THUNAR_APPLICATION_SELECT_FILES
 } ThunarApplicationProcessAction;
 
+/* the limits of a single transfer, launching it without limits is the
+ * same as { 0, THUNAR_IO_PRIORITY_NORMAL } */
+typedef struct
+{
+  guint64          bandwidth_limit;
+  ThunarIoPriority io_priority;
+} ThunarTransferLimits;
+
 #define THUNAR_TYPE_APPLICATION (thunar_application_get_type ())
 #define THUNAR_APPLICATION(obj) (G_TYPE_CHECK_INSTANCE_CAST ((obj), THUNAR_TYPE_APPLICATION, ThunarApplication))
 #define THUNAR_APPLICATION_CLASS(klass) (G_TYPE_CHECK_CLASS_CAST ((klass), THUNAR_TYPE_APPLICATION, ThunarApplicationClass))
@@ -123,20 +131,22 @@ thunar_application_create_file_from_template (ThunarApplication     *application
                                               ThunarOperationLogMode log_mode);
 
 void
-thunar_application_copy_to (ThunarApplication     *application,
-                            gpointer               parent,
-                            GList                 *source_file_list,
-                            GList                 *target_file_list,
-                            ThunarOperationLogMode log_mode,
-                            GClosure              *new_files_closure);
+thunar_application_copy_to (ThunarApplication          *application,
+                            gpointer                    parent,
+                            GList                      *source_file_list,
+                            GList                      *target_file_list,
+                            ThunarOperationLogMode      log_mode,
+                            GClosure                   *new_files_closure,
+                            const ThunarTransferLimits *limits);
 
 void
-thunar_application_copy_into (ThunarApplication     *application,
-                              gpointer               parent,
-                              GList                 *source_file_list,
-                              GFile                 *target_file,
-                              ThunarOperationLogMode log_mode,
-                              GClosure              *new_files_closure);
+thunar_application_copy_into (ThunarApplication          *application,
+                              gpointer                    parent,
+                              GList                      *source_file_list,
+                              GFile                      *target_file,
+                              ThunarOperationLogMode      log_mode,
+                              GClosure                   *new_files_closure,
+                              const ThunarTransferLimits *limits);
 
 void
 thunar_application_link_into (ThunarApplication     *application,
@@ -147,12 +157,13 @@ thunar_application_link_into (ThunarApplication     *application,
                               GClosure              *new_files_closure);
 
 void
-thunar_application_move_into (ThunarApplication     *application,
-                              gpointer               parent,
-                              GList                 *source_file_list,
-                              GFile                 *target_file,
-                              ThunarOperationLogMode log_mode,
-                              GClosure              *new_files_closure);
+thunar_application_move_into (ThunarApplication          *application,
+                              gpointer                    parent,
+                              GList                      *source_file_list,
+                              GFile                      *target_file,
+                              ThunarOperationLogMode      log_mode,
+                              GClosure                   *new_files_closure,
+                              const ThunarTransferLimits *limits);
 
 void
 thunar_application_move_files (ThunarApplication     *application,
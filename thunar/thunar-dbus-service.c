@@ -70,13 +70,14 @@ thunar_dbus_service_parse_uri_and_display (ThunarDBusService *dbus_service,
                                            GdkScreen        **screen_return,
                                            GError           **error);
 static gboolean
-thunar_dbus_service_transfer_files (ThunarDBusTransferMode transfer_mode,
-                                    const gchar           *working_directory,
-                                    const gchar *const    *source_filenames,
-                                    const gchar *const    *target_filenames,
-                                    const gchar           *display,
-                                    const gchar           *startup_id,
-                                    GError               **error);
+thunar_dbus_service_transfer_files (ThunarDBusTransferMode       transfer_mode,
+                                    const gchar                 *working_directory,
+                                    const gchar *const          *source_filenames,
+                                    const gchar *const          *target_filenames,
+                                    const gchar                 *display,
+                                    const gchar                 *startup_id,
+                                    const ThunarTransferLimits  *limits,
+                                    GError                     **error);
 static void
 thunar_dbus_service_trash_bin_changed (ThunarDBusService *dbus_service,
                                        ThunarFile        *trash_bin);
@@ -233,6 +234,17 @@ thunar_dbus_service_link_into (ThunarDBusFileManager *object,
                                const gchar           *startup_id,
                                ThunarDBusService     *dbus_service);
 static gboolean
+thunar_dbus_service_transfer_files_with_options (ThunarDBusFileManager *object,
+                                                 GDBusMethodInvocation *invocation,
+                                                 const gchar           *mode,
+                                                 const gchar           *working_directory,
+                                                 gchar                **source_filenames,
+                                                 gchar                **target_filenames,
+                                                 GVariant              *options,
+                                                 const gchar           *display,
+                                                 const gchar           *startup_id,
+                                                 ThunarDBusService     *dbus_service);
+static gboolean
 thunar_dbus_service_unlink_files (ThunarDBusFileManager *object,
                                   GDBusMethodInvocation *invocation,
                                   const gchar           *working_directory,
@@ -343,6 +355,7 @@ thunar_dbus_service_init (ThunarDBusService *dbus_service)
                             "handle-copy-into", thunar_dbus_service_copy_into,
                             "handle-move-into", thunar_dbus_service_move_into,
                             "handle-link-into", thunar_dbus_service_link_into,
+                            "handle-transfer-files", thunar_dbus_service_transfer_files_with_options,
                             "handle-unlink-files", thunar_dbus_service_unlink_files,
                             "handle-launch-files", thunar_dbus_service_launch_files,
                             "handle-rename-file", thunar_dbus_service_rename_file,
@@ -1157,13 +1170,14 @@ out:
 
 
 static gboolean
-thunar_dbus_service_transfer_files (ThunarDBusTransferMode transfer_mode,
-                                    const gchar           *working_directory,
-                                    const gchar *const    *source_filenames,
-                                    const gchar *const    *target_filenames,
-                                    const gchar           *display,
-                                    const gchar           *startup_id,
-                                    GError               **error)
+thunar_dbus_service_transfer_files (ThunarDBusTransferMode       transfer_mode,
+                                    const gchar                 *working_directory,
+                                    const gchar *const          *source_filenames,
+                                    const gchar *const          *target_filenames,
+                                    const gchar                 *display,
+                                    const gchar                 *startup_id,
+                                    const ThunarTransferLimits  *limits,
+                                    GError                     **error)
 {
   ThunarApplication *application;
   GdkScreen         *screen;
@@ -1256,19 +1270,19 @@ thunar_dbus_service_transfer_files (ThunarDBusTransferMode transfer_mode,
               thunar_application_copy_to (application, screen,
                                           source_file_list, target_file_list,
                                           THUNAR_OPERATION_LOG_NO_OPERATIONS,
-                                          NULL);
+                                          NULL, limits);
               break;
             case THUNAR_DBUS_TRANSFER_MODE_COPY_INTO:
               thunar_application_copy_into (application, screen,
                                             source_file_list, target_file_list->data,
                                             THUNAR_OPERATION_LOG_NO_OPERATIONS,
-                                            NULL);
+                                            NULL, limits);
               break;
             case THUNAR_DBUS_TRANSFER_MODE_MOVE_INTO:
               thunar_application_move_into (application, screen,
                                             source_file_list, target_file_list->data,
                                             THUNAR_OPERATION_LOG_NO_OPERATIONS,
-                                            NULL);
+                                            NULL, limits);
               break;
             case THUNAR_DBUS_TRANSFER_MODE_LINK_INTO:
               thunar_application_link_into (application, screen,
@@ -1317,6 +1331,7 @@ thunar_dbus_service_copy_to (ThunarDBusFileManager *object,
                                       (const gchar *const *) target_filenames,
                                       display,
                                       startup_id,
+                                      NULL,
                                       &error);
 
   if (error)
@@ -1348,6 +1363,7 @@ thunar_dbus_service_copy_into (ThunarDBusFileManager *object,
                                       target_filenames,
                                       display,
                                       startup_id,
+                                      NULL,
                                       &error);
 
   if (error)
@@ -1379,6 +1395,7 @@ thunar_dbus_service_move_into (ThunarDBusFileManager *object,
                                       target_filenames,
                                       display,
                                       startup_id,
+                                      NULL,
                                       &error);
 
   if (error)
@@ -1410,6 +1427,7 @@ thunar_dbus_service_link_into (ThunarDBusFileManager *object,
                                       target_filenames,
                                       display,
                                       startup_id,
+                                      NULL,
                                       &error);
 
   if (error)
@@ -1421,6 +1439,70 @@ thunar_dbus_service_link_into (ThunarDBusFileManager *object,
 }
 
 
+
+static gboolean
+thunar_dbus_service_transfer_files_with_options (ThunarDBusFileManager *object,
+                                                 GDBusMethodInvocation *invocation,
+                                                 const gchar           *mode,
+                                                 const gchar           *working_directory,
+                                                 gchar                **source_filenames,
+                                                 gchar                **target_filenames,
+                                                 GVariant              *options,
+                                                 const gchar           *display,
+                                                 const gchar           *startup_id,
+                                                 ThunarDBusService     *dbus_service)
+{
+  ThunarDBusTransferMode transfer_mode;
+  ThunarTransferLimits   limits = { 0, THUNAR_IO_PRIORITY_NORMAL };
+  const gchar           *io_priority_str = NULL;
+  GError                *error = NULL;
+
+  if (g_strcmp0 (mode, "copy-to") == 0)
+    transfer_mode = THUNAR_DBUS_TRANSFER_MODE_COPY_TO;
+  else if (g_strcmp0 (mode, "copy-into") == 0)
+    transfer_mode = THUNAR_DBUS_TRANSFER_MODE_COPY_INTO;
+  else if (g_strcmp0 (mode, "move-into") == 0)
+    transfer_mode = THUNAR_DBUS_TRANSFER_MODE_MOVE_INTO;
+  else
+    {
+      g_set_error (&error, G_FILE_ERROR, G_FILE_ERROR_INVAL,
+                   _("Unknown transfer mode \"%s\""), mode);
+      goto out;
+    }
+
+  /* the limits of the transfer, unknown options are ignored */
+  g_variant_lookup (options, "bandwidth-limit", "t", &limits.bandwidth_limit);
+  if (g_variant_lookup (options, "io-priority", "&s", &io_priority_str))
+    {
+      if (g_strcmp0 (io_priority_str, "idle") == 0)
+        limits.io_priority = THUNAR_IO_PRIORITY_IDLE;
+      else if (g_strcmp0 (io_priority_str, "normal") != 0)
+        {
+          g_set_error (&error, G_FILE_ERROR, G_FILE_ERROR_INVAL,
+                       _("Unknown I/O priority \"%s\""), io_priority_str);
+          goto out;
+        }
+    }
+
+  thunar_dbus_service_transfer_files (transfer_mode,
+                                      working_directory,
+                                      (const gchar *const *) source_filenames,
+                                      (const gchar *const *) target_filenames,
+                                      display,
+                                      startup_id,
+                                      &limits,
+                                      &error);
+
+out:
+  if (error)
+    g_dbus_method_invocation_take_error (invocation, error);
+  else
+    thunar_dbus_file_manager_complete_transfer_files (object, invocation);
+
+  return TRUE;
+}
+
+
 static gboolean
 thunar_dbus_service_unlink_files (ThunarDBusFileManager *object,
                                   GDBusMethodInvocation *invocation,
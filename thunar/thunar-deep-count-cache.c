@@ -0,0 +1,472 @@
+/* vi:set et ai sw=2 sts=2 ts=2: */
+/*-
+ * Copyright (c) 2026 The Xfce Development Team
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+ * Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_ERRNO_H
+#include <errno.h>
+#endif
+#ifdef HAVE_FCNTL_H
+#include <fcntl.h>
+#endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+#ifdef HAVE_SYS_STAT_H
+#include <sys/stat.h>
+#endif
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+#include "thunar/thunar-deep-count-cache.h"
+#include "thunar/thunar-private.h"
+
+
+
+/* the cache is dropped as a whole once it grows beyond this number of
+ * directories, so it cannot grow without bounds */
+#define THUNAR_DEEP_COUNT_CACHE_MAX_ENTRIES (1 << 18)
+
+
+
+typedef struct _ThunarDeepCountCacheKey    ThunarDeepCountCacheKey;
+typedef struct _ThunarDeepCountCacheWatch  ThunarDeepCountCacheWatch;
+
+
+
+static guint
+thunar_deep_count_cache_key_hash (gconstpointer key);
+static gboolean
+thunar_deep_count_cache_key_equal (gconstpointer a,
+                                   gconstpointer b);
+static void
+thunar_deep_count_cache_entry_clear (gpointer data);
+static void
+thunar_deep_count_cache_remove (ThunarDeepCountCacheEntry *entry);
+
+
+
+struct _ThunarDeepCountCacheKey
+{
+  guint64 device;
+  guint64 inode;
+};
+
+struct _ThunarDeepCountCacheWatch
+{
+  ThunarDeepCountCacheNotify func;
+  gpointer                   user_data;
+};
+
+
+
+/* directories by (device, inode) and by location, only accessed with
+ * cache_mutex held since the deep count workers share the cache */
+static GHashTable *cache_by_inode = NULL;
+static GHashTable *cache_by_file = NULL;
+static GMutex      cache_mutex;
+
+/* watches told about invalidated directories,
+ * only used in the main thread */
+static GSList *cache_watches = NULL;
+
+
+
+static guint
+thunar_deep_count_cache_key_hash (gconstpointer key)
+{
+  const ThunarDeepCountCacheKey *k = key;
+
+  return g_int64_hash (&k->inode) ^ g_int64_hash (&k->device);
+}
+
+
+
+static gboolean
+thunar_deep_count_cache_key_equal (gconstpointer a,
+                                   gconstpointer b)
+{
+  const ThunarDeepCountCacheKey *ka = a;
+  const ThunarDeepCountCacheKey *kb = b;
+
+  return ka->inode == kb->inode && ka->device == kb->device;
+}
+
+
+
+static void
+thunar_deep_count_cache_entry_clear (gpointer data)
+{
+  ThunarDeepCountCacheEntry *entry = data;
+
+  g_object_unref (entry->directory);
+  g_ptr_array_unref (entry->subdirectories);
+  g_array_unref (entry->links);
+  g_string_free (entry->file_names, TRUE);
+}
+
+
+
+static inline guint64
+thunar_deep_count_cache_stamp_add (guint64 stamp,
+                                   guint64 inode,
+                                   guint64 size,
+                                   guint64 ctime,
+                                   guint32 ctime_usec)
+{
+  /* FNV-1a over the fields */
+  stamp = (stamp ^ inode) * G_GUINT64_CONSTANT (0x100000001b3);
+  stamp = (stamp ^ size) * G_GUINT64_CONSTANT (0x100000001b3);
+  stamp = (stamp ^ ctime) * G_GUINT64_CONSTANT (0x100000001b3);
+  stamp = (stamp ^ ctime_usec) * G_GUINT64_CONSTANT (0x100000001b3);
+
+  return stamp;
+}
+
+
+
+/**
+ * thunar_deep_count_cache_entry_new:
+ * @directory : the #GFile of the directory.
+ * @device    : the device of the @directory.
+ * @inode     : the inode of the @directory.
+ * @mtime     : the modification time of the @directory in microseconds.
+ *
+ * Allocates a new, empty entry for the @directory, to be filled while
+ * the @directory is read. Only local directories can be cached, see
+ * thunar_deep_count_cache_entry_is_current().
+ *
+ * Return value: (transfer full): the new #ThunarDeepCountCacheEntry.
+ **/
+ThunarDeepCountCacheEntry *
+thunar_deep_count_cache_entry_new (GFile  *directory,
+                                   guint64 device,
+                                   guint64 inode,
+                                   guint64 mtime)
+{
+  ThunarDeepCountCacheEntry *entry;
+
+  _thunar_return_val_if_fail (G_IS_FILE (directory), NULL);
+
+  entry = g_atomic_rc_box_new0 (ThunarDeepCountCacheEntry);
+  entry->directory = g_object_ref (directory);
+  entry->device = device;
+  entry->inode = inode;
+  entry->mtime = mtime;
+  entry->subdirectories = g_ptr_array_new_with_free_func (g_free);
+  entry->links = g_array_new (FALSE, FALSE, sizeof (ThunarDeepCountCacheLink));
+  entry->file_names = g_string_new (NULL);
+  entry->files_stamp = G_GUINT64_CONSTANT (0xcbf29ce484222325);
+
+  return entry;
+}
+
+
+
+ThunarDeepCountCacheEntry *
+thunar_deep_count_cache_entry_ref (ThunarDeepCountCacheEntry *entry)
+{
+  return g_atomic_rc_box_acquire (entry);
+}
+
+
+
+void
+thunar_deep_count_cache_entry_unref (ThunarDeepCountCacheEntry *entry)
+{
+  g_atomic_rc_box_release_full (entry, thunar_deep_count_cache_entry_clear);
+}
+
+
+
+/**
+ * thunar_deep_count_cache_entry_add_file:
+ * @entry      : a #ThunarDeepCountCacheEntry being filled.
+ * @name       : the name of a file in the directory, which is not a directory.
+ * @inode      : the inode of the file.
+ * @size       : the size of the file.
+ * @ctime      : the time of the last status change of the file.
+ * @ctime_usec : the microseconds of @ctime.
+ *
+ * Remembers the state of a file of the directory, since changes of the
+ * file don't update the modification time of the directory.
+ **/
+void
+thunar_deep_count_cache_entry_add_file (ThunarDeepCountCacheEntry *entry,
+                                        const gchar               *name,
+                                        guint64                    inode,
+                                        guint64                    size,
+                                        guint64                    ctime,
+                                        guint32                    ctime_usec)
+{
+  _thunar_return_if_fail (entry != NULL);
+  _thunar_return_if_fail (name != NULL);
+
+  g_string_append_len (entry->file_names, name, strlen (name) + 1);
+  entry->files_stamp = thunar_deep_count_cache_stamp_add (entry->files_stamp, inode, size, ctime, ctime_usec);
+}
+
+
+
+/**
+ * thunar_deep_count_cache_entry_is_current:
+ * @entry : a #ThunarDeepCountCacheEntry returned by thunar_deep_count_cache_lookup().
+ *
+ * Checks the files of the directory against the state they were in when
+ * the directory was read. Writing to a file changes its size or at least
+ * its change time, but not the modification time of the directory. This
+ * only needs a stat() of each file, instead of reading the directory.
+ *
+ * Return value: %TRUE if none of the files changed since @entry was filled.
+ **/
+gboolean
+thunar_deep_count_cache_entry_is_current (ThunarDeepCountCacheEntry *entry)
+{
+  struct stat  statb;
+  const gchar *path;
+  const gchar *name;
+  const gchar *end;
+  guint64      stamp = G_GUINT64_CONSTANT (0xcbf29ce484222325);
+  gint         dir_fd;
+  gint         result;
+
+  _thunar_return_val_if_fail (entry != NULL, FALSE);
+
+  path = g_file_peek_path (entry->directory);
+  if (path == NULL)
+    return FALSE;
+
+  dir_fd = open (path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (dir_fd < 0)
+    return FALSE;
+
+  end = entry->file_names->str + entry->file_names->len;
+  for (name = entry->file_names->str; name < end; name += strlen (name) + 1)
+    {
+      result = fstatat (dir_fd, name, &statb, entry->follow_symlinks ? 0 : AT_SYMLINK_NOFOLLOW);
+
+      /* GIO reports broken symlinks themselves */
+      if (result != 0 && errno == ENOENT && entry->follow_symlinks)
+        result = fstatat (dir_fd, name, &statb, AT_SYMLINK_NOFOLLOW);
+
+      if (result != 0)
+        break;
+
+      stamp = thunar_deep_count_cache_stamp_add (stamp, statb.st_ino, statb.st_size,
+                                                 statb.st_ctim.tv_sec, statb.st_ctim.tv_nsec / 1000);
+    }
+
+  close (dir_fd);
+
+  return name >= end && stamp == entry->files_stamp;
+}
+
+
+
+/* must be called with cache_mutex held */
+static void
+thunar_deep_count_cache_remove (ThunarDeepCountCacheEntry *entry)
+{
+  ThunarDeepCountCacheKey key = { entry->device, entry->inode };
+
+  /* only drop the file mapping if it still belongs to this entry */
+  if (g_hash_table_lookup (cache_by_file, entry->directory) == entry)
+    g_hash_table_remove (cache_by_file, entry->directory);
+
+  g_hash_table_remove (cache_by_inode, &key);
+}
+
+
+
+/**
+ * thunar_deep_count_cache_lookup:
+ * @device : the device of the directory.
+ * @inode  : the inode of the directory.
+ * @mtime  : the current modification time of the directory in microseconds.
+ *
+ * Looks up what was found in the directory when it was read the last time.
+ * The result is only returned if the directory has not been modified since.
+ *
+ * Return value: (transfer full) (nullable): a #ThunarDeepCountCacheEntry or %NULL.
+ **/
+ThunarDeepCountCacheEntry *
+thunar_deep_count_cache_lookup (guint64 device,
+                                guint64 inode,
+                                guint64 mtime)
+{
+  ThunarDeepCountCacheKey    key = { device, inode };
+  ThunarDeepCountCacheEntry *entry = NULL;
+
+  g_mutex_lock (&cache_mutex);
+
+  if (cache_by_inode != NULL)
+    entry = g_hash_table_lookup (cache_by_inode, &key);
+
+  if (entry != NULL && entry->mtime == mtime)
+    thunar_deep_count_cache_entry_ref (entry);
+  else
+    entry = NULL;
+
+  g_mutex_unlock (&cache_mutex);
+
+  return entry;
+}
+
+
+
+/**
+ * thunar_deep_count_cache_insert:
+ * @entry : a completely filled #ThunarDeepCountCacheEntry.
+ *
+ * Remembers @entry for later deep counts, replacing any older entry
+ * for the same directory.
+ **/
+void
+thunar_deep_count_cache_insert (ThunarDeepCountCacheEntry *entry)
+{
+  ThunarDeepCountCacheKey   *key;
+  ThunarDeepCountCacheEntry *old_entry;
+
+  _thunar_return_if_fail (entry != NULL);
+
+  g_mutex_lock (&cache_mutex);
+
+  if (G_UNLIKELY (cache_by_inode == NULL))
+    {
+      cache_by_inode = g_hash_table_new_full (thunar_deep_count_cache_key_hash, thunar_deep_count_cache_key_equal,
+                                              g_free, (GDestroyNotify) thunar_deep_count_cache_entry_unref);
+      cache_by_file = g_hash_table_new (g_file_hash, (GEqualFunc) g_file_equal);
+    }
+
+  if (g_hash_table_size (cache_by_inode) >= THUNAR_DEEP_COUNT_CACHE_MAX_ENTRIES)
+    {
+      g_hash_table_remove_all (cache_by_file);
+      g_hash_table_remove_all (cache_by_inode);
+    }
+
+  /* drop the previous state of the directory and whatever was cached
+   * for its location before */
+  key = g_new (ThunarDeepCountCacheKey, 1);
+  key->device = entry->device;
+  key->inode = entry->inode;
+  old_entry = g_hash_table_lookup (cache_by_inode, key);
+  if (old_entry != NULL)
+    thunar_deep_count_cache_remove (old_entry);
+  old_entry = g_hash_table_lookup (cache_by_file, entry->directory);
+  if (old_entry != NULL)
+    thunar_deep_count_cache_remove (old_entry);
+
+  g_hash_table_insert (cache_by_inode, key, thunar_deep_count_cache_entry_ref (entry));
+  g_hash_table_insert (cache_by_file, entry->directory, entry);
+
+  g_mutex_unlock (&cache_mutex);
+}
+
+
+
+/**
+ * thunar_deep_count_cache_invalidate:
+ * @directory : the #GFile of a directory.
+ *
+ * Forgets what was found in @directory, to be called when a file
+ * monitor reports changes of its contents that do not necessarily
+ * update the modification time of @directory. Everybody registered
+ * with thunar_deep_count_cache_add_notify() is told about it, so the
+ * counts of the folders containing @directory can be updated.
+ *
+ * Must be called from the main thread.
+ **/
+void
+thunar_deep_count_cache_invalidate (GFile *directory)
+{
+  ThunarDeepCountCacheEntry *entry;
+
+  _thunar_return_if_fail (G_IS_FILE (directory));
+
+  g_mutex_lock (&cache_mutex);
+
+  if (cache_by_file != NULL)
+    {
+      entry = g_hash_table_lookup (cache_by_file, directory);
+      if (entry != NULL)
+        thunar_deep_count_cache_remove (entry);
+    }
+
+  g_mutex_unlock (&cache_mutex);
+
+  for (GSList *lp = cache_watches; lp != NULL;)
+    {
+      ThunarDeepCountCacheWatch *watch = lp->data;
+
+      /* the notify may remove its own watch */
+      lp = lp->next;
+      (*watch->func) (directory, watch->user_data);
+    }
+}
+
+
+
+/**
+ * thunar_deep_count_cache_add_notify:
+ * @func      : the function to call with the invalidated directory.
+ * @user_data : user data to pass to @func.
+ *
+ * Calls @func whenever thunar_deep_count_cache_invalidate() was called
+ * for a directory, until thunar_deep_count_cache_remove_notify() is
+ * called. Must be called from the main thread.
+ **/
+void
+thunar_deep_count_cache_add_notify (ThunarDeepCountCacheNotify func,
+                                    gpointer                   user_data)
+{
+  ThunarDeepCountCacheWatch *watch;
+
+  _thunar_return_if_fail (func != NULL);
+
+  watch = g_slice_new (ThunarDeepCountCacheWatch);
+  watch->func = func;
+  watch->user_data = user_data;
+  cache_watches = g_slist_prepend (cache_watches, watch);
+}
+
+
+
+/**
+ * thunar_deep_count_cache_remove_notify:
+ * @func      : the function passed to thunar_deep_count_cache_add_notify().
+ * @user_data : the user data passed to thunar_deep_count_cache_add_notify().
+ *
+ * Stops calling @func for invalidated directories.
+ **/
+void
+thunar_deep_count_cache_remove_notify (ThunarDeepCountCacheNotify func,
+                                       gpointer                   user_data)
+{
+  ThunarDeepCountCacheWatch *watch;
+
+  for (GSList *lp = cache_watches; lp != NULL; lp = lp->next)
+    {
+      watch = lp->data;
+      if (watch->func == func && watch->user_data == user_data)
+        {
+          cache_watches = g_slist_delete_link (cache_watches, lp);
+          g_slice_free (ThunarDeepCountCacheWatch, watch);
+          return;
+        }
+    }
+}
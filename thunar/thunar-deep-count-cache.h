@@ -0,0 +1,107 @@
+/* vi:set et ai sw=2 sts=2 ts=2: */
+/*-
+ * Copyright (c) 2026 The Xfce Development Team
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+ * Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef __THUNAR_DEEP_COUNT_CACHE_H__
+#define __THUNAR_DEEP_COUNT_CACHE_H__
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS;
+
+typedef struct _ThunarDeepCountCacheEntry ThunarDeepCountCacheEntry;
+typedef struct _ThunarDeepCountCacheLink  ThunarDeepCountCacheLink;
+
+typedef void (*ThunarDeepCountCacheNotify) (GFile   *directory,
+                                            gpointer user_data);
+
+/* a file with more than one hard link, its allocated size is only
+ * counted for the first link found during a deep count */
+struct _ThunarDeepCountCacheLink
+{
+  guint64 device;
+  guint64 inode;
+  guint64 size_on_disk;
+};
+
+/* what a deep count found directly inside of a directory, the entry
+ * must not be modified once it was inserted into the cache */
+struct _ThunarDeepCountCacheEntry
+{
+  /* the directory and the state it was read in */
+  GFile  *directory;
+  guint64 device;
+  guint64 inode;
+  guint64 mtime;
+
+  /* files which are not directories, the allocated size excludes the
+   * hard linked files, it is (guint64) -1 if unknown */
+  guint64 total_size;
+  guint64 total_size_on_disk;
+  guint   file_count;
+
+  /* names of the subdirectories on the same filesystem */
+  GPtrArray *subdirectories;
+
+  /* names of the other files, separated by '\0', and a hash of their
+   * inode, size and change time, which tells whether one of them changed */
+  GString *file_names;
+  guint64  files_stamp;
+  gboolean follow_symlinks;
+
+  /* array of ThunarDeepCountCacheLink */
+  GArray *links;
+};
+
+ThunarDeepCountCacheEntry *
+thunar_deep_count_cache_entry_new (GFile  *directory,
+                                   guint64 device,
+                                   guint64 inode,
+                                   guint64 mtime) G_GNUC_MALLOC;
+ThunarDeepCountCacheEntry *
+thunar_deep_count_cache_entry_ref (ThunarDeepCountCacheEntry *entry);
+void
+thunar_deep_count_cache_entry_unref (ThunarDeepCountCacheEntry *entry);
+void
+thunar_deep_count_cache_entry_add_file (ThunarDeepCountCacheEntry *entry,
+                                        const gchar               *name,
+                                        guint64                    inode,
+                                        guint64                    size,
+                                        guint64                    ctime,
+                                        guint32                    ctime_usec);
+gboolean
+thunar_deep_count_cache_entry_is_current (ThunarDeepCountCacheEntry *entry);
+
+ThunarDeepCountCacheEntry *
+thunar_deep_count_cache_lookup (guint64 device,
+                                guint64 inode,
+                                guint64 mtime);
+void
+thunar_deep_count_cache_insert (ThunarDeepCountCacheEntry *entry);
+void
+thunar_deep_count_cache_invalidate (GFile *directory);
+void
+thunar_deep_count_cache_add_notify (ThunarDeepCountCacheNotify func,
+                                    gpointer                   user_data);
+void
+thunar_deep_count_cache_remove_notify (ThunarDeepCountCacheNotify func,
+                                       gpointer                   user_data);
+
+G_END_DECLS;
+
+#endif /* !__THUNAR_DEEP_COUNT_CACHE_H__ */
@@ -19,6 +19,7 @@
  * MA  02111-1307  USA
  */
 
+#include "thunar/thunar-deep-count-cache.h"
 #include "thunar/thunar-deep-count-job.h"
 #include "thunar/thunar-job.h"
 #include "thunar/thunar-marshal.h"
@@ -40,7 +41,30 @@ enum
 
 
 #define DEEP_COUNT_FILE_INFO_NAMESPACE \
-  G_FILE_ATTRIBUTE_STANDARD_TYPE "," G_FILE_ATTRIBUTE_STANDARD_SIZE "," G_FILE_ATTRIBUTE_STANDARD_ALLOCATED_SIZE "," G_FILE_ATTRIBUTE_ID_FILESYSTEM
+  G_FILE_ATTRIBUTE_STANDARD_TYPE "," G_FILE_ATTRIBUTE_STANDARD_SIZE "," G_FILE_ATTRIBUTE_STANDARD_ALLOCATED_SIZE "," G_FILE_ATTRIBUTE_ID_FILESYSTEM "," \
+  G_FILE_ATTRIBUTE_UNIX_NLINK "," G_FILE_ATTRIBUTE_UNIX_DEVICE "," G_FILE_ATTRIBUTE_UNIX_INODE "," \
+  G_FILE_ATTRIBUTE_TIME_MODIFIED "," G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC "," G_FILE_ATTRIBUTE_TIME_CHANGED "," G_FILE_ATTRIBUTE_TIME_CHANGED_USEC
+
+/* upper limit for the default number of threads walking the directories */
+#define DEEP_COUNT_MAX_THREADS 8
+
+/* number of independently locked parts of the inode set */
+#define DEEP_COUNT_INODE_SHARDS 16
+
+/* directories modified less than this many microseconds ago are not
+ * cached, they could still be changing within the same mtime */
+#define DEEP_COUNT_CACHE_MIN_AGE (2 * G_USEC_PER_SEC)
+
+
+
+typedef struct _ThunarDeepCountCounters ThunarDeepCountCounters;
+typedef struct _ThunarDeepCountDir      ThunarDeepCountDir;
+typedef struct _ThunarDeepCountInode    ThunarDeepCountInode;
+typedef struct _ThunarDeepCountInodes   ThunarDeepCountInodes;
+typedef struct _ThunarDeepCountWalk     ThunarDeepCountWalk;
+typedef struct _ThunarDeepCountWorker   ThunarDeepCountWorker;
+
+
 
 static void
 thunar_deep_count_job_finalize (GObject *object);
@@ -70,8 +94,8 @@ struct _ThunarDeepCountJob
   GList              *files;
   GFileQueryInfoFlags query_flags;
 
-  /* the time of the last "status-update" emission */
-  gint64 last_time;
+  /* number of threads walking the directories, 0 for automatic */
+  guint max_threads;
 
   /* status information */
   guint64 total_size;
@@ -83,6 +107,88 @@ struct _ThunarDeepCountJob
 
 
 
+struct _ThunarDeepCountCounters
+{
+  guint64 total_size;
+  guint64 total_size_on_disk;
+  guint   file_count;
+  guint   directory_count;
+  guint   unreadable_directory_count;
+};
+
+/* identifies a file with more than one hard link */
+struct _ThunarDeepCountInode
+{
+  guint64 device;
+  guint64 inode;
+};
+
+/* open addressing set of inodes, (0, 0) marks a free slot */
+struct _ThunarDeepCountInodes
+{
+  GMutex                lock;
+  ThunarDeepCountInode *slots;
+  gsize                 n_slots;
+  gsize                 n_used;
+};
+
+/* a directory waiting to be read */
+struct _ThunarDeepCountDir
+{
+  GFile       *file;
+  GFileInfo   *info;
+  const gchar *toplevel_fs_id;
+  gboolean     toplevel;
+};
+
+struct _ThunarDeepCountWorker
+{
+  /* protects the queue and the published counters */
+  GMutex lock;
+
+  /* directories queued by this worker, others steal from the tail */
+  GQueue queue;
+
+  /* only touched by the worker thread itself */
+  ThunarDeepCountCounters counters;
+
+  /* snapshot of the counters, merged for status updates */
+  ThunarDeepCountCounters published;
+};
+
+/* state shared by the workers during one execution of the job */
+struct _ThunarDeepCountWalk
+{
+  ThunarDeepCountJob *job;
+
+  ThunarDeepCountWorker *workers;
+  guint                  n_workers;
+
+  /* number of directories queued or being read, atomic */
+  gint n_pending;
+
+  /* number of workers waiting for new directories, atomic */
+  gint n_idle;
+
+  /* idle workers and the job thread wait for changes here */
+  GMutex lock;
+  GCond  cond;
+
+  /* error for an unreadable job file, protected by lock */
+  GError *error;
+
+  /* counters of the job files which are not directories */
+  ThunarDeepCountCounters counters;
+
+  /* hard linked files seen so far, their allocated size is only counted once */
+  ThunarDeepCountInodes inodes[DEEP_COUNT_INODE_SHARDS];
+
+  /* filesystem ids of the job files */
+  GSList *fs_ids;
+};
+
+
+
 static guint deep_count_signals[LAST_SIGNAL];
 
 
@@ -106,8 +212,10 @@ thunar_deep_count_job_class_init (ThunarDeepCountJobClass *klass)
   /**
    * ThunarDeepCountJob::status-update:
    * @job                        : a #ThunarJob.
-   * @total_size                 : the total size in bytes.
-   * @total_size_on_disk         : the total allocated size in bytes.
+   * @total_size                 : the total size in bytes, hard linked
+   *                                files are counted once per link.
+   * @total_size_on_disk         : the total allocated size in bytes, hard
+   *                                linked files are counted only once.
    * @file_count                 : the number of files.
    * @directory_count            : the number of directories.
    * @unreadable_directory_count : the number of unreadable directories.
@@ -170,177 +278,547 @@ thunar_deep_count_job_status_update (ThunarDeepCountJob *job)
 
 
 static gboolean
-thunar_deep_count_job_process (ThunarJob   *job,
-                               GFile       *file,
-                               GFileInfo   *file_info,
-                               const gchar *toplevel_fs_id,
-                               GError     **error)
+thunar_deep_count_walk_add_inode (ThunarDeepCountWalk *walk,
+                                  guint64              device,
+                                  guint64              inode)
 {
-  ThunarDeepCountJob *count_job = THUNAR_DEEP_COUNT_JOB (job);
-  GFileEnumerator    *enumerator;
-  GFileInfo          *child_info;
-  GFileInfo          *info;
-  gboolean            success = TRUE;
-  GFile              *child;
-  gint64              real_time;
-  const gchar        *fs_id;
-  gboolean            toplevel_file = (toplevel_fs_id == NULL);
+  ThunarDeepCountInodes *inodes;
+  ThunarDeepCountInode  *slots;
+  gboolean               added = TRUE;
+  guint64                hash;
+  gsize                  n_slots;
+  gsize                  n, i;
 
-  _thunar_return_val_if_fail (THUNAR_IS_JOB (job), FALSE);
-  _thunar_return_val_if_fail (G_IS_FILE (file), FALSE);
-  _thunar_return_val_if_fail (file_info == NULL || G_IS_FILE_INFO (file_info), FALSE);
-  _thunar_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+  /* (0, 0) is used for free slots, don't try to track such a file */
+  if (G_UNLIKELY (device == 0 && inode == 0))
+    return TRUE;
 
-  /* abort if job was already cancelled */
-  if (thunar_job_is_cancelled (job))
-    return FALSE;
+  /* the high bits select the shard, the low bits the slot */
+  hash = (inode * G_GUINT64_CONSTANT (0x9e3779b97f4a7c15)) ^ device;
+  inodes = &walk->inodes[(hash >> 56) % DEEP_COUNT_INODE_SHARDS];
+
+  g_mutex_lock (&inodes->lock);
+
+  /* keep the load below one half, so probe sequences remain short */
+  if (inodes->n_used * 2 >= inodes->n_slots)
+    {
+      n_slots = MAX (inodes->n_slots * 2, 256);
+      slots = g_new0 (ThunarDeepCountInode, n_slots);
+      for (n = 0; n < inodes->n_slots; n++)
+        {
+          if (inodes->slots[n].device == 0 && inodes->slots[n].inode == 0)
+            continue;
+
+          i = ((inodes->slots[n].inode * G_GUINT64_CONSTANT (0x9e3779b97f4a7c15)) ^ inodes->slots[n].device) & (n_slots - 1);
+          while (slots[i].device != 0 || slots[i].inode != 0)
+            i = (i + 1) & (n_slots - 1);
+          slots[i] = inodes->slots[n];
+        }
+
+      g_free (inodes->slots);
+      inodes->slots = slots;
+      inodes->n_slots = n_slots;
+    }
+
+  for (i = hash & (inodes->n_slots - 1);; i = (i + 1) & (inodes->n_slots - 1))
+    {
+      if (inodes->slots[i].device == 0 && inodes->slots[i].inode == 0)
+        {
+          inodes->slots[i].device = device;
+          inodes->slots[i].inode = inode;
+          inodes->n_used++;
+          break;
+        }
 
-  if (file_info != NULL)
+      if (inodes->slots[i].device == device && inodes->slots[i].inode == inode)
+        {
+          added = FALSE;
+          break;
+        }
+    }
+
+  g_mutex_unlock (&inodes->lock);
+
+  return added;
+}
+
+
+
+static void
+thunar_deep_count_counters_add_size_on_disk (guint64 *total_size_on_disk,
+                                             guint64  size_on_disk)
+{
+  if (*total_size_on_disk != (guint64) -1)
+    {
+      if (size_on_disk != (guint64) -1)
+        *total_size_on_disk += size_on_disk;
+      else
+        *total_size_on_disk = (guint64) -1;
+    }
+}
+
+
+
+static void
+thunar_deep_count_walk_add_link (ThunarDeepCountWalk            *walk,
+                                 ThunarDeepCountCounters        *counters,
+                                 const ThunarDeepCountCacheLink *link)
+{
+  /* other links to the same file were counted already, they don't take
+   * up any additional space on the disk */
+  if (thunar_deep_count_walk_add_inode (walk, link->device, link->inode))
+    thunar_deep_count_counters_add_size_on_disk (&counters->total_size_on_disk, link->size_on_disk);
+}
+
+
+
+static void
+thunar_deep_count_walk_add_file (ThunarDeepCountWalk       *walk,
+                                 ThunarDeepCountCounters   *counters,
+                                 ThunarDeepCountCacheEntry *entry,
+                                 GFileInfo                 *info)
+{
+  ThunarDeepCountCacheLink link;
+  guint64                  size;
+  guint64                  size_on_disk = (guint64) -1;
+
+  size = g_file_info_get_attribute_uint64 (info, G_FILE_ATTRIBUTE_STANDARD_SIZE);
+  if (g_file_info_has_attribute (info, G_FILE_ATTRIBUTE_STANDARD_ALLOCATED_SIZE))
+    size_on_disk = g_file_info_get_attribute_uint64 (info, G_FILE_ATTRIBUTE_STANDARD_ALLOCATED_SIZE);
+
+  /* we have a regular file or at least not a directory */
+  counters->file_count++;
+
+  /* add size of the file to the total size */
+  counters->total_size += size;
+
+  if (entry != NULL)
+    {
+      entry->file_count++;
+      entry->total_size += size;
+      thunar_deep_count_cache_entry_add_file (entry, g_file_info_get_name (info),
+                                              g_file_info_get_attribute_uint64 (info, G_FILE_ATTRIBUTE_UNIX_INODE), size,
+                                              g_file_info_get_attribute_uint64 (info, G_FILE_ATTRIBUTE_TIME_CHANGED),
+                                              g_file_info_get_attribute_uint32 (info, G_FILE_ATTRIBUTE_TIME_CHANGED_USEC));
+    }
+
+  if (g_file_info_get_attribute_uint32 (info, G_FILE_ATTRIBUTE_UNIX_NLINK) > 1)
     {
-      /* use the enumerator info */
-      info = g_object_ref (file_info);
+      link.device = g_file_info_get_attribute_uint32 (info, G_FILE_ATTRIBUTE_UNIX_DEVICE);
+      link.inode = g_file_info_get_attribute_uint64 (info, G_FILE_ATTRIBUTE_UNIX_INODE);
+      link.size_on_disk = size_on_disk;
+      thunar_deep_count_walk_add_link (walk, counters, &link);
+
+      if (entry != NULL)
+        g_array_append_val (entry->links, link);
     }
   else
     {
-      /* query size and type of the current file */
-      info = g_file_query_info (file,
-                                DEEP_COUNT_FILE_INFO_NAMESPACE,
-                                count_job->query_flags,
-                                thunar_job_get_cancellable (job),
-                                error);
+      /* add allocated size of the file to the total allocated size */
+      thunar_deep_count_counters_add_size_on_disk (&counters->total_size_on_disk, size_on_disk);
+
+      if (entry != NULL)
+        thunar_deep_count_counters_add_size_on_disk (&entry->total_size_on_disk, size_on_disk);
     }
+}
 
-  /* abort on invalid info or cancellation */
-  if (info == NULL)
-    return FALSE;
 
-  /* abort on cancellation */
-  if (thunar_job_is_cancelled (job))
+
+static void
+thunar_deep_count_counters_merge (ThunarDeepCountJob            *job,
+                                  const ThunarDeepCountCounters *counters)
+{
+  job->total_size += counters->total_size;
+  job->file_count += counters->file_count;
+  job->directory_count += counters->directory_count;
+  job->unreadable_directory_count += counters->unreadable_directory_count;
+  thunar_deep_count_counters_add_size_on_disk (&job->total_size_on_disk, counters->total_size_on_disk);
+}
+
+
+
+static void
+thunar_deep_count_walk_sum (ThunarDeepCountWalk *walk)
+{
+  ThunarDeepCountJob *job = walk->job;
+  guint               n;
+
+  /* start from what the job thread counted itself */
+  job->total_size = 0;
+  job->total_size_on_disk = 0;
+  job->file_count = 0;
+  job->directory_count = 0;
+  job->unreadable_directory_count = 0;
+  thunar_deep_count_counters_merge (job, &walk->counters);
+
+  /* add the last snapshots published by the workers */
+  for (n = 0; n < walk->n_workers; n++)
     {
-      g_object_unref (info);
-      return FALSE;
+      g_mutex_lock (&walk->workers[n].lock);
+      thunar_deep_count_counters_merge (job, &walk->workers[n].published);
+      g_mutex_unlock (&walk->workers[n].lock);
     }
+}
+
+
+
+static void
+thunar_deep_count_walk_push (ThunarDeepCountWalk   *walk,
+                             ThunarDeepCountWorker *worker,
+                             GFile                 *directory,
+                             GFileInfo             *info,
+                             const gchar           *toplevel_fs_id,
+                             gboolean               toplevel)
+{
+  ThunarDeepCountDir *dir;
+
+  dir = g_slice_new (ThunarDeepCountDir);
+  dir->file = g_object_ref (directory);
+  dir->info = (info != NULL) ? g_object_ref (info) : NULL;
+  dir->toplevel_fs_id = toplevel_fs_id;
+  dir->toplevel = toplevel;
+
+  /* account for the directory before anyone can take it */
+  g_atomic_int_inc (&walk->n_pending);
+
+  g_mutex_lock (&worker->lock);
+  g_queue_push_head (&worker->queue, dir);
+  g_mutex_unlock (&worker->lock);
+}
 
-  /* only check files on the same filesystem so no remote mounts or
-   * dummy filesystems are counted */
-  fs_id = g_file_info_get_attribute_string (info, G_FILE_ATTRIBUTE_ID_FILESYSTEM);
-  if (fs_id == NULL)
-    fs_id = "";
 
-  if (toplevel_fs_id == NULL)
+
+static void
+thunar_deep_count_dir_free (gpointer data)
+{
+  ThunarDeepCountDir *dir = data;
+
+  g_object_unref (dir->file);
+  if (dir->info != NULL)
+    g_object_unref (dir->info);
+  g_slice_free (ThunarDeepCountDir, dir);
+}
+
+
+
+static ThunarDeepCountDir *
+thunar_deep_count_walk_pop (ThunarDeepCountWalk   *walk,
+                            ThunarDeepCountWorker *worker)
+{
+  ThunarDeepCountWorker *victim;
+  ThunarDeepCountDir    *dir;
+  guint                  self = worker - walk->workers;
+  guint                  n;
+
+  /* work depth-first on the own queue, that keeps the queues short */
+  g_mutex_lock (&worker->lock);
+  dir = g_queue_pop_head (&worker->queue);
+  g_mutex_unlock (&worker->lock);
+
+  /* otherwise steal from the other end of another worker's queue, where
+   * the directories closest to the toplevel (and so the largest subtrees
+   * to be expected) are */
+  for (n = 1; dir == NULL && n < walk->n_workers; n++)
     {
-      /* first toplevel, so use this id */
-      toplevel_fs_id = fs_id;
+      victim = &walk->workers[(self + n) % walk->n_workers];
+      g_mutex_lock (&victim->lock);
+      dir = g_queue_pop_tail (&victim->queue);
+      g_mutex_unlock (&victim->lock);
     }
-  else if (strcmp (fs_id, toplevel_fs_id) != 0)
+
+  return dir;
+}
+
+
+
+static void
+thunar_deep_count_walk_cached (ThunarDeepCountWalk       *walk,
+                               ThunarDeepCountWorker     *worker,
+                               ThunarDeepCountDir        *dir,
+                               ThunarDeepCountCacheEntry *entry)
+{
+  ThunarDeepCountCounters *counters = &worker->counters;
+  GFile                   *child;
+  guint                    n;
+
+  /* the directory did not change since it was read the last time */
+  counters->directory_count++;
+  counters->file_count += entry->file_count;
+  counters->total_size += entry->total_size;
+  thunar_deep_count_counters_add_size_on_disk (&counters->total_size_on_disk, entry->total_size_on_disk);
+
+  for (n = 0; n < entry->links->len; n++)
+    thunar_deep_count_walk_add_link (walk, counters, &g_array_index (entry->links, ThunarDeepCountCacheLink, n));
+
+  /* the subdirectories still need to be checked */
+  for (n = 0; n < entry->subdirectories->len; n++)
     {
-      /* release the file info */
-      g_object_unref (info);
+      child = g_file_get_child (dir->file, g_ptr_array_index (entry->subdirectories, n));
+      thunar_deep_count_walk_push (walk, worker, child, NULL, dir->toplevel_fs_id, FALSE);
+      g_object_unref (child);
+    }
+}
 
-      /* other filesystem, continue */
-      return TRUE;
+
+
+static void
+thunar_deep_count_walk_directory (ThunarDeepCountWalk   *walk,
+                                  ThunarDeepCountWorker *worker,
+                                  ThunarDeepCountDir    *dir)
+{
+  ThunarJob                 *job = THUNAR_JOB (walk->job);
+  ThunarDeepCountCacheEntry *entry = NULL;
+  GFileEnumerator           *enumerator = NULL;
+  GFileInfo                 *child_info;
+  GFile                     *child;
+  const gchar               *fs_id;
+  GError                    *error = NULL;
+  gboolean                   pushed = FALSE;
+  gboolean                   follow_symlinks;
+  guint64                    device;
+  guint64                    inode;
+  guint64                    mtime;
+
+  /* directories taken from the cache are not known to exist anymore,
+   * nor to be on the same filesystem (something could be mounted there) */
+  if (dir->info == NULL)
+    {
+      dir->info = g_file_query_info (dir->file, DEEP_COUNT_FILE_INFO_NAMESPACE, walk->job->query_flags,
+                                     thunar_job_get_cancellable (job), &error);
+      if (dir->info != NULL)
+        {
+          fs_id = g_file_info_get_attribute_string (dir->info, G_FILE_ATTRIBUTE_ID_FILESYSTEM);
+          if (g_file_info_get_file_type (dir->info) != G_FILE_TYPE_DIRECTORY
+              || g_strcmp0 (fs_id != NULL ? fs_id : "", dir->toplevel_fs_id) != 0)
+            return;
+        }
     }
 
-  /* recurse if we have a directory */
-  if (g_file_info_get_file_type (info) == G_FILE_TYPE_DIRECTORY)
+  if (dir->info != NULL)
     {
+      device = g_file_info_get_attribute_uint32 (dir->info, G_FILE_ATTRIBUTE_UNIX_DEVICE);
+      inode = g_file_info_get_attribute_uint64 (dir->info, G_FILE_ATTRIBUTE_UNIX_INODE);
+      mtime = g_file_info_get_attribute_uint64 (dir->info, G_FILE_ATTRIBUTE_TIME_MODIFIED) * G_USEC_PER_SEC
+              + g_file_info_get_attribute_uint32 (dir->info, G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC);
+
+      /* files without an inode number can not be identified reliably,
+       * and only local files can be checked for changes cheaply */
+      if (inode != 0 && g_file_peek_path (dir->file) != NULL)
+        {
+          follow_symlinks = (walk->job->query_flags & G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS) == 0;
+
+          /* the modification time of the directory only covers the names,
+           * so check the files themselves as well */
+          entry = thunar_deep_count_cache_lookup (device, inode, mtime);
+          if (entry != NULL && entry->follow_symlinks == follow_symlinks && thunar_deep_count_cache_entry_is_current (entry))
+            {
+              thunar_deep_count_walk_cached (walk, worker, dir, entry);
+              pushed = entry->subdirectories->len > 0;
+              g_clear_pointer (&entry, thunar_deep_count_cache_entry_unref);
+              goto wake_up;
+            }
+          g_clear_pointer (&entry, thunar_deep_count_cache_entry_unref);
+
+          /* remember the contents, unless the directory is still being modified */
+          if ((gint64) mtime < g_get_real_time () - DEEP_COUNT_CACHE_MIN_AGE)
+            {
+              entry = thunar_deep_count_cache_entry_new (dir->file, device, inode, mtime);
+              entry->follow_symlinks = follow_symlinks;
+            }
+        }
+
       /* try to read from the directory */
-      enumerator = g_file_enumerate_children (file,
+      enumerator = g_file_enumerate_children (dir->file,
                                               DEEP_COUNT_FILE_INFO_NAMESPACE "," G_FILE_ATTRIBUTE_STANDARD_NAME,
-                                              count_job->query_flags,
+                                              walk->job->query_flags,
                                               thunar_job_get_cancellable (job),
-                                              error);
+                                              &error);
+    }
+
+  if (thunar_job_is_cancelled (job))
+    {
+      g_clear_error (&error);
+      goto out;
+    }
+
+  if (enumerator == NULL)
+    {
+      /* directory was unreadable */
+      worker->counters.unreadable_directory_count++;
+
+      /* we only bail out if the job file is unreadable, ignore
+       * errors from files other than the job file */
+      if (dir->toplevel && g_list_length (walk->job->files) < 2)
+        {
+          g_mutex_lock (&walk->lock);
+          if (walk->error == NULL)
+            walk->error = g_steal_pointer (&error);
+          g_mutex_unlock (&walk->lock);
+        }
+
+      g_clear_error (&error);
+      goto out;
+    }
+
+  /* directory was readable */
+  worker->counters.directory_count++;
+
+  while (!thunar_job_is_cancelled (job))
+    {
+      /* query next child info, abort on invalid child info (iteration ends) */
+      child_info = g_file_enumerator_next_file (enumerator, thunar_job_get_cancellable (job), &error);
+      if (child_info == NULL)
+        break;
 
-      if (!thunar_job_is_cancelled (job))
+      /* only check files on the same filesystem so no remote mounts or
+       * dummy filesystems are counted */
+      fs_id = g_file_info_get_attribute_string (child_info, G_FILE_ATTRIBUTE_ID_FILESYSTEM);
+      if (g_strcmp0 (fs_id != NULL ? fs_id : "", dir->toplevel_fs_id) == 0)
         {
-          if (enumerator == NULL)
+          if (g_file_info_get_file_type (child_info) == G_FILE_TYPE_DIRECTORY)
             {
-              /* directory was unreadable */
-              count_job->unreadable_directory_count++;
-
-              if (toplevel_file
-                  && g_list_length (count_job->files) < 2)
-                {
-                  /* we only bail out if the job file is unreadable */
-                  success = FALSE;
-                }
-              else
-                {
-                  /* ignore errors from files other than the job file */
-                  g_clear_error (error);
-                }
+              /* queue the subdirectory, it is counted once it is read */
+              child = g_file_resolve_relative_path (dir->file, g_file_info_get_name (child_info));
+              thunar_deep_count_walk_push (walk, worker, child, child_info, dir->toplevel_fs_id, FALSE);
+              g_object_unref (child);
+              pushed = TRUE;
+
+              if (entry != NULL)
+                g_ptr_array_add (entry->subdirectories, g_strdup (g_file_info_get_name (child_info)));
             }
           else
             {
-              /* directory was readable */
-              count_job->directory_count++;
-
-              while (!thunar_job_is_cancelled (job))
-                {
-                  /* query next child info */
-                  child_info = g_file_enumerator_next_file (enumerator,
-                                                            thunar_job_get_cancellable (job),
-                                                            error);
-
-                  /* abort on invalid child info (iteration ends) or cancellation */
-                  if (child_info == NULL)
-                    break;
-
-                  if (!thunar_job_is_cancelled (job))
-                    {
-                      /* generate a GFile for the child */
-                      child = g_file_resolve_relative_path (file, g_file_info_get_name (child_info));
-
-                      /* recurse unless the job was cancelled before */
-                      thunar_deep_count_job_process (job, child, child_info, toplevel_fs_id, error);
-
-                      /* free resources */
-                      g_object_unref (child);
-                    }
-
-                  g_object_unref (child_info);
-                }
+              thunar_deep_count_walk_add_file (walk, &worker->counters, entry, child_info);
             }
         }
 
-      /* destroy the enumerator */
-      if (enumerator != NULL)
-        g_object_unref (enumerator);
+      g_object_unref (child_info);
+    }
 
-      /* emit status update whenever we've finished a directory,
-       * but not more than four times per second */
-      real_time = g_get_real_time ();
-      if (real_time >= count_job->last_time)
-        {
-          if (count_job->last_time != 0)
-            thunar_deep_count_job_status_update (count_job);
-          count_job->last_time = real_time + (G_USEC_PER_SEC / 4);
-        }
+  /* only cache complete listings */
+  if (entry != NULL && error == NULL && !thunar_job_is_cancelled (job))
+    thunar_deep_count_cache_insert (entry);
+
+  g_clear_error (&error);
+
+wake_up:
+  /* wake up idle workers, so they can steal the new directories */
+  if (pushed && g_atomic_int_get (&walk->n_idle) > 0)
+    {
+      g_mutex_lock (&walk->lock);
+      g_cond_broadcast (&walk->cond);
+      g_mutex_unlock (&walk->lock);
     }
-  else
+
+out:
+  if (enumerator != NULL)
+    g_object_unref (enumerator);
+  if (entry != NULL)
+    thunar_deep_count_cache_entry_unref (entry);
+}
+
+
+
+static void
+thunar_deep_count_worker_run (gpointer data,
+                              gpointer user_data)
+{
+  ThunarDeepCountWorker *worker = data;
+  ThunarDeepCountWalk   *walk = user_data;
+  ThunarDeepCountDir    *dir;
+
+  while (!thunar_job_is_cancelled (THUNAR_JOB (walk->job)))
     {
-      /* we have a regular file or at least not a directory */
-      count_job->file_count++;
+      dir = thunar_deep_count_walk_pop (walk, worker);
+      if (dir == NULL)
+        {
+          /* nothing left to steal and nobody is reading a directory
+           * which could queue more, so we are done */
+          if (g_atomic_int_get (&walk->n_pending) == 0)
+            break;
+
+          /* wait until other workers queued new directories, the timeout
+           * only guards against missing a wake-up */
+          g_atomic_int_inc (&walk->n_idle);
+          g_mutex_lock (&walk->lock);
+          if (g_atomic_int_get (&walk->n_pending) > 0)
+            g_cond_wait_until (&walk->cond, &walk->lock, g_get_monotonic_time () + 10 * G_TIME_SPAN_MILLISECOND);
+          g_mutex_unlock (&walk->lock);
+          g_atomic_int_add (&walk->n_idle, -1);
+          continue;
+        }
 
-      /* add size of the file to the total size */
-      count_job->total_size += g_file_info_get_attribute_uint64 (info, G_FILE_ATTRIBUTE_STANDARD_SIZE);
+      thunar_deep_count_walk_directory (walk, worker, dir);
+      thunar_deep_count_dir_free (dir);
 
-      /* add allocated size of the file to the total allocated size */
-      if (count_job->total_size_on_disk != (guint64) -1)
+      /* publish the counters for the next status update */
+      g_mutex_lock (&worker->lock);
+      worker->published = worker->counters;
+      g_mutex_unlock (&worker->lock);
+
+      /* the last directory was processed, wake up everyone waiting */
+      if (g_atomic_int_dec_and_test (&walk->n_pending))
         {
-          if (g_file_info_has_attribute (info, G_FILE_ATTRIBUTE_STANDARD_ALLOCATED_SIZE))
-            count_job->total_size_on_disk += g_file_info_get_attribute_uint64 (info, G_FILE_ATTRIBUTE_STANDARD_ALLOCATED_SIZE);
-          else
-            count_job->total_size_on_disk = (guint64) -1;
+          g_mutex_lock (&walk->lock);
+          g_cond_broadcast (&walk->cond);
+          g_mutex_unlock (&walk->lock);
         }
     }
+}
+
+
+
+static gboolean
+thunar_deep_count_job_process (ThunarDeepCountJob  *count_job,
+                               ThunarDeepCountWalk *walk,
+                               GFile               *file,
+                               guint                n,
+                               GError             **error)
+{
+  ThunarJob   *job = THUNAR_JOB (count_job);
+  GFileInfo   *info;
+  const gchar *fs_id;
+  gchar       *toplevel_fs_id;
+
+  _thunar_return_val_if_fail (G_IS_FILE (file), FALSE);
+  _thunar_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+  /* query size and type of the job file */
+  info = g_file_query_info (file,
+                            DEEP_COUNT_FILE_INFO_NAMESPACE,
+                            count_job->query_flags,
+                            thunar_job_get_cancellable (job),
+                            error);
+
+  /* abort on invalid info or cancellation */
+  if (info == NULL)
+    return FALSE;
+
+  if (thunar_job_is_cancelled (job))
+    {
+      g_object_unref (info);
+      return FALSE;
+    }
+
+  if (g_file_info_get_file_type (info) == G_FILE_TYPE_DIRECTORY)
+    {
+      /* the filesystem of the job file, children on other filesystems
+       * are not counted */
+      fs_id = g_file_info_get_attribute_string (info, G_FILE_ATTRIBUTE_ID_FILESYSTEM);
+      toplevel_fs_id = g_strdup (fs_id != NULL ? fs_id : "");
+      walk->fs_ids = g_slist_prepend (walk->fs_ids, toplevel_fs_id);
+
+      /* spread the job files over the workers, the rest is balanced by stealing */
+      thunar_deep_count_walk_push (walk, &walk->workers[n % walk->n_workers], file, info, toplevel_fs_id, TRUE);
+    }
+  else
+    {
+      thunar_deep_count_walk_add_file (walk, &walk->counters, NULL, info);
+    }
 
-  /* destroy the file info */
   g_object_unref (info);
 
-  /* we've succeeded if there was no error when loading information
-   * about the job file itself and the job was not cancelled */
-  return !thunar_job_is_cancelled (job) && success;
+  return TRUE;
 }
 
 
@@ -350,10 +828,14 @@ thunar_deep_count_job_execute (ThunarJob *job,
                                GError   **error)
 {
   ThunarDeepCountJob *count_job = THUNAR_DEEP_COUNT_JOB (job);
+  ThunarDeepCountWalk walk = { 0 };
+  GThreadPool        *pool;
   gboolean            success = TRUE;
   GError             *err = NULL;
   GList              *lp;
   GFile              *gfile;
+  gint64              next_update;
+  guint               n;
 
   _thunar_return_val_if_fail (THUNAR_IS_JOB (job), FALSE);
   _thunar_return_val_if_fail (error == NULL || *error == NULL, FALSE);
@@ -368,17 +850,67 @@ thunar_deep_count_job_execute (ThunarJob *job,
   count_job->file_count = 0;
   count_job->directory_count = 0;
   count_job->unreadable_directory_count = 0;
-  count_job->last_time = 0;
 
-  /* count files, directories and compute size of the job files */
-  for (lp = count_job->files; lp != NULL; lp = lp->next)
+  walk.job = count_job;
+  walk.n_workers = count_job->max_threads;
+  if (walk.n_workers == 0)
+    walk.n_workers = CLAMP (g_get_num_processors (), 1, DEEP_COUNT_MAX_THREADS);
+  walk.workers = g_new0 (ThunarDeepCountWorker, walk.n_workers);
+  g_mutex_init (&walk.lock);
+  g_cond_init (&walk.cond);
+  for (n = 0; n < walk.n_workers; n++)
+    g_mutex_init (&walk.workers[n].lock);
+  for (n = 0; n < DEEP_COUNT_INODE_SHARDS; n++)
+    g_mutex_init (&walk.inodes[n].lock);
+
+  /* count the job files and queue the directories among them */
+  for (lp = count_job->files, n = 0; lp != NULL; lp = lp->next, n++)
     {
       gfile = thunar_file_get_file (THUNAR_FILE (lp->data));
-      success = thunar_deep_count_job_process (job, gfile, NULL, NULL, &err);
+      success = thunar_deep_count_job_process (count_job, &walk, gfile, n, &err);
       if (G_UNLIKELY (!success))
         break;
     }
 
+  if (success && g_atomic_int_get (&walk.n_pending) > 0)
+    {
+      /* the workers run on shared threads, so short jobs don't pay for
+       * spawning threads each time */
+      pool = g_thread_pool_new (thunar_deep_count_worker_run, &walk, walk.n_workers, FALSE, NULL);
+      for (n = 0; n < walk.n_workers; n++)
+        g_thread_pool_push (pool, &walk.workers[n], NULL);
+
+      /* emit status updates while the workers are busy, but not more
+       * than four times per second */
+      next_update = g_get_monotonic_time () + (G_USEC_PER_SEC / 4);
+      g_mutex_lock (&walk.lock);
+      while (g_atomic_int_get (&walk.n_pending) > 0 && !thunar_job_is_cancelled (job))
+        {
+          g_cond_wait_until (&walk.cond, &walk.lock, next_update);
+          if (g_get_monotonic_time () >= next_update)
+            {
+              g_mutex_unlock (&walk.lock);
+              thunar_deep_count_walk_sum (&walk);
+              thunar_deep_count_job_status_update (count_job);
+              next_update = g_get_monotonic_time () + (G_USEC_PER_SEC / 4);
+              g_mutex_lock (&walk.lock);
+            }
+        }
+      g_mutex_unlock (&walk.lock);
+
+      /* wait for the workers to return */
+      g_thread_pool_free (pool, FALSE, TRUE);
+
+      if (walk.error != NULL)
+        {
+          err = g_steal_pointer (&walk.error);
+          success = FALSE;
+        }
+    }
+
+  if (thunar_job_is_cancelled (job))
+    success = FALSE;
+
   if (!success)
     {
       g_assert (err != NULL || thunar_job_is_cancelled (job));
@@ -396,12 +928,30 @@ thunar_deep_count_job_execute (ThunarJob *job,
             g_propagate_error (error, err);
         }
     }
-  else if (!thunar_job_is_cancelled (job))
+  else
     {
       /* emit final status update at the very end of the computation */
+      thunar_deep_count_walk_sum (&walk);
       thunar_deep_count_job_status_update (count_job);
     }
 
+  /* release whatever was left behind on cancellation */
+  for (n = 0; n < walk.n_workers; n++)
+    {
+      g_queue_clear_full (&walk.workers[n].queue, thunar_deep_count_dir_free);
+      g_mutex_clear (&walk.workers[n].lock);
+    }
+  g_free (walk.workers);
+  for (n = 0; n < DEEP_COUNT_INODE_SHARDS; n++)
+    {
+      g_free (walk.inodes[n].slots);
+      g_mutex_clear (&walk.inodes[n].lock);
+    }
+  g_slist_free_full (walk.fs_ids, g_free);
+  g_clear_error (&walk.error);
+  g_mutex_clear (&walk.lock);
+  g_cond_clear (&walk.cond);
+
   return success;
 }
 
@@ -423,3 +973,23 @@ thunar_deep_count_job_new (GList              *files,
 
   return job;
 }
+
+
+
+/**
+ * thunar_deep_count_job_set_max_threads:
+ * @job         : a #ThunarDeepCountJob.
+ * @max_threads : the number of threads to use, or 0 to use one per
+ *                processor (up to a limit).
+ *
+ * Sets the number of threads reading directories in parallel. Must be
+ * called before the @job is launched.
+ **/
+void
+thunar_deep_count_job_set_max_threads (ThunarDeepCountJob *job,
+                                       guint               max_threads)
+{
+  _thunar_return_if_fail (THUNAR_IS_DEEP_COUNT_JOB (job));
+
+  job->max_threads = max_threads;
+}
@@ -45,6 +45,10 @@ ThunarDeepCountJob *
 thunar_deep_count_job_new (GList              *files,
                            GFileQueryInfoFlags flags) G_GNUC_MALLOC G_GNUC_WARN_UNUSED_RESULT;
 
+void
+thunar_deep_count_job_set_max_threads (ThunarDeepCountJob *job,
+                                       guint               max_threads);
+
 G_END_DECLS;
 
 #endif /* !__THUNAR_DEEP_COUNT_JOB_H__ */
@@ -45,6 +45,9 @@ enum
 #define GTK_MOVE_DIRECTION_BACKWARD -1
 #define THUNAR_DETAILED_VIEW_UPDATE_EXPAND_ARROW_TIMEOUT (20)
 
+/* delay in ms before the total sizes of the visible folders are requested */
+#define THUNAR_DETAILED_VIEW_UPDATE_TOTAL_SIZES_TIMEOUT (100)
+
 static void
 thunar_details_view_realize (GtkWidget *widget);
 static void
@@ -173,6 +176,8 @@ static void
 thunar_details_view_unblock_selection_changed (ThunarStandardView *standard_view);
 static void
 thunar_details_view_update_visible_expand_arrows (ThunarDetailsView *details_view);
+static void
+thunar_details_view_update_visible_total_sizes (ThunarDetailsView *details_view);
 
 
 
@@ -206,6 +211,7 @@ struct _ThunarDetailsView
   gboolean expandable_folders;
 
   guint update_expand_arrows_timeout_source_id;
+  guint update_total_sizes_timeout_source_id;
 };
 
 
@@ -321,6 +327,7 @@ thunar_details_view_init (ThunarDetailsView *details_view)
   ThunarColumn      column;
 
   details_view->update_expand_arrows_timeout_source_id = 0;
+  details_view->update_total_sizes_timeout_source_id = 0;
 
   /* we need to force the GtkTreeView to recalculate column sizes
    * whenever the zoom-level changes, so we connect a handler here.
@@ -372,6 +379,13 @@ thunar_details_view_init (ThunarDetailsView *details_view)
   g_signal_connect_after (G_OBJECT (THUNAR_STANDARD_VIEW (details_view)->model), "row-changed",
                           G_CALLBACK (thunar_details_view_row_changed), details_view);
 
+  /* the total sizes are determined for the visible folders only */
+  g_signal_connect_swapped (G_OBJECT (details_view->column_model), "columns-changed", G_CALLBACK (thunar_details_view_update_visible_total_sizes), details_view);
+  g_signal_connect_swapped (gtk_scrolled_window_get_vadjustment (GTK_SCROLLED_WINDOW (details_view)), "value-changed", G_CALLBACK (thunar_details_view_update_visible_total_sizes), details_view);
+  g_signal_connect_swapped (THUNAR_STANDARD_VIEW (details_view)->model, "rows-reordered", G_CALLBACK (thunar_details_view_update_visible_total_sizes), details_view);
+  g_signal_connect_swapped (THUNAR_STANDARD_VIEW (details_view)->model, "row-inserted", G_CALLBACK (thunar_details_view_update_visible_total_sizes), details_view);
+  g_signal_connect_swapped (THUNAR_STANDARD_VIEW (details_view)->model, "notify::num-files", G_CALLBACK (thunar_details_view_update_visible_total_sizes), details_view);
+
   /* allocate the shared right-aligned text renderer */
   right_aligned_renderer = g_object_new (thunar_text_renderer_get_type (), "xalign", 1.0f, NULL);
 
@@ -430,7 +444,7 @@ thunar_details_view_init (ThunarDetailsView *details_view)
       else
         {
           /* size is right aligned, everything else is left aligned */
-          renderer = (column == THUNAR_COLUMN_SIZE || column == THUNAR_COLUMN_SIZE_IN_BYTES) ? right_aligned_renderer : left_aligned_renderer;
+          renderer = (column == THUNAR_COLUMN_SIZE || column == THUNAR_COLUMN_SIZE_IN_BYTES || column == THUNAR_COLUMN_TOTAL_SIZE) ? right_aligned_renderer : left_aligned_renderer;
           details_view->renderers[column] = renderer;
 
           /* add the renderer */
@@ -560,11 +574,17 @@ thunar_details_view_finalize (GObject *object)
 
   /* disconnect from the default column model */
   g_signal_handlers_disconnect_by_func (G_OBJECT (details_view->column_model), thunar_details_view_columns_changed, details_view);
+  g_signal_handlers_disconnect_by_func (G_OBJECT (details_view->column_model), thunar_details_view_update_visible_total_sizes, details_view);
   g_object_unref (G_OBJECT (details_view->column_model));
 
+  g_signal_handlers_disconnect_by_func (THUNAR_STANDARD_VIEW (details_view)->model, thunar_details_view_update_visible_total_sizes, details_view);
+
   if (details_view->update_expand_arrows_timeout_source_id != 0)
     g_source_remove (details_view->update_expand_arrows_timeout_source_id);
 
+  if (details_view->update_total_sizes_timeout_source_id != 0)
+    g_source_remove (details_view->update_total_sizes_timeout_source_id);
+
   if (details_view->idle_id)
     g_source_remove (details_view->idle_id);
 
@@ -842,8 +862,6 @@ thunar_details_view_get_visible_files (ThunarDetailsView *details_view)
   GtkTreeIter          end_iter;
   GList               *files = 0;
 
-  details_view->update_expand_arrows_timeout_source_id = 0;
-
   if (!thunar_details_view_get_visible_range (THUNAR_STANDARD_VIEW (details_view), &start_path, &end_path))
     return NULL;
 
@@ -1751,6 +1769,44 @@ thunar_details_view_update_visible_expand_arrows (ThunarDetailsView *details_vie
 
 
 
+static gboolean
+thunar_details_view_update_visible_total_sizes_timeout (gpointer data)
+{
+  _thunar_return_val_if_fail (THUNAR_IS_DETAILS_VIEW (data), G_SOURCE_REMOVE);
+
+  ThunarDetailsView   *details_view = THUNAR_DETAILS_VIEW (data);
+  ThunarTreeViewModel *model = (THUNAR_STANDARD_VIEW (details_view))->model;
+  GList               *files = NULL;
+
+  details_view->update_total_sizes_timeout_source_id = 0;
+
+  /* an empty request cancels whatever is still being counted */
+  if (gtk_tree_view_column_get_visible (details_view->columns[THUNAR_COLUMN_TOTAL_SIZE]))
+    files = thunar_details_view_get_visible_files (details_view);
+
+  thunar_tree_view_model_request_total_sizes (model, files);
+  g_list_free_full (files, g_object_unref);
+
+  return G_SOURCE_REMOVE;
+}
+
+
+
+static void
+thunar_details_view_update_visible_total_sizes (ThunarDetailsView *details_view)
+{
+  _thunar_return_if_fail (THUNAR_IS_DETAILS_VIEW (details_view));
+
+  /* Reset wait time if the timer is already running, so scrolling
+   * through a folder does not start counting every passed folder */
+  if (details_view->update_total_sizes_timeout_source_id != 0)
+    g_source_remove (details_view->update_total_sizes_timeout_source_id);
+
+  details_view->update_total_sizes_timeout_source_id = g_timeout_add (THUNAR_DETAILED_VIEW_UPDATE_TOTAL_SIZES_TIMEOUT, (GSourceFunc) thunar_details_view_update_visible_total_sizes_timeout, details_view);
+}
+
+
+
 /**
  * thunar_details_view_set_expandable_folders:
  * @details_view  : a #ThunarDetailsView.
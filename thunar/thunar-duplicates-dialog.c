@@ -0,0 +1,406 @@
+/* vi:set et ai sw=2 sts=2 ts=2: */
+/*-
+ * Copyright (c) 2026 The Xfce Development Team
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+ * Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "thunar/thunar-abstract-dialog.h"
+#include "thunar/thunar-duplicates-dialog.h"
+#include "thunar/thunar-duplicates-job.h"
+#include "thunar/thunar-preferences.h"
+#include "thunar/thunar-private.h"
+#include "thunar/thunar-window.h"
+
+#include <libxfce4util/libxfce4util.h>
+
+
+
+/* Columns of the duplicates store */
+enum
+{
+  COLUMN_FILE,
+  COLUMN_NAME,
+  COLUMN_LOCATION,
+  COLUMN_SIZE,
+  N_COLUMNS,
+};
+
+
+
+static void
+thunar_duplicates_dialog_finalize (GObject *object);
+static void
+thunar_duplicates_dialog_response (GtkDialog *dialog,
+                                   gint       response);
+static void
+thunar_duplicates_dialog_duplicates_found (ThunarJob              *job,
+                                           GList                  *files,
+                                           guint64                 size,
+                                           ThunarDuplicatesDialog *dialog);
+static void
+thunar_duplicates_dialog_percent (ThunarJob              *job,
+                                  gdouble                 percent,
+                                  ThunarDuplicatesDialog *dialog);
+static void
+thunar_duplicates_dialog_finished (ThunarJob              *job,
+                                   ThunarDuplicatesDialog *dialog);
+static void
+thunar_duplicates_dialog_row_activated (GtkTreeView            *tree_view,
+                                        GtkTreePath            *path,
+                                        GtkTreeViewColumn      *column,
+                                        ThunarDuplicatesDialog *dialog);
+static void
+thunar_duplicates_dialog_stop_job (ThunarDuplicatesDialog *dialog);
+
+
+
+struct _ThunarDuplicatesDialogClass
+{
+  ThunarAbstractDialogClass __parent__;
+};
+
+struct _ThunarDuplicatesDialog
+{
+  ThunarAbstractDialog __parent__;
+
+  GtkTreeStore *store;
+  GtkWidget    *tree_view;
+  GtkWidget    *progress_bar;
+  GtkWidget    *status_label;
+
+  ThunarJob *job;
+
+  gboolean file_size_binary;
+
+  /* statistics of the sets found so far */
+  guint   n_sets;
+  guint64 wasted_size;
+};
+
+
+
+G_DEFINE_TYPE (ThunarDuplicatesDialog, thunar_duplicates_dialog, THUNAR_TYPE_ABSTRACT_DIALOG)
+
+
+
+static void
+thunar_duplicates_dialog_class_init (ThunarDuplicatesDialogClass *klass)
+{
+  GtkDialogClass *gtkdialog_class;
+  GObjectClass   *gobject_class;
+
+  gobject_class = G_OBJECT_CLASS (klass);
+  gobject_class->finalize = thunar_duplicates_dialog_finalize;
+
+  gtkdialog_class = GTK_DIALOG_CLASS (klass);
+  gtkdialog_class->response = thunar_duplicates_dialog_response;
+}
+
+
+
+static void
+thunar_duplicates_dialog_init (ThunarDuplicatesDialog *dialog)
+{
+  ThunarPreferences *preferences;
+  GtkTreeViewColumn *column;
+  GtkCellRenderer   *renderer;
+  GtkWidget         *content_area;
+  GtkWidget         *scrolled_window;
+  GtkWidget         *box;
+
+  preferences = thunar_preferences_get ();
+  g_object_get (G_OBJECT (preferences), "misc-file-size-binary", &dialog->file_size_binary, NULL);
+  g_object_unref (preferences);
+
+  gtk_dialog_add_button (GTK_DIALOG (dialog), _("_Close"), GTK_RESPONSE_CLOSE);
+  gtk_window_set_default_size (GTK_WINDOW (dialog), 640, 480);
+  gtk_window_set_title (GTK_WINDOW (dialog), _("Duplicate Files"));
+
+  content_area = gtk_dialog_get_content_area (GTK_DIALOG (dialog));
+
+  box = gtk_box_new (GTK_ORIENTATION_VERTICAL, 6);
+  gtk_container_set_border_width (GTK_CONTAINER (box), 6);
+  gtk_box_pack_start (GTK_BOX (content_area), box, TRUE, TRUE, 0);
+  gtk_widget_show (box);
+
+  dialog->status_label = gtk_label_new (_("Searching for duplicate files..."));
+  gtk_label_set_xalign (GTK_LABEL (dialog->status_label), 0.0f);
+  gtk_label_set_ellipsize (GTK_LABEL (dialog->status_label), PANGO_ELLIPSIZE_END);
+  gtk_box_pack_start (GTK_BOX (box), dialog->status_label, FALSE, FALSE, 0);
+  gtk_widget_show (dialog->status_label);
+
+  dialog->progress_bar = gtk_progress_bar_new ();
+  gtk_box_pack_start (GTK_BOX (box), dialog->progress_bar, FALSE, FALSE, 0);
+  gtk_widget_show (dialog->progress_bar);
+
+  scrolled_window = gtk_scrolled_window_new (NULL, NULL);
+  gtk_scrolled_window_set_policy (GTK_SCROLLED_WINDOW (scrolled_window), GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+  gtk_scrolled_window_set_shadow_type (GTK_SCROLLED_WINDOW (scrolled_window), GTK_SHADOW_IN);
+  gtk_box_pack_start (GTK_BOX (box), scrolled_window, TRUE, TRUE, 0);
+  gtk_widget_show (scrolled_window);
+
+  /* one toplevel row per set of duplicates, with the files as children */
+  dialog->store = gtk_tree_store_new (N_COLUMNS, G_TYPE_FILE, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING);
+  dialog->tree_view = gtk_tree_view_new_with_model (GTK_TREE_MODEL (dialog->store));
+  g_signal_connect (G_OBJECT (dialog->tree_view), "row-activated", G_CALLBACK (thunar_duplicates_dialog_row_activated), dialog);
+  gtk_container_add (GTK_CONTAINER (scrolled_window), dialog->tree_view);
+  gtk_widget_show (dialog->tree_view);
+
+  renderer = gtk_cell_renderer_text_new ();
+  g_object_set (G_OBJECT (renderer), "ellipsize", PANGO_ELLIPSIZE_END, NULL);
+  column = gtk_tree_view_column_new_with_attributes (_("Name"), renderer, "text", COLUMN_NAME, NULL);
+  gtk_tree_view_column_set_expand (column, TRUE);
+  gtk_tree_view_column_set_resizable (column, TRUE);
+  gtk_tree_view_append_column (GTK_TREE_VIEW (dialog->tree_view), column);
+
+  renderer = gtk_cell_renderer_text_new ();
+  g_object_set (G_OBJECT (renderer), "ellipsize", PANGO_ELLIPSIZE_MIDDLE, NULL);
+  column = gtk_tree_view_column_new_with_attributes (_("Location"), renderer, "text", COLUMN_LOCATION, NULL);
+  gtk_tree_view_column_set_expand (column, TRUE);
+  gtk_tree_view_column_set_resizable (column, TRUE);
+  gtk_tree_view_append_column (GTK_TREE_VIEW (dialog->tree_view), column);
+
+  renderer = gtk_cell_renderer_text_new ();
+  g_object_set (G_OBJECT (renderer), "xalign", 1.0f, NULL);
+  column = gtk_tree_view_column_new_with_attributes (_("Size"), renderer, "text", COLUMN_SIZE, NULL);
+  gtk_tree_view_append_column (GTK_TREE_VIEW (dialog->tree_view), column);
+}
+
+
+
+static void
+thunar_duplicates_dialog_finalize (GObject *object)
+{
+  ThunarDuplicatesDialog *dialog = THUNAR_DUPLICATES_DIALOG (object);
+
+  thunar_duplicates_dialog_stop_job (dialog);
+
+  g_object_unref (dialog->store);
+
+  (*G_OBJECT_CLASS (thunar_duplicates_dialog_parent_class)->finalize) (object);
+}
+
+
+
+static void
+thunar_duplicates_dialog_response (GtkDialog *dialog,
+                                   gint       response)
+{
+  if (response == GTK_RESPONSE_CLOSE || response == GTK_RESPONSE_DELETE_EVENT)
+    {
+      /* don't keep reading files for a closed dialog */
+      thunar_duplicates_dialog_stop_job (THUNAR_DUPLICATES_DIALOG (dialog));
+      gtk_widget_destroy (GTK_WIDGET (dialog));
+    }
+  else if (GTK_DIALOG_CLASS (thunar_duplicates_dialog_parent_class)->response != NULL)
+    {
+      (*GTK_DIALOG_CLASS (thunar_duplicates_dialog_parent_class)->response) (dialog, response);
+    }
+}
+
+
+
+static void
+thunar_duplicates_dialog_update_status (ThunarDuplicatesDialog *dialog)
+{
+  gchar *size_string;
+  gchar *text;
+
+  size_string = g_format_size_full (dialog->wasted_size, dialog->file_size_binary ? G_FORMAT_SIZE_IEC_UNITS : G_FORMAT_SIZE_DEFAULT);
+  /* TRANSLATORS: the size is the space which would be freed by keeping only one file of each set */
+  text = g_strdup_printf (ngettext ("%u set of duplicates, %s in extra copies",
+                                    "%u sets of duplicates, %s in extra copies",
+                                    dialog->n_sets),
+                          dialog->n_sets, size_string);
+  gtk_label_set_text (GTK_LABEL (dialog->status_label), text);
+  g_free (size_string);
+  g_free (text);
+}
+
+
+
+static void
+thunar_duplicates_dialog_duplicates_found (ThunarJob              *job,
+                                           GList                  *files,
+                                           guint64                 size,
+                                           ThunarDuplicatesDialog *dialog)
+{
+  GtkTreeIter parent;
+  GtkTreeIter iter;
+  GFile      *location;
+  gchar      *size_string;
+  gchar      *basename;
+  gchar      *display_name;
+  gchar      *location_name;
+  gchar      *text;
+  GList      *lp;
+  guint       n_files = g_list_length (files);
+
+  _thunar_return_if_fail (THUNAR_IS_DUPLICATES_DIALOG (dialog));
+
+  size_string = g_format_size_full (size, dialog->file_size_binary ? G_FORMAT_SIZE_IEC_UNITS : G_FORMAT_SIZE_DEFAULT);
+
+  text = g_strdup_printf (ngettext ("%u identical file", "%u identical files", n_files), n_files);
+  gtk_tree_store_insert_with_values (dialog->store, &parent, NULL, -1,
+                                     COLUMN_NAME, text,
+                                     COLUMN_SIZE, size_string,
+                                     -1);
+  g_free (text);
+
+  for (lp = files; lp != NULL; lp = lp->next)
+    {
+      basename = g_file_get_basename (lp->data);
+      display_name = g_filename_display_name (basename);
+      location = g_file_get_parent (lp->data);
+      location_name = (location != NULL) ? g_file_get_parse_name (location) : NULL;
+
+      gtk_tree_store_insert_with_values (dialog->store, &iter, &parent, -1,
+                                         COLUMN_FILE, lp->data,
+                                         COLUMN_NAME, display_name,
+                                         COLUMN_LOCATION, location_name,
+                                         COLUMN_SIZE, size_string,
+                                         -1);
+
+      g_free (basename);
+      g_free (display_name);
+      g_free (location_name);
+      if (location != NULL)
+        g_object_unref (location);
+    }
+
+  g_free (size_string);
+
+  dialog->n_sets++;
+  dialog->wasted_size += size * (n_files - 1);
+  thunar_duplicates_dialog_update_status (dialog);
+}
+
+
+
+static void
+thunar_duplicates_dialog_percent (ThunarJob              *job,
+                                  gdouble                 percent,
+                                  ThunarDuplicatesDialog *dialog)
+{
+  _thunar_return_if_fail (THUNAR_IS_DUPLICATES_DIALOG (dialog));
+
+  gtk_progress_bar_set_fraction (GTK_PROGRESS_BAR (dialog->progress_bar), CLAMP (percent / 100.0, 0.0, 1.0));
+}
+
+
+
+static void
+thunar_duplicates_dialog_finished (ThunarJob              *job,
+                                   ThunarDuplicatesDialog *dialog)
+{
+  _thunar_return_if_fail (THUNAR_IS_DUPLICATES_DIALOG (dialog));
+
+  thunar_duplicates_dialog_stop_job (dialog);
+
+  gtk_widget_hide (dialog->progress_bar);
+  if (dialog->n_sets == 0)
+    gtk_label_set_text (GTK_LABEL (dialog->status_label), _("No duplicate files found"));
+}
+
+
+
+static void
+thunar_duplicates_dialog_row_activated (GtkTreeView            *tree_view,
+                                        GtkTreePath            *path,
+                                        GtkTreeViewColumn      *column,
+                                        ThunarDuplicatesDialog *dialog)
+{
+  GtkTreeIter iter;
+  GtkWindow  *window;
+  GFile      *file = NULL;
+  GList       files = { NULL, NULL, NULL };
+
+  _thunar_return_if_fail (THUNAR_IS_DUPLICATES_DIALOG (dialog));
+
+  if (!gtk_tree_model_get_iter (GTK_TREE_MODEL (dialog->store), &iter, path))
+    return;
+
+  gtk_tree_model_get (GTK_TREE_MODEL (dialog->store), &iter, COLUMN_FILE, &file, -1);
+  if (file == NULL)
+    {
+      /* rows of sets just expand or collapse */
+      if (gtk_tree_view_row_expanded (tree_view, path))
+        gtk_tree_view_collapse_row (tree_view, path);
+      else
+        gtk_tree_view_expand_row (tree_view, path, FALSE);
+      return;
+    }
+
+  /* show the file in the window the search was started from */
+  window = gtk_window_get_transient_for (GTK_WINDOW (dialog));
+  if (THUNAR_IS_WINDOW (window))
+    {
+      files.data = file;
+      thunar_window_open_files_in_location (THUNAR_WINDOW (window), &files);
+    }
+
+  g_object_unref (file);
+}
+
+
+
+static void
+thunar_duplicates_dialog_stop_job (ThunarDuplicatesDialog *dialog)
+{
+  if (dialog->job == NULL)
+    return;
+
+  g_signal_handlers_disconnect_by_data (dialog->job, dialog);
+  thunar_job_cancel (dialog->job);
+  g_clear_object (&dialog->job);
+}
+
+
+
+/**
+ * thunar_duplicates_dialog_new:
+ * @parent : the #ThunarWindow the search is started from, or %NULL.
+ * @folder : the #GFile of the folder to search.
+ *
+ * Allocates a new #ThunarDuplicatesDialog and starts searching @folder
+ * for files with identical contents. Sets of duplicates are added to
+ * the dialog as they are found.
+ *
+ * Return value: the newly allocated #ThunarDuplicatesDialog.
+ **/
+GtkWidget *
+thunar_duplicates_dialog_new (GtkWindow *parent,
+                              GFile     *folder)
+{
+  ThunarDuplicatesDialog *dialog;
+  GList                   files = { folder, NULL, NULL };
+
+  _thunar_return_val_if_fail (parent == NULL || GTK_IS_WINDOW (parent), NULL);
+  _thunar_return_val_if_fail (G_IS_FILE (folder), NULL);
+
+  dialog = g_object_new (THUNAR_TYPE_DUPLICATES_DIALOG,
+                         "transient-for", parent,
+                         "destroy-with-parent", parent != NULL,
+                         NULL);
+
+  dialog->job = THUNAR_JOB (thunar_duplicates_job_new (&files));
+  g_signal_connect (dialog->job, "duplicates-found", G_CALLBACK (thunar_duplicates_dialog_duplicates_found), dialog);
+  g_signal_connect (dialog->job, "percent", G_CALLBACK (thunar_duplicates_dialog_percent), dialog);
+  g_signal_connect (dialog->job, "finished", G_CALLBACK (thunar_duplicates_dialog_finished), dialog);
+  thunar_job_launch (dialog->job);
+
+  return GTK_WIDGET (dialog);
+}
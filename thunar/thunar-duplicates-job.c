@@ -0,0 +1,633 @@
+/* vi:set et ai sw=2 sts=2 ts=2: */
+/*-
+ * Copyright (c) 2026 The Xfce Development Team
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+ * Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "thunar/thunar-duplicates-job.h"
+#include "thunar/thunar-job.h"
+#include "thunar/thunar-marshal.h"
+#include "thunar/thunar-private.h"
+
+#include <string.h>
+
+
+
+/* Signal identifiers */
+enum
+{
+  DUPLICATES_FOUND,
+  LAST_SIGNAL,
+};
+
+
+#define DUPLICATES_FILE_INFO_NAMESPACE \
+  G_FILE_ATTRIBUTE_STANDARD_NAME "," G_FILE_ATTRIBUTE_STANDARD_TYPE "," G_FILE_ATTRIBUTE_STANDARD_SIZE "," \
+  G_FILE_ATTRIBUTE_UNIX_DEVICE "," G_FILE_ATTRIBUTE_UNIX_INODE
+
+/* upper limit for the default number of threads hashing files, the
+ * hashing is mostly limited by the disk, not by the processors */
+#define DUPLICATES_MAX_THREADS 4
+
+/* number of bytes hashed at the start and at the end of a file before
+ * the whole file is read, files up to twice this size are completely
+ * covered by the first pass */
+#define DUPLICATES_BLOCK_SIZE (16 * 1024)
+
+/* size of the read buffer while hashing whole files */
+#define DUPLICATES_BUFFER_SIZE (128 * 1024)
+
+#define DUPLICATES_CHECKSUM_TYPE   G_CHECKSUM_SHA256
+#define DUPLICATES_CHECKSUM_LENGTH 32
+
+
+
+typedef struct _ThunarDuplicatesFile  ThunarDuplicatesFile;
+typedef struct _ThunarDuplicatesGroup ThunarDuplicatesGroup;
+typedef struct _ThunarDuplicatesHash  ThunarDuplicatesHash;
+
+
+
+static void
+thunar_duplicates_job_finalize (GObject *object);
+static gboolean
+thunar_duplicates_job_execute (ThunarJob *job,
+                               GError   **error);
+
+
+
+struct _ThunarDuplicatesJobClass
+{
+  ThunarJobClass __parent__;
+};
+
+struct _ThunarDuplicatesJob
+{
+  ThunarJob __parent__;
+
+  GList *files;
+
+  /* number of threads hashing files, 0 for automatic */
+  guint max_threads;
+};
+
+
+
+/* a regular file, hard links to it are only kept once */
+struct _ThunarDuplicatesFile
+{
+  GFile  *file;
+  guint64 size;
+  guint64 device;
+  guint64 inode;
+
+  /* digest of the current stage, only valid unless failed */
+  guint8   digest[DUPLICATES_CHECKSUM_LENGTH];
+  gboolean failed;
+
+  /* group the file is hashed for */
+  ThunarDuplicatesGroup *group;
+};
+
+/* files of the same size which are hashed together */
+struct _ThunarDuplicatesGroup
+{
+  guint64    size;
+  GPtrArray *files;
+
+  /* whether the whole files are hashed, instead of their ends */
+  gboolean full;
+
+  /* number of files not hashed yet, atomic */
+  gint n_pending;
+};
+
+/* state shared with the hashing threads during one execution of the job */
+struct _ThunarDuplicatesHash
+{
+  GThreadPool  *pool;
+  GCancellable *cancellable;
+
+  /* groups whose files are all hashed */
+  GAsyncQueue *finished;
+
+  /* only touched by the job thread */
+  guint   n_groups;
+  guint64 total_bytes;
+  guint64 done_bytes;
+};
+
+
+
+static guint duplicates_signals[LAST_SIGNAL];
+
+
+
+G_DEFINE_TYPE (ThunarDuplicatesJob, thunar_duplicates_job, THUNAR_TYPE_JOB)
+
+
+
+static void
+thunar_duplicates_job_class_init (ThunarDuplicatesJobClass *klass)
+{
+  ThunarJobClass *job_class;
+  GObjectClass   *gobject_class;
+
+  gobject_class = G_OBJECT_CLASS (klass);
+  gobject_class->finalize = thunar_duplicates_job_finalize;
+
+  job_class = THUNAR_JOB_CLASS (klass);
+  job_class->execute = thunar_duplicates_job_execute;
+
+  /**
+   * ThunarDuplicatesJob::duplicates-found:
+   * @job   : a #ThunarJob.
+   * @files : a #GList of #GFile<!---->s with identical contents.
+   * @size  : the size of each of the @files in bytes.
+   *
+   * Emitted by the @job for each set of duplicates as soon as it is
+   * confirmed. Hard links to the same file are
+   * never reported as duplicates, only one of the links appears in
+   * @files. The list is owned by the @job.
+   **/
+  duplicates_signals[DUPLICATES_FOUND] =
+  g_signal_new (I_ ("duplicates-found"),
+                G_TYPE_FROM_CLASS (klass),
+                G_SIGNAL_NO_HOOKS,
+                0, NULL, NULL,
+                _thunar_marshal_VOID__POINTER_UINT64,
+                G_TYPE_NONE, 2,
+                G_TYPE_POINTER,
+                G_TYPE_UINT64);
+}
+
+
+
+static void
+thunar_duplicates_job_init (ThunarDuplicatesJob *job)
+{
+}
+
+
+
+static void
+thunar_duplicates_job_finalize (GObject *object)
+{
+  ThunarDuplicatesJob *job = THUNAR_DUPLICATES_JOB (object);
+
+  g_list_free_full (job->files, g_object_unref);
+
+  (*G_OBJECT_CLASS (thunar_duplicates_job_parent_class)->finalize) (object);
+}
+
+
+
+static void
+thunar_duplicates_file_free (gpointer data)
+{
+  ThunarDuplicatesFile *dfile = data;
+
+  g_object_unref (dfile->file);
+  g_slice_free (ThunarDuplicatesFile, dfile);
+}
+
+
+
+/* collects all non-empty regular files below the job files, without
+ * following symlinks */
+static void
+thunar_duplicates_job_collect (ThunarDuplicatesJob *job,
+                               GPtrArray           *dfiles)
+{
+  ThunarDuplicatesFile *dfile;
+  GFileEnumerator      *enumerator;
+  GCancellable         *cancellable;
+  GFileInfo            *info;
+  GFileType             type;
+  GQueue                directories = G_QUEUE_INIT;
+  GFile                *directory;
+  GFile                *child;
+  GList                *lp;
+
+  cancellable = thunar_job_get_cancellable (THUNAR_JOB (job));
+
+  for (lp = job->files; lp != NULL; lp = lp->next)
+    g_queue_push_tail (&directories, g_object_ref (lp->data));
+
+  while ((directory = g_queue_pop_head (&directories)) != NULL)
+    {
+      if (g_cancellable_is_cancelled (cancellable))
+        {
+          g_object_unref (directory);
+          continue;
+        }
+
+      /* unreadable folders are skipped, there is nothing to compare */
+      enumerator = g_file_enumerate_children (directory, DUPLICATES_FILE_INFO_NAMESPACE,
+                                              G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS,
+                                              cancellable, NULL);
+      if (enumerator == NULL)
+        {
+          g_object_unref (directory);
+          continue;
+        }
+
+      while ((info = g_file_enumerator_next_file (enumerator, cancellable, NULL)) != NULL)
+        {
+          type = g_file_info_get_file_type (info);
+          if (type == G_FILE_TYPE_DIRECTORY)
+            {
+              g_queue_push_tail (&directories, g_file_get_child (directory, g_file_info_get_name (info)));
+            }
+          else if (type == G_FILE_TYPE_REGULAR && g_file_info_get_size (info) > 0)
+            {
+              child = g_file_get_child (directory, g_file_info_get_name (info));
+
+              dfile = g_slice_new0 (ThunarDuplicatesFile);
+              dfile->file = child;
+              dfile->size = g_file_info_get_size (info);
+              dfile->device = g_file_info_get_attribute_uint32 (info, G_FILE_ATTRIBUTE_UNIX_DEVICE);
+              dfile->inode = g_file_info_get_attribute_uint64 (info, G_FILE_ATTRIBUTE_UNIX_INODE);
+              g_ptr_array_add (dfiles, dfile);
+            }
+
+          g_object_unref (info);
+        }
+
+      g_object_unref (enumerator);
+      g_object_unref (directory);
+    }
+}
+
+
+
+static gint
+thunar_duplicates_file_compare_by_size (gconstpointer a,
+                                        gconstpointer b)
+{
+  const ThunarDuplicatesFile *dfile_a = *(ThunarDuplicatesFile *const *) a;
+  const ThunarDuplicatesFile *dfile_b = *(ThunarDuplicatesFile *const *) b;
+
+  /* larger files first, hard links next to each other */
+  if (dfile_a->size != dfile_b->size)
+    return (dfile_a->size > dfile_b->size) ? -1 : 1;
+  if (dfile_a->device != dfile_b->device)
+    return (dfile_a->device < dfile_b->device) ? -1 : 1;
+  if (dfile_a->inode != dfile_b->inode)
+    return (dfile_a->inode < dfile_b->inode) ? -1 : 1;
+  return 0;
+}
+
+
+
+static gint
+thunar_duplicates_file_compare_by_digest (gconstpointer a,
+                                          gconstpointer b)
+{
+  const ThunarDuplicatesFile *dfile_a = *(ThunarDuplicatesFile *const *) a;
+  const ThunarDuplicatesFile *dfile_b = *(ThunarDuplicatesFile *const *) b;
+
+  /* files which could not be hashed last */
+  if (dfile_a->failed || dfile_b->failed)
+    return dfile_a->failed - dfile_b->failed;
+
+  return memcmp (dfile_a->digest, dfile_b->digest, DUPLICATES_CHECKSUM_LENGTH);
+}
+
+
+
+/* reads @length bytes (or less at the end of the file) into the checksum,
+ * returns the number of bytes read or -1 on errors */
+static gssize
+thunar_duplicates_checksum_update (GChecksum    *checksum,
+                                   GInputStream *stream,
+                                   guint8       *buffer,
+                                   gsize         buffer_size,
+                                   guint64       length,
+                                   GCancellable *cancellable)
+{
+  gssize n_read;
+  gsize  total = 0;
+
+  while (total < length)
+    {
+      n_read = g_input_stream_read (stream, buffer, MIN (buffer_size, length - total), cancellable, NULL);
+      if (n_read < 0)
+        return -1;
+      if (n_read == 0)
+        break;
+
+      g_checksum_update (checksum, buffer, n_read);
+      total += n_read;
+    }
+
+  return total;
+}
+
+
+
+static gboolean
+thunar_duplicates_file_hash (ThunarDuplicatesFile *dfile,
+                             gboolean              full,
+                             GCancellable         *cancellable)
+{
+  GFileInputStream *stream;
+  GChecksum        *checksum;
+  gboolean          succeed = FALSE;
+  guint8           *buffer;
+  gsize             digest_len = DUPLICATES_CHECKSUM_LENGTH;
+  gssize            n_read;
+  guint64           offset;
+
+  stream = g_file_read (dfile->file, cancellable, NULL);
+  if (stream == NULL)
+    return FALSE;
+
+  checksum = g_checksum_new (DUPLICATES_CHECKSUM_TYPE);
+  buffer = g_malloc (full ? DUPLICATES_BUFFER_SIZE : DUPLICATES_BLOCK_SIZE);
+
+  if (full)
+    {
+      /* the file must not have changed its size since it was found */
+      n_read = thunar_duplicates_checksum_update (checksum, G_INPUT_STREAM (stream), buffer, DUPLICATES_BUFFER_SIZE,
+                                                  G_MAXUINT64, cancellable);
+      succeed = (n_read >= 0 && (guint64) n_read == dfile->size);
+    }
+  else
+    {
+      /* the first block, followed by the last one unless it overlaps */
+      n_read = thunar_duplicates_checksum_update (checksum, G_INPUT_STREAM (stream), buffer, DUPLICATES_BLOCK_SIZE,
+                                                  DUPLICATES_BLOCK_SIZE, cancellable);
+      succeed = (n_read >= 0 && (guint64) n_read == MIN (dfile->size, DUPLICATES_BLOCK_SIZE));
+
+      if (succeed && dfile->size > DUPLICATES_BLOCK_SIZE)
+        {
+          offset = MAX (DUPLICATES_BLOCK_SIZE, dfile->size - DUPLICATES_BLOCK_SIZE);
+          succeed = g_seekable_seek (G_SEEKABLE (stream), offset, G_SEEK_SET, cancellable, NULL);
+          if (succeed)
+            {
+              n_read = thunar_duplicates_checksum_update (checksum, G_INPUT_STREAM (stream), buffer, DUPLICATES_BLOCK_SIZE,
+                                                          dfile->size - offset, cancellable);
+              succeed = (n_read >= 0 && (guint64) n_read == dfile->size - offset);
+            }
+        }
+    }
+
+  if (succeed)
+    g_checksum_get_digest (checksum, dfile->digest, &digest_len);
+
+  g_free (buffer);
+  g_checksum_free (checksum);
+  g_input_stream_close (G_INPUT_STREAM (stream), NULL, NULL);
+  g_object_unref (stream);
+
+  return succeed;
+}
+
+
+
+static void
+thunar_duplicates_job_hash_file (gpointer data,
+                                 gpointer user_data)
+{
+  ThunarDuplicatesFile  *dfile = data;
+  ThunarDuplicatesHash  *hash = user_data;
+  ThunarDuplicatesGroup *group = dfile->group;
+
+  if (g_cancellable_is_cancelled (hash->cancellable))
+    dfile->failed = TRUE;
+  else
+    dfile->failed = !thunar_duplicates_file_hash (dfile, group->full, hash->cancellable);
+
+  /* the last file of the group hands it back to the job thread */
+  if (g_atomic_int_dec_and_test (&group->n_pending))
+    g_async_queue_push (hash->finished, group);
+}
+
+
+
+static void
+thunar_duplicates_job_push_group (ThunarDuplicatesHash *hash,
+                                  guint64               size,
+                                  ThunarDuplicatesFile **dfiles,
+                                  guint                 n_dfiles,
+                                  gboolean              full)
+{
+  ThunarDuplicatesGroup *group;
+  guint                  n;
+
+  group = g_slice_new0 (ThunarDuplicatesGroup);
+  group->size = size;
+  group->full = full;
+  group->n_pending = n_dfiles;
+  group->files = g_ptr_array_sized_new (n_dfiles);
+
+  for (n = 0; n < n_dfiles; n++)
+    {
+      dfiles[n]->group = group;
+      g_ptr_array_add (group->files, dfiles[n]);
+    }
+
+  hash->n_groups++;
+
+  for (n = 0; n < n_dfiles; n++)
+    g_thread_pool_push (hash->pool, dfiles[n], NULL);
+}
+
+
+
+static void
+thunar_duplicates_job_emit (ThunarDuplicatesJob   *job,
+                            guint64                size,
+                            ThunarDuplicatesFile **dfiles,
+                            guint                  n_dfiles)
+{
+  GList *files = NULL;
+  guint  n;
+
+  for (n = n_dfiles; n > 0; n--)
+    files = g_list_prepend (files, dfiles[n - 1]->file);
+
+  thunar_job_emit (THUNAR_JOB (job), duplicates_signals[DUPLICATES_FOUND], 0, files, size);
+
+  g_list_free (files);
+}
+
+
+
+/* splits a hashed group into sets of equal digests, which are either
+ * reported or hashed completely */
+static void
+thunar_duplicates_job_split_group (ThunarDuplicatesJob   *job,
+                                   ThunarDuplicatesHash  *hash,
+                                   ThunarDuplicatesGroup *group)
+{
+  ThunarDuplicatesFile **dfiles = (ThunarDuplicatesFile **) group->files->pdata;
+  guint                  n_dfiles = group->files->len;
+  guint                  start;
+  guint                  end;
+
+  g_ptr_array_sort (group->files, thunar_duplicates_file_compare_by_digest);
+
+  for (start = 0; start < n_dfiles; start = end)
+    {
+      for (end = start + 1; end < n_dfiles; end++)
+        if (dfiles[end]->failed || thunar_duplicates_file_compare_by_digest (&dfiles[start], &dfiles[end]) != 0)
+          break;
+
+      if (dfiles[start]->failed || end - start < 2)
+        {
+          /* nothing to compare with anymore */
+          hash->done_bytes += group->size * (end - start);
+        }
+      else if (group->full || group->size <= 2 * DUPLICATES_BLOCK_SIZE)
+        {
+          /* all bytes are known to be equal */
+          thunar_duplicates_job_emit (job, group->size, dfiles + start, end - start);
+          hash->done_bytes += group->size * (end - start);
+        }
+      else
+        {
+          thunar_duplicates_job_push_group (hash, group->size, dfiles + start, end - start, TRUE);
+        }
+    }
+
+  g_ptr_array_unref (group->files);
+  g_slice_free (ThunarDuplicatesGroup, group);
+}
+
+
+
+static gboolean
+thunar_duplicates_job_execute (ThunarJob *job,
+                               GError   **error)
+{
+  ThunarDuplicatesJob   *duplicates_job = THUNAR_DUPLICATES_JOB (job);
+  ThunarDuplicatesGroup *group;
+  ThunarDuplicatesFile **dfiles;
+  ThunarDuplicatesHash   hash = { 0, };
+  GPtrArray             *all_files;
+  GPtrArray             *candidates;
+  guint                  n_threads;
+  guint                  start;
+  guint                  end;
+
+  _thunar_return_val_if_fail (THUNAR_IS_DUPLICATES_JOB (job), FALSE);
+  _thunar_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+  /* stage one: collect all files and group them by size */
+  all_files = g_ptr_array_new_with_free_func (thunar_duplicates_file_free);
+  thunar_duplicates_job_collect (duplicates_job, all_files);
+  g_ptr_array_sort (all_files, thunar_duplicates_file_compare_by_size);
+
+  if (duplicates_job->max_threads > 0)
+    n_threads = duplicates_job->max_threads;
+  else
+    n_threads = CLAMP (g_get_num_processors (), 1, DUPLICATES_MAX_THREADS);
+
+  hash.cancellable = thunar_job_get_cancellable (job);
+  hash.finished = g_async_queue_new ();
+  hash.pool = g_thread_pool_new (thunar_duplicates_job_hash_file, &hash, n_threads, FALSE, NULL);
+
+  /* stage two: hash the ends of all files sharing their size with another
+   * file, the largest first so the most space is found early */
+  candidates = g_ptr_array_new ();
+  dfiles = (ThunarDuplicatesFile **) all_files->pdata;
+  for (start = 0; start < all_files->len; start = end)
+    {
+      /* hard links to the same file are no duplicates, keep one of them */
+      g_ptr_array_set_size (candidates, 0);
+      for (end = start; end < all_files->len && dfiles[end]->size == dfiles[start]->size; end++)
+        if (end == start
+            || dfiles[end]->inode != dfiles[end - 1]->inode
+            || dfiles[end]->device != dfiles[end - 1]->device)
+          g_ptr_array_add (candidates, dfiles[end]);
+
+      if (candidates->len >= 2)
+        {
+          hash.total_bytes += dfiles[start]->size * candidates->len;
+          thunar_duplicates_job_push_group (&hash, dfiles[start]->size,
+                                            (ThunarDuplicatesFile **) candidates->pdata, candidates->len, FALSE);
+        }
+    }
+  g_ptr_array_unref (candidates);
+
+  /* stage three: hash the files with equal ends completely, sets of
+   * duplicates are reported as soon as they are confirmed */
+  while (hash.n_groups > 0)
+    {
+      group = g_async_queue_pop (hash.finished);
+      hash.n_groups--;
+      thunar_duplicates_job_split_group (duplicates_job, &hash, group);
+
+      if (hash.total_bytes > 0)
+        thunar_job_percent (job, (hash.done_bytes * 100.0) / hash.total_bytes);
+    }
+
+  g_thread_pool_free (hash.pool, FALSE, TRUE);
+  g_async_queue_unref (hash.finished);
+
+  g_ptr_array_unref (all_files);
+
+  return !thunar_job_set_error_if_cancelled (job, error);
+}
+
+
+
+/**
+ * thunar_duplicates_job_new:
+ * @files : a #GList of #GFile<!---->s of the folders to search.
+ *
+ * Allocates a new #ThunarDuplicatesJob, which searches the @files for
+ * regular files with identical contents. Files are grouped by their
+ * size first, then by a checksum of their first and last blocks, and
+ * only the remaining candidates are read completely, on a pool of
+ * worker threads.
+ *
+ * Return value: the newly allocated #ThunarDuplicatesJob.
+ **/
+ThunarDuplicatesJob *
+thunar_duplicates_job_new (GList *files)
+{
+  ThunarDuplicatesJob *job;
+
+  _thunar_return_val_if_fail (files != NULL, NULL);
+
+  job = g_object_new (THUNAR_TYPE_DUPLICATES_JOB, NULL);
+  job->files = g_list_copy_deep (files, (GCopyFunc) (void (*) (void)) g_object_ref, NULL);
+
+  return job;
+}
+
+
+
+/**
+ * thunar_duplicates_job_set_max_threads:
+ * @job         : a #ThunarDuplicatesJob.
+ * @max_threads : the number of threads to use, or 0 to use one per
+ *                processor (up to a limit).
+ *
+ * Sets the number of threads hashing files in parallel. Must be
+ * called before the @job is launched.
+ **/
+void
+thunar_duplicates_job_set_max_threads (ThunarDuplicatesJob *job,
+                                       guint                max_threads)
+{
+  _thunar_return_if_fail (THUNAR_IS_DUPLICATES_JOB (job));
+
+  job->max_threads = max_threads;
+}
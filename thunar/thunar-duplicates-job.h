@@ -0,0 +1,51 @@
+/* vi:set et ai sw=2 sts=2 ts=2: */
+/*-
+ * Copyright (c) 2026 The Xfce Development Team
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+ * Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef __THUNAR_DUPLICATES_JOB_H__
+#define __THUNAR_DUPLICATES_JOB_H__
+
+#include "thunar/thunar-job.h"
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS;
+
+typedef struct _ThunarDuplicatesJobClass ThunarDuplicatesJobClass;
+typedef struct _ThunarDuplicatesJob      ThunarDuplicatesJob;
+
+#define THUNAR_TYPE_DUPLICATES_JOB (thunar_duplicates_job_get_type ())
+#define THUNAR_DUPLICATES_JOB(obj) (G_TYPE_CHECK_INSTANCE_CAST ((obj), THUNAR_TYPE_DUPLICATES_JOB, ThunarDuplicatesJob))
+#define THUNAR_DUPLICATES_JOB_CLASS(klass) (G_TYPE_CHECK_CLASS_CAST ((klass), THUNAR_TYPE_DUPLICATES_JOB, ThunarDuplicatesJobClass))
+#define THUNAR_IS_DUPLICATES_JOB(obj) (G_TYPE_CHECK_INSTANCE_TYPE ((obj), THUNAR_TYPE_DUPLICATES_JOB))
+#define THUNAR_IS_DUPLICATES_JOB_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), THUNAR_TYPE_DUPLICATES_JOB))
+#define THUNAR_DUPLICATES_JOB_GET_CLASS(obj) (G_TYPE_INSTANCE_GET_CLASS ((obj), THUNAR_TYPE_DUPLICATES_JOB, ThunarDuplicatesJobClass))
+
+GType
+thunar_duplicates_job_get_type (void);
+
+ThunarDuplicatesJob *
+thunar_duplicates_job_new (GList *files) G_GNUC_MALLOC G_GNUC_WARN_UNUSED_RESULT;
+
+void
+thunar_duplicates_job_set_max_threads (ThunarDuplicatesJob *job,
+                                       guint                max_threads);
+
+G_END_DECLS;
+
+#endif /* !__THUNAR_DUPLICATES_JOB_H__ */
@@ -155,6 +155,7 @@ thunar_column_get_type (void)
         { THUNAR_COLUMN_SIZE,          "THUNAR_COLUMN_SIZE",          N_ ("Size"),          },
         { THUNAR_COLUMN_SIZE_IN_BYTES, "THUNAR_COLUMN_SIZE_IN_BYTES", N_ ("Size in Bytes"), },
         { THUNAR_COLUMN_TYPE,          "THUNAR_COLUMN_TYPE",          N_ ("Type"),          },
+        { THUNAR_COLUMN_TOTAL_SIZE,    "THUNAR_COLUMN_TOTAL_SIZE",    N_ ("Total Size"),    },
         { THUNAR_COLUMN_FILE,          "THUNAR_COLUMN_FILE",          N_ ("File"),          },
         { THUNAR_COLUMN_FILE_NAME,     "THUNAR_COLUMN_FILE_NAME",     N_ ("File Name"),     },
         { 0,                           NULL,                          NULL,                 },
@@ -314,6 +315,29 @@ thunar_recursive_search_get_type (void)
 }
 
 
+GType
+thunar_search_mode_get_type (void)
+{
+  static GType type = G_TYPE_INVALID;
+  if (G_UNLIKELY (type == G_TYPE_INVALID))
+    {
+      /* clang-format off */
+      static const GEnumValue values[] =
+        {
+          { THUNAR_SEARCH_MODE_SUBSTRING, "THUNAR_SEARCH_MODE_SUBSTRING", "substring", },
+          { THUNAR_SEARCH_MODE_GLOB,      "THUNAR_SEARCH_MODE_GLOB",      "glob",      },
+          { THUNAR_SEARCH_MODE_REGEX,     "THUNAR_SEARCH_MODE_REGEX",     "regex",     },
+          { 0,                            NULL,                           NULL,        },
+        };
+      /* clang-format on */
+
+      type = g_enum_register_static (I_ ("ThunarSearchMode"), values);
+    }
+
+  return type;
+}
+
+
 GType
 thunar_zoom_level_get_type (void)
 {
@@ -735,6 +759,55 @@ thunar_verify_file_get_type (void)
 
 
 
+GType
+thunar_reflink_mode_get_type (void)
+{
+  static GType type = G_TYPE_INVALID;
+
+  if (G_UNLIKELY (type == G_TYPE_INVALID))
+    {
+      /* clang-format off */
+      static const GEnumValue values[] =
+      {
+        { THUNAR_REFLINK_MODE_NEVER,  "THUNAR_REFLINK_MODE_NEVER",  N_("Never"),},
+        { THUNAR_REFLINK_MODE_AUTO,   "THUNAR_REFLINK_MODE_AUTO",   N_("If Supported"),},
+        { THUNAR_REFLINK_MODE_ALWAYS, "THUNAR_REFLINK_MODE_ALWAYS", N_("Always"),},
+        { 0,                          NULL,                         NULL,},
+      };
+      /* clang-format on */
+
+      type = g_enum_register_static (I_ ("ThunarReflinkMode"), values);
+    }
+
+  return type;
+}
+
+
+
+GType
+thunar_io_priority_get_type (void)
+{
+  static GType type = G_TYPE_INVALID;
+
+  if (G_UNLIKELY (type == G_TYPE_INVALID))
+    {
+      /* clang-format off */
+      static const GEnumValue values[] =
+      {
+        { THUNAR_IO_PRIORITY_NORMAL, "THUNAR_IO_PRIORITY_NORMAL", N_("Normal"),},
+        { THUNAR_IO_PRIORITY_IDLE,   "THUNAR_IO_PRIORITY_IDLE",   N_("Idle"),},
+        { 0,                         NULL,                        NULL,},
+      };
+      /* clang-format on */
+
+      type = g_enum_register_static (I_ ("ThunarIoPriority"), values);
+    }
+
+  return type;
+}
+
+
+
 /**
  * thunar_status_bar_info_toggle_bit:
  * @info   : a #guint.
@@ -105,6 +105,7 @@ thunar_date_style_get_type (void);
  * @THUNAR_COLUMN_SIZE          : file size.
  * @THUNAR_COLUMN_SIZE_IN_BYTES : file size in bytes.
  * @THUNAR_COLUMN_TYPE          : file type (e.g. 'plain text document').
+ * @THUNAR_COLUMN_TOTAL_SIZE    : recursive size of folders, file size otherwise.
  * @THUNAR_COLUMN_FILE          : #ThunarFile object.
  * @THUNAR_COLUMN_FILE_NAME     : real file name.
  *
@@ -128,6 +129,7 @@ typedef enum
   THUNAR_COLUMN_SIZE,
   THUNAR_COLUMN_SIZE_IN_BYTES,
   THUNAR_COLUMN_TYPE,
+  THUNAR_COLUMN_TOTAL_SIZE,
 
   /* special internal columns */
   THUNAR_COLUMN_FILE,
@@ -290,6 +292,28 @@ GType
 thunar_recursive_search_get_type (void);
 
 
+#define THUNAR_TYPE_SEARCH_MODE (thunar_search_mode_get_type ())
+
+/**
+ * ThunarSearchMode:
+ * @THUNAR_SEARCH_MODE_SUBSTRING : all whitespace separated terms must be contained in the name.
+ * @THUNAR_SEARCH_MODE_GLOB      : the query is a shell-style wildcard pattern (e.g. "*.log"),
+ *                                 patterns containing '/' are matched against the relative path.
+ * @THUNAR_SEARCH_MODE_REGEX     : the query is a Perl-compatible regular expression.
+ *
+ * How a search query is matched against file names.
+ **/
+typedef enum
+{
+  THUNAR_SEARCH_MODE_SUBSTRING,
+  THUNAR_SEARCH_MODE_GLOB,
+  THUNAR_SEARCH_MODE_REGEX,
+} ThunarSearchMode;
+
+GType
+thunar_search_mode_get_type (void);
+
+
 #define THUNAR_TYPE_ZOOM_LEVEL (thunar_zoom_level_get_type ())
 
 /**
@@ -446,6 +470,44 @@ thunar_verify_file_get_type (void);
 
 
 
+#define THUNAR_TYPE_REFLINK_MODE (thunar_reflink_mode_get_type ())
+
+/**
+ * ThunarReflinkMode:
+ * @THUNAR_REFLINK_MODE_NEVER  : Always copy the data of local files
+ * @THUNAR_REFLINK_MODE_AUTO   : Share the data of local files if the file system supports it
+ * @THUNAR_REFLINK_MODE_ALWAYS : Fail if the data of local files cannot be shared
+ **/
+typedef enum
+{
+  THUNAR_REFLINK_MODE_NEVER,
+  THUNAR_REFLINK_MODE_AUTO,
+  THUNAR_REFLINK_MODE_ALWAYS,
+} ThunarReflinkMode;
+
+GType
+thunar_reflink_mode_get_type (void);
+
+
+
+#define THUNAR_TYPE_IO_PRIORITY (thunar_io_priority_get_type ())
+
+/**
+ * ThunarIoPriority:
+ * @THUNAR_IO_PRIORITY_NORMAL : Transfer files with the priority of the rest of Thunar
+ * @THUNAR_IO_PRIORITY_IDLE   : Only access local disks when nothing else uses them
+ **/
+typedef enum
+{
+  THUNAR_IO_PRIORITY_NORMAL,
+  THUNAR_IO_PRIORITY_IDLE,
+} ThunarIoPriority;
+
+GType
+thunar_io_priority_get_type (void);
+
+
+
 /**
  * ThunarNewTabBehavior:
  * @THUNAR_NEW_TAB_BEHAVIOR_FOLLOW_PREFERENCE   : switching to the new tab or not is controlled by a preference.
@@ -238,6 +238,9 @@ struct _ThunarFile
    * there were > 10.000 files in a folder (Creation of #ThunarFolder seems to be slow) */
   guint   file_count;
   guint64 file_count_timestamp;
+
+  /* Recursive size of this directory in bytes, or -1 if it was not determined yet */
+  gint64 total_size;
 };
 
 typedef struct
@@ -452,6 +455,7 @@ thunar_file_init (ThunarFile *file)
 {
   file->file_count = 0;
   file->file_count_timestamp = 0;
+  file->total_size = -1;
   file->display_name = NULL;
   file->is_thumbnail = FALSE;
   for (gint i = 0; i < N_THUMBNAIL_SIZES; i++)
@@ -3724,6 +3728,48 @@ thunar_file_set_file_count (ThunarFile *file,
 }
 
 
+
+/**
+ * thunar_file_get_total_size
+ * @file: A #ThunarFileInstance
+ *
+ * Returns the recursive size of @file as determined by the last
+ * deep count of the directory, see thunar_file_set_total_size().
+ * For other files this is the size of the file itself.
+ *
+ * Return value: the size in bytes, or -1 if it is not known yet
+ **/
+gint64
+thunar_file_get_total_size (const ThunarFile *file)
+{
+  _thunar_return_val_if_fail (THUNAR_IS_FILE (file), -1);
+
+  if (!thunar_file_is_directory (file))
+    return thunar_file_get_size (file);
+
+  return file->total_size;
+}
+
+
+
+/**
+ * thunar_file_set_total_size
+ * @file: A #ThunarFileInstance
+ * @total_size: The recursive size of the directory in bytes
+ *
+ * Remembers the recursive size of @file if it is a directory, so
+ * all views of the directory can show it without counting again.
+ **/
+void
+thunar_file_set_total_size (ThunarFile *file,
+                            gint64      total_size)
+{
+  _thunar_return_if_fail (thunar_file_is_directory (file));
+
+  file->total_size = total_size;
+}
+
+
 /**
  * thunar_file_get_emblem_names:
  * @file : a #ThunarFile instance.
@@ -4926,6 +4972,7 @@ thunar_file_clear_directory_specific_settings (ThunarFile *file)
   g_file_info_remove_attribute (file->info, "metadata::thunar-zoom-level-ThunarDetailsView");
   g_file_info_remove_attribute (file->info, "metadata::thunar-zoom-level-ThunarIconView");
   g_file_info_remove_attribute (file->info, "metadata::thunar-zoom-level-ThunarCompactView");
+  g_file_info_remove_attribute (file->info, "metadata::thunar-zoom-level-ThunarTreemapView");
 
   g_file_set_attribute (file->gfile, "metadata::thunar-view-type", G_FILE_ATTRIBUTE_TYPE_INVALID,
                         NULL, G_FILE_QUERY_INFO_NONE, NULL, NULL);
@@ -4943,6 +4990,8 @@ thunar_file_clear_directory_specific_settings (ThunarFile *file)
                         NULL, G_FILE_QUERY_INFO_NONE, NULL, NULL);
   g_file_set_attribute (file->gfile, "metadata::thunar-zoom-level-ThunarCompactView", G_FILE_ATTRIBUTE_TYPE_INVALID,
                         NULL, G_FILE_QUERY_INFO_NONE, NULL, NULL);
+  g_file_set_attribute (file->gfile, "metadata::thunar-zoom-level-ThunarTreemapView", G_FILE_ATTRIBUTE_TYPE_INVALID,
+                        NULL, G_FILE_QUERY_INFO_NONE, NULL, NULL);
 
   thunar_file_changed (file);
 }
@@ -4981,6 +5030,8 @@ thunar_file_has_directory_specific_settings (ThunarFile *file)
     return TRUE;
   if (g_file_info_has_attribute (file->info, "metadata::thunar-zoom-level-ThunarCompactView"))
     return TRUE;
+  if (g_file_info_has_attribute (file->info, "metadata::thunar-zoom-level-ThunarTreemapView"))
+    return TRUE;
 
   return FALSE;
 }
@@ -5273,6 +5324,28 @@ thunar_cmp_files_by_size_in_bytes (const ThunarFile *a,
 
 
 
+gint
+thunar_cmp_files_by_total_size (const ThunarFile *a,
+                                const ThunarFile *b,
+                                gboolean          case_sensitive)
+{
+  gint64 size_a;
+  gint64 size_b;
+
+  /* directories which were not counted yet sort before everything else */
+  size_a = thunar_file_get_total_size (a);
+  size_b = thunar_file_get_total_size (b);
+
+  if (size_a < size_b)
+    return -1;
+  else if (size_a > size_b)
+    return 1;
+
+  return thunar_file_compare_by_name (a, b, case_sensitive);
+}
+
+
+
 gint
 thunar_cmp_files_by_size_and_items_count (ThunarFile *a,
                                           ThunarFile *b,
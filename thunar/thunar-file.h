@@ -332,6 +332,11 @@ thunar_file_get_file_count (ThunarFile *file,
 void
 thunar_file_set_file_count (ThunarFile *file,
                             const guint count);
+gint64
+thunar_file_get_total_size (const ThunarFile *file);
+void
+thunar_file_set_total_size (ThunarFile *file,
+                            gint64      total_size);
 
 GList *
 thunar_file_get_emblem_names (ThunarFile *file);
@@ -477,6 +482,10 @@ thunar_cmp_files_by_size_in_bytes (const ThunarFile *a,
                                    const ThunarFile *b,
                                    gboolean          case_sensitive);
 gint
+thunar_cmp_files_by_total_size (const ThunarFile *a,
+                                const ThunarFile *b,
+                                gboolean          case_sensitive);
+gint
 thunar_cmp_files_by_size_and_items_count (ThunarFile *a,
                                           ThunarFile *b,
                                           gboolean    case_sensitive);
@@ -18,6 +18,7 @@
  * Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include "thunar/thunar-deep-count-cache.h"
 #include "thunar/thunar-folder.h"
 #include "thunar/thunar-gobject-extensions.h"
 #include "thunar/thunar-io-jobs.h"
@@ -974,6 +975,10 @@ thunar_folder_monitor (GFileMonitor     *monitor,
       return;
     }
 
+  /* the contents changed, modifications of files don't necessarily
+   * update the modification time of the folder itself */
+  thunar_deep_count_cache_invalidate (thunar_file_get_file (folder->corresponding_file));
+
   /* For rename/delete it is important to only do lookup here, no ThunarFile creation */
   event_file_thunar = thunar_file_cache_lookup (event_file);
   other_file_thunar = (other_file == NULL) ? NULL : thunar_file_cache_lookup (other_file);
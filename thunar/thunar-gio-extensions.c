@@ -56,6 +56,7 @@
 
 #include "thunar/thunar-file.h"
 #include "thunar/thunar-gio-extensions.h"
+#include "thunar/thunar-io-copy.h"
 #include "thunar/thunar-preferences.h"
 #include "thunar/thunar-private.h"
 #include "thunar/thunar-util.h"
@@ -901,20 +902,120 @@ thunar_g_file_hastable_get_type (void)
 
 
 
+/* local regular files are copied (and verified) by Thunar, everything else by GIO */
+static gboolean
+thunar_g_file_copy_data (GFile                *source,
+                         GFile                *destination,
+                         GFileCopyFlags        flags,
+                         ThunarReflinkMode     reflink_mode,
+                         gboolean              verify,
+                         GCancellable         *cancellable,
+                         GFileProgressCallback progress_callback,
+                         gpointer              progress_callback_data,
+                         gchar               **checksum_return,
+                         GError              **error)
+{
+  GError *err = NULL;
+
+  if (thunar_io_copy_local_file (source, destination, flags, reflink_mode, verify, cancellable,
+                                 progress_callback, progress_callback_data, checksum_return, &err))
+    return TRUE;
+
+  if (!g_error_matches (err, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED))
+    {
+      g_propagate_error (error, err);
+      return FALSE;
+    }
+
+  g_error_free (err);
+
+  if (!g_file_copy (source, destination, flags, cancellable, progress_callback, progress_callback_data, error))
+    return FALSE;
+
+  /* GIO doesn't hand out the data, so both files have to be read again */
+  if (verify && !thunar_g_file_compare_contents (source, destination, cancellable, &err))
+    {
+      /* if the copied file is corrupted and yet no error */
+      if (err == NULL)
+        err = g_error_new (G_FILE_ERROR, G_FILE_ERROR_AGAIN, "Copied file does not match with the original");
+      g_propagate_error (error, err);
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
+
+
+/**
+ * thunar_g_file_get_partial:
+ * @destination : the destination #GFile of a copy.
+ *
+ * Returns the file a copy to @destination is written to first, if
+ * thunar_g_file_copy() is asked to use *.partial~ files.
+ *
+ * Return value: (transfer full): the *.partial~ #GFile.
+ **/
+GFile *
+thunar_g_file_get_partial (GFile *destination)
+{
+  GFile *parent;
+  GFile *partial;
+  gchar *partial_name;
+  gchar *base_name;
+
+  _thunar_return_val_if_fail (g_file_has_parent (destination, NULL), NULL);
+
+  base_name = g_file_get_basename (destination);
+  if (base_name == NULL)
+    {
+      base_name = g_strdup ("UNNAMED");
+    }
+
+  /* limit filename length */
+  partial_name = g_strdup_printf ("%.100s.partial~", base_name);
+  parent = g_file_get_parent (destination);
+
+  /* parent can't be NULL since destination must be a file */
+  partial = g_file_get_child (parent, partial_name);
+  g_object_unref (parent);
+  g_free (partial_name);
+  g_free (base_name);
+
+  return partial;
+}
+
+
+
 /**
  * thunar_g_file_copy:
  * @source                 : input #GFile
  * @destination            : destination #GFile
  * @flags                  : set of #GFileCopyFlags
  * @use_partial            : option to use *.partial~
+ * @keep_partial           : whether the *.partial~ of a cancelled copy is kept
+ * @resume_offset          : the bytes of an existing *.partial~ to continue from, or 0
+ * @reflink_mode           : whether copies of local files share the data of @source
+ * @verify                 : whether to verify the contents of a copied regular file
  * @cancellable            : (nullable): optional #GCancellable object
  * @progress_callback      : (nullable) (scope call): function to callback with progress information
  * @progress_callback_data : (clousure): user data to pass to @progress_callback
+ * @checksum_return        : (out) (optional): return location for the checksum of the data
  * @error                  : (nullable): #GError to set on error
  *
- * Calls g_file_copy() if @use_partial is not enabled.
- * If enabled, copies files to *.partial~ first and then
- * renames *.partial~ into its original name.
+ * Copies @source to @destination, see thunar_io_copy_local_file() for
+ * local regular files, g_file_copy() is used for everything else.
+ * If @use_partial is enabled, copies files to *.partial~ first and then
+ * renames *.partial~ into its original name. An existing *.partial~ left
+ * by an interrupted copy is continued after @resume_offset bytes if
+ * possible, see thunar_io_copy_resume_local_file(), or replaced otherwise.
+ * If @keep_partial is %TRUE, the *.partial~ is left behind when the copy
+ * is cancelled, so it can be continued later.
+ *
+ * The @checksum_return is only set for local regular files, it is left
+ * untouched for files copied by GIO. Those are verified by comparing the
+ * contents of both files after the copy, so @verify must only be set for
+ * regular files.
  *
  * Return value: %TRUE on success, %FALSE otherwise.
  **/
@@ -923,18 +1024,23 @@ thunar_g_file_copy (GFile                *source,
                     GFile                *destination,
                     GFileCopyFlags        flags,
                     gboolean              use_partial,
+                    gboolean              keep_partial,
+                    goffset               resume_offset,
+                    ThunarReflinkMode     reflink_mode,
+                    gboolean              verify,
                     GCancellable         *cancellable,
                     GFileProgressCallback progress_callback,
                     gpointer              progress_callback_data,
+                    gchar               **checksum_return,
                     GError              **error)
 {
-  gboolean            success;
+  gboolean            success = FALSE;
+  gboolean            resumed = FALSE;
   GFileQueryInfoFlags query_flags;
   GFileInfo          *info = NULL;
-  GFile              *parent;
   GFile              *partial;
-  gchar              *partial_name;
   gchar              *base_name;
+  GError             *err = NULL;
 
   _thunar_return_val_if_fail (g_file_has_parent (destination, NULL), FALSE);
 
@@ -961,7 +1067,8 @@ thunar_g_file_copy (GFile                *source,
 
   if (!use_partial)
     {
-      success = g_file_copy (source, destination, flags, cancellable, progress_callback, progress_callback_data, error);
+      success = thunar_g_file_copy_data (source, destination, flags, reflink_mode, verify, cancellable,
+                                         progress_callback, progress_callback_data, checksum_return, error);
       return success;
     }
 
@@ -988,28 +1095,36 @@ thunar_g_file_copy (GFile                *source,
         }
     }
 
-  /* generate partial file name */
   base_name = g_file_get_basename (destination);
   if (base_name == NULL)
     {
       base_name = g_strdup ("UNNAMED");
     }
 
-  /* limit filename length */
-  partial_name = g_strdup_printf ("%.100s.partial~", base_name);
-  parent = g_file_get_parent (destination);
+  partial = thunar_g_file_get_partial (destination);
 
-  /* parent can't be NULL since destination must be a file */
-  partial = g_file_get_child (parent, partial_name);
-  g_clear_object (&parent);
-  g_free (partial_name);
+  /* continue an interrupted copy, if the partial file is still there */
+  if (resume_offset > 0)
+    {
+      success = thunar_io_copy_resume_local_file (source, partial, resume_offset, flags, verify, cancellable,
+                                                  progress_callback, progress_callback_data, checksum_return, &err);
+      resumed = success || !g_error_matches (err, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED);
+      if (resumed && err != NULL)
+        g_propagate_error (error, err);
+      else
+        g_clear_error (&err);
+    }
 
-  /* check if partial file exists */
-  if (g_file_query_exists (partial, NULL))
-    g_file_delete (partial, NULL, error);
+  if (!resumed)
+    {
+      /* check if partial file exists */
+      if (g_file_query_exists (partial, NULL))
+        g_file_delete (partial, NULL, error);
 
-  /* copy file to .partial */
-  success = g_file_copy (source, partial, flags, cancellable, progress_callback, progress_callback_data, error);
+      /* copy file to .partial */
+      success = thunar_g_file_copy_data (source, partial, flags, reflink_mode, verify, cancellable,
+                                         progress_callback, progress_callback_data, checksum_return, error);
+    }
 
   if (success)
     {
@@ -1018,9 +1133,11 @@ thunar_g_file_copy (GFile                *source,
       success = (renamed_file != NULL);
       if (success)
         g_object_unref (renamed_file);
+      else if (checksum_return != NULL)
+        g_clear_pointer (checksum_return, g_free);
     }
 
-  if (!success)
+  if (!success && !(keep_partial && g_cancellable_is_cancelled (cancellable)))
     {
       /* try to remove incomplete file. */
       /* failure is expected so error is ignored */
@@ -1303,6 +1420,74 @@ thunar_g_file_compare_contents (GFile        *file_a,
 
 
 
+/**
+ * thunar_g_file_compute_checksum:
+ * @file          : a #GFile
+ * @checksum_type : the #GChecksumType to compute
+ * @cancellable   : (nullable): optional #GCancellable object
+ * @error         : (nullable): optional #GError
+ *
+ * Reads the whole @file and computes its checksum. Local files are read
+ * with direct I/O where supported, so a file that was just written is
+ * read back from the disk and not from the kernel's buffer cache.
+ *
+ * Return value: (transfer full) (nullable): the checksum as hexadecimal
+ *               string, or %NULL on error.
+ **/
+gchar *
+thunar_g_file_compute_checksum (GFile        *file,
+                                GChecksumType checksum_type,
+                                GCancellable *cancellable,
+                                GError      **error)
+{
+  GInputStream *inp = NULL;
+  GChecksum    *checksum;
+  void         *buf = NULL;
+  unsigned int  buf_align = 0;
+  size_t        buf_size = 0;
+  gsize         bytes_read;
+  gchar        *result = NULL;
+
+  g_return_val_if_fail (G_IS_FILE (file), NULL);
+  g_return_val_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable), NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+#ifdef HAVE_DIRECT_IO
+  if (g_file_has_uri_scheme (file, "file"))
+    inp = open_file_and_buffer_for_direct_io (file, cancellable, &buf, &buf_align, &buf_size);
+#endif
+
+  if (inp == NULL)
+    inp = open_file_and_buffer_fallback (file, cancellable, &buf, &buf_align, &buf_size, error);
+
+  if (inp == NULL)
+    return NULL;
+
+  checksum = g_checksum_new (checksum_type);
+
+  for (;;)
+    {
+      if (!g_input_stream_read_all (inp, buf, buf_size, &bytes_read, cancellable, error))
+        break;
+
+      if (bytes_read == 0)
+        {
+          result = g_strdup (g_checksum_get_string (checksum));
+          break;
+        }
+
+      g_checksum_update (checksum, buf, bytes_read);
+    }
+
+  g_checksum_free (checksum);
+  g_object_unref (inp);
+  free (buf);
+
+  return result;
+}
+
+
+
 /**
  * thunar_g_file_list_new_from_string:
  * @string : a string representation of a URI list.
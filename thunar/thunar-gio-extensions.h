@@ -21,6 +21,8 @@
 #ifndef __THUNAR_GIO_EXTENSIONS_H__
 #define __THUNAR_GIO_EXTENSIONS_H__
 
+#include "thunar/thunar-enum-types.h"
+
 #include <gio/gio.h>
 
 G_BEGIN_DECLS
@@ -121,14 +123,22 @@ gchar *
 thunar_g_file_get_free_space_string (const ThunarFilesystemSpaceInfo *fs_space_info,
                                      gboolean                         file_size_binary);
 
+GFile *
+thunar_g_file_get_partial (GFile *destination);
+
 gboolean
 thunar_g_file_copy (GFile                *source,
                     GFile                *destination,
                     GFileCopyFlags        flags,
                     gboolean              use_partial,
+                    gboolean              keep_partial,
+                    goffset               resume_offset,
+                    ThunarReflinkMode     reflink_mode,
+                    gboolean              verify,
                     GCancellable         *cancellable,
                     GFileProgressCallback progress_callback,
                     gpointer              progress_callback_data,
+                    gchar               **checksum_return,
                     GError              **error);
 
 gboolean
@@ -137,6 +147,12 @@ thunar_g_file_compare_contents (GFile        *file_a,
                                 GCancellable *cancellable,
                                 GError      **error);
 
+gchar *
+thunar_g_file_compute_checksum (GFile        *file,
+                                GChecksumType checksum_type,
+                                GCancellable *cancellable,
+                                GError      **error);
+
 /**
  * THUNAR_TYPE_G_FILE_LIST:
  *
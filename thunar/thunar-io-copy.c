@@ -0,0 +1,1140 @@
+/* vi:set et ai sw=2 sts=2 ts=2: */
+/*-
+ * Copyright (c) 2026 The Xfce Development Team
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+ * Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifdef __linux__
+#define _GNU_SOURCE
+#endif
+
+#ifdef HAVE_ERRNO_H
+#include <errno.h>
+#endif
+#ifdef HAVE_FCNTL_H
+#include <fcntl.h>
+#endif
+#ifdef HAVE_LINUX_FS_H
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+#ifdef HAVE_SYS_STAT_H
+#include <sys/stat.h>
+#endif
+#ifdef HAVE_SYS_SYSCALL_H
+#include <sys/syscall.h>
+#endif
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+#include "thunar/thunar-gio-extensions.h"
+#include "thunar/thunar-io-copy.h"
+#include "thunar/thunar-private.h"
+
+#include <libxfce4util/libxfce4util.h>
+
+
+
+/* bytes copied by a single copy_file_range() call, small enough to
+ * report progress and to react on cancellation in time */
+#define THUNAR_IO_COPY_RANGE_SIZE (8 * 1024 * 1024)
+
+/* size of the buffer if the data is read and written by us */
+#define THUNAR_IO_COPY_BUFFER_SIZE (256 * 1024)
+
+/* holes are added to the checksum in chunks of this size */
+#define THUNAR_IO_COPY_ZEROS_SIZE (64 * 1024)
+
+/* smaller files are not preallocated, they fit into a few extents anyway */
+#define THUNAR_IO_COPY_PREALLOCATE_MIN_SIZE (1024 * 1024)
+
+/* ioprio_set(2) has no wrapper in the C library, see linux/ioprio.h */
+#if defined(HAVE_SYS_SYSCALL_H) && defined(SYS_ioprio_set) && defined(SYS_ioprio_get)
+#define THUNAR_IO_COPY_HAVE_IOPRIO 1
+#define THUNAR_IO_COPY_IOPRIO_WHO_PROCESS 1
+#define THUNAR_IO_COPY_IOPRIO_CLASS_SHIFT 13
+#define THUNAR_IO_COPY_IOPRIO_CLASS_IDLE 3
+#endif
+
+
+
+typedef struct _ThunarIoCopy ThunarIoCopy;
+
+
+
+static gboolean
+thunar_io_copy_clone (gint source_fd,
+                      gint destination_fd);
+static gboolean
+thunar_io_copy_pwrite_all (gint         fd,
+                           const gchar *buffer,
+                           gsize        length,
+                           goffset      offset);
+static void
+thunar_io_copy_checksum_update (ThunarIoCopy *copy,
+                                const gchar  *data,
+                                gsize         length,
+                                goffset       offset);
+static gboolean
+thunar_io_copy_preallocate (ThunarIoCopy *copy,
+                            goffset       offset,
+                            GError      **error);
+static gboolean
+thunar_io_copy_range (ThunarIoCopy *copy,
+                      goffset       offset,
+                      goffset       end,
+                      GError      **error);
+static gboolean
+thunar_io_copy_sparse (ThunarIoCopy *copy,
+                       goffset       offset,
+                       GError      **error);
+static gboolean
+thunar_io_copy_drop_cache (gint         fd,
+                           const gchar *path,
+                           GError     **error);
+
+
+
+/* state of a copy which is not done as a reflink */
+struct _ThunarIoCopy
+{
+  gint    source_fd;
+  gint    destination_fd;
+  GFile  *destination;
+
+  /* the logical size of the source, including holes */
+  goffset size;
+
+  /* the number of bytes actually copied, excluding holes */
+  goffset n_copied;
+
+  /* whether copy_file_range() is used, or read() and write() */
+  gboolean use_copy_range;
+  gchar   *buffer;
+
+  /* the checksum of the data up to checksum_offset, or %NULL if no
+   * checksum is computed, which requires the data to pass through us */
+  GChecksum *checksum;
+  goffset    checksum_offset;
+
+  GCancellable         *cancellable;
+  GFileProgressCallback progress_callback;
+  gpointer              progress_callback_data;
+};
+
+
+
+static gboolean
+thunar_io_copy_clone (gint source_fd,
+                      gint destination_fd)
+{
+#if defined(HAVE_LINUX_FS_H) && defined(FICLONE)
+  return ioctl (destination_fd, FICLONE, source_fd) == 0;
+#else
+  return FALSE;
+#endif
+}
+
+
+
+static gboolean
+thunar_io_copy_pwrite_all (gint         fd,
+                           const gchar *buffer,
+                           gsize        length,
+                           goffset      offset)
+{
+  gssize n;
+
+  while (length > 0)
+    {
+      n = pwrite (fd, buffer, length, offset);
+      if (n < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          return FALSE;
+        }
+
+      buffer += n;
+      length -= n;
+      offset += n;
+    }
+
+  return TRUE;
+}
+
+
+
+/* adds @length bytes of @data at @offset to the checksum, the holes skipped
+ * before @offset are added as zeros since that's what is read back */
+static void
+thunar_io_copy_checksum_update (ThunarIoCopy *copy,
+                                const gchar  *data,
+                                gsize         length,
+                                goffset       offset)
+{
+  static const guchar zeros[THUNAR_IO_COPY_ZEROS_SIZE] = { 0 };
+  gsize               n;
+
+  while (copy->checksum_offset < offset)
+    {
+      n = MIN (THUNAR_IO_COPY_ZEROS_SIZE, offset - copy->checksum_offset);
+      g_checksum_update (copy->checksum, zeros, n);
+      copy->checksum_offset += n;
+    }
+
+  if (length > 0)
+    {
+      g_checksum_update (copy->checksum, (const guchar *) data, length);
+      copy->checksum_offset += length;
+    }
+}
+
+
+
+/* allocates the blocks of the destination from @offset up to the size of the
+ * source before the data is copied, so the file system can lay out the copy
+ * contiguously and a full disk is reported before any data is written */
+static gboolean
+thunar_io_copy_preallocate (ThunarIoCopy *copy,
+                            goffset       offset,
+                            GError      **error)
+{
+#if defined(HAVE_FALLOCATE) && defined(FALLOC_FL_KEEP_SIZE)
+  gint result;
+
+  if (copy->size - offset < THUNAR_IO_COPY_PREALLOCATE_MIN_SIZE)
+    return TRUE;
+
+  /* the size grows while the data is written, so a source which is
+   * truncated meanwhile leaves no zeros at the end of the copy */
+  do
+    result = fallocate (copy->destination_fd, FALLOC_FL_KEEP_SIZE, offset, copy->size - offset);
+  while (result != 0 && errno == EINTR);
+
+  /* file systems which cannot preallocate are written as before */
+  if (result != 0 && errno == ENOSPC)
+    {
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_NO_SPACE,
+                   _("Error writing to file \"%s\": %s"),
+                   g_file_peek_path (copy->destination), g_strerror (errno));
+      return FALSE;
+    }
+#endif
+
+  return TRUE;
+}
+
+
+
+/* copies the data from @offset up to @end, or the end of the file if @end is -1,
+ * to the same offset in the destination */
+static gboolean
+thunar_io_copy_range (ThunarIoCopy *copy,
+                      goffset       offset,
+                      goffset       end,
+                      GError      **error)
+{
+  gsize  length;
+  gssize n;
+
+  while (end < 0 || offset < end)
+    {
+      if (g_cancellable_set_error_if_cancelled (copy->cancellable, error))
+        return FALSE;
+
+#ifdef HAVE_COPY_FILE_RANGE
+      if (copy->use_copy_range)
+        {
+          loff_t source_offset = offset;
+          loff_t destination_offset = offset;
+
+          /* let the kernel (or the server of a network file system) copy the data */
+          length = (end < 0) ? THUNAR_IO_COPY_RANGE_SIZE : MIN (THUNAR_IO_COPY_RANGE_SIZE, end - offset);
+          n = copy_file_range (copy->source_fd, &source_offset, copy->destination_fd, &destination_offset, length, 0);
+
+          /* not supported between these files, or a file that doesn't report its size
+           * (like the ones in /proc), copy the data ourselves */
+          if (copy->n_copied == 0 && (n == 0 || (n < 0 && (errno == EXDEV || errno == EINVAL || errno == ENOSYS || errno == EOPNOTSUPP))))
+            {
+              copy->use_copy_range = FALSE;
+              continue;
+            }
+        }
+      else
+#endif
+        {
+          if (copy->buffer == NULL)
+            copy->buffer = g_malloc (THUNAR_IO_COPY_BUFFER_SIZE);
+
+          length = (end < 0) ? THUNAR_IO_COPY_BUFFER_SIZE : MIN (THUNAR_IO_COPY_BUFFER_SIZE, end - offset);
+          n = pread (copy->source_fd, copy->buffer, length, offset);
+          if (n > 0 && !thunar_io_copy_pwrite_all (copy->destination_fd, copy->buffer, n, offset))
+            n = -1;
+        }
+
+      if (n < 0)
+        {
+          if (errno == EINTR)
+            continue;
+
+          g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errno),
+                       _("Error writing to file \"%s\": %s"),
+                       g_file_peek_path (copy->destination), g_strerror (errno));
+          return FALSE;
+        }
+
+      /* end of the file, it might have been truncated meanwhile */
+      if (n == 0)
+        break;
+
+      if (copy->checksum != NULL)
+        thunar_io_copy_checksum_update (copy, copy->buffer, n, offset);
+
+      offset += n;
+      copy->n_copied += n;
+
+      /* the progress counts logical bytes, so skipped holes are included */
+      if (copy->progress_callback != NULL)
+        copy->progress_callback (offset, MAX (offset, copy->size), copy->progress_callback_data);
+    }
+
+  return TRUE;
+}
+
+
+
+/* copies only the data extents of a sparse file from @offset on, the holes
+ * in between are not written and stay holes in the destination */
+static gboolean
+thunar_io_copy_sparse (ThunarIoCopy *copy,
+                       goffset       offset,
+                       GError      **error)
+{
+#if defined(SEEK_DATA) && defined(SEEK_HOLE)
+  goffset data;
+  goffset hole = offset;
+
+  while (hole < copy->size)
+    {
+      data = lseek (copy->source_fd, hole, SEEK_DATA);
+      if (data < 0)
+        {
+          /* no more data after the last hole */
+          if (errno == ENXIO)
+            break;
+
+          /* the file system doesn't know about holes */
+          if (hole == offset && errno == EINVAL)
+            return thunar_io_copy_range (copy, offset, -1, error);
+
+          goto failed;
+        }
+
+      if (data >= copy->size)
+        break;
+
+      /* there is always an implicit hole at the end of the file */
+      hole = lseek (copy->source_fd, data, SEEK_HOLE);
+      if (hole < 0)
+        goto failed;
+      hole = MIN (hole, copy->size);
+
+      if (!thunar_io_copy_range (copy, data, hole, error))
+        return FALSE;
+    }
+
+  /* recreate a hole at the end of the file */
+  if (ftruncate (copy->destination_fd, copy->size) != 0)
+    goto failed;
+
+  if (copy->checksum != NULL)
+    thunar_io_copy_checksum_update (copy, NULL, 0, copy->size);
+
+  if (copy->progress_callback != NULL)
+    copy->progress_callback (copy->size, copy->size, copy->progress_callback_data);
+
+  return TRUE;
+
+failed:
+  g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errno),
+               _("Error writing to file \"%s\": %s"),
+               g_file_peek_path (copy->destination), g_strerror (errno));
+  return FALSE;
+#else
+  return thunar_io_copy_range (copy, offset, -1, error);
+#endif
+}
+
+
+
+/* writes the copy to the disk and drops it from the page cache, so
+ * it is read back from the disk when it is verified */
+static gboolean
+thunar_io_copy_drop_cache (gint         fd,
+                           const gchar *path,
+                           GError     **error)
+{
+  /* some file systems cannot be synced, there is nothing to flush then */
+  if (fsync (fd) != 0 && errno != EINVAL)
+    {
+      g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errno),
+                   _("Error writing to file \"%s\": %s"),
+                   path, g_strerror (errno));
+      return FALSE;
+    }
+
+#ifdef HAVE_POSIX_FADVISE
+  /* only clean pages are dropped, which all are after the sync */
+  posix_fadvise (fd, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+
+  return TRUE;
+}
+
+
+
+/**
+ * thunar_io_copy_local_file:
+ * @source                 : the #GFile to copy.
+ * @destination            : the #GFile of the copy.
+ * @flags                  : set of #GFileCopyFlags.
+ * @reflink_mode           : whether the copy shares the data of @source.
+ * @verify                 : whether to verify the contents of the copy.
+ * @cancellable            : (nullable): optional #GCancellable object.
+ * @progress_callback      : (nullable) (scope call): function to callback with progress information.
+ * @progress_callback_data : (closure): user data to pass to @progress_callback.
+ * @checksum_return        : (out) (optional): return location for the checksum of the data.
+ * @error                  : (nullable): #GError to set on error.
+ *
+ * Copies a local regular file without going through GIO's streams. The
+ * copy shares the data of @source if the file system supports it
+ * (reflink), depending on @reflink_mode. Otherwise the data is copied with
+ * copy_file_range(), which lets file systems like NFS or CIFS copy on the
+ * server, or read and written by Thunar if @reflink_mode is
+ * %THUNAR_REFLINK_MODE_NEVER. Holes of sparse files are preserved, other
+ * copies are preallocated with fallocate() if the file system supports it,
+ * so a full disk is reported with %G_IO_ERROR_NO_SPACE before any data is
+ * written.
+ *
+ * If %G_FILE_COPY_OVERWRITE is in @flags, the data is copied into a
+ * temporary file next to @destination, which replaces @destination once
+ * the copy is complete, so the file to overwrite survives a failed copy.
+ *
+ * If @verify is %TRUE, the checksum of the data is computed while it is
+ * copied and compared to the checksum of the copy read back afterwards,
+ * so the source is only read once. The copy is written to the disk and
+ * dropped from the page cache before, so it is read back from the disk.
+ * A copy sharing the data of @source is not compared, since both read
+ * the same blocks. A copy that doesn't match is removed and reported as
+ * %G_FILE_ERROR_AGAIN.
+ *
+ * If @checksum_return is not %NULL, it is set to the checksum of type
+ * %THUNAR_IO_COPY_CHECKSUM_TYPE on success. Computing the checksum needs
+ * the data to pass through Thunar, so copy_file_range() is not used then.
+ *
+ * Files which are not handled here (remote or not regular files) are
+ * reported with %G_IO_ERROR_NOT_SUPPORTED before the @destination is
+ * touched, those have to be copied with g_file_copy() instead.
+ *
+ * Return value: %TRUE on success, %FALSE otherwise.
+ **/
+gboolean
+thunar_io_copy_local_file (GFile                *source,
+                           GFile                *destination,
+                           GFileCopyFlags        flags,
+                           ThunarReflinkMode     reflink_mode,
+                           gboolean              verify,
+                           GCancellable         *cancellable,
+                           GFileProgressCallback progress_callback,
+                           gpointer              progress_callback_data,
+                           gchar               **checksum_return,
+                           GError              **error)
+{
+  struct stat  source_stat;
+  struct stat  destination_stat;
+  const gchar *source_path;
+  const gchar *destination_path;
+  gchar       *target_path;
+  gchar       *dirname;
+  gchar       *basename;
+  gchar       *template;
+  gchar       *checksum = NULL;
+  gchar       *destination_checksum;
+  GFile       *target;
+  gboolean     success;
+  gboolean     cloned = FALSE;
+  gint         source_fd;
+  gint         destination_fd;
+  gint         open_flags;
+
+  _thunar_return_val_if_fail (G_IS_FILE (source), FALSE);
+  _thunar_return_val_if_fail (G_IS_FILE (destination), FALSE);
+  _thunar_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+  source_path = g_file_peek_path (source);
+  destination_path = g_file_peek_path (destination);
+
+  /* backups are left to GIO */
+  if (source_path == NULL || destination_path == NULL || (flags & G_FILE_COPY_BACKUP) != 0)
+    goto not_supported;
+
+  /* symlinks, directories and special files are copied by GIO, don't
+   * even open those since opening a FIFO would block */
+  open_flags = O_RDONLY | O_CLOEXEC;
+  if ((flags & G_FILE_COPY_NOFOLLOW_SYMLINKS) != 0)
+    {
+      open_flags |= O_NOFOLLOW;
+      if (lstat (source_path, &source_stat) != 0 || !S_ISREG (source_stat.st_mode))
+        goto not_supported;
+    }
+  else if (stat (source_path, &source_stat) != 0 || !S_ISREG (source_stat.st_mode))
+    goto not_supported;
+
+  source_fd = open (source_path, open_flags);
+  if (source_fd < 0)
+    {
+      g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errno),
+                   _("Error opening file \"%s\": %s"),
+                   source_path, g_strerror (errno));
+      return FALSE;
+    }
+
+  if (fstat (source_fd, &source_stat) != 0 || !S_ISREG (source_stat.st_mode))
+    {
+      close (source_fd);
+      goto not_supported;
+    }
+
+  if ((flags & G_FILE_COPY_OVERWRITE) != 0)
+    {
+      /* folders in the way are reported by GIO */
+      if (lstat (destination_path, &destination_stat) == 0 && S_ISDIR (destination_stat.st_mode))
+        {
+          close (source_fd);
+          goto not_supported;
+        }
+
+      /* the file to overwrite is only replaced once the copy is complete, like
+       * GIO does, so it survives a failed or cancelled copy */
+      dirname = g_path_get_dirname (destination_path);
+      basename = g_path_get_basename (destination_path);
+      template = g_strdup_printf (".%s.XXXXXX", basename);
+      target_path = g_build_filename (dirname, template, NULL);
+      g_free (template);
+      g_free (basename);
+      g_free (dirname);
+
+      destination_fd = g_mkstemp_full (target_path, O_WRONLY | O_CLOEXEC, source_stat.st_mode & 0777);
+      target = g_file_new_for_path (target_path);
+    }
+  else
+    {
+      /* like GIO, fail if the destination exists */
+      target_path = g_strdup (destination_path);
+      destination_fd = open (target_path, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC | O_NOFOLLOW, source_stat.st_mode & 0777);
+      target = g_object_ref (destination);
+    }
+
+  if (destination_fd < 0)
+    {
+      g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errno),
+                   _("Error opening file \"%s\": %s"),
+                   destination_path, g_strerror (errno));
+      close (source_fd);
+      g_object_unref (target);
+      g_free (target_path);
+      return FALSE;
+    }
+
+  if (reflink_mode != THUNAR_REFLINK_MODE_NEVER && thunar_io_copy_clone (source_fd, destination_fd))
+    {
+      success = TRUE;
+      cloned = TRUE;
+
+      if (progress_callback != NULL)
+        progress_callback (source_stat.st_size, source_stat.st_size, progress_callback_data);
+    }
+  else if (reflink_mode == THUNAR_REFLINK_MODE_ALWAYS)
+    {
+      success = FALSE;
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_FAILED,
+                   _("The file system does not support sharing the data of \"%s\" with a copy"),
+                   source_path);
+    }
+  else
+    {
+      ThunarIoCopy copy = { 0 };
+
+      copy.source_fd = source_fd;
+      copy.destination_fd = destination_fd;
+      copy.destination = destination;
+      copy.size = source_stat.st_size;
+      copy.cancellable = cancellable;
+      copy.progress_callback = progress_callback;
+      copy.progress_callback_data = progress_callback_data;
+
+      if (verify || checksum_return != NULL)
+        copy.checksum = g_checksum_new (THUNAR_IO_COPY_CHECKSUM_TYPE);
+
+      /* copy_file_range() may share the data as well, so it is not used in "never" mode */
+      copy.use_copy_range = (reflink_mode == THUNAR_REFLINK_MODE_AUTO && copy.checksum == NULL);
+
+      /* files with less blocks allocated than their size have holes, which
+       * must not be allocated in the copy */
+      if (source_stat.st_blocks < source_stat.st_size / 512)
+        success = thunar_io_copy_sparse (&copy, 0, error);
+      else
+        success = (thunar_io_copy_preallocate (&copy, 0, error)
+                   && thunar_io_copy_range (&copy, 0, -1, error));
+
+      if (success && copy.checksum != NULL)
+        checksum = g_strdup (g_checksum_get_string (copy.checksum));
+
+      g_clear_pointer (&copy.checksum, g_checksum_free);
+      g_free (copy.buffer);
+    }
+
+  close (source_fd);
+
+  if (success && verify && !cloned)
+    success = thunar_io_copy_drop_cache (destination_fd, destination_path, error);
+
+  /* network file systems may only report write errors on close */
+  if (close (destination_fd) != 0 && success)
+    {
+      success = FALSE;
+      g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errno),
+                   _("Error writing to file \"%s\": %s"),
+                   destination_path, g_strerror (errno));
+    }
+
+  if (success && cloned && checksum_return != NULL)
+    {
+      /* the copy shares the data of the source, so both have the same checksum */
+      checksum = thunar_g_file_compute_checksum (source, THUNAR_IO_COPY_CHECKSUM_TYPE, cancellable, error);
+      success = (checksum != NULL);
+    }
+
+  if (success && verify && !cloned)
+    {
+      /* read the copy back from the disk */
+      destination_checksum = thunar_g_file_compute_checksum (target, THUNAR_IO_COPY_CHECKSUM_TYPE, cancellable, error);
+      if (destination_checksum == NULL)
+        success = FALSE;
+      else if (strcmp (checksum, destination_checksum) != 0)
+        {
+          success = FALSE;
+          g_set_error_literal (error, G_FILE_ERROR, G_FILE_ERROR_AGAIN,
+                               "Copied file does not match with the original");
+        }
+      g_free (destination_checksum);
+    }
+
+  if (success && strcmp (target_path, destination_path) != 0 && rename (target_path, destination_path) != 0)
+    {
+      success = FALSE;
+      g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errno),
+                   _("Error writing to file \"%s\": %s"),
+                   destination_path, g_strerror (errno));
+    }
+
+  g_object_unref (target);
+
+  if (!success)
+    {
+      /* don't leave an incomplete (or corrupted) copy behind, the file to
+       * overwrite, if any, was not touched */
+      unlink (target_path);
+      g_free (target_path);
+      g_free (checksum);
+      return FALSE;
+    }
+
+  g_free (target_path);
+
+  /* copy permissions (or all metadata) like GIO, failing to do so is not an error */
+  g_file_copy_attributes (source, destination, flags, cancellable, NULL);
+
+  if (checksum_return != NULL)
+    *checksum_return = checksum;
+  else
+    g_free (checksum);
+
+  return TRUE;
+
+not_supported:
+  g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED,
+                       "Not a local regular file");
+  return FALSE;
+}
+
+
+
+/**
+ * thunar_io_copy_resume_local_file:
+ * @source                 : the #GFile to copy.
+ * @destination            : the incomplete copy of @source.
+ * @offset                 : the number of bytes known to be copied already.
+ * @flags                  : set of #GFileCopyFlags.
+ * @verify                 : whether to verify the contents of the copy.
+ * @cancellable            : (nullable): optional #GCancellable object.
+ * @progress_callback      : (nullable) (scope call): function to callback with progress information.
+ * @progress_callback_data : (closure): user data to pass to @progress_callback.
+ * @checksum_return        : (out) (optional): return location for the checksum of the data.
+ * @error                  : (nullable): #GError to set on error.
+ *
+ * Continues an interrupted copy of a local regular file, copying the data
+ * after @offset. Whatever was written to @destination beyond @offset is
+ * discarded, since it might not have reached the disk.
+ *
+ * The first @offset bytes don't pass through Thunar again, so if @verify
+ * is %TRUE or a checksum is requested, both files are read back once the
+ * copy is complete, the copy from the disk if @verify is %TRUE. A copy
+ * that doesn't match is removed and reported as %G_FILE_ERROR_AGAIN. The
+ * @destination of a cancelled copy is kept, so it can be continued later,
+ * it is up to the caller to delete it.
+ *
+ * If the copy cannot be continued (remote files, or a @destination shorter
+ * than @offset), %G_IO_ERROR_NOT_SUPPORTED is reported before the
+ * @destination is touched, and the file has to be copied from the start.
+ *
+ * Return value: %TRUE on success, %FALSE otherwise.
+ **/
+gboolean
+thunar_io_copy_resume_local_file (GFile                *source,
+                                  GFile                *destination,
+                                  goffset               offset,
+                                  GFileCopyFlags        flags,
+                                  gboolean              verify,
+                                  GCancellable         *cancellable,
+                                  GFileProgressCallback progress_callback,
+                                  gpointer              progress_callback_data,
+                                  gchar               **checksum_return,
+                                  GError              **error)
+{
+  ThunarIoCopy copy = { 0 };
+  struct stat  source_stat;
+  struct stat  destination_stat;
+  const gchar *source_path;
+  const gchar *destination_path;
+  gchar       *checksum = NULL;
+  gchar       *source_checksum;
+  gboolean     success;
+  gint         source_fd;
+  gint         destination_fd;
+
+  _thunar_return_val_if_fail (G_IS_FILE (source), FALSE);
+  _thunar_return_val_if_fail (G_IS_FILE (destination), FALSE);
+  _thunar_return_val_if_fail (offset >= 0, FALSE);
+  _thunar_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+  source_path = g_file_peek_path (source);
+  destination_path = g_file_peek_path (destination);
+  if (source_path == NULL || destination_path == NULL)
+    goto not_supported;
+
+  source_fd = open (source_path, O_RDONLY | O_CLOEXEC | (((flags & G_FILE_COPY_NOFOLLOW_SYMLINKS) != 0) ? O_NOFOLLOW : 0));
+  if (source_fd < 0)
+    {
+      g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errno),
+                   _("Error opening file \"%s\": %s"),
+                   source_path, g_strerror (errno));
+      return FALSE;
+    }
+
+  destination_fd = open (destination_path, O_WRONLY | O_CLOEXEC | O_NOFOLLOW);
+  if (destination_fd < 0)
+    {
+      close (source_fd);
+      goto not_supported;
+    }
+
+  /* the data up to the offset must still be there */
+  if (fstat (source_fd, &source_stat) != 0 || !S_ISREG (source_stat.st_mode)
+      || fstat (destination_fd, &destination_stat) != 0 || !S_ISREG (destination_stat.st_mode)
+      || destination_stat.st_size < offset || source_stat.st_size < offset)
+    {
+      close (destination_fd);
+      close (source_fd);
+      goto not_supported;
+    }
+
+  copy.source_fd = source_fd;
+  copy.destination_fd = destination_fd;
+  copy.destination = destination;
+  copy.size = source_stat.st_size;
+  copy.use_copy_range = TRUE;
+  copy.cancellable = cancellable;
+  copy.progress_callback = progress_callback;
+  copy.progress_callback_data = progress_callback_data;
+
+  if (ftruncate (destination_fd, offset) != 0)
+    {
+      success = FALSE;
+      g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errno),
+                   _("Error writing to file \"%s\": %s"),
+                   destination_path, g_strerror (errno));
+    }
+  else if (source_stat.st_blocks < source_stat.st_size / 512)
+    success = thunar_io_copy_sparse (&copy, offset, error);
+  else
+    success = (thunar_io_copy_preallocate (&copy, offset, error)
+               && thunar_io_copy_range (&copy, offset, -1, error));
+
+  g_free (copy.buffer);
+  close (source_fd);
+
+  if (success && verify)
+    success = thunar_io_copy_drop_cache (destination_fd, destination_path, error);
+
+  /* network file systems may only report write errors on close */
+  if (close (destination_fd) != 0 && success)
+    {
+      success = FALSE;
+      g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errno),
+                   _("Error writing to file \"%s\": %s"),
+                   destination_path, g_strerror (errno));
+    }
+
+  if (success && (verify || checksum_return != NULL))
+    {
+      checksum = thunar_g_file_compute_checksum (destination, THUNAR_IO_COPY_CHECKSUM_TYPE, cancellable, error);
+      success = (checksum != NULL);
+
+      if (success && verify)
+        {
+          source_checksum = thunar_g_file_compute_checksum (source, THUNAR_IO_COPY_CHECKSUM_TYPE, cancellable, error);
+          if (source_checksum == NULL)
+            success = FALSE;
+          else if (strcmp (checksum, source_checksum) != 0)
+            {
+              success = FALSE;
+              g_set_error_literal (error, G_FILE_ERROR, G_FILE_ERROR_AGAIN,
+                                   "Copied file does not match with the original");
+            }
+          g_free (source_checksum);
+        }
+    }
+
+  if (!success)
+    {
+      /* don't leave a corrupted copy behind, the data of a cancelled
+       * copy is kept so it can be continued once more */
+      if (!g_cancellable_is_cancelled (cancellable))
+        unlink (destination_path);
+      g_free (checksum);
+      return FALSE;
+    }
+
+  /* copy permissions (or all metadata) like GIO, failing to do so is not an error */
+  g_file_copy_attributes (source, destination, flags, cancellable, NULL);
+
+  if (checksum_return != NULL)
+    *checksum_return = checksum;
+  else
+    g_free (checksum);
+
+  return TRUE;
+
+not_supported:
+  g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED,
+                       "Cannot resume the copy");
+  return FALSE;
+}
+
+
+
+/**
+ * thunar_io_copy_hard_link:
+ * @existing    : a local #GFile.
+ * @destination : the #GFile of the new link.
+ * @flags       : set of #GFileCopyFlags.
+ * @error       : (nullable): #GError to set on error.
+ *
+ * Creates @destination as another hard link of @existing, used instead of
+ * copying a file if another link of the source was copied to @existing
+ * before. Like GIO, fails with %G_IO_ERROR_EXISTS if @destination exists,
+ * unless @flags contain %G_FILE_COPY_OVERWRITE.
+ *
+ * If the file system does not support hard links between these files,
+ * %G_IO_ERROR_NOT_SUPPORTED is reported and the file has to be copied.
+ *
+ * Return value: %TRUE on success, %FALSE otherwise.
+ **/
+gboolean
+thunar_io_copy_hard_link (GFile         *existing,
+                          GFile         *destination,
+                          GFileCopyFlags flags,
+                          GError       **error)
+{
+  const gchar *existing_path;
+  const gchar *destination_path;
+  gboolean     replaced = FALSE;
+
+  _thunar_return_val_if_fail (G_IS_FILE (existing), FALSE);
+  _thunar_return_val_if_fail (G_IS_FILE (destination), FALSE);
+  _thunar_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+  existing_path = g_file_peek_path (existing);
+  destination_path = g_file_peek_path (destination);
+  if (existing_path == NULL || destination_path == NULL)
+    {
+      g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED,
+                           "Not a local file");
+      return FALSE;
+    }
+
+  while (link (existing_path, destination_path) != 0)
+    {
+      /* replace the destination once, directories are left to the caller */
+      if (errno == EEXIST && (flags & G_FILE_COPY_OVERWRITE) != 0 && !replaced)
+        {
+          replaced = TRUE;
+          if (unlink (destination_path) == 0)
+            continue;
+          errno = EEXIST;
+        }
+
+      if (errno == EXDEV || errno == EPERM || errno == EMLINK || errno == EOPNOTSUPP || errno == ENOSYS)
+        g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED,
+                     "Cannot link \"%s\": %s", destination_path, g_strerror (errno));
+      else
+        g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errno),
+                     _("Error opening file \"%s\": %s"),
+                     destination_path, g_strerror (errno));
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
+
+
+/* opens @path with @open_flags and flushes it, errno is set on failure */
+static gboolean
+thunar_io_copy_fsync_path (const gchar *path,
+                           gint         open_flags)
+{
+  gint fd;
+  gint saved_errno;
+
+  fd = open (path, O_RDONLY | O_CLOEXEC | open_flags);
+  if (fd < 0)
+    return FALSE;
+
+  /* some file systems cannot be synced, there is nothing to flush then */
+  if (fsync (fd) != 0 && errno != EINVAL)
+    {
+      saved_errno = errno;
+      close (fd);
+      errno = saved_errno;
+      return FALSE;
+    }
+
+  close (fd);
+  return TRUE;
+}
+
+
+
+/**
+ * thunar_io_copy_sync:
+ * @file  : a #GFile.
+ * @error : (nullable): #GError to set on error.
+ *
+ * Flushes the contents of @file and the folder entry of it to the disk,
+ * so a copy of @file survives a crash once the source is deleted. Only
+ * regular files and folders are synced, remote files are left to GIO.
+ *
+ * Return value: %TRUE on success, %FALSE otherwise.
+ **/
+gboolean
+thunar_io_copy_sync (GFile   *file,
+                     GError **error)
+{
+  const gchar *path;
+  gchar       *parent_path;
+  struct stat  file_stat;
+  gboolean     succeed;
+
+  _thunar_return_val_if_fail (G_IS_FILE (file), FALSE);
+  _thunar_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+  path = g_file_peek_path (file);
+  if (path == NULL)
+    return TRUE;
+
+  /* opening fifos or devices could block or have side effects */
+  succeed = lstat (path, &file_stat) == 0;
+  if (succeed && (S_ISREG (file_stat.st_mode) || S_ISDIR (file_stat.st_mode)))
+    succeed = thunar_io_copy_fsync_path (path, O_NOFOLLOW);
+
+  /* the entry of @file in its folder */
+  if (succeed)
+    {
+      parent_path = g_path_get_dirname (path);
+      succeed = thunar_io_copy_fsync_path (parent_path, O_DIRECTORY);
+      g_free (parent_path);
+    }
+
+  if (!succeed)
+    {
+      g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errno),
+                   _("Error writing to file \"%s\": %s"),
+                   path, g_strerror (errno));
+    }
+
+  return succeed;
+}
+
+
+
+/**
+ * thunar_io_copy_write_checksum_file:
+ * @file        : the #GFile the @checksum belongs to.
+ * @checksum    : the checksum of @file, as returned by thunar_io_copy_local_file().
+ * @cancellable : (nullable): optional #GCancellable object.
+ * @error       : (nullable): #GError to set on error.
+ *
+ * Writes the @checksum to a file next to @file, named like @file with
+ * ".sha256" appended, in the format of sha256sum(1), so the copy can be
+ * checked with "sha256sum -c" later on. An existing file of that name
+ * is never replaced, %G_IO_ERROR_EXISTS is reported instead.
+ *
+ * Return value: (transfer full) (nullable): the checksum file, or %NULL
+ *               on error.
+ **/
+GFile *
+thunar_io_copy_write_checksum_file (GFile        *file,
+                                    const gchar  *checksum,
+                                    GCancellable *cancellable,
+                                    GError      **error)
+{
+  GFileOutputStream *stream;
+  GFile             *parent;
+  GFile             *checksum_file;
+  gchar             *basename;
+  gchar             *name;
+  gchar             *contents;
+  gboolean           success;
+
+  _thunar_return_val_if_fail (G_IS_FILE (file), NULL);
+  _thunar_return_val_if_fail (checksum != NULL, NULL);
+  _thunar_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  parent = g_file_get_parent (file);
+  if (G_UNLIKELY (parent == NULL))
+    {
+      g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_INVALID_FILENAME,
+                           "Cannot write a checksum file for the root folder");
+      return NULL;
+    }
+
+  basename = g_file_get_basename (file);
+  name = g_strconcat (basename, ".sha256", NULL);
+  checksum_file = g_file_get_child (parent, name);
+  g_free (name);
+  g_object_unref (parent);
+
+  /* the user's own file of that name is left alone */
+  stream = g_file_create (checksum_file, G_FILE_CREATE_NONE, cancellable, error);
+  if (stream == NULL)
+    {
+      g_object_unref (checksum_file);
+      g_free (basename);
+      return NULL;
+    }
+
+  contents = g_strdup_printf ("%s  %s\n", checksum, basename);
+  success = g_output_stream_write_all (G_OUTPUT_STREAM (stream), contents, strlen (contents), NULL, cancellable, error)
+            && g_output_stream_close (G_OUTPUT_STREAM (stream), cancellable, error);
+  g_object_unref (stream);
+  g_free (contents);
+  g_free (basename);
+
+  if (!success)
+    {
+      /* don't leave a truncated checksum behind */
+      g_file_delete (checksum_file, NULL, NULL);
+      g_clear_object (&checksum_file);
+    }
+
+  return checksum_file;
+}
+
+
+
+/**
+ * thunar_io_copy_set_io_priority:
+ * @priority : the #ThunarIoPriority for the disk accesses of the calling thread.
+ *
+ * Changes the I/O scheduling class of the calling thread, so a copy with
+ * %THUNAR_IO_PRIORITY_IDLE only reads from and writes to local disks while
+ * no one else uses them. Only supported on Linux, and only effective with
+ * I/O schedulers that honour priorities (like BFQ).
+ *
+ * Since the priority sticks to the thread, which is reused by the thread
+ * pools of Thunar, it must be reverted with thunar_io_copy_restore_io_priority()
+ * when done.
+ *
+ * Return value: the previous priority of the thread, or -1 if unchanged.
+ **/
+gint
+thunar_io_copy_set_io_priority (ThunarIoPriority priority)
+{
+#ifdef THUNAR_IO_COPY_HAVE_IOPRIO
+  gint previous;
+
+  if (priority != THUNAR_IO_PRIORITY_IDLE)
+    return -1;
+
+  previous = syscall (SYS_ioprio_get, THUNAR_IO_COPY_IOPRIO_WHO_PROCESS, 0);
+  if (previous < 0)
+    return -1;
+
+  if (syscall (SYS_ioprio_set, THUNAR_IO_COPY_IOPRIO_WHO_PROCESS, 0,
+               THUNAR_IO_COPY_IOPRIO_CLASS_IDLE << THUNAR_IO_COPY_IOPRIO_CLASS_SHIFT)
+      < 0)
+    return -1;
+
+  return previous;
+#else
+  return -1;
+#endif
+}
+
+
+
+/**
+ * thunar_io_copy_restore_io_priority:
+ * @previous : the return value of thunar_io_copy_set_io_priority().
+ *
+ * Reverts the I/O priority of the calling thread.
+ **/
+void
+thunar_io_copy_restore_io_priority (gint previous)
+{
+#ifdef THUNAR_IO_COPY_HAVE_IOPRIO
+  if (previous >= 0)
+    syscall (SYS_ioprio_set, THUNAR_IO_COPY_IOPRIO_WHO_PROCESS, 0, previous);
+#endif
+}
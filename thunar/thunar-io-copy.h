@@ -0,0 +1,76 @@
+/* vi:set et ai sw=2 sts=2 ts=2: */
+/*-
+ * Copyright (c) 2026 The Xfce Development Team
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+ * Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef __THUNAR_IO_COPY_H__
+#define __THUNAR_IO_COPY_H__
+
+#include "thunar/thunar-enum-types.h"
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+/* the type of the checksums computed while copying, the checksum
+ * files written by thunar_io_copy_write_checksum_file() depend on it */
+#define THUNAR_IO_COPY_CHECKSUM_TYPE G_CHECKSUM_SHA256
+
+gboolean
+thunar_io_copy_local_file (GFile                *source,
+                           GFile                *destination,
+                           GFileCopyFlags        flags,
+                           ThunarReflinkMode     reflink_mode,
+                           gboolean              verify,
+                           GCancellable         *cancellable,
+                           GFileProgressCallback progress_callback,
+                           gpointer              progress_callback_data,
+                           gchar               **checksum_return,
+                           GError              **error);
+gboolean
+thunar_io_copy_resume_local_file (GFile                *source,
+                                  GFile                *destination,
+                                  goffset               offset,
+                                  GFileCopyFlags        flags,
+                                  gboolean              verify,
+                                  GCancellable         *cancellable,
+                                  GFileProgressCallback progress_callback,
+                                  gpointer              progress_callback_data,
+                                  gchar               **checksum_return,
+                                  GError              **error);
+gboolean
+thunar_io_copy_hard_link (GFile         *existing,
+                          GFile         *destination,
+                          GFileCopyFlags flags,
+                          GError       **error);
+gboolean
+thunar_io_copy_sync (GFile   *file,
+                     GError **error);
+GFile *
+thunar_io_copy_write_checksum_file (GFile        *file,
+                                    const gchar  *checksum,
+                                    GCancellable *cancellable,
+                                    GError      **error);
+gint
+thunar_io_copy_set_io_priority (ThunarIoPriority priority);
+void
+thunar_io_copy_restore_io_priority (gint previous);
+
+G_END_DECLS
+
+#endif /* !__THUNAR_IO_COPY_H__ */
@@ -0,0 +1,575 @@
+/* vi:set et ai sw=2 sts=2 ts=2: */
+/*-
+ * Copyright (c) 2026 The Xfce Development Team
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+ * Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_DIRENT_H
+#include <dirent.h>
+#endif
+#ifdef HAVE_ERRNO_H
+#include <errno.h>
+#endif
+#ifdef HAVE_FCNTL_H
+#include <fcntl.h>
+#endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+#ifdef HAVE_SYS_STAT_H
+#include <sys/stat.h>
+#endif
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+#include "thunar/thunar-application.h"
+#include "thunar/thunar-gio-extensions.h"
+#include "thunar/thunar-io-delete.h"
+#include "thunar/thunar-private.h"
+#include "thunar/thunar-thumbnail-cache.h"
+
+#include <libxfce4util/libxfce4util.h>
+
+
+
+/* the number of nested folders a thread keeps open while walking them in
+ * place, deeper folders are walked once the open ones are closed */
+#define MAX_OPEN_DEPTH 32
+
+
+
+typedef struct _ThunarIoDelete    ThunarIoDelete;
+typedef struct _ThunarIoDeleteDir ThunarIoDeleteDir;
+
+
+
+static void
+thunar_io_delete_walk_tree (ThunarIoDelete    *delete,
+                            ThunarIoDeleteDir *dir);
+static void
+thunar_io_delete_walk (ThunarIoDelete    *delete,
+                       ThunarIoDeleteDir *dir,
+                       gint               dir_fd,
+                       guint              depth,
+                       GQueue            *deferred);
+
+
+
+struct _ThunarIoDelete
+{
+  ThunarJob            *job;
+  ThunarThumbnailCache *thumbnail_cache;
+
+  /* walks the folders handed over by the other threads, if any, the
+   * number of folders queued or walked is protected by the mutex */
+  GThreadPool *pool;
+  guint        n_threads;
+  guint        n_pending;
+  GMutex       mutex;
+  GCond        cond;
+
+  /* the user is asked by one thread at a time */
+  GMutex ask_mutex;
+
+  /* the files found and deleted so far, accessed atomically, and
+   * reported by one thread at a time */
+  gint   n_found;
+  gint   n_deleted;
+  GMutex progress_mutex;
+};
+
+struct _ThunarIoDeleteDir
+{
+  ThunarIoDeleteDir *parent;
+  gchar             *path;
+
+  /* the name of the folder in its parent, part of the path */
+  const gchar *name;
+
+  /* a descriptor of the folder, the subfolders are opened and removed
+   * relative to it, so they are not looked up by their paths again,
+   * -1 until the first subfolder was found */
+  gint fd;
+
+  /* the walk of the folder and of its subfolders walked by other threads,
+   * the folder is removed once the last of them is done */
+  gint ref_count;
+
+  /* whether something in the folder was kept, so the folder is kept too */
+  gint keep;
+
+  /* whether the folder was walked again since it was not empty */
+  gboolean walked_again;
+};
+
+
+
+static ThunarIoDeleteDir *
+thunar_io_delete_dir_new (ThunarIoDeleteDir *parent,
+                          const gchar       *name)
+{
+  ThunarIoDeleteDir *dir;
+
+  dir = g_slice_new0 (ThunarIoDeleteDir);
+  dir->parent = parent;
+  dir->path = (parent != NULL) ? g_build_filename (parent->path, name, NULL) : g_strdup (name);
+  dir->name = dir->path + strlen (dir->path) - strlen (name);
+  dir->fd = -1;
+  dir->ref_count = 1;
+
+  if (parent != NULL)
+    g_atomic_int_inc (&parent->ref_count);
+
+  return dir;
+}
+
+
+
+/* returns the descriptor @dir is opened and removed relative to, and the
+ * name of @dir there, the path of @dir if its parent has no descriptor */
+static gint
+thunar_io_delete_dir_at (ThunarIoDeleteDir *dir,
+                         const gchar      **name)
+{
+  if (dir->parent != NULL && dir->parent->fd >= 0)
+    {
+      *name = dir->name;
+      return dir->parent->fd;
+    }
+
+  *name = dir->path;
+  return AT_FDCWD;
+}
+
+
+
+static void
+thunar_io_delete_progress (ThunarIoDelete *delete,
+                           const gchar    *path)
+{
+  GFile *file;
+  GList  current_file;
+  gint   n_deleted;
+
+  file = g_file_new_for_path (path);
+
+  /* notify the thumbnail cache that the corresponding thumbnail can also be deleted now */
+  thunar_thumbnail_cache_delete_file (delete->thumbnail_cache, file);
+
+  /* the total grows while the folders are walked */
+  n_deleted = g_atomic_int_add (&delete->n_deleted, 1) + 1;
+  if ((n_deleted % 8) == 0)
+    {
+      current_file.data = file;
+      current_file.prev = current_file.next = NULL;
+
+      g_mutex_lock (&delete->progress_mutex);
+      thunar_job_set_n_total_files (delete->job, g_atomic_int_get (&delete->n_found));
+      thunar_job_processing_file (delete->job, &current_file, n_deleted);
+      g_mutex_unlock (&delete->progress_mutex);
+    }
+
+  g_object_unref (file);
+}
+
+
+
+static ThunarJobResponse
+thunar_io_delete_ask_skip (ThunarIoDelete *delete,
+                           const gchar    *path,
+                           gint            error_code)
+{
+  ThunarJobResponse response;
+  gchar            *base_name;
+  gchar            *display_name;
+
+  base_name = g_path_get_basename (path);
+  display_name = g_filename_display_name (base_name);
+  g_free (base_name);
+
+  /* ask the user whether he wants to skip this file */
+  g_mutex_lock (&delete->ask_mutex);
+  response = thunar_job_ask_skip (delete->job,
+                                  _("Could not delete file \"%s\": %s"),
+                                  display_name, g_strerror (error_code));
+  g_mutex_unlock (&delete->ask_mutex);
+
+  g_free (display_name);
+
+  return response;
+}
+
+
+
+/* removes @name relative to @dir_fd, @path is the full path of it */
+static gboolean
+thunar_io_delete_remove (ThunarIoDelete *delete,
+                         gint            dir_fd,
+                         const gchar    *name,
+                         const gchar    *path,
+                         gint            flags)
+{
+  gint error_code;
+
+  while (unlinkat (dir_fd, name, flags) != 0)
+    {
+      /* the file is gone already */
+      error_code = errno;
+      if (error_code == ENOENT)
+        break;
+
+      if (thunar_io_delete_ask_skip (delete, path, error_code) != THUNAR_JOB_RESPONSE_RETRY)
+        return FALSE;
+    }
+
+  thunar_io_delete_progress (delete, path);
+
+  return TRUE;
+}
+
+
+
+/* opens the folder @name relative to @dir_fd, without following symlinks */
+static gint
+thunar_io_delete_open (ThunarIoDelete    *delete,
+                       ThunarIoDeleteDir *dir,
+                       gint               dir_fd,
+                       const gchar       *name)
+{
+  gint fd;
+
+  while ((fd = openat (dir_fd, name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC)) < 0)
+    {
+      if (thunar_io_delete_ask_skip (delete, dir->path, errno) != THUNAR_JOB_RESPONSE_RETRY)
+        {
+          g_atomic_int_set (&dir->keep, TRUE);
+          return -1;
+        }
+    }
+
+  return fd;
+}
+
+
+
+/* to be called once a walk of @dir is done, removes @dir and the
+ * folders of it which are empty now, from the bottom up */
+static void
+thunar_io_delete_release (ThunarIoDelete    *delete,
+                          ThunarIoDeleteDir *dir)
+{
+  ThunarIoDeleteDir *parent;
+  const gchar       *name;
+  gboolean           removed;
+  gint               at_fd;
+
+  while (dir != NULL && g_atomic_int_dec_and_test (&dir->ref_count))
+    {
+      at_fd = thunar_io_delete_dir_at (dir, &name);
+
+      if (g_atomic_int_get (&dir->keep) || thunar_job_is_cancelled (delete->job))
+        removed = FALSE;
+      else if (unlinkat (at_fd, name, AT_REMOVEDIR) == 0)
+        {
+          thunar_io_delete_progress (delete, dir->path);
+          removed = TRUE;
+        }
+      else if (errno == ENOTEMPTY && !dir->walked_again)
+        {
+          /* a walk may miss entries if the folder is changed meanwhile,
+           * like on some network file systems, so walk it once more */
+          dir->walked_again = TRUE;
+          g_atomic_int_set (&dir->ref_count, 1);
+          thunar_io_delete_walk_tree (delete, dir);
+          continue;
+        }
+      else
+        removed = thunar_io_delete_remove (delete, at_fd, name, dir->path, AT_REMOVEDIR);
+
+      parent = dir->parent;
+      if (!removed && parent != NULL)
+        g_atomic_int_set (&parent->keep, TRUE);
+
+      if (dir->fd >= 0)
+        close (dir->fd);
+      g_free (dir->path);
+      g_slice_free (ThunarIoDeleteDir, dir);
+
+      dir = parent;
+    }
+}
+
+
+
+/* hands @dir over to an idle thread of the pool, if there is one */
+static gboolean
+thunar_io_delete_push (ThunarIoDelete    *delete,
+                       ThunarIoDeleteDir *dir)
+{
+  gboolean pushed = FALSE;
+
+  if (delete->pool == NULL)
+    return FALSE;
+
+  g_mutex_lock (&delete->mutex);
+  if (delete->n_pending < delete->n_threads)
+    {
+      delete->n_pending++;
+      pushed = TRUE;
+    }
+  g_mutex_unlock (&delete->mutex);
+
+  if (pushed)
+    g_thread_pool_push (delete->pool, dir, NULL);
+
+  return pushed;
+}
+
+
+
+static void
+thunar_io_delete_thread (gpointer data,
+                         gpointer user_data)
+{
+  ThunarIoDeleteDir *dir = data;
+  ThunarIoDelete    *delete = user_data;
+
+  thunar_io_delete_walk_tree (delete, dir);
+  thunar_io_delete_release (delete, dir);
+
+  g_mutex_lock (&delete->mutex);
+  if (--delete->n_pending == 0)
+    g_cond_broadcast (&delete->cond);
+  g_mutex_unlock (&delete->mutex);
+}
+
+
+
+/* deletes the contents of @dir and of its subfolders, without releasing
+ * @dir, the folders are opened relative to their parents */
+static void
+thunar_io_delete_walk_tree (ThunarIoDelete    *delete,
+                            ThunarIoDeleteDir *dir)
+{
+  GQueue       deferred = G_QUEUE_INIT;
+  const gchar *name;
+  gint         at_fd;
+  gint         fd;
+
+  at_fd = thunar_io_delete_dir_at (dir, &name);
+  fd = thunar_io_delete_open (delete, dir, at_fd, name);
+  if (fd >= 0)
+    thunar_io_delete_walk (delete, dir, fd, 0, &deferred);
+
+  /* the folders too deep to be walked in place, their parents are kept
+   * until they are released */
+  while ((dir = g_queue_pop_head (&deferred)) != NULL)
+    {
+      fd = -1;
+      at_fd = thunar_io_delete_dir_at (dir, &name);
+      if (!thunar_job_is_cancelled (delete->job))
+        fd = thunar_io_delete_open (delete, dir, at_fd, name);
+      if (fd >= 0)
+        thunar_io_delete_walk (delete, dir, fd, 0, &deferred);
+      thunar_io_delete_release (delete, dir);
+    }
+}
+
+
+
+/* deletes the contents of @dir while they are read, takes @dir_fd over,
+ * the subfolders are walked in place unless another thread is idle or
+ * @depth folders are open already, then they are added to @deferred */
+static void
+thunar_io_delete_walk (ThunarIoDelete    *delete,
+                       ThunarIoDeleteDir *dir,
+                       gint               dir_fd,
+                       guint              depth,
+                       GQueue            *deferred)
+{
+  ThunarIoDeleteDir *child;
+  struct dirent     *entry;
+  struct stat        statbuf;
+  gboolean           is_dir;
+  DIR               *stream;
+  gint               child_fd;
+
+  stream = fdopendir (dir_fd);
+  if (G_UNLIKELY (stream == NULL))
+    {
+      close (dir_fd);
+      g_atomic_int_set (&dir->keep, TRUE);
+      return;
+    }
+
+  while (!thunar_job_is_cancelled (delete->job) && (entry = readdir (stream)) != NULL)
+    {
+      if (strcmp (entry->d_name, ".") == 0 || strcmp (entry->d_name, "..") == 0)
+        continue;
+
+      g_atomic_int_inc (&delete->n_found);
+
+      /* not all file systems report the type */
+      if (entry->d_type == DT_UNKNOWN)
+        is_dir = fstatat (dirfd (stream), entry->d_name, &statbuf, AT_SYMLINK_NOFOLLOW) == 0 && S_ISDIR (statbuf.st_mode);
+      else
+        is_dir = entry->d_type == DT_DIR;
+
+      if (!is_dir)
+        {
+          gchar *path = g_build_filename (dir->path, entry->d_name, NULL);
+
+          if (!thunar_io_delete_remove (delete, dirfd (stream), entry->d_name, path, 0))
+            g_atomic_int_set (&dir->keep, TRUE);
+
+          g_free (path);
+          continue;
+        }
+
+      /* the subfolders walked by other threads or later on are opened
+       * and removed relative to this folder, even if it is closed here */
+      if (dir->fd < 0)
+        dir->fd = fcntl (dirfd (stream), F_DUPFD_CLOEXEC, 0);
+
+      child = thunar_io_delete_dir_new (dir, entry->d_name);
+      if (thunar_io_delete_push (delete, child))
+        continue;
+
+      /* every level keeps its folder open, don't run out of descriptors */
+      if (depth + 1 >= MAX_OPEN_DEPTH)
+        {
+          g_queue_push_tail (deferred, child);
+          continue;
+        }
+
+      child_fd = thunar_io_delete_open (delete, child, dirfd (stream), entry->d_name);
+      if (child_fd >= 0)
+        thunar_io_delete_walk (delete, child, child_fd, depth + 1, deferred);
+      thunar_io_delete_release (delete, child);
+    }
+
+  closedir (stream);
+}
+
+
+
+/**
+ * thunar_io_delete_local_files:
+ * @job       : the #ThunarJob deleting the files.
+ * @file_list : the list of local #GFile<!---->s to delete.
+ * @n_threads : the number of threads to delete independent folders.
+ *
+ * Deletes the files in @file_list and the contents of the folders among
+ * them, without following symlinks. Unlike thunar_io_scan_directory(),
+ * the folders are not collected upfront: they are deleted while they are
+ * read, relative to the descriptors of their folders, so the memory used
+ * does not depend on the number of files. Subfolders are handed over to
+ * up to @n_threads - 1 other threads while they are idle.
+ *
+ * The progress is reported to @job and the user is asked whether to skip
+ * files which cannot be deleted. The folders of skipped files are kept.
+ **/
+void
+thunar_io_delete_local_files (ThunarJob *job,
+                              GList     *file_list,
+                              guint      n_threads)
+{
+  ThunarApplication *application;
+  ThunarIoDeleteDir *parent;
+  ThunarIoDeleteDir *dir;
+  ThunarIoDelete     delete;
+  const gchar       *path;
+  struct stat        statbuf;
+  gchar             *dirname;
+  gchar             *basename;
+
+  _thunar_return_if_fail (THUNAR_IS_JOB (job));
+
+  delete.job = job;
+  delete.pool = NULL;
+  delete.n_threads = MAX (n_threads, 1) - 1;
+  delete.n_pending = 0;
+  delete.n_found = 0;
+  delete.n_deleted = 0;
+  g_mutex_init (&delete.mutex);
+  g_cond_init (&delete.cond);
+  g_mutex_init (&delete.ask_mutex);
+  g_mutex_init (&delete.progress_mutex);
+
+  application = thunar_application_get ();
+  delete.thumbnail_cache = thunar_application_get_thumbnail_cache (application);
+  g_object_unref (application);
+
+  /* shared threads, since the pool only lives as long as the job */
+  if (delete.n_threads > 0)
+    delete.pool = g_thread_pool_new (thunar_io_delete_thread, &delete, delete.n_threads, FALSE, NULL);
+
+  for (GList *lp = file_list; lp != NULL && !thunar_job_is_cancelled (job); lp = lp->next)
+    {
+      /* skip root folders which cannot be deleted anyway */
+      if (thunar_g_file_is_root (lp->data))
+        continue;
+
+      path = g_file_peek_path (lp->data);
+      if (G_UNLIKELY (path == NULL))
+        continue;
+
+      g_atomic_int_inc (&delete.n_found);
+
+      if (lstat (path, &statbuf) == 0 && S_ISDIR (statbuf.st_mode))
+        {
+          /* the folder containing @path is only a base to open the
+           * folder relative to, it is never removed */
+          dirname = g_path_get_dirname (path);
+          basename = g_path_get_basename (path);
+          parent = thunar_io_delete_dir_new (NULL, dirname);
+          parent->fd = open (dirname, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+          parent->keep = TRUE;
+          dir = thunar_io_delete_dir_new (parent, basename);
+          g_free (basename);
+          g_free (dirname);
+
+          thunar_io_delete_walk_tree (&delete, dir);
+          thunar_io_delete_release (&delete, dir);
+          thunar_io_delete_release (&delete, parent);
+        }
+      else
+        {
+          thunar_io_delete_remove (&delete, AT_FDCWD, path, path, 0);
+        }
+    }
+
+  /* wait for the folders walked by the other threads */
+  g_mutex_lock (&delete.mutex);
+  while (delete.n_pending > 0)
+    g_cond_wait (&delete.cond, &delete.mutex);
+  g_mutex_unlock (&delete.mutex);
+
+  if (delete.pool != NULL)
+    g_thread_pool_free (delete.pool, FALSE, TRUE);
+
+  /* the progress is only reported every few files, report where it ended */
+  thunar_job_set_n_total_files (job, g_atomic_int_get (&delete.n_found));
+  thunar_job_percent (job, 100.0 * g_atomic_int_get (&delete.n_deleted) / MAX (g_atomic_int_get (&delete.n_found), 1));
+
+  g_object_unref (delete.thumbnail_cache);
+
+  g_mutex_clear (&delete.mutex);
+  g_cond_clear (&delete.cond);
+  g_mutex_clear (&delete.ask_mutex);
+  g_mutex_clear (&delete.progress_mutex);
+}
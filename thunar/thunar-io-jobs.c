@@ -21,27 +21,44 @@
 #ifdef HAVE_ERRNO_H
 #include <errno.h>
 #endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
 
 #include "thunar/thunar-application.h"
 #include "thunar/thunar-enum-types.h"
 #include "thunar/thunar-file.h"
 #include "thunar/thunar-gio-extensions.h"
 #include "thunar/thunar-gobject-extensions.h"
+#include "thunar/thunar-io-delete.h"
 #include "thunar/thunar-io-jobs-util.h"
 #include "thunar/thunar-io-jobs.h"
+#include "thunar/thunar-io-recent.h"
 #include "thunar/thunar-io-scan-directory.h"
+#include "thunar/thunar-io-trash.h"
 #include "thunar/thunar-job.h"
 #include "thunar/thunar-preferences.h"
 #include "thunar/thunar-private.h"
+#include "thunar/thunar-search-query.h"
 #include "thunar/thunar-simple-job.h"
 #include "thunar/thunar-thumbnail-cache.h"
 #include "thunar/thunar-transfer-job.h"
+#include "thunar/thunar-util.h"
 
 #include <gio/gio.h>
 #include <glib/gstdio.h>
 
 
 
+/* upper limit for the number of threads deleting local folders, deleting
+ * is mostly limited by the disk, not by the processors */
+#define UNLINK_MAX_THREADS 4
+
+/* attributes needed by the search job to match and filter files */
+#define SEARCH_FILE_INFO_NAMESPACE \
+  G_FILE_ATTRIBUTE_STANDARD_TYPE "," G_FILE_ATTRIBUTE_STANDARD_TARGET_URI "," G_FILE_ATTRIBUTE_STANDARD_DISPLAY_NAME "," \
+  G_FILE_ATTRIBUTE_STANDARD_IS_BACKUP "," G_FILE_ATTRIBUTE_STANDARD_IS_HIDDEN "," G_FILE_ATTRIBUTE_STANDARD_NAME ",recent::*"
+
 static GList *
 _tij_collect_nofollow (ThunarJob *job,
                        GList     *base_file_list,
@@ -543,6 +560,7 @@ _thunar_io_jobs_unlink (ThunarJob *job,
   GError               *err = NULL;
   GList                *file_list;
   GList                *stage_file_list = NULL;
+  GList                *local_file_list = NULL;
   GList                *lp;
   GFile                *parent;
   gchar                *base_name;
@@ -552,7 +570,7 @@ _thunar_io_jobs_unlink (ThunarJob *job,
 
   _thunar_return_val_if_fail (THUNAR_IS_JOB (job), FALSE);
   _thunar_return_val_if_fail (param_values != NULL, FALSE);
-  _thunar_return_val_if_fail (param_values->len == 1, FALSE);
+  _thunar_return_val_if_fail (param_values->len == 2, FALSE);
   _thunar_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
   /* get the file list */
@@ -624,6 +642,30 @@ _thunar_io_jobs_unlink (ThunarJob *job,
   if (stage_file_list == NULL)
     return TRUE;
 
+  /* local files are deleted while their folders are read, instead of collecting them first */
+  for (lp = stage_file_list; lp != NULL;)
+    {
+      GList *lp_next = lp->next;
+
+      if (g_file_is_native (lp->data))
+        {
+          stage_file_list = g_list_remove_link (stage_file_list, lp);
+          local_file_list = g_list_concat (lp, local_file_list);
+        }
+
+      lp = lp_next;
+    }
+
+  if (local_file_list != NULL)
+    {
+      thunar_io_delete_local_files (job, local_file_list,
+                                    g_value_get_uint (&g_array_index (param_values, GValue, 1)));
+      thunar_g_list_free_full (local_file_list);
+    }
+
+  if (stage_file_list == NULL)
+    return !thunar_job_set_error_if_cancelled (THUNAR_JOB (job), error);
+
   /* recursively collect files for removal, not following any symlinks */
   file_list = _tij_collect_nofollow (job, stage_file_list, TRUE, &err);
   thunar_g_list_free_full (stage_file_list);
@@ -720,8 +762,11 @@ again:
 ThunarJob *
 thunar_io_jobs_unlink_files (GList *file_list)
 {
-  ThunarJob *job = thunar_simple_job_new (_thunar_io_jobs_unlink, 1,
-                                          THUNAR_TYPE_G_FILE_LIST, file_list);
+  ThunarJob *job;
+
+  job = thunar_simple_job_new (_thunar_io_jobs_unlink, 2,
+                               THUNAR_TYPE_G_FILE_LIST, file_list,
+                               G_TYPE_UINT, CLAMP (g_get_num_processors (), 1, UNLINK_MAX_THREADS));
 
 #ifdef HAVE_LIBCANBERRA
   /* If the files to unlink are in the trash, the job is an 'empty trash' job */
@@ -996,9 +1041,12 @@ _thunar_io_jobs_trash (ThunarJob *job,
   ThunarJobOperation    *operation = NULL;
   ThunarJobResponse      response;
   ThunarOperationLogMode log_mode;
+  ThunarIoTrash         *trash;
   GError                *err = NULL;
   GList                 *file_list;
+  GList                 *trashed_list = NULL;
   GList                 *lp;
+  guint                  n_processed = 0;
 
   _thunar_return_val_if_fail (THUNAR_IS_JOB (job), FALSE);
   _thunar_return_val_if_fail (param_values != NULL, FALSE);
@@ -1018,12 +1066,24 @@ _thunar_io_jobs_trash (ThunarJob *job,
   if (log_mode != THUNAR_OPERATION_LOG_NO_OPERATIONS)
     operation = thunar_job_operation_new (THUNAR_JOB_OPERATION_KIND_TRASH);
 
-  for (lp = file_list; err == NULL && lp != NULL; lp = lp->next)
+  /* local files on the file system of the home trash are moved there by us, the
+   * others, and those we fail to move, are left to g_file_trash() */
+  trash = thunar_io_trash_new ();
+
+  thunar_job_set_n_total_files (job, g_list_length (file_list));
+
+  for (lp = file_list; err == NULL && lp != NULL; lp = lp->next, n_processed++)
     {
       _thunar_assert (G_IS_FILE (lp->data));
 
+      if (thunar_job_set_error_if_cancelled (job, &err))
+        break;
+
+      thunar_job_processing_file (job, lp, n_processed);
+
       /* trash the file or folder */
-      g_file_trash (lp->data, thunar_job_get_cancellable (THUNAR_JOB (job)), &err);
+      if (trash == NULL || !thunar_io_trash_file (trash, lp->data))
+        g_file_trash (lp->data, thunar_job_get_cancellable (THUNAR_JOB (job)), &err);
 
       if (err != NULL)
         {
@@ -1039,7 +1099,18 @@ _thunar_io_jobs_trash (ThunarJob *job,
         }
 
       if (err == NULL && log_mode != THUNAR_OPERATION_LOG_NO_OPERATIONS)
-        thunar_job_operation_add (operation, lp->data, NULL);
+        trashed_list = g_list_prepend (trashed_list, lp->data);
+    }
+
+  if (trash != NULL)
+    thunar_io_trash_free (trash);
+
+  /* the files are added at once, the undo of many trashed files is common */
+  if (operation != NULL)
+    {
+      trashed_list = g_list_reverse (trashed_list);
+      thunar_job_operation_add_files (operation, trashed_list);
+      g_list_free (trashed_list);
     }
 
   if (log_mode == THUNAR_OPERATION_LOG_OPERATIONS)
@@ -1635,25 +1706,156 @@ thunar_io_jobs_count_files (ThunarFile *file)
 
 
 
+/* Everything a search job needs to know besides the current folder */
+typedef struct
+{
+  ThunarTreeViewModel           *model;
+  ThunarJob                     *job;
+  ThunarSearchQuery             *query;
+  enum ThunarTreeViewModelSearch search_type;
+  gboolean                       show_hidden;
+  gboolean                       uses_relative_path;
+  gchar                         *namespace;
+
+  /* search scope, only relevant for recursive searches */
+  gchar         *filesystem_id; /* NULL to cross filesystem boundaries */
+  gint           max_depth;     /* -1 for unlimited */
+  GPatternSpec **excluded_names;
+  GFile        **excluded_folders;
+} ThunarSearchContext;
+
+
+
 static void
-_thunar_search_folder (ThunarTreeViewModel           *model,
-                       ThunarJob                     *job,
-                       gchar                         *uri,
-                       gchar                        **search_query_c_terms,
-                       enum ThunarTreeViewModelSearch search_type,
-                       gboolean                       show_hidden)
+_thunar_search_context_set_exclusions (ThunarSearchContext *context,
+                                       const gchar         *excluded_folders)
 {
+  GPtrArray *names;
+  GPtrArray *folders;
+  GFile     *home;
+  gchar    **entries;
+  gchar     *path;
+
+  if (excluded_folders == NULL || *excluded_folders == '\0')
+    return;
+
+  names = g_ptr_array_new ();
+  folders = g_ptr_array_new ();
+  home = thunar_g_file_new_for_home ();
+
+  entries = g_strsplit (excluded_folders, ",", -1);
+  for (guint n = 0; entries[n] != NULL; n++)
+    {
+      g_strstrip (entries[n]);
+      if (*entries[n] == '\0')
+        continue;
+
+      if (strchr (entries[n], '/') == NULL)
+        {
+          /* plain entries are wildcard patterns for the folder name */
+          g_ptr_array_add (names, g_pattern_spec_new (entries[n]));
+        }
+      else
+        {
+          /* everything else refers to one specific folder */
+          path = thunar_util_expand_filename (entries[n], home, NULL);
+          if (path != NULL)
+            g_ptr_array_add (folders, g_file_new_for_path (path));
+          g_free (path);
+        }
+    }
+  g_strfreev (entries);
+  g_object_unref (home);
+
+  g_ptr_array_add (names, NULL);
+  g_ptr_array_add (folders, NULL);
+  context->excluded_names = (GPatternSpec **) g_ptr_array_free (names, FALSE);
+  context->excluded_folders = (GFile **) g_ptr_array_free (folders, FALSE);
+}
+
+
+
+static void
+_thunar_search_context_free (ThunarSearchContext *context)
+{
+  if (context->excluded_names != NULL)
+    for (guint n = 0; context->excluded_names[n] != NULL; n++)
+      g_pattern_spec_free (context->excluded_names[n]);
+  g_free (context->excluded_names);
+
+  if (context->excluded_folders != NULL)
+    for (guint n = 0; context->excluded_folders[n] != NULL; n++)
+      g_object_unref (context->excluded_folders[n]);
+  g_free (context->excluded_folders);
+
+  g_free (context->filesystem_id);
+  g_free (context->namespace);
+}
+
+
+
+static gboolean
+_thunar_search_may_descend (ThunarSearchContext *context,
+                            GFile               *directory,
+                            GFileInfo           *info,
+                            guint                depth)
+{
+  const gchar *fs_id;
+  const gchar *name;
+
+  if (context->search_type != THUNAR_TREE_VIEW_MODEL_SEARCH_RECURSIVE)
+    return FALSE;
+
+  /* depth of the directory's children, counted from the searched folder */
+  if (context->max_depth >= 0 && depth >= (guint) context->max_depth)
+    return FALSE;
+
+  /* don't cross mount points, same check as done by the deep count job */
+  if (context->filesystem_id != NULL)
+    {
+      fs_id = g_file_info_get_attribute_string (info, G_FILE_ATTRIBUTE_ID_FILESYSTEM);
+      if (g_strcmp0 (fs_id, context->filesystem_id) != 0)
+        return FALSE;
+    }
+
+  if (context->excluded_names != NULL)
+    {
+      name = g_file_info_get_name (info);
+      for (guint n = 0; context->excluded_names[n] != NULL; n++)
+        if (g_pattern_spec_match_string (context->excluded_names[n], name))
+          return FALSE;
+    }
+
+  if (context->excluded_folders != NULL)
+    for (guint n = 0; context->excluded_folders[n] != NULL; n++)
+      if (g_file_equal (context->excluded_folders[n], directory))
+        return FALSE;
+
+  return thunar_search_query_may_descend (context->query, g_file_info_get_display_name (info), depth);
+}
+
+
+
+static void
+_thunar_search_folder (ThunarSearchContext *context,
+                       gchar               *uri,
+                       guint                depth,
+                       const gchar         *relative_path)
+{
+  ThunarJob       *job = context->job;
   GCancellable    *cancellable;
   GFileEnumerator *enumerator;
   GFile           *directory;
   GList           *files_found = NULL; /* contains the matching files in this folder only */
-  const gchar *namespace;
+  GPtrArray       *recent_infos = NULL;
+  GFileInfo      **target_infos = NULL;
+  guint            recent_index = 0;
+  const gchar *namespace = context->namespace;
   const gchar *display_name;
-  gchar       *display_name_c; /* converted to ignore case */
+  gchar       *file_relative_path;
 
   cancellable = thunar_job_get_cancellable (THUNAR_JOB (job));
   directory = g_file_new_for_uri (uri);
-  namespace = G_FILE_ATTRIBUTE_STANDARD_TYPE "," G_FILE_ATTRIBUTE_STANDARD_TARGET_URI "," G_FILE_ATTRIBUTE_STANDARD_DISPLAY_NAME "," G_FILE_ATTRIBUTE_STANDARD_IS_BACKUP "," G_FILE_ATTRIBUTE_STANDARD_IS_HIDDEN "," G_FILE_ATTRIBUTE_STANDARD_NAME ", recent::*";
 
   /* The directory enumerator MUST NOT follow symlinks itself, meaning that any symlinks that
    * g_file_enumerator_next_file() emits are the actual symlink entries. This prevents one
@@ -1668,6 +1870,19 @@ _thunar_search_folder (ThunarTreeViewModel           *model,
       return;
     }
 
+  /* resolve the targets of all `recent:///` entries at once */
+  if (g_file_has_uri_scheme (directory, "recent"))
+    {
+      GFileInfo *info;
+
+      recent_infos = g_ptr_array_new_with_free_func (g_object_unref);
+      while ((info = g_file_enumerator_next_file (enumerator, cancellable, NULL)) != NULL)
+        g_ptr_array_add (recent_infos, info);
+
+      target_infos = thunar_io_recent_query_targets ((GFileInfo *const *) recent_infos->pdata, recent_infos->len,
+                                                     namespace, G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS, cancellable);
+    }
+
   /* go through every file in the folder and check if it matches */
   while (thunar_job_is_cancelled (THUNAR_JOB (job)) == FALSE)
     {
@@ -1675,27 +1890,34 @@ _thunar_search_folder (ThunarTreeViewModel           *model,
       GFileInfo *info;
       GFileType  type;
 
-      /* get GFile and GFileInfo */
-      info = g_file_enumerator_next_file (enumerator, cancellable, NULL);
-      if (G_UNLIKELY (info == NULL))
-        break;
-
-      if (g_file_has_uri_scheme (directory, "recent"))
+      if (recent_infos != NULL)
         {
-          file = g_file_new_for_uri (g_file_info_get_attribute_string (info, G_FILE_ATTRIBUTE_STANDARD_TARGET_URI));
-          g_object_unref (info);
-          info = g_file_query_info (file, namespace, G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS, cancellable, NULL);
+          if (recent_index >= recent_infos->len)
+            break;
+
+          /* skip entries whose target is gone or unreachable */
+          info = g_steal_pointer (&target_infos[recent_index]);
           if (G_UNLIKELY (info == NULL))
             {
-              g_object_unref (file);
-              break;
+              recent_index++;
+              continue;
             }
+
+          file = g_file_new_for_uri (g_file_info_get_attribute_string (g_ptr_array_index (recent_infos, recent_index++),
+                                                                       G_FILE_ATTRIBUTE_STANDARD_TARGET_URI));
         }
       else
-        file = g_file_get_child (directory, g_file_info_get_name (info));
+        {
+          /* get GFile and GFileInfo */
+          info = g_file_enumerator_next_file (enumerator, cancellable, NULL);
+          if (G_UNLIKELY (info == NULL))
+            break;
+
+          file = g_file_get_child (directory, g_file_info_get_name (info));
+        }
 
       /* respect last-show-hidden */
-      if (show_hidden == FALSE)
+      if (context->show_hidden == FALSE)
         {
           /* same logic as thunar_file_is_hidden() */
           if (g_file_info_get_attribute_boolean (info, G_FILE_ATTRIBUTE_STANDARD_IS_HIDDEN)
@@ -1708,29 +1930,42 @@ _thunar_search_folder (ThunarTreeViewModel           *model,
         }
 
       type = g_file_info_get_file_type (info);
+      display_name = g_file_info_get_display_name (info);
+
+      /* path patterns are matched against the location relative to the searched folder */
+      if (context->uses_relative_path && relative_path != NULL)
+        file_relative_path = g_strconcat (relative_path, "/", display_name, NULL);
+      else if (context->uses_relative_path)
+        file_relative_path = g_strdup (display_name);
+      else
+        file_relative_path = NULL;
 
-      /* handle directories */
-      if (type == G_FILE_TYPE_DIRECTORY && search_type == THUNAR_TREE_VIEW_MODEL_SEARCH_RECURSIVE)
+      /* handle directories, unless they are out of the search scope */
+      if (type == G_FILE_TYPE_DIRECTORY && _thunar_search_may_descend (context, file, info, depth))
         {
           gchar *file_uri = g_file_get_uri (file);
-          _thunar_search_folder (model, job, file_uri, search_query_c_terms, search_type, show_hidden);
+          _thunar_search_folder (context, file_uri, depth + 1, file_relative_path);
           g_free (file_uri);
         }
 
-      /* prepare entry display name */
-      display_name = g_file_info_get_display_name (info);
-      display_name_c = thunar_g_utf8_normalize_for_search (display_name, TRUE, TRUE);
-
-      /* search for all substrings */
-      if (thunar_util_search_terms_match (search_query_c_terms, display_name_c))
+      /* check the entry against the precompiled query, metadata first since
+       * that is cheaper than matching the name */
+      if (thunar_search_query_match_info (context->query, info)
+          && thunar_search_query_match (context->query, display_name, file_relative_path))
         files_found = g_list_prepend (files_found, thunar_file_get (file, NULL));
 
       /* free memory */
-      g_free (display_name_c);
+      g_free (file_relative_path);
       g_object_unref (file);
       g_object_unref (info);
     }
 
+  if (recent_infos != NULL)
+    {
+      thunar_io_recent_free_targets (target_infos, recent_infos->len);
+      g_ptr_array_unref (recent_infos);
+    }
+
   g_object_unref (enumerator);
   g_object_unref (directory);
 
@@ -1740,7 +1975,7 @@ _thunar_search_folder (ThunarTreeViewModel           *model,
       return;
     }
 
-  thunar_tree_view_model_add_search_files (model, files_found);
+  thunar_tree_view_model_add_search_files (context->model, files_found);
 }
 
 
@@ -1750,69 +1985,120 @@ _thunar_job_search_directory (ThunarJob *job,
                               GArray    *param_values,
                               GError   **error)
 {
-  ThunarTreeViewModel           *model;
-  ThunarFile                    *directory;
-  const char                    *search_query_c;
-  gchar                        **search_query_c_terms;
-  gboolean                       is_source_device_local;
-  ThunarRecursiveSearchMode      mode;
-  gboolean                       show_hidden;
-  enum ThunarTreeViewModelSearch search_type;
-  gchar                         *directory_uri;
-
-  search_type = THUNAR_TREE_VIEW_MODEL_SEARCH_NON_RECURSIVE;
+  ThunarSearchContext       context = { 0 };
+  ThunarFile               *directory;
+  gboolean                  is_source_device_local;
+  ThunarRecursiveSearchMode mode;
+  gchar                    *directory_uri;
+  GFileInfo                *info;
+  GString                  *namespace;
 
   if (thunar_job_set_error_if_cancelled (THUNAR_JOB (job), error))
     return FALSE;
 
-  model = g_value_get_object (&g_array_index (param_values, GValue, 0));
-  search_query_c = g_value_get_string (&g_array_index (param_values, GValue, 1));
+  context.job = job;
+  context.model = g_value_get_object (&g_array_index (param_values, GValue, 0));
+  context.query = g_value_get_boxed (&g_array_index (param_values, GValue, 1));
   directory = g_value_get_object (&g_array_index (param_values, GValue, 2));
   mode = g_value_get_enum (&g_array_index (param_values, GValue, 3));
-  show_hidden = g_value_get_boolean (&g_array_index (param_values, GValue, 4));
-
-  search_query_c_terms = thunar_util_split_search_query (search_query_c, error);
-  if (search_query_c_terms == NULL)
-    return FALSE;
+  context.show_hidden = g_value_get_boolean (&g_array_index (param_values, GValue, 4));
+  context.max_depth = g_value_get_int (&g_array_index (param_values, GValue, 6));
+  context.uses_relative_path = thunar_search_query_uses_relative_path (context.query);
 
+  context.search_type = THUNAR_TREE_VIEW_MODEL_SEARCH_NON_RECURSIVE;
   is_source_device_local = thunar_g_file_is_on_local_device (thunar_file_get_file (directory));
   if (mode == THUNAR_RECURSIVE_SEARCH_ALWAYS || (mode == THUNAR_RECURSIVE_SEARCH_LOCAL && is_source_device_local))
-    search_type = THUNAR_TREE_VIEW_MODEL_SEARCH_RECURSIVE;
+    context.search_type = THUNAR_TREE_VIEW_MODEL_SEARCH_RECURSIVE;
+
+  if (context.search_type == THUNAR_TREE_VIEW_MODEL_SEARCH_RECURSIVE)
+    {
+      /* remember the filesystem of the searched folder */
+      if (g_value_get_boolean (&g_array_index (param_values, GValue, 5)))
+        {
+          info = g_file_query_info (thunar_file_get_file (directory), G_FILE_ATTRIBUTE_ID_FILESYSTEM,
+                                    G_FILE_QUERY_INFO_NONE, thunar_job_get_cancellable (job), NULL);
+          if (info != NULL)
+            {
+              context.filesystem_id = g_strdup (g_file_info_get_attribute_string (info, G_FILE_ATTRIBUTE_ID_FILESYSTEM));
+              g_object_unref (info);
+            }
+        }
+
+      _thunar_search_context_set_exclusions (&context, g_value_get_string (&g_array_index (param_values, GValue, 7)));
+    }
+
+  /* only request the attributes needed for the filters and the search scope */
+  namespace = g_string_new (SEARCH_FILE_INFO_NAMESPACE);
+  if (context.filesystem_id != NULL)
+    g_string_append (namespace, "," G_FILE_ATTRIBUTE_ID_FILESYSTEM);
+  if (thunar_search_query_get_attributes (context.query) != NULL)
+    g_string_append_printf (namespace, ",%s", thunar_search_query_get_attributes (context.query));
+  context.namespace = g_string_free (namespace, FALSE);
 
   directory_uri = thunar_file_dup_uri (directory);
 
-  _thunar_search_folder (model, job, directory_uri, search_query_c_terms, search_type, show_hidden);
+  _thunar_search_folder (&context, directory_uri, 0, NULL);
 
   g_free (directory_uri);
-  g_strfreev (search_query_c_terms);
+  _thunar_search_context_free (&context);
 
   return TRUE;
 }
 
 
 
+/**
+ * thunar_io_jobs_search_directory:
+ * @model        : the #ThunarTreeViewModel to add the search results to.
+ * @search_query : the compiled #ThunarSearchQuery.
+ * @directory    : the #ThunarFile of the folder to search in.
+ *
+ * Searches @directory (and its subfolders, depending on the
+ * "misc-recursive-search" preference) for files matching @search_query.
+ * Matching is done on the job thread, only matches reach @model. The
+ * "misc-search-*" preferences limit which subfolders are searched.
+ *
+ * Return value: the newly allocated #ThunarJob.
+ **/
 ThunarJob *
 thunar_io_jobs_search_directory (ThunarTreeViewModel *model,
-                                 const gchar         *search_query,
+                                 ThunarSearchQuery   *search_query,
                                  ThunarFile          *directory)
 {
   ThunarPreferences        *preferences;
   ThunarRecursiveSearchMode mode;
   gboolean                  show_hidden;
+  gboolean                  same_filesystem;
+  gint                      max_depth;
+  gchar                    *excluded_folders;
+  ThunarJob                *job;
+
+  _thunar_return_val_if_fail (search_query != NULL, NULL);
 
   preferences = thunar_preferences_get ();
 
   /* grab a reference of preferences determine the current recursive search mode */
-  g_object_get (G_OBJECT (preferences), "misc-recursive-search", &mode, NULL);
-  g_object_get (G_OBJECT (preferences), "last-show-hidden", &show_hidden, NULL);
+  g_object_get (G_OBJECT (preferences),
+                "misc-recursive-search", &mode,
+                "last-show-hidden", &show_hidden,
+                "misc-search-same-filesystem", &same_filesystem,
+                "misc-search-max-depth", &max_depth,
+                "misc-search-excluded-folders", &excluded_folders,
+                NULL);
 
   g_object_unref (preferences);
-  return thunar_simple_job_new (_thunar_job_search_directory, 5,
-                                THUNAR_TYPE_TREE_VIEW_MODEL, model,
-                                G_TYPE_STRING, search_query,
-                                THUNAR_TYPE_FILE, directory,
-                                G_TYPE_ENUM, mode,
-                                G_TYPE_BOOLEAN, show_hidden);
+  job = thunar_simple_job_new (_thunar_job_search_directory, 8,
+                               THUNAR_TYPE_TREE_VIEW_MODEL, model,
+                               THUNAR_TYPE_SEARCH_QUERY, search_query,
+                               THUNAR_TYPE_FILE, directory,
+                               G_TYPE_ENUM, mode,
+                               G_TYPE_BOOLEAN, show_hidden,
+                               G_TYPE_BOOLEAN, same_filesystem,
+                               G_TYPE_INT, max_depth,
+                               G_TYPE_STRING, excluded_folders);
+  g_free (excluded_folders);
+
+  return job;
 }
 
 
@@ -23,6 +23,7 @@
 
 #include "thunar/thunar-enum-types.h"
 #include "thunar/thunar-job.h"
+#include "thunar/thunar-search-query.h"
 #include "thunar/thunar-standard-view.h"
 #include "thunar/thunar-tree-view-model.h"
 
@@ -70,7 +71,7 @@ ThunarJob *
 thunar_io_jobs_count_files (ThunarFile *file);
 ThunarJob *
 thunar_io_jobs_search_directory (ThunarTreeViewModel *model,
-                                 const gchar         *search_query,
+                                 ThunarSearchQuery   *search_query,
                                  ThunarFile          *directory);
 ThunarJob *
 thunar_io_jobs_clear_metadata_for_files (GList *files,
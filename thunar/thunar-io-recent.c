@@ -0,0 +1,440 @@
+/* vi:set et ai sw=2 sts=2 ts=2: */
+/*-
+ * Copyright (c) 2026 The Xfce Development Team
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+ * Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+#ifdef HAVE_SYS_STAT_H
+#include <sys/stat.h>
+#endif
+
+#include "thunar/thunar-io-recent.h"
+#include "thunar/thunar-private.h"
+
+
+
+/* maximum number of target queries running at the same time, the
+ * targets of recent:/// frequently live on (slow) remote mounts */
+#define THUNAR_IO_RECENT_MAX_QUERIES 8
+
+/* maximum number of target infos cached for all sets of attributes */
+#define THUNAR_IO_RECENT_MAX_ENTRIES 1024
+
+/* how long the info of a remote target is used without querying it again,
+ * in microseconds, local targets are checked against the file instead */
+#define THUNAR_IO_RECENT_REMOTE_TIMEOUT (60 * G_USEC_PER_SEC)
+
+
+
+typedef struct _ThunarIoRecentBatch  ThunarIoRecentBatch;
+typedef struct _ThunarIoRecentEntry  ThunarIoRecentEntry;
+typedef struct _ThunarIoRecentStamp  ThunarIoRecentStamp;
+typedef struct _ThunarIoRecentTarget ThunarIoRecentTarget;
+
+
+
+static GHashTable *
+thunar_io_recent_cache_lookup_table (const gchar        *attributes,
+                                     GFileQueryInfoFlags flags);
+static void
+thunar_io_recent_entry_free (gpointer data);
+static void
+thunar_io_recent_stamp_file (GFile               *file,
+                             GFileQueryInfoFlags  flags,
+                             ThunarIoRecentStamp *stamp);
+static void
+thunar_io_recent_query_target (gpointer data,
+                               gpointer user_data);
+
+
+
+struct _ThunarIoRecentBatch
+{
+  const gchar        *attributes;
+  GFileQueryInfoFlags flags;
+  GCancellable       *cancellable;
+};
+
+/* identifies the state of a target when its info was queried */
+struct _ThunarIoRecentStamp
+{
+  gboolean local;  /* whether the fields below are set */
+  gboolean exists; /* whether the target could be stat()ed */
+  guint64  device;
+  guint64  inode;
+  gint64   size;
+  gint64   mtime_sec;
+  gint64   mtime_nsec;
+  gint64   ctime_sec;
+  gint64   ctime_nsec;
+  gint64   time; /* monotonic time of the query */
+};
+
+struct _ThunarIoRecentEntry
+{
+  GList               link; /* in recent_cache_lru, the data is the entry */
+  GHashTable         *table;
+  gchar              *uri;
+  GFileInfo          *info;
+  ThunarIoRecentStamp stamp;
+};
+
+struct _ThunarIoRecentTarget
+{
+  const gchar        *uri;
+  GFileInfo          *info;
+  ThunarIoRecentStamp stamp;
+  gboolean            queried;
+};
+
+
+
+/* target infos of recent:/// entries, stored per set of queried attributes
+ * ("flags:attributes" -> (target uri -> ThunarIoRecentEntry)), only accessed
+ * with recent_cache_mutex held, since it is shared between all jobs. All
+ * entries are also in recent_cache_lru, least recently used first */
+static GHashTable *recent_cache = NULL;
+static GQueue      recent_cache_lru = G_QUEUE_INIT;
+static guint       recent_cache_generation = 0;
+static GMutex      recent_cache_mutex;
+
+
+
+static GHashTable *
+thunar_io_recent_cache_lookup_table (const gchar        *attributes,
+                                     GFileQueryInfoFlags flags)
+{
+  GHashTable *table;
+  gchar      *key;
+
+  if (G_UNLIKELY (recent_cache == NULL))
+    recent_cache = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_hash_table_unref);
+
+  key = g_strdup_printf ("%u:%s", (guint) flags, attributes);
+  table = g_hash_table_lookup (recent_cache, key);
+  if (table == NULL)
+    {
+      /* the key is the uri of the entry */
+      table = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, thunar_io_recent_entry_free);
+      g_hash_table_insert (recent_cache, key, table);
+    }
+  else
+    g_free (key);
+
+  return table;
+}
+
+
+
+static void
+thunar_io_recent_entry_free (gpointer data)
+{
+  ThunarIoRecentEntry *entry = data;
+
+  g_queue_unlink (&recent_cache_lru, &entry->link);
+  g_object_unref (entry->info);
+  g_free (entry->uri);
+  g_slice_free (ThunarIoRecentEntry, entry);
+}
+
+
+
+static void
+thunar_io_recent_cache_insert (GHashTable                 *table,
+                               const ThunarIoRecentTarget *target)
+{
+  ThunarIoRecentEntry *entry;
+
+  entry = g_slice_new0 (ThunarIoRecentEntry);
+  entry->link.data = entry;
+  entry->table = table;
+  entry->uri = g_strdup (target->uri);
+  entry->info = g_file_info_dup (target->info);
+  entry->stamp = target->stamp;
+
+  /* replaces (and frees) the previous entry of the uri, if any */
+  g_hash_table_replace (table, entry->uri, entry);
+  g_queue_push_tail_link (&recent_cache_lru, &entry->link);
+
+  /* forget the least recently used infos */
+  while (recent_cache_lru.length > THUNAR_IO_RECENT_MAX_ENTRIES)
+    {
+      entry = recent_cache_lru.head->data;
+      g_hash_table_remove (entry->table, entry->uri);
+    }
+}
+
+
+
+static void
+thunar_io_recent_stamp_file (GFile               *file,
+                             GFileQueryInfoFlags  flags,
+                             ThunarIoRecentStamp *stamp)
+{
+  struct stat  statb;
+  const gchar *path;
+  gint         result;
+
+  memset (stamp, 0, sizeof (*stamp));
+  stamp->time = g_get_monotonic_time ();
+
+  /* remote targets are not checked, a stat() may take as long as the query */
+  path = g_file_peek_path (file);
+  if (path == NULL)
+    return;
+
+  stamp->local = TRUE;
+
+  if ((flags & G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS) != 0)
+    result = lstat (path, &statb);
+  else
+    result = stat (path, &statb);
+
+  if (result != 0)
+    return;
+
+  stamp->exists = TRUE;
+  stamp->device = statb.st_dev;
+  stamp->inode = statb.st_ino;
+  stamp->size = statb.st_size;
+  stamp->mtime_sec = statb.st_mtim.tv_sec;
+  stamp->mtime_nsec = statb.st_mtim.tv_nsec;
+  stamp->ctime_sec = statb.st_ctim.tv_sec;
+  stamp->ctime_nsec = statb.st_ctim.tv_nsec;
+}
+
+
+
+/* whether the target of a cached info is still in the state it was queried in */
+static gboolean
+thunar_io_recent_target_is_valid (const ThunarIoRecentTarget *target,
+                                  GFileQueryInfoFlags         flags)
+{
+  ThunarIoRecentStamp stamp;
+  GFile              *file;
+
+  if (!target->stamp.local)
+    return g_get_monotonic_time () - target->stamp.time < THUNAR_IO_RECENT_REMOTE_TIMEOUT;
+
+  file = g_file_new_for_uri (target->uri);
+  thunar_io_recent_stamp_file (file, flags, &stamp);
+  g_object_unref (file);
+
+  /* the ctime also changes with the metadata, like the permissions */
+  return stamp.exists
+         && target->stamp.exists
+         && stamp.device == target->stamp.device
+         && stamp.inode == target->stamp.inode
+         && stamp.size == target->stamp.size
+         && stamp.mtime_sec == target->stamp.mtime_sec
+         && stamp.mtime_nsec == target->stamp.mtime_nsec
+         && stamp.ctime_sec == target->stamp.ctime_sec
+         && stamp.ctime_nsec == target->stamp.ctime_nsec;
+}
+
+
+
+static void
+thunar_io_recent_query_target (gpointer data,
+                               gpointer user_data)
+{
+  ThunarIoRecentTarget *target = data;
+  ThunarIoRecentBatch  *batch = user_data;
+  GFile                *file;
+
+  if (g_cancellable_is_cancelled (batch->cancellable))
+    return;
+
+  /* stamp before querying, so a change meanwhile is noticed next time */
+  file = g_file_new_for_uri (target->uri);
+  thunar_io_recent_stamp_file (file, batch->flags, &target->stamp);
+
+  /* a failure leaves the info unset, so the entry is skipped by the caller */
+  target->info = g_file_query_info (file, batch->attributes, batch->flags, batch->cancellable, NULL);
+  target->queried = TRUE;
+  g_object_unref (file);
+}
+
+
+
+/**
+ * thunar_io_recent_query_targets:
+ * @recent_infos : the #GFileInfo<!---->s of entries enumerated from recent:///
+ * @n_infos      : the number of @recent_infos
+ * @attributes   : the attributes to query for the targets
+ * @flags        : the #GFileQueryInfoFlags to use for the queries
+ * @cancellable  : a #GCancellable or %NULL
+ *
+ * Resolves the target of each recent entry. Targets not known from a
+ * previous call are queried in parallel, with a bounded number of queries
+ * at once. The result is cached until thunar_io_recent_invalidate() is
+ * called. A cached info of a local target is only used if the target
+ * didn't change since, the one of a remote target for a minute.
+ *
+ * Return value: (transfer full): an array of @n_infos target infos, in the
+ *               order of @recent_infos, where unreachable targets are %NULL.
+ *               Release with thunar_io_recent_free_targets().
+ **/
+GFileInfo **
+thunar_io_recent_query_targets (GFileInfo *const   *recent_infos,
+                                guint               n_infos,
+                                const gchar        *attributes,
+                                GFileQueryInfoFlags flags,
+                                GCancellable       *cancellable)
+{
+  ThunarIoRecentTarget *targets;
+  ThunarIoRecentBatch   batch;
+  ThunarIoRecentEntry  *entry;
+  GThreadPool          *pool = NULL;
+  GFileInfo           **target_infos;
+  GHashTable           *table;
+  guint                 generation;
+  guint                 n_missing = 0;
+  guint                 n;
+
+  _thunar_return_val_if_fail (attributes != NULL, NULL);
+
+  target_infos = g_new0 (GFileInfo *, n_infos + 1);
+  targets = g_new0 (ThunarIoRecentTarget, n_infos);
+
+  /* pick whatever is already known from the cache, handing out copies since
+   * the callers are free to modify the returned infos */
+  g_mutex_lock (&recent_cache_mutex);
+  table = thunar_io_recent_cache_lookup_table (attributes, flags);
+  for (n = 0; n < n_infos; n++)
+    {
+      targets[n].uri = g_file_info_get_attribute_string (recent_infos[n], G_FILE_ATTRIBUTE_STANDARD_TARGET_URI);
+      if (G_UNLIKELY (targets[n].uri == NULL))
+        continue;
+
+      entry = g_hash_table_lookup (table, targets[n].uri);
+      if (entry != NULL)
+        {
+          target_infos[n] = g_file_info_dup (entry->info);
+          targets[n].stamp = entry->stamp;
+
+          /* most recently used */
+          g_queue_unlink (&recent_cache_lru, &entry->link);
+          g_queue_push_tail_link (&recent_cache_lru, &entry->link);
+        }
+    }
+  generation = recent_cache_generation;
+  g_mutex_unlock (&recent_cache_mutex);
+
+  /* check the cached infos without holding the lock, targets which were
+   * modified or deleted meanwhile are queried again */
+  for (n = 0; n < n_infos; n++)
+    {
+      if (targets[n].uri == NULL)
+        continue;
+
+      if (target_infos[n] != NULL && !thunar_io_recent_target_is_valid (&targets[n], flags))
+        g_clear_object (&target_infos[n]);
+
+      if (target_infos[n] == NULL)
+        n_missing++;
+    }
+
+  if (n_missing > 0)
+    {
+      batch.attributes = attributes;
+      batch.flags = flags;
+      batch.cancellable = cancellable;
+
+      /* shared threads, so concurrent jobs don't spawn their own set */
+      pool = g_thread_pool_new (thunar_io_recent_query_target, &batch,
+                                MIN (n_missing, THUNAR_IO_RECENT_MAX_QUERIES), FALSE, NULL);
+    }
+
+  if (pool != NULL)
+    {
+      for (n = 0; n < n_infos; n++)
+        if (targets[n].uri != NULL && target_infos[n] == NULL)
+          g_thread_pool_push (pool, &targets[n], NULL);
+
+      /* wait for all queries to finish */
+      g_thread_pool_free (pool, FALSE, TRUE);
+
+      g_mutex_lock (&recent_cache_mutex);
+
+      /* the recent list changed meanwhile, don't cache outdated results */
+      table = (generation == recent_cache_generation) ? thunar_io_recent_cache_lookup_table (attributes, flags) : NULL;
+
+      for (n = 0; n < n_infos; n++)
+        {
+          if (!targets[n].queried)
+            continue;
+
+          /* targets which are gone are dropped from the cache */
+          if (table != NULL && targets[n].info == NULL)
+            g_hash_table_remove (table, targets[n].uri);
+          else if (table != NULL)
+            thunar_io_recent_cache_insert (table, &targets[n]);
+          target_infos[n] = targets[n].info;
+        }
+
+      g_mutex_unlock (&recent_cache_mutex);
+    }
+
+  g_free (targets);
+
+  return target_infos;
+}
+
+
+
+/**
+ * thunar_io_recent_free_targets:
+ * @target_infos : the result of thunar_io_recent_query_targets()
+ * @n_infos      : the number of entries in @target_infos
+ *
+ * Releases @target_infos including all infos still contained.
+ **/
+void
+thunar_io_recent_free_targets (GFileInfo **target_infos,
+                               guint       n_infos)
+{
+  guint n;
+
+  if (target_infos == NULL)
+    return;
+
+  for (n = 0; n < n_infos; n++)
+    if (target_infos[n] != NULL)
+      g_object_unref (target_infos[n]);
+
+  g_free (target_infos);
+}
+
+
+
+/**
+ * thunar_io_recent_invalidate:
+ *
+ * Drops all cached target infos. To be called whenever the list of
+ * recently used files changes.
+ **/
+void
+thunar_io_recent_invalidate (void)
+{
+  g_mutex_lock (&recent_cache_mutex);
+  recent_cache_generation++;
+  g_clear_pointer (&recent_cache, g_hash_table_unref);
+  g_mutex_unlock (&recent_cache_mutex);
+}
@@ -0,0 +1,41 @@
+/* vi:set et ai sw=2 sts=2 ts=2: */
+/*-
+ * Copyright (c) 2026 The Xfce Development Team
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+ * Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef __THUNAR_IO_RECENT_H__
+#define __THUNAR_IO_RECENT_H__
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+GFileInfo **
+thunar_io_recent_query_targets (GFileInfo *const   *recent_infos,
+                                guint               n_infos,
+                                const gchar        *attributes,
+                                GFileQueryInfoFlags flags,
+                                GCancellable       *cancellable);
+void
+thunar_io_recent_free_targets (GFileInfo **target_infos,
+                               guint       n_infos);
+void
+thunar_io_recent_invalidate (void);
+
+G_END_DECLS
+
+#endif /* !__THUNAR_IO_RECENT_H__ */
@@ -19,6 +19,7 @@
  */
 
 #include "thunar/thunar-gio-extensions.h"
+#include "thunar/thunar-io-recent.h"
 #include "thunar/thunar-io-scan-directory.h"
 #include "thunar/thunar-job.h"
 #include "thunar/thunar-private.h"
@@ -54,6 +55,9 @@ thunar_io_scan_directory (ThunarJob          *job,
   GFileEnumerator *enumerator;
   GFileInfo       *info;
   GFileInfo       *recent_info;
+  GPtrArray       *recent_infos = NULL;
+  GFileInfo      **target_infos = NULL;
+  guint            recent_index = 0;
   GFileType        type;
   GError          *err = NULL;
   GFile           *child_file;
@@ -113,11 +117,39 @@ thunar_io_scan_directory (ThunarJob          *job,
       return NULL;
     }
 
+  /* when scanning `recent:///`, read all entries first, so their targets can
+   * be resolved at once instead of one after the other */
+  if (g_file_has_uri_scheme (file, "recent"))
+    {
+      recent_infos = g_ptr_array_new_with_free_func (g_object_unref);
+      while (n_files_max == NULL || recent_infos->len < *n_files_max)
+        {
+          info = g_file_enumerator_next_file (enumerator, cancellable, &err);
+          if (info == NULL)
+            break;
+          g_ptr_array_add (recent_infos, info);
+        }
+
+      if (G_UNLIKELY (err != NULL))
+        {
+          g_ptr_array_unref (recent_infos);
+          g_object_unref (enumerator);
+          g_propagate_error (error, err);
+          return NULL;
+        }
+
+      target_infos = thunar_io_recent_query_targets ((GFileInfo *const *) recent_infos->pdata, recent_infos->len,
+                                                     namespace, flags, cancellable);
+    }
+
   /* iterate over children one by one */
   while (job == NULL || !thunar_job_is_cancelled (THUNAR_JOB (job)))
     {
       /* query info of the child */
-      info = g_file_enumerator_next_file (enumerator, cancellable, &err);
+      if (recent_infos != NULL)
+        info = recent_index < recent_infos->len ? g_object_ref (g_ptr_array_index (recent_infos, recent_index)) : NULL;
+      else
+        info = g_file_enumerator_next_file (enumerator, cancellable, &err);
 
       /* break when end of enumerator is reached */
       if (G_UNLIKELY (info == NULL && err == NULL))
@@ -166,20 +198,21 @@ thunar_io_scan_directory (ThunarJob          *job,
         }
 
       /* check if we are scanning `recent:///` */
-      if (g_file_has_uri_scheme (file, "recent"))
+      if (recent_infos != NULL)
         {
-          /* create Gfile using the target URI */
-          child_file = g_file_new_for_uri (g_file_info_get_attribute_string (info, G_FILE_ATTRIBUTE_STANDARD_TARGET_URI));
-
-          /* create new file info using Gfile*/
+          /* take the resolved info of the target */
           recent_info = info;
-          info = g_file_query_info (child_file, namespace, flags, cancellable, &err);
+          info = g_steal_pointer (&target_infos[recent_index++]);
 
+          /* skip entries whose target is gone or unreachable */
           if (G_UNLIKELY (info == NULL))
             {
               g_object_unref (recent_info);
-              break;
+              continue;
             }
+
+          /* create Gfile using the target URI */
+          child_file = g_file_new_for_uri (g_file_info_get_attribute_string (recent_info, G_FILE_ATTRIBUTE_STANDARD_TARGET_URI));
         }
       else
         {
@@ -216,11 +249,19 @@ thunar_io_scan_directory (ThunarJob          *job,
 
       g_object_unref (child_file);
       g_object_unref (info);
+      if (recent_info != NULL)
+        g_object_unref (recent_info);
     }
 
   /* release the enumerator */
   g_object_unref (enumerator);
 
+  if (recent_infos != NULL)
+    {
+      thunar_io_recent_free_targets (target_infos, recent_infos->len);
+      g_ptr_array_unref (recent_infos);
+    }
+
   if (G_UNLIKELY (err != NULL))
     {
       g_propagate_error (error, err);
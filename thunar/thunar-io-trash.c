@@ -0,0 +1,343 @@
+/* vi:set et ai sw=2 sts=2 ts=2: */
+/*-
+ * Copyright (c) 2026 The Xfce Development Team
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+ * Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef __linux__
+#define _GNU_SOURCE
+#endif
+
+#ifdef HAVE_ERRNO_H
+#include <errno.h>
+#endif
+#ifdef HAVE_FCNTL_H
+#include <fcntl.h>
+#endif
+#ifdef HAVE_STDIO_H
+#include <stdio.h>
+#endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+#ifdef HAVE_SYS_STAT_H
+#include <sys/stat.h>
+#endif
+#ifdef HAVE_TIME_H
+#include <time.h>
+#endif
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+#include "thunar/thunar-io-trash.h"
+#include "thunar/thunar-private.h"
+#include "thunar/thunar-util.h"
+
+#include <glib/gstdio.h>
+
+
+
+/* Moves local files into the home trash as described by the freedesktop.org
+ * trash specification, without the per-file setup done by g_file_trash(): the
+ * trash folders and the folder of the trashed files stay open, and every file
+ * only costs the creation of its info file and a rename. */
+struct _ThunarIoTrash
+{
+  /* the home trash and its folders */
+  gchar *path;
+  dev_t  dev;
+  gint   files_fd;
+  gint   info_fd;
+
+  /* the folder of the previous file, most files share it */
+  gchar *dir_path;
+  gint   dir_fd;
+
+  /* the deletion date of the previous file, formatted again once a second passed */
+  time_t date_time;
+  gchar  date[32];
+};
+
+
+
+/**
+ * thunar_io_trash_new:
+ *
+ * Opens the home trash of the user, creating its folders if needed.
+ *
+ * Return value: a new #ThunarIoTrash or %NULL if the home trash cannot
+ *               be used, free it with thunar_io_trash_free().
+ **/
+ThunarIoTrash *
+thunar_io_trash_new (void)
+{
+  ThunarIoTrash *trash;
+  struct stat    statbuf;
+  gchar         *files_path;
+  gchar         *info_path;
+
+  trash = g_slice_new0 (ThunarIoTrash);
+  trash->path = g_build_filename (g_get_user_data_dir (), "Trash", NULL);
+  trash->files_fd = -1;
+  trash->info_fd = -1;
+  trash->dir_fd = -1;
+  trash->date_time = (time_t) -1;
+
+  /* the folders of the trash are only accessible by the user */
+  files_path = g_build_filename (trash->path, "files", NULL);
+  info_path = g_build_filename (trash->path, "info", NULL);
+  if (g_mkdir_with_parents (files_path, 0700) == 0 && g_mkdir_with_parents (info_path, 0700) == 0)
+    {
+      trash->files_fd = open (files_path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+      trash->info_fd = open (info_path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    }
+  g_free (files_path);
+  g_free (info_path);
+
+  if (trash->files_fd < 0 || trash->info_fd < 0 || fstat (trash->files_fd, &statbuf) != 0)
+    {
+      thunar_io_trash_free (trash);
+      return NULL;
+    }
+
+  trash->dev = statbuf.st_dev;
+
+  return trash;
+}
+
+
+
+/* the name of the @n-th attempt to store @basename in the trash, the
+ * number goes in front of the extension, like "photo.2.jpg" or "backup.2.tar.gz" */
+static gchar *
+thunar_io_trash_unique_name (const gchar *basename,
+                             guint        n)
+{
+  const gchar *dot;
+
+  if (n == 1)
+    return g_strdup (basename);
+
+  dot = thunar_util_str_get_extension (basename);
+  if (dot != NULL)
+    return g_strdup_printf ("%.*s.%u%s", (gint) (dot - basename), basename, n, dot);
+  else
+    return g_strdup_printf ("%s.%u", basename, n);
+}
+
+
+
+static gboolean
+thunar_io_trash_write (gint         fd,
+                       const gchar *data,
+                       gsize        length)
+{
+  gssize n;
+
+  while (length > 0)
+    {
+      n = write (fd, data, length);
+      if (n < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          return FALSE;
+        }
+
+      data += n;
+      length -= n;
+    }
+
+  return TRUE;
+}
+
+
+
+/* renames @name in @dir_fd to @trash_name in @trash_fd, failing with EEXIST
+ * instead of replacing a file left in the trash without its info file */
+static gint
+thunar_io_trash_rename (gint         dir_fd,
+                        const gchar *name,
+                        gint         trash_fd,
+                        const gchar *trash_name)
+{
+  struct stat statbuf;
+
+#if defined(HAVE_RENAMEAT2) && defined(RENAME_NOREPLACE)
+  if (renameat2 (dir_fd, name, trash_fd, trash_name, RENAME_NOREPLACE) == 0)
+    return 0;
+
+  /* not every file system supports the flag */
+  if (errno != EINVAL && errno != ENOSYS)
+    return -1;
+#endif
+
+  if (fstatat (trash_fd, trash_name, &statbuf, AT_SYMLINK_NOFOLLOW) == 0)
+    {
+      errno = EEXIST;
+      return -1;
+    }
+
+  return renameat (dir_fd, name, trash_fd, trash_name);
+}
+
+
+
+/**
+ * thunar_io_trash_file:
+ * @trash : a #ThunarIoTrash
+ * @file  : the #GFile to trash
+ *
+ * Moves @file into the home trash if it is a local file on the same file
+ * system. Its info file is written before, as the trash specification
+ * requires, and removed again if the file cannot be moved.
+ *
+ * Return value: %TRUE if @file was trashed, %FALSE if it was left in place
+ *               and has to be trashed by g_file_trash() instead, which
+ *               also reports the error, if any.
+ **/
+gboolean
+thunar_io_trash_file (ThunarIoTrash *trash,
+                      GFile         *file)
+{
+  struct stat  statbuf;
+  struct tm    tm;
+  const gchar *path;
+  gchar       *dir_path;
+  gchar       *basename;
+  gchar       *escaped;
+  gchar       *contents;
+  gchar       *name;
+  gchar       *info_name;
+  gboolean     trashed = FALSE;
+  gboolean     failed = FALSE;
+  gboolean     written;
+  time_t       now;
+  gsize        length;
+  gsize        path_length;
+  guint        n;
+  gint         fd;
+
+  _thunar_return_val_if_fail (trash != NULL, FALSE);
+  _thunar_return_val_if_fail (G_IS_FILE (file), FALSE);
+
+  /* files on other file systems go to the trash of their file system */
+  path = g_file_peek_path (file);
+  if (path == NULL || g_lstat (path, &statbuf) != 0 || statbuf.st_dev != trash->dev)
+    return FALSE;
+
+  /* the trash itself is never trashed */
+  path_length = strlen (trash->path);
+  if (strncmp (path, trash->path, path_length) == 0 && (path[path_length] == '\0' || path[path_length] == G_DIR_SEPARATOR))
+    return FALSE;
+
+  dir_path = g_path_get_dirname (path);
+  if (g_strcmp0 (dir_path, trash->dir_path) != 0)
+    {
+      if (trash->dir_fd >= 0)
+        close (trash->dir_fd);
+
+      g_free (trash->dir_path);
+      trash->dir_path = dir_path;
+      trash->dir_fd = open (dir_path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    }
+  else
+    {
+      g_free (dir_path);
+    }
+
+  if (trash->dir_fd < 0)
+    return FALSE;
+
+  /* the deletion date is in local time, without time zone */
+  now = time (NULL);
+  if (now != trash->date_time && localtime_r (&now, &tm) != NULL)
+    {
+      strftime (trash->date, sizeof (trash->date), "%Y-%m-%dT%H:%M:%S", &tm);
+      trash->date_time = now;
+    }
+
+  /* the original location is an absolute path in the home trash, escaped like an URI */
+  escaped = g_uri_escape_string (path, "/", FALSE);
+  contents = g_strdup_printf ("[Trash Info]\nPath=%s\nDeletionDate=%s\n", escaped, trash->date);
+  length = strlen (contents);
+  g_free (escaped);
+
+  basename = g_path_get_basename (path);
+  for (n = 1; !trashed && !failed; n++)
+    {
+      name = thunar_io_trash_unique_name (basename, n);
+      info_name = g_strconcat (name, ".trashinfo", NULL);
+
+      /* the info file is created exclusively, which reserves the name in the trash */
+      fd = openat (trash->info_fd, info_name, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+      if (fd >= 0)
+        {
+          written = thunar_io_trash_write (fd, contents, length);
+          if (close (fd) != 0)
+            written = FALSE;
+
+          if (written && thunar_io_trash_rename (trash->dir_fd, basename, trash->files_fd, name) == 0)
+            {
+              trashed = TRUE;
+            }
+          else
+            {
+              /* a file left in the trash without its info file keeps its name */
+              failed = (!written || errno != EEXIST);
+              unlinkat (trash->info_fd, info_name, 0);
+            }
+        }
+      else
+        {
+          failed = (errno != EEXIST);
+        }
+
+      g_free (info_name);
+      g_free (name);
+    }
+
+  g_free (basename);
+  g_free (contents);
+
+  return trashed;
+}
+
+
+
+/**
+ * thunar_io_trash_free:
+ * @trash : a #ThunarIoTrash
+ *
+ * Closes the folders opened by @trash and frees it.
+ **/
+void
+thunar_io_trash_free (ThunarIoTrash *trash)
+{
+  _thunar_return_if_fail (trash != NULL);
+
+  if (trash->files_fd >= 0)
+    close (trash->files_fd);
+  if (trash->info_fd >= 0)
+    close (trash->info_fd);
+  if (trash->dir_fd >= 0)
+    close (trash->dir_fd);
+
+  g_free (trash->dir_path);
+  g_free (trash->path);
+  g_slice_free (ThunarIoTrash, trash);
+}
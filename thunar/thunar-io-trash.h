@@ -0,0 +1,39 @@
+/* vi:set et ai sw=2 sts=2 ts=2: */
+/*-
+ * Copyright (c) 2026 The Xfce Development Team
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+ * Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef __THUNAR_IO_TRASH_H__
+#define __THUNAR_IO_TRASH_H__
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ThunarIoTrash ThunarIoTrash;
+
+ThunarIoTrash *
+thunar_io_trash_new (void);
+gboolean
+thunar_io_trash_file (ThunarIoTrash *trash,
+                      GFile         *file);
+void
+thunar_io_trash_free (ThunarIoTrash *trash);
+
+G_END_DECLS
+
+#endif /* !__THUNAR_IO_TRASH_H__ */
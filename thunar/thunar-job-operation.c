@@ -54,6 +54,10 @@ struct _ThunarJobOperation
   /* Files overwritten as a part of an operation */
   GList *overwritten_files;
 
+  /* Files created next to the targets, like checksum files, which
+   * are deleted when the operation is undone */
+  GList *created_files;
+
   /**
    * Optional timestamps (in seconds) which tell when the operation was started and ended.
    * Only used for trash/restore operations.
@@ -84,6 +88,7 @@ thunar_job_operation_init (ThunarJobOperation *self)
   self->source_file_list = NULL;
   self->target_file_list = NULL;
   self->overwritten_files = NULL;
+  self->created_files = NULL;
 }
 
 
@@ -98,6 +103,7 @@ thunar_job_operation_finalize (GObject *object)
   g_list_free_full (op->source_file_list, g_object_unref);
   g_list_free_full (op->target_file_list, g_object_unref);
   g_list_free_full (op->overwritten_files, g_object_unref);
+  g_list_free_full (op->created_files, g_object_unref);
 
   (*G_OBJECT_CLASS (thunar_job_operation_parent_class)->finalize) (object);
 }
@@ -164,6 +170,61 @@ thunar_job_operation_add (ThunarJobOperation *job_operation,
 
 
 
+/**
+ * thunar_job_operation_add_files:
+ * @job_operation: a #ThunarJobOperation
+ * @source_files:  a #GList of #GFile<!---->s
+ *
+ * Adds each of the @source_files without a target file to the given job operation,
+ * like thunar_job_operation_add() does, but without searching the whole list of
+ * the operation for every file, which matters for operations on many files.
+ **/
+void
+thunar_job_operation_add_files (ThunarJobOperation *job_operation,
+                                GList              *source_files)
+{
+  GHashTable *added;
+  GList      *new_files = NULL;
+  GList      *lp;
+  GFile      *ancestor;
+  GFile      *parent;
+  gboolean    is_descendant;
+
+  _thunar_return_if_fail (THUNAR_IS_JOB_OPERATION (job_operation));
+
+  added = g_hash_table_new (g_file_hash, (GEqualFunc) g_file_equal);
+  for (lp = job_operation->source_file_list; lp != NULL; lp = lp->next)
+    g_hash_table_add (added, lp->data);
+
+  for (lp = source_files; lp != NULL; lp = lp->next)
+    {
+      _thunar_assert (G_IS_FILE (lp->data));
+
+      /* skip descendants of files already added, see thunar_job_operation_add() */
+      is_descendant = FALSE;
+      for (ancestor = g_object_ref (lp->data); !is_descendant && ancestor != NULL; ancestor = parent)
+        {
+          is_descendant = g_hash_table_contains (added, ancestor);
+          parent = g_file_get_parent (ancestor);
+          g_object_unref (ancestor);
+        }
+      if (ancestor != NULL)
+        g_object_unref (ancestor);
+
+      if (is_descendant)
+        continue;
+
+      g_hash_table_add (added, lp->data);
+      new_files = g_list_prepend (new_files, g_object_ref (lp->data));
+    }
+
+  job_operation->source_file_list = g_list_concat (job_operation->source_file_list, g_list_reverse (new_files));
+
+  g_hash_table_destroy (added);
+}
+
+
+
 /***
  * thunar_job_operation_overwrite:
  * @job_operation:    a #ThunarJobOperation
@@ -182,6 +243,27 @@ thunar_job_operation_overwrite (ThunarJobOperation *job_operation,
 
 
 
+/**
+ * thunar_job_operation_add_created:
+ * @job_operation: a #ThunarJobOperation
+ * @created_file:  a #GFile representing the file that has been created
+ *
+ * Logs a file created next to the targets of a copy operation, like a
+ * checksum file. It is deleted when the operation is undone, but not
+ * copied again when it is redone, the copy creates it anew.
+ **/
+void
+thunar_job_operation_add_created (ThunarJobOperation *job_operation,
+                                  GFile              *created_file)
+{
+  _thunar_return_if_fail (THUNAR_IS_JOB_OPERATION (job_operation));
+  _thunar_return_if_fail (G_IS_FILE (created_file));
+
+  job_operation->created_files = thunar_g_list_append_deep (job_operation->created_files, created_file);
+}
+
+
+
 /**
  * thunar_job_operation_get_timestamps:
  * @job_operation: a #ThunarJobOperation
@@ -327,7 +409,8 @@ thunar_job_operation_new_invert (ThunarJobOperation *job_operation)
     case THUNAR_JOB_OPERATION_KIND_COPY:
       inverted_operation = g_object_new (THUNAR_TYPE_JOB_OPERATION, NULL);
       inverted_operation->operation_kind = THUNAR_JOB_OPERATION_KIND_DELETE;
-      inverted_operation->source_file_list = thunar_g_list_copy_deep (job_operation->target_file_list);
+      inverted_operation->source_file_list = g_list_concat (thunar_g_list_copy_deep (job_operation->target_file_list),
+                                                            thunar_g_list_copy_deep (job_operation->created_files));
       break;
 
     case THUNAR_JOB_OPERATION_KIND_MOVE:
@@ -532,7 +615,7 @@ thunar_job_operation_execute (ThunarJobOperation *job_operation,
     case THUNAR_JOB_OPERATION_KIND_COPY:
       thunar_application_copy_to (application, NULL,
                                   job_operation->source_file_list, job_operation->target_file_list,
-                                  THUNAR_OPERATION_LOG_NO_OPERATIONS, NULL);
+                                  THUNAR_OPERATION_LOG_NO_OPERATIONS, NULL, NULL);
       break;
 
     case THUNAR_JOB_OPERATION_KIND_CREATE_FILE:
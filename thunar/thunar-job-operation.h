@@ -36,8 +36,14 @@ thunar_job_operation_add (ThunarJobOperation *job_operation,
                           GFile              *source_file,
                           GFile              *target_file);
 void
+thunar_job_operation_add_files (ThunarJobOperation *job_operation,
+                                GList              *source_files);
+void
 thunar_job_operation_overwrite (ThunarJobOperation *job_operation,
                                 GFile              *overwritten_file);
+void
+thunar_job_operation_add_created (ThunarJobOperation *job_operation,
+                                  GFile              *created_file);
 ThunarJobOperation *
 thunar_job_operation_new_invert (ThunarJobOperation *job_operation);
 gboolean
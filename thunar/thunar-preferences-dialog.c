@@ -32,6 +32,7 @@
 #include "thunar/thunar-renamer-dialog.h"
 #include "thunar/thunar-shortcuts-view.h"
 #include "thunar/thunar-statusbar.h"
+#include "thunar/thunar-treemap-view.h"
 #include "thunar/thunar-util.h"
 #include "thunar/thunar-window.h"
 
@@ -125,8 +126,10 @@ transform_view_string_to_index (GBinding     *binding,
     g_value_set_int (dst_value, 1);
   else if (type == THUNAR_TYPE_COMPACT_VIEW)
     g_value_set_int (dst_value, 2);
-  else
+  else if (type == THUNAR_TYPE_TREEMAP_VIEW)
     g_value_set_int (dst_value, 3);
+  else
+    g_value_set_int (dst_value, 4);
 
   return TRUE;
 }
@@ -153,6 +156,10 @@ transform_view_index_to_string (GBinding     *binding,
       g_value_set_static_string (dst_value, g_type_name (THUNAR_TYPE_COMPACT_VIEW));
       break;
 
+    case 3:
+      g_value_set_static_string (dst_value, g_type_name (THUNAR_TYPE_TREEMAP_VIEW));
+      break;
+
     default:
       g_value_set_static_string (dst_value, g_type_name (G_TYPE_NONE));
       break;
@@ -368,6 +375,7 @@ thunar_preferences_dialog_init (ThunarPreferencesDialog *dialog)
   gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (combo), _("Icon View"));
   gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (combo), _("List View"));
   gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (combo), _("Compact View"));
+  gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (combo), _("Treemap View"));
   gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (combo), _("Last Active View"));
   g_object_bind_property_full (G_OBJECT (dialog->preferences), "default-view",
                                G_OBJECT (combo), "active",
@@ -1323,6 +1331,38 @@ thunar_preferences_dialog_init (ThunarPreferencesDialog *dialog)
   gtk_label_set_mnemonic_widget (GTK_LABEL (label), combo);
   gtk_widget_show (combo);
 
+  /* next row */
+  row++;
+
+  label = gtk_label_new_with_mnemonic (_("Share data of copies (reflink):"));
+  gtk_label_set_xalign (GTK_LABEL (label), 0.0f);
+  gtk_grid_attach (GTK_GRID (grid), label, 0, row, 1, 1);
+  gtk_widget_show (label);
+  gtk_widget_set_tooltip_text (label, _("On file systems like Btrfs or XFS, a copy of a local file can share its data "
+                                        "with the original until either of them is modified. Such copies are done "
+                                        "instantly and take no additional space. With \"Always\", local files are "
+                                        "not copied at all if the file system does not support this."));
+
+  combo = gtk_combo_box_text_new ();
+  type = g_type_class_ref (THUNAR_TYPE_REFLINK_MODE);
+  gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (combo), _(g_enum_get_value (type, THUNAR_REFLINK_MODE_NEVER)->value_nick));
+  gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (combo), _(g_enum_get_value (type, THUNAR_REFLINK_MODE_AUTO)->value_nick));
+  gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (combo), _(g_enum_get_value (type, THUNAR_REFLINK_MODE_ALWAYS)->value_nick));
+  g_type_class_unref (type);
+  g_object_bind_property_full (G_OBJECT (dialog->preferences),
+                               "misc-transfer-reflink-mode",
+                               G_OBJECT (combo),
+                               "active",
+                               G_BINDING_BIDIRECTIONAL | G_BINDING_SYNC_CREATE,
+                               transform_enum_value_to_index,
+                               transform_index_to_enum_value,
+                               (gpointer) thunar_reflink_mode_get_type, NULL);
+  gtk_widget_set_hexpand (combo, TRUE);
+  gtk_grid_attach (GTK_GRID (grid), combo, 1, row, 1, 1);
+  thunar_gtk_label_set_a11y_relation (GTK_LABEL (label), combo);
+  gtk_label_set_mnemonic_widget (GTK_LABEL (label), combo);
+  gtk_widget_show (combo);
+
   frame = g_object_new (GTK_TYPE_FRAME, "border-width", 0, "shadow-type", GTK_SHADOW_NONE, NULL);
   gtk_box_pack_start (GTK_BOX (vbox), frame, FALSE, TRUE, 0);
   gtk_widget_show (frame);
@@ -1364,6 +1404,93 @@ thunar_preferences_dialog_init (ThunarPreferencesDialog *dialog)
   gtk_label_set_mnemonic_widget (GTK_LABEL (label), combo);
   gtk_widget_show (combo);
 
+  /* next row */
+  row++;
+
+  label = gtk_label_new_with_mnemonic (_("Match file names using:"));
+  gtk_label_set_xalign (GTK_LABEL (label), 0.0f);
+  gtk_grid_attach (GTK_GRID (grid), label, 0, row, 1, 1);
+  gtk_widget_show (label);
+
+  combo = gtk_combo_box_text_new ();
+  gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (combo), _("Substrings"));
+  gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (combo), _("Wildcards"));
+  gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (combo), _("Regular Expressions"));
+  g_object_bind_property (G_OBJECT (dialog->preferences),
+                          "misc-search-mode",
+                          G_OBJECT (combo),
+                          "active",
+                          G_BINDING_BIDIRECTIONAL | G_BINDING_SYNC_CREATE);
+  gtk_widget_set_tooltip_text (combo, _("Wildcard patterns like \"*.log\" and regular expressions like \"^IMG_\\d{4}\" "
+                                        "are compiled once per search. Wildcard patterns containing a \"/\" are "
+                                        "matched against the path relative to the searched folder."));
+  gtk_widget_set_hexpand (combo, TRUE);
+  gtk_grid_attach (GTK_GRID (grid), combo, 1, row, 1, 1);
+  thunar_gtk_label_set_a11y_relation (GTK_LABEL (label), combo);
+  gtk_label_set_mnemonic_widget (GTK_LABEL (label), combo);
+  gtk_widget_show (combo);
+
+  /* next row */
+  row++;
+
+  label = gtk_label_new_with_mnemonic (_("Maximum subfolder _depth:"));
+  gtk_label_set_xalign (GTK_LABEL (label), 0.0f);
+  gtk_grid_attach (GTK_GRID (grid), label, 0, row, 1, 1);
+  gtk_widget_show (label);
+
+  button = gtk_spin_button_new_with_range (-1, 999, 1);
+  g_object_bind_property (G_OBJECT (dialog->preferences),
+                          "misc-search-max-depth",
+                          G_OBJECT (button),
+                          "value",
+                          G_BINDING_BIDIRECTIONAL | G_BINDING_SYNC_CREATE);
+  gtk_widget_set_tooltip_text (button, _("The number of subfolder levels a recursive search descends into. "
+                                         "Set the value to 0 to only search the current folder, or to -1 for no limit."));
+  gtk_widget_set_halign (button, GTK_ALIGN_START);
+  gtk_grid_attach (GTK_GRID (grid), button, 1, row, 1, 1);
+  thunar_gtk_label_set_a11y_relation (GTK_LABEL (label), button);
+  gtk_label_set_mnemonic_widget (GTK_LABEL (label), button);
+  gtk_widget_show (button);
+
+  /* next row */
+  row++;
+
+  label = gtk_label_new_with_mnemonic (_("E_xcluded folders:"));
+  gtk_label_set_xalign (GTK_LABEL (label), 0.0f);
+  gtk_grid_attach (GTK_GRID (grid), label, 0, row, 1, 1);
+  gtk_widget_show (label);
+
+  entry = gtk_entry_new ();
+  gtk_entry_set_placeholder_text (GTK_ENTRY (entry), _(".git, node_modules, ~/.cache"));
+  g_object_bind_property (G_OBJECT (dialog->preferences),
+                          "misc-search-excluded-folders",
+                          G_OBJECT (entry),
+                          "text",
+                          G_BINDING_BIDIRECTIONAL | G_BINDING_SYNC_CREATE);
+  gtk_widget_set_tooltip_text (entry, _("Comma separated list of folders a recursive search never descends into. "
+                                        "Entries containing a \"/\" are folder paths, all other entries are "
+                                        "wildcard patterns for folder names."));
+  gtk_widget_set_hexpand (entry, TRUE);
+  gtk_grid_attach (GTK_GRID (grid), entry, 1, row, 1, 1);
+  thunar_gtk_label_set_a11y_relation (GTK_LABEL (label), entry);
+  gtk_label_set_mnemonic_widget (GTK_LABEL (label), entry);
+  gtk_widget_show (entry);
+
+  /* next row */
+  row++;
+
+  button = gtk_check_button_new_with_mnemonic (_("Stay on the same _file system"));
+  g_object_bind_property (G_OBJECT (dialog->preferences),
+                          "misc-search-same-filesystem",
+                          G_OBJECT (button),
+                          "active",
+                          G_BINDING_BIDIRECTIONAL | G_BINDING_SYNC_CREATE);
+  gtk_widget_set_tooltip_text (button, _("Select this option to not search inside of other file systems "
+                                         "mounted below the current folder, like network shares or removable drives."));
+  gtk_widget_set_hexpand (button, TRUE);
+  gtk_grid_attach (GTK_GRID (grid), button, 0, row, 2, 1);
+  gtk_widget_show (button);
+
   frame = g_object_new (GTK_TYPE_FRAME, "border-width", 0, "shadow-type", GTK_SHADOW_NONE, NULL);
   gtk_box_pack_start (GTK_BOX (vbox), frame, FALSE, TRUE, 0);
   gtk_widget_show (frame);
@@ -75,6 +75,7 @@ enum
   PROP_LAST_SORT_ORDER,
   PROP_LAST_STATUSBAR_VISIBLE,
   PROP_LAST_IMAGE_PREVIEW_VISIBLE,
+  PROP_LAST_TREEMAP_VIEW_ZOOM_LEVEL,
   PROP_LAST_VIEW,
   PROP_LAST_WINDOW_HEIGHT,
   PROP_LAST_WINDOW_WIDTH,
@@ -103,6 +104,10 @@ enum
   PROP_MISC_OPEN_NEW_WINDOW_AS_TAB,
   PROP_MISC_RECURSIVE_PERMISSIONS,
   PROP_MISC_RECURSIVE_SEARCH,
+  PROP_MISC_SEARCH_MODE,
+  PROP_MISC_SEARCH_SAME_FILESYSTEM,
+  PROP_MISC_SEARCH_EXCLUDED_FOLDERS,
+  PROP_MISC_SEARCH_MAX_DEPTH,
   PROP_MISC_REMEMBER_GEOMETRY,
   PROP_MISC_RESOLVE_LINKS,
   PROP_MISC_SHOW_ABOUT_TEMPLATES,
@@ -122,6 +127,15 @@ enum
   PROP_MISC_WINDOW_ICON,
   PROP_MISC_TRANSFER_USE_PARTIAL,
   PROP_MISC_TRANSFER_VERIFY_FILE,
+  PROP_MISC_TRANSFER_PARALLEL_FILES,
+  PROP_MISC_TRANSFER_REFLINK_MODE,
+  PROP_MISC_TRANSFER_CHECKSUM_FILES,
+  PROP_MISC_TRANSFER_BUDGET_ROTATIONAL,
+  PROP_MISC_TRANSFER_BUDGET_SOLID_STATE,
+  PROP_MISC_TRANSFER_BUDGET_REMOTE,
+  PROP_MISC_TRANSFER_PIPELINED,
+  PROP_MISC_TRANSFER_JOURNAL,
+  PROP_MISC_TRANSFER_PRESERVE_HARD_LINKS,
   PROP_MISC_IMAGE_PREVIEW_FULL,
   PROP_SHORTCUTS_ICON_EMBLEMS,
   PROP_SHORTCUTS_ICON_SIZE,
@@ -610,6 +624,19 @@ thunar_preferences_class_init (ThunarPreferencesClass *klass)
                         FALSE,
                         G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
 
+  /**
+   * ThunarPreferences:last-treemap-view-zoom-level:
+   *
+   * The last selected #ThunarZoomLevel for the #ThunarTreemapView.
+   **/
+  preferences_props[PROP_LAST_TREEMAP_VIEW_ZOOM_LEVEL] =
+  g_param_spec_enum ("last-treemap-view-zoom-level",
+                     "LastTreemapViewZoomLevel",
+                     NULL,
+                     THUNAR_TYPE_ZOOM_LEVEL,
+                     THUNAR_ZOOM_LEVEL_100_PERCENT,
+                     G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
   /**
    * ThunarPreferences:last-view:
    *
@@ -713,7 +740,7 @@ thunar_preferences_class_init (ThunarPreferencesClass *klass)
                        "menu:0,back:1,forward:1,open-parent:1,open-home:1,"
                        "new-tab:0,new-window:0,toggle-split-view:0,"
                        "undo:0,redo:0,zoom-out:0,zoom-in:0,zoom-reset:0,"
-                       "view-as-icons:0,view-as-detailed-list:0,view-as-compact-list:0,view-switcher:0,show-hidden:0,"
+                       "view-as-icons:0,view-as-detailed-list:0,view-as-compact-list:0,view-as-treemap:0,view-switcher:0,show-hidden:0,"
                        "location-bar:1,reload:0,search:1",
                        G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
 
@@ -941,6 +968,62 @@ thunar_preferences_class_init (ThunarPreferencesClass *klass)
                      THUNAR_RECURSIVE_SEARCH_ALWAYS,
                      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
 
+  /**
+   * ThunarPreferences:misc-search-mode:
+   *
+   * Whether the search query is split into substrings, or interpreted
+   * as a wildcard pattern or as a regular expression.
+   **/
+  preferences_props[PROP_MISC_SEARCH_MODE] =
+  g_param_spec_enum ("misc-search-mode",
+                     "MiscSearchMode",
+                     NULL,
+                     THUNAR_TYPE_SEARCH_MODE,
+                     THUNAR_SEARCH_MODE_SUBSTRING,
+                     G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * ThunarPreferences:misc-search-same-filesystem:
+   *
+   * Whether a recursive search stays on the filesystem of the searched
+   * folder, so mount points (including bind and network mounts) below it
+   * are not descended into.
+   **/
+  preferences_props[PROP_MISC_SEARCH_SAME_FILESYSTEM] =
+  g_param_spec_boolean ("misc-search-same-filesystem",
+                        "MiscSearchSameFilesystem",
+                        NULL,
+                        FALSE,
+                        G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * ThunarPreferences:misc-search-excluded-folders:
+   *
+   * Comma separated list of folders a recursive search never descends
+   * into. Entries containing a '/' are folder paths (a leading '~' is
+   * expanded), all other entries are wildcard patterns for folder names.
+   **/
+  preferences_props[PROP_MISC_SEARCH_EXCLUDED_FOLDERS] =
+  g_param_spec_string ("misc-search-excluded-folders",
+                       "MiscSearchExcludedFolders",
+                       NULL,
+                       "",
+                       G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * ThunarPreferences:misc-search-max-depth:
+   *
+   * Maximum number of subfolder levels a recursive search descends into.
+   * 0 only searches the current folder, -1 for unlimited.
+   **/
+  preferences_props[PROP_MISC_SEARCH_MAX_DEPTH] =
+  g_param_spec_int ("misc-search-max-depth",
+                    "MiscSearchMaxDepth",
+                    NULL,
+                    -1, G_MAXINT,
+                    -1,
+                    G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
   /**
    * ThunarPreferences:misc-remember-geometry:
    *
@@ -1163,6 +1246,132 @@ thunar_preferences_class_init (ThunarPreferencesClass *klass)
                      THUNAR_VERIFY_FILE_MODE_DISABLED,
                      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
 
+  /**
+   * ThunarPreferences:misc-transfer-parallel-files:
+   *
+   * The maximum number of files copied at the same time within a single
+   * copy operation between local folders. Speeds up copying many small
+   * files, 1 copies one file after another.
+   **/
+  preferences_props[PROP_MISC_TRANSFER_PARALLEL_FILES] =
+  g_param_spec_uint ("misc-transfer-parallel-files",
+                     "MiscTransferParallelFiles",
+                     NULL,
+                     1, 64,
+                     1,
+                     G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * ThunarPreferences:misc-transfer-reflink-mode:
+   *
+   * Whether copies of local files share the data with the original file
+   * (reflink) on file systems supporting it, like Btrfs or XFS.
+   **/
+  preferences_props[PROP_MISC_TRANSFER_REFLINK_MODE] =
+  g_param_spec_enum ("misc-transfer-reflink-mode",
+                     "MiscTransferReflinkMode",
+                     NULL,
+                     THUNAR_TYPE_REFLINK_MODE,
+                     THUNAR_REFLINK_MODE_AUTO,
+                     G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * ThunarPreferences:misc-transfer-checksum-files:
+   *
+   * Whether a "<name>.sha256" file with the checksum of the data is written
+   * next to each copy of a local regular file. Without
+   * misc-transfer-verify-file, the checksum is taken from the source only.
+   **/
+  preferences_props[PROP_MISC_TRANSFER_CHECKSUM_FILES] =
+  g_param_spec_boolean ("misc-transfer-checksum-files",
+                        "MiscTransferChecksumFiles",
+                        NULL,
+                        FALSE,
+                        G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * ThunarPreferences:misc-transfer-budget-rotational:
+   *
+   * The number of files copied from or to a single hard disk at the same
+   * time, by all running copy and move operations together.
+   **/
+  preferences_props[PROP_MISC_TRANSFER_BUDGET_ROTATIONAL] =
+  g_param_spec_uint ("misc-transfer-budget-rotational",
+                     "MiscTransferBudgetRotational",
+                     NULL,
+                     1, 64,
+                     1,
+                     G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * ThunarPreferences:misc-transfer-budget-solid-state:
+   *
+   * The number of files copied from or to a single SSD (or another local
+   * device which is not a hard disk) at the same time.
+   **/
+  preferences_props[PROP_MISC_TRANSFER_BUDGET_SOLID_STATE] =
+  g_param_spec_uint ("misc-transfer-budget-solid-state",
+                     "MiscTransferBudgetSolidState",
+                     NULL,
+                     1, 64,
+                     4,
+                     G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * ThunarPreferences:misc-transfer-budget-remote:
+   *
+   * The number of files copied from or to a single remote location, like
+   * a network share, at the same time.
+   **/
+  preferences_props[PROP_MISC_TRANSFER_BUDGET_REMOTE] =
+  g_param_spec_uint ("misc-transfer-budget-remote",
+                     "MiscTransferBudgetRemote",
+                     NULL,
+                     1, 64,
+                     1,
+                     G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * ThunarPreferences:misc-transfer-pipelined:
+   *
+   * Whether copying starts right away while the folders are still
+   * scanned, instead of collecting all files before the first one is
+   * copied. The total size shown grows while the scan proceeds.
+   **/
+  preferences_props[PROP_MISC_TRANSFER_PIPELINED] =
+  g_param_spec_boolean ("misc-transfer-pipelined",
+                        "MiscTransferPipelined",
+                        NULL,
+                        FALSE,
+                        G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * ThunarPreferences:misc-transfer-journal:
+   *
+   * Whether copies keep a journal of the files copied so far, so Thunar
+   * offers to resume them after it was closed or crashed while copying.
+   **/
+  preferences_props[PROP_MISC_TRANSFER_JOURNAL] =
+  g_param_spec_boolean ("misc-transfer-journal",
+                        "MiscTransferJournal",
+                        NULL,
+                        FALSE,
+                        G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * ThunarPreferences:misc-transfer-preserve-hard-links:
+   *
+   * Whether hard links within the copied folders are kept, so files with
+   * several links are copied only once instead of once per link, which
+   * saves the space of snapshot and backup folders.
+   **/
+  preferences_props[PROP_MISC_TRANSFER_PRESERVE_HARD_LINKS] =
+  g_param_spec_boolean ("misc-transfer-preserve-hard-links",
+                        "MiscTransferPreserveHardLinks",
+                        NULL,
+                        FALSE,
+                        G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
   /**
    * ThunarPreferences:misc-image-preview-mode:
    *
@@ -20,6 +20,7 @@
 
 #include "thunar/thunar-dialogs.h"
 #include "thunar/thunar-gobject-extensions.h"
+#include "thunar/thunar-gtk-extensions.h"
 #include "thunar/thunar-job.h"
 #include "thunar/thunar-pango-extensions.h"
 #include "thunar/thunar-private.h"
@@ -61,6 +62,8 @@ static void
 thunar_progress_view_unpause_job (ThunarProgressView *view);
 static void
 thunar_progress_view_cancel_job (ThunarProgressView *view);
+static void
+thunar_progress_view_limit_menu (ThunarProgressView *view);
 static ThunarJobResponse
 thunar_progress_view_ask (ThunarProgressView *view,
                           const gchar        *message,
@@ -86,6 +89,8 @@ static void
 thunar_progress_view_percent (ThunarProgressView *view,
                               gdouble             percent,
                               ThunarJob          *job);
+static gboolean
+thunar_progress_view_sample (gpointer user_data);
 static void
 thunar_progress_view_frozen (ThunarProgressView *view,
                              ThunarJob          *job);
@@ -114,15 +119,24 @@ struct _ThunarProgressView
   GtkWidget *message_label;
   GtkWidget *pause_button;
   GtkWidget *unpause_button;
+  GtkWidget *limit_button;
 
   gboolean launched;
 
+  /* transfer jobs don't emit "percent", their progress is sampled */
+  guint sample_timer_id;
+
   gchar *icon_name;
   gchar *title;
 };
 
 
 
+/* the bandwidth limits offered for transfer jobs, in bytes per second */
+static const guint64 bandwidth_limits[] = { 0, 100 * 1000 * 1000, 10 * 1000 * 1000, 1000 * 1000 };
+
+
+
 G_DEFINE_TYPE (ThunarProgressView, thunar_progress_view, GTK_TYPE_BOX)
 
 
@@ -211,6 +225,7 @@ thunar_progress_view_init (ThunarProgressView *view)
   GtkWidget *hbox;
 
   view->launched = FALSE;
+  view->sample_timer_id = 0;
 
   gtk_orientable_set_orientation (GTK_ORIENTABLE (view), GTK_ORIENTATION_VERTICAL);
 
@@ -259,6 +274,14 @@ thunar_progress_view_init (ThunarProgressView *view)
   gtk_widget_set_can_focus (view->unpause_button, FALSE);
   gtk_widget_hide (view->unpause_button);
 
+  view->limit_button = gtk_button_new_from_icon_name ("view-more-symbolic", GTK_ICON_SIZE_BUTTON);
+  gtk_button_set_relief (GTK_BUTTON (view->limit_button), GTK_RELIEF_NONE);
+  gtk_widget_set_tooltip_text (view->limit_button, _("Transfer speed and priority"));
+  g_signal_connect_swapped (view->limit_button, "clicked", G_CALLBACK (thunar_progress_view_limit_menu), view);
+  gtk_box_pack_start (GTK_BOX (hbox), view->limit_button, FALSE, FALSE, 0);
+  gtk_widget_set_can_focus (view->limit_button, FALSE);
+  gtk_widget_hide (view->limit_button);
+
   cancel_button = gtk_button_new_from_icon_name ("media-playback-stop-symbolic", GTK_ICON_SIZE_BUTTON);
   gtk_button_set_relief (GTK_BUTTON (cancel_button), GTK_RELIEF_NONE);
   g_signal_connect_swapped (cancel_button, "clicked", G_CALLBACK (thunar_progress_view_cancel_job), view);
@@ -450,6 +473,11 @@ thunar_progress_view_cancel_job (ThunarProgressView *view)
       /* don't listen to percentage updates any more */
       g_signal_handlers_disconnect_matched (view->job, G_SIGNAL_MATCH_FUNC, 0, 0, NULL,
                                             thunar_progress_view_percent, NULL);
+      if (view->sample_timer_id != 0)
+        {
+          g_source_remove (view->sample_timer_id);
+          view->sample_timer_id = 0;
+        }
 
       /* don't listen to info messages any more */
       g_signal_handlers_disconnect_matched (view->job, G_SIGNAL_MATCH_FUNC, 0, 0, NULL,
@@ -466,6 +494,96 @@ thunar_progress_view_cancel_job (ThunarProgressView *view)
 
 
 
+static void
+thunar_progress_view_limit_toggled (GtkCheckMenuItem   *item,
+                                    ThunarProgressView *view)
+{
+  guint64 *limit;
+
+  _thunar_return_if_fail (THUNAR_IS_PROGRESS_VIEW (view));
+
+  /* radio items are toggled when deselected as well */
+  if (view->job == NULL || !gtk_check_menu_item_get_active (item))
+    return;
+
+  limit = g_object_get_data (G_OBJECT (item), I_ ("thunar-bandwidth-limit"));
+  g_object_set (view->job, "bandwidth-limit", *limit, NULL);
+}
+
+
+
+static void
+thunar_progress_view_priority_toggled (GtkCheckMenuItem   *item,
+                                       ThunarProgressView *view)
+{
+  _thunar_return_if_fail (THUNAR_IS_PROGRESS_VIEW (view));
+
+  if (view->job != NULL)
+    g_object_set (view->job, "io-priority",
+                  gtk_check_menu_item_get_active (item) ? THUNAR_IO_PRIORITY_IDLE : THUNAR_IO_PRIORITY_NORMAL,
+                  NULL);
+}
+
+
+
+static void
+thunar_progress_view_limit_menu (ThunarProgressView *view)
+{
+  ThunarIoPriority io_priority;
+  GtkWidget       *menu;
+  GtkWidget       *mi;
+  GSList          *group = NULL;
+  guint64          limit;
+  gchar           *size_str;
+  gchar           *label;
+  guint            n;
+
+  _thunar_return_if_fail (THUNAR_IS_PROGRESS_VIEW (view));
+  _thunar_return_if_fail (THUNAR_IS_TRANSFER_JOB (view->job));
+
+  g_object_get (view->job, "bandwidth-limit", &limit, "io-priority", &io_priority, NULL);
+
+  menu = gtk_menu_new ();
+
+  /* the speed limits, changed while the job is running */
+  for (n = 0; n < G_N_ELEMENTS (bandwidth_limits); n++)
+    {
+      if (bandwidth_limits[n] == 0)
+        label = g_strdup (_("Unlimited Speed"));
+      else
+        {
+          size_str = g_format_size (bandwidth_limits[n]);
+          label = g_strdup_printf (_("Limit to %s/sec"), size_str);
+          g_free (size_str);
+        }
+
+      mi = gtk_radio_menu_item_new_with_label (group, label);
+      group = gtk_radio_menu_item_get_group (GTK_RADIO_MENU_ITEM (mi));
+      gtk_check_menu_item_set_active (GTK_CHECK_MENU_ITEM (mi), limit == bandwidth_limits[n]);
+      g_object_set_data (G_OBJECT (mi), I_ ("thunar-bandwidth-limit"), (gpointer) &bandwidth_limits[n]);
+      g_signal_connect (G_OBJECT (mi), "toggled", G_CALLBACK (thunar_progress_view_limit_toggled), view);
+      gtk_menu_shell_append (GTK_MENU_SHELL (menu), mi);
+      gtk_widget_show (mi);
+      g_free (label);
+    }
+
+  mi = gtk_separator_menu_item_new ();
+  gtk_menu_shell_append (GTK_MENU_SHELL (menu), mi);
+  gtk_widget_show (mi);
+
+  mi = gtk_check_menu_item_new_with_label (_("Low Disk Priority"));
+  gtk_widget_set_tooltip_text (mi, _("Only access local disks while no other program uses them"));
+  gtk_check_menu_item_set_active (GTK_CHECK_MENU_ITEM (mi), io_priority == THUNAR_IO_PRIORITY_IDLE);
+  g_signal_connect (G_OBJECT (mi), "toggled", G_CALLBACK (thunar_progress_view_priority_toggled), view);
+  gtk_menu_shell_append (GTK_MENU_SHELL (menu), mi);
+  gtk_widget_show (mi);
+
+  /* run the menu (taking over the floating reference on menu) */
+  thunar_gtk_menu_run (GTK_MENU (menu));
+}
+
+
+
 static ThunarJobResponse
 thunar_progress_view_ask (ThunarProgressView *view,
                           const gchar        *message,
@@ -599,6 +717,24 @@ thunar_progress_view_percent (ThunarProgressView *view,
 
 
 
+static gboolean
+thunar_progress_view_sample (gpointer user_data)
+{
+  ThunarProgressView *view = THUNAR_PROGRESS_VIEW (user_data);
+  gdouble             percent;
+
+  _thunar_return_val_if_fail (THUNAR_IS_TRANSFER_JOB (view->job), G_SOURCE_REMOVE);
+
+  /* only update the view if the transfer made progress */
+  percent = thunar_transfer_job_sample (THUNAR_TRANSFER_JOB (view->job));
+  if (percent >= 0.0)
+    thunar_progress_view_percent (view, percent, view->job);
+
+  return G_SOURCE_CONTINUE;
+}
+
+
+
 static void
 thunar_progress_view_frozen (ThunarProgressView *view,
                              ThunarJob          *job)
@@ -704,6 +840,12 @@ thunar_progress_view_set_job (ThunarProgressView *view,
   /* disconnect from the previous job */
   if (G_LIKELY (view->job != NULL))
     {
+      if (view->sample_timer_id != 0)
+        {
+          g_source_remove (view->sample_timer_id);
+          view->sample_timer_id = 0;
+        }
+
       g_signal_handlers_disconnect_by_data (view->job, view);
       g_object_unref (G_OBJECT (view->job));
     }
@@ -724,12 +866,17 @@ thunar_progress_view_set_job (ThunarProgressView *view,
       g_signal_connect_swapped (job, "percent", G_CALLBACK (thunar_progress_view_percent), view);
       g_signal_connect_swapped (job, "frozen", G_CALLBACK (thunar_progress_view_frozen), view);
       g_signal_connect_swapped (job, "unfrozen", G_CALLBACK (thunar_progress_view_unfrozen), view);
+      if (THUNAR_IS_TRANSFER_JOB (job))
+        view->sample_timer_id = g_timeout_add (THUNAR_TRANSFER_JOB_SAMPLE_INTERVAL, thunar_progress_view_sample, view);
       if (thunar_job_is_pausable (job))
         {
           gtk_widget_show (view->unpause_button);
         }
     }
 
+  /* only transfers can be throttled */
+  gtk_widget_set_visible (view->limit_button, THUNAR_IS_TRANSFER_JOB (job));
+
   g_object_notify (G_OBJECT (view), "job");
 }
 
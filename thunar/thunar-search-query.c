@@ -0,0 +1,1003 @@
+/* vi:set et ai sw=2 sts=2 ts=2: */
+/*-
+ * Copyright (c) 2026 The Xfce Development Team
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+ * Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_STDIO_H
+#include <stdio.h>
+#endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+#include "thunar/thunar-gobject-extensions.h"
+#include "thunar/thunar-private.h"
+#include "thunar/thunar-search-query.h"
+#include "thunar/thunar-util.h"
+
+#include <libxfce4util/libxfce4util.h>
+
+
+
+/* A ThunarSearchQuery is compiled once in the main thread and then shared
+ * (read-only) by the search job threads, hence it is reference counted
+ * instead of being copied. */
+struct _ThunarSearchQuery
+{
+  gint             ref_count;
+  ThunarSearchMode mode;
+
+  /* THUNAR_SEARCH_MODE_SUBSTRING */
+  gchar **terms;
+
+  /* THUNAR_SEARCH_MODE_GLOB: one pattern per path component. Patterns
+   * without a '/' only have a single component, which is matched against
+   * the file name. Otherwise the first 'n_fixed' components (the ones in
+   * front of the first "**") allow to prune directories during the walk. */
+  GPatternSpec **components;
+  guint          n_components;
+  guint          n_fixed;
+  GPatternSpec  *path_spec;
+
+  /* THUNAR_SEARCH_MODE_REGEX */
+  GRegex *regex;
+
+  /* metadata filters parsed from "key:value" terms, see thunar_search_query_new() */
+  guint         filters;
+  guint64       min_size;
+  guint64       max_size;
+  gint64        min_mtime; /* inclusive, in seconds */
+  gint64        max_mtime; /* exclusive, in seconds */
+  GFileType     file_type;
+  GPatternSpec *mime_spec;
+};
+
+
+
+/* Flags for ThunarSearchQuery:filters */
+enum
+{
+  FILTER_SIZE = 1 << 0,
+  FILTER_MTIME = 1 << 1,
+  FILTER_FILE_TYPE = 1 << 2,
+  FILTER_MIME_TYPE = 1 << 3,
+};
+
+
+
+GType
+thunar_search_query_get_type (void)
+{
+  static GType type = G_TYPE_INVALID;
+
+  if (G_UNLIKELY (type == G_TYPE_INVALID))
+    {
+      type = g_boxed_type_register_static (I_ ("ThunarSearchQuery"),
+                                           (GBoxedCopyFunc) thunar_search_query_ref,
+                                           (GBoxedFreeFunc) thunar_search_query_unref);
+    }
+
+  return type;
+}
+
+
+
+static inline gboolean
+thunar_search_query_is_path_glob (const ThunarSearchQuery *query)
+{
+  return query->mode == THUNAR_SEARCH_MODE_GLOB && query->path_spec != NULL;
+}
+
+
+
+static gboolean
+thunar_search_query_compile_glob (ThunarSearchQuery *query,
+                                  const gchar       *pattern)
+{
+  gchar **parts;
+  guint   n;
+
+  /* simple patterns are matched against the file name only */
+  if (strchr (pattern, '/') == NULL)
+    {
+      query->components = g_new0 (GPatternSpec *, 1);
+      query->components[0] = g_pattern_spec_new (pattern);
+      query->n_components = 1;
+      query->n_fixed = 1;
+      return TRUE;
+    }
+
+  /* split the pattern into its path components, ignoring empty ones */
+  parts = g_strsplit (pattern, "/", -1);
+  query->components = g_new0 (GPatternSpec *, g_strv_length (parts));
+  query->n_fixed = G_MAXUINT;
+  for (n = 0; parts[n] != NULL; n++)
+    {
+      if (*parts[n] == '\0')
+        continue;
+
+      if (query->n_fixed == G_MAXUINT && strstr (parts[n], "**") != NULL)
+        query->n_fixed = query->n_components;
+
+      query->components[query->n_components++] = g_pattern_spec_new (parts[n]);
+    }
+  g_strfreev (parts);
+
+  if (query->n_fixed == G_MAXUINT)
+    query->n_fixed = query->n_components;
+
+  /* nothing left to match against, e.g. "/" */
+  if (query->n_components == 0)
+    return FALSE;
+
+  /* the full pattern is used for patterns containing "**", where the
+   * number of path components of a match is not known in advance */
+  query->path_spec = g_pattern_spec_new (pattern);
+
+  return TRUE;
+}
+
+
+
+static const gchar *
+thunar_search_query_parse_operator (const gchar *value,
+                                    gchar       *op,
+                                    gboolean    *inclusive)
+{
+  *op = '\0';
+  *inclusive = TRUE;
+
+  if (*value == '<' || *value == '>')
+    {
+      *op = *value++;
+      *inclusive = (*value == '=');
+      if (*inclusive)
+        value++;
+    }
+
+  return value;
+}
+
+
+
+static gboolean
+thunar_search_query_parse_size (const gchar *str,
+                                guint64     *size_return)
+{
+  static const gchar units[] = "KMGTP";
+  const gchar       *unit;
+  gdouble            value;
+  gdouble            multiplier = 1;
+  gboolean           decimal;
+  gchar             *end;
+
+  value = g_ascii_strtod (str, &end);
+  if (end == str || value < 0)
+    return FALSE;
+
+  if (*end != '\0' && g_ascii_strcasecmp (end, "b") != 0)
+    {
+      /* "K", "KiB" are binary units, "KB" is a decimal unit */
+      unit = strchr (units, g_ascii_toupper (*end));
+      if (unit == NULL)
+        return FALSE;
+
+      decimal = (g_ascii_strcasecmp (end + 1, "b") == 0);
+      if (!decimal && end[1] != '\0' && g_ascii_strcasecmp (end + 1, "ib") != 0)
+        return FALSE;
+
+      for (gint n = 0; n <= unit - units; n++)
+        multiplier *= decimal ? 1000 : 1024;
+    }
+
+  *size_return = (guint64) (value * multiplier);
+
+  return TRUE;
+}
+
+
+
+static gboolean
+thunar_search_query_parse_size_filter (ThunarSearchQuery *query,
+                                       const gchar       *value)
+{
+  const gchar *separator;
+  gboolean     inclusive;
+  guint64      size;
+  gchar       *lower;
+  gchar        op;
+
+  query->min_size = 0;
+  query->max_size = G_MAXUINT64;
+
+  /* "size:1M..10M" */
+  separator = strstr (value, "..");
+  if (separator != NULL)
+    {
+      lower = g_strndup (value, separator - value);
+      if (!thunar_search_query_parse_size (lower, &query->min_size)
+          || !thunar_search_query_parse_size (separator + 2, &query->max_size))
+        {
+          g_free (lower);
+          return FALSE;
+        }
+      g_free (lower);
+      return TRUE;
+    }
+
+  /* "size:>1G", "size:<=100K" or "size:0" */
+  value = thunar_search_query_parse_operator (value, &op, &inclusive);
+  if (!thunar_search_query_parse_size (value, &size))
+    return FALSE;
+
+  if (op == '>')
+    query->min_size = inclusive ? size : size + 1;
+  else if (op == '<' && !inclusive && size == 0)
+    return FALSE;
+  else if (op == '<')
+    query->max_size = inclusive ? size : size - 1;
+  else
+    query->min_size = query->max_size = size;
+
+  return TRUE;
+}
+
+
+
+static gboolean
+thunar_search_query_parse_time (const gchar *str,
+                                gint64       now,
+                                gint64      *start_return,
+                                gint64      *end_return)
+{
+  GDateTime *date;
+  GDateTime *next_day;
+  GDateTime *today;
+  gint64     value;
+  gint       year, month, day;
+  gint       length = 0;
+  gchar     *end;
+
+  today = g_date_time_new_now_local ();
+  date = g_date_time_new_local (g_date_time_get_year (today), g_date_time_get_month (today), g_date_time_get_day_of_month (today), 0, 0, 0);
+  g_date_time_unref (today);
+  today = date;
+
+  /* well-known periods */
+  if (g_ascii_strcasecmp (str, "today") == 0)
+    {
+      next_day = g_date_time_add_days (today, 1);
+      *start_return = g_date_time_to_unix (today);
+      *end_return = g_date_time_to_unix (next_day);
+      g_date_time_unref (next_day);
+    }
+  else if (g_ascii_strcasecmp (str, "yesterday") == 0)
+    {
+      date = g_date_time_add_days (today, -1);
+      *start_return = g_date_time_to_unix (date);
+      *end_return = g_date_time_to_unix (today);
+      g_date_time_unref (date);
+    }
+  else if (g_ascii_strcasecmp (str, "week") == 0 || g_ascii_strcasecmp (str, "month") == 0 || g_ascii_strcasecmp (str, "year") == 0)
+    {
+      /* the start of the period up to now, a point in time like "7d" */
+      value = (*str == 'w' || *str == 'W') ? 7 : (*str == 'm' || *str == 'M') ? 30 : 365;
+      *start_return = *end_return = now - value * 24 * 60 * 60;
+    }
+  else if (sscanf (str, "%4d-%2d-%2d%n", &year, &month, &day, &length) == 3 && str[length] == '\0')
+    {
+      /* a calendar day in local time */
+      date = g_date_time_new_local (year, month, day, 0, 0, 0);
+      if (date == NULL)
+        {
+          g_date_time_unref (today);
+          return FALSE;
+        }
+      next_day = g_date_time_add_days (date, 1);
+      *start_return = g_date_time_to_unix (date);
+      *end_return = g_date_time_to_unix (next_day);
+      g_date_time_unref (next_day);
+      g_date_time_unref (date);
+    }
+  else
+    {
+      /* a point in time relative to now, e.g. "30m", "12h", "7d", "2w" or "1y" */
+      value = g_ascii_strtoll (str, &end, 10);
+      if (end == str || value < 0 || end[0] == '\0' || end[1] != '\0')
+        {
+          g_date_time_unref (today);
+          return FALSE;
+        }
+
+      switch (g_ascii_tolower (*end))
+        {
+        case 'm':
+          value *= 60;
+          break;
+        case 'h':
+          value *= 60 * 60;
+          break;
+        case 'd':
+          value *= 24 * 60 * 60;
+          break;
+        case 'w':
+          value *= 7 * 24 * 60 * 60;
+          break;
+        case 'y':
+          value *= 365 * 24 * 60 * 60;
+          break;
+        default:
+          g_date_time_unref (today);
+          return FALSE;
+        }
+
+      *start_return = *end_return = now - value;
+    }
+
+  g_date_time_unref (today);
+
+  return TRUE;
+}
+
+
+
+static gboolean
+thunar_search_query_parse_mtime_filter (ThunarSearchQuery *query,
+                                        const gchar       *value)
+{
+  const gchar *separator;
+  gboolean     inclusive;
+  gint64       now = g_get_real_time () / G_USEC_PER_SEC;
+  gint64       start, end;
+  gint64       unused;
+  gchar       *lower;
+  gchar        op;
+
+  query->min_mtime = G_MININT64;
+  query->max_mtime = G_MAXINT64;
+
+  /* "modified:2024-01-01..2024-03-31" */
+  separator = strstr (value, "..");
+  if (separator != NULL)
+    {
+      lower = g_strndup (value, separator - value);
+      if (!thunar_search_query_parse_time (lower, now, &query->min_mtime, &unused)
+          || !thunar_search_query_parse_time (separator + 2, now, &unused, &query->max_mtime))
+        {
+          g_free (lower);
+          return FALSE;
+        }
+      g_free (lower);
+
+      /* relative points in time have no duration */
+      if (query->max_mtime == unused)
+        query->max_mtime = unused + 1;
+
+      return TRUE;
+    }
+
+  /* ">" means later than, "<" means earlier than, so ">7d" finds
+   * files modified within the last seven days */
+  value = thunar_search_query_parse_operator (value, &op, &inclusive);
+  if (!thunar_search_query_parse_time (value, now, &start, &end))
+    return FALSE;
+
+  if (op == '>')
+    query->min_mtime = (start == end || inclusive) ? start : end;
+  else if (op == '<')
+    query->max_mtime = (start == end || !inclusive) ? start : end;
+  else if (start == end)
+    query->min_mtime = start; /* "modified:7d" is the same as "modified:>7d" */
+  else
+    {
+      query->min_mtime = start;
+      query->max_mtime = end;
+    }
+
+  return TRUE;
+}
+
+
+
+static gboolean
+thunar_search_query_parse_type_filter (ThunarSearchQuery *query,
+                                       const gchar       *value)
+{
+  gchar *pattern;
+
+  if (*value == '\0')
+    return FALSE;
+
+  if (g_ascii_strcasecmp (value, "file") == 0)
+    query->file_type = G_FILE_TYPE_REGULAR;
+  else if (g_ascii_strcasecmp (value, "folder") == 0 || g_ascii_strcasecmp (value, "directory") == 0)
+    query->file_type = G_FILE_TYPE_DIRECTORY;
+  else if (g_ascii_strcasecmp (value, "link") == 0 || g_ascii_strcasecmp (value, "symlink") == 0)
+    query->file_type = G_FILE_TYPE_SYMBOLIC_LINK;
+  else
+    {
+      /* a media type like "image" matches all image MIME types */
+      if (strchr (value, '/') == NULL)
+        pattern = g_strconcat (value, "/*", NULL);
+      else
+        pattern = g_strdup (value);
+
+      if (query->mime_spec != NULL)
+        g_pattern_spec_free (query->mime_spec);
+      query->mime_spec = g_pattern_spec_new (pattern);
+      query->filters |= FILTER_MIME_TYPE;
+      g_free (pattern);
+
+      return TRUE;
+    }
+
+  query->filters |= FILTER_FILE_TYPE;
+
+  return TRUE;
+}
+
+
+
+/* Moves the "key:value" filter terms from @query into @search_query and
+ * returns the remaining part of the query, which is matched against the
+ * file names. Unknown keys are left as they are. */
+static gchar *
+thunar_search_query_parse_filters (ThunarSearchQuery *search_query,
+                                   const gchar       *query,
+                                   GError           **error)
+{
+  const gchar *start;
+  const gchar *end;
+  const gchar *value;
+  GString     *remainder;
+  gboolean     valid = TRUE;
+  gchar       *term;
+
+  remainder = g_string_sized_new (strlen (query));
+
+  for (start = query; *start != '\0'; start = end)
+    {
+      /* keep the whitespace in front of the term, it may be part of a regular expression */
+      for (end = start; g_ascii_isspace (*end); end++)
+        ;
+      for (; *end != '\0' && !g_ascii_isspace (*end); end++)
+        ;
+
+      term = g_strndup (start, end - start);
+      g_strchug (term);
+
+      if (g_str_has_prefix (term, "size:"))
+        {
+          value = term + strlen ("size:");
+          valid = thunar_search_query_parse_size_filter (search_query, value);
+          search_query->filters |= FILTER_SIZE;
+        }
+      else if (g_str_has_prefix (term, "modified:"))
+        {
+          value = term + strlen ("modified:");
+          valid = thunar_search_query_parse_mtime_filter (search_query, value);
+          search_query->filters |= FILTER_MTIME;
+        }
+      else if (g_str_has_prefix (term, "type:"))
+        {
+          value = term + strlen ("type:");
+          valid = thunar_search_query_parse_type_filter (search_query, value);
+        }
+      else
+        {
+          g_string_append_len (remainder, start, end - start);
+        }
+
+      if (!valid)
+        {
+          g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_INVAL,
+                       _("Invalid search filter \"%s\""), term);
+          g_free (term);
+          g_string_free (remainder, TRUE);
+          return NULL;
+        }
+
+      g_free (term);
+    }
+
+  return g_strstrip (g_string_free (remainder, FALSE));
+}
+
+
+
+/**
+ * thunar_search_query_new:
+ * @query : the search query as entered by the user.
+ * @mode  : how to interpret @query.
+ * @error : return location for errors or %NULL.
+ *
+ * Compiles @query for @mode, so the search job only has to run the
+ * precompiled matcher for every file it visits. Matching is always
+ * case-insensitive and ignores diacritics, just like the plain substring
+ * search.
+ *
+ * In addition to the name, @query may contain the following filters,
+ * which are checked against the file metadata:
+ *  - "size:" followed by a size like "10M", ">1G", "<=4KiB" or "1M..10M".
+ *    Folders never match a size filter.
+ *  - "modified:" followed by a date ("2024-12-31"), a time relative to now
+ *    ("30m", "12h", "7d", "2w", "1y") or one of "today", "yesterday",
+ *    "week", "month" and "year". ">" means later and "<" means earlier,
+ *    so "modified:>7d" finds files modified within the last seven days.
+ *  - "type:" followed by "file", "folder", "link", a MIME media type like
+ *    "image" or a MIME type like "application/pdf".
+ * Filters are not parsed in %THUNAR_SEARCH_MODE_REGEX, where text like
+ * "type:" is a valid part of the expression.
+ *
+ * The caller is responsible to free the returned query using
+ * thunar_search_query_unref() when no longer needed.
+ *
+ * Return value: the compiled #ThunarSearchQuery or %NULL if @query is
+ *               not valid for @mode.
+ **/
+ThunarSearchQuery *
+thunar_search_query_new (const gchar     *query,
+                         ThunarSearchMode mode,
+                         GError         **error)
+{
+  ThunarSearchQuery *search_query;
+  gchar             *normalized;
+  gchar             *name_query;
+
+  _thunar_return_val_if_fail (query != NULL, NULL);
+  _thunar_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  search_query = g_new0 (ThunarSearchQuery, 1);
+  search_query->ref_count = 1;
+  search_query->mode = mode;
+
+  /* "key:value" is a valid part of a regular expression */
+  if (mode == THUNAR_SEARCH_MODE_REGEX)
+    name_query = g_strdup (query);
+  else
+    name_query = thunar_search_query_parse_filters (search_query, query, error);
+  if (name_query == NULL)
+    {
+      thunar_search_query_unref (search_query);
+      return NULL;
+    }
+
+  /* regular expressions may contain escapes like \D or \S, which must not be case folded */
+  normalized = thunar_g_utf8_normalize_for_search (name_query, TRUE, mode != THUNAR_SEARCH_MODE_REGEX);
+  g_free (name_query);
+  if (G_UNLIKELY (normalized == NULL))
+    {
+      g_set_error_literal (error, G_CONVERT_ERROR, G_CONVERT_ERROR_ILLEGAL_SEQUENCE,
+                           _("The search query is not valid UTF-8"));
+      thunar_search_query_unref (search_query);
+      return NULL;
+    }
+
+  /* only filters, so every name matches */
+  if (*normalized == '\0' && search_query->filters != 0)
+    {
+      search_query->mode = THUNAR_SEARCH_MODE_SUBSTRING;
+      search_query->terms = g_new0 (gchar *, 1);
+      g_free (normalized);
+      return search_query;
+    }
+
+  switch (mode)
+    {
+    case THUNAR_SEARCH_MODE_GLOB:
+      if (!thunar_search_query_compile_glob (search_query, normalized))
+        {
+          g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_INVAL,
+                       _("The pattern \"%s\" does not match any file name"), query);
+          g_clear_pointer (&search_query, thunar_search_query_unref);
+        }
+      break;
+
+    case THUNAR_SEARCH_MODE_REGEX:
+      /* G_REGEX_OPTIMIZE enables the PCRE2 JIT, which pays off since the
+       * expression is matched against every file name below the folder */
+      search_query->regex = g_regex_new (normalized, G_REGEX_CASELESS | G_REGEX_OPTIMIZE, 0, error);
+      if (search_query->regex == NULL)
+        g_clear_pointer (&search_query, thunar_search_query_unref);
+      break;
+
+    case THUNAR_SEARCH_MODE_SUBSTRING:
+    default:
+      search_query->mode = THUNAR_SEARCH_MODE_SUBSTRING;
+      search_query->terms = thunar_util_split_search_query (normalized, error);
+      if (search_query->terms == NULL)
+        g_clear_pointer (&search_query, thunar_search_query_unref);
+      break;
+    }
+
+  g_free (normalized);
+
+  return search_query;
+}
+
+
+
+/**
+ * thunar_search_query_ref:
+ * @query : a #ThunarSearchQuery.
+ *
+ * Increments the reference count on @query by one.
+ *
+ * Return value: @query.
+ **/
+ThunarSearchQuery *
+thunar_search_query_ref (ThunarSearchQuery *query)
+{
+  _thunar_return_val_if_fail (query != NULL, NULL);
+
+  g_atomic_int_inc (&query->ref_count);
+
+  return query;
+}
+
+
+
+/**
+ * thunar_search_query_unref:
+ * @query : a #ThunarSearchQuery.
+ *
+ * Decrements the reference count on @query by one and frees
+ * the query once the reference count drops to zero.
+ **/
+void
+thunar_search_query_unref (ThunarSearchQuery *query)
+{
+  _thunar_return_if_fail (query != NULL);
+
+  if (!g_atomic_int_dec_and_test (&query->ref_count))
+    return;
+
+  for (guint n = 0; n < query->n_components; n++)
+    g_pattern_spec_free (query->components[n]);
+  g_free (query->components);
+
+  if (query->path_spec != NULL)
+    g_pattern_spec_free (query->path_spec);
+
+  if (query->regex != NULL)
+    g_regex_unref (query->regex);
+
+  if (query->mime_spec != NULL)
+    g_pattern_spec_free (query->mime_spec);
+
+  g_strfreev (query->terms);
+  g_free (query);
+}
+
+
+
+/**
+ * thunar_search_query_get_mode:
+ * @query : a #ThunarSearchQuery.
+ *
+ * Return value: the #ThunarSearchMode @query was compiled for.
+ **/
+ThunarSearchMode
+thunar_search_query_get_mode (const ThunarSearchQuery *query)
+{
+  _thunar_return_val_if_fail (query != NULL, THUNAR_SEARCH_MODE_SUBSTRING);
+  return query->mode;
+}
+
+
+
+/**
+ * thunar_search_query_uses_relative_path:
+ * @query : a #ThunarSearchQuery.
+ *
+ * Return value: %TRUE if thunar_search_query_match() needs the relative
+ *               path of the files, %FALSE if the display name suffices.
+ **/
+gboolean
+thunar_search_query_uses_relative_path (const ThunarSearchQuery *query)
+{
+  _thunar_return_val_if_fail (query != NULL, FALSE);
+  return thunar_search_query_is_path_glob (query);
+}
+
+
+
+static gboolean
+thunar_search_query_match_path (const ThunarSearchQuery *query,
+                                const gchar             *path_n)
+{
+  gchar  **parts;
+  gboolean matched;
+  guint    n;
+
+  /* with "**" the number of components is unknown, so match the whole path */
+  if (query->n_fixed < query->n_components)
+    return g_pattern_spec_match_string (query->path_spec, path_n);
+
+  parts = g_strsplit (path_n, "/", -1);
+  matched = (g_strv_length (parts) == query->n_components);
+  for (n = 0; matched && parts[n] != NULL; n++)
+    matched = g_pattern_spec_match_string (query->components[n], parts[n]);
+  g_strfreev (parts);
+
+  return matched;
+}
+
+
+
+/**
+ * thunar_search_query_match:
+ * @query         : a #ThunarSearchQuery.
+ * @display_name  : the display name of the file.
+ * @relative_path : the '/' separated display path of the file, relative to
+ *                  the searched folder, or %NULL if not known.
+ *
+ * Checks whether a file matches @query. @relative_path is only used for
+ * wildcard patterns containing a '/'; those never match if it is %NULL.
+ *
+ * This function can be called from any thread.
+ *
+ * Return value: %TRUE if the file matches @query.
+ **/
+gboolean
+thunar_search_query_match (const ThunarSearchQuery *query,
+                           const gchar             *display_name,
+                           const gchar             *relative_path)
+{
+  gboolean matched = FALSE;
+  gchar   *name_n;
+
+  _thunar_return_val_if_fail (query != NULL, FALSE);
+
+  if (G_UNLIKELY (display_name == NULL))
+    return FALSE;
+
+  if (thunar_search_query_is_path_glob (query))
+    {
+      if (relative_path == NULL)
+        return FALSE;
+
+      name_n = thunar_g_utf8_normalize_for_search (relative_path, TRUE, TRUE);
+      if (G_LIKELY (name_n != NULL))
+        matched = thunar_search_query_match_path (query, name_n);
+      g_free (name_n);
+
+      return matched;
+    }
+
+  name_n = thunar_g_utf8_normalize_for_search (display_name, TRUE, query->mode != THUNAR_SEARCH_MODE_REGEX);
+  if (G_UNLIKELY (name_n == NULL))
+    return FALSE;
+
+  switch (query->mode)
+    {
+    case THUNAR_SEARCH_MODE_GLOB:
+      matched = g_pattern_spec_match_string (query->components[0], name_n);
+      break;
+
+    case THUNAR_SEARCH_MODE_REGEX:
+      matched = g_regex_match (query->regex, name_n, 0, NULL);
+      break;
+
+    case THUNAR_SEARCH_MODE_SUBSTRING:
+    default:
+      matched = thunar_util_search_terms_match (query->terms, name_n);
+      break;
+    }
+
+  g_free (name_n);
+
+  return matched;
+}
+
+
+
+/**
+ * thunar_search_query_get_attributes:
+ * @query : a #ThunarSearchQuery.
+ *
+ * Returns the file attributes needed by thunar_search_query_match_info()
+ * in addition to the name and type of the file, so the search job can
+ * request them from the directory enumerator.
+ *
+ * Return value: a comma separated list of attributes or %NULL if
+ *               @query has no metadata filters.
+ **/
+const gchar *
+thunar_search_query_get_attributes (const ThunarSearchQuery *query)
+{
+  _thunar_return_val_if_fail (query != NULL, NULL);
+
+  if (query->filters == 0)
+    return NULL;
+
+  return G_FILE_ATTRIBUTE_STANDARD_SIZE "," G_FILE_ATTRIBUTE_TIME_MODIFIED "," G_FILE_ATTRIBUTE_STANDARD_FAST_CONTENT_TYPE;
+}
+
+
+
+/**
+ * thunar_search_query_match_info:
+ * @query : a #ThunarSearchQuery.
+ * @info  : the #GFileInfo of a file, containing the standard::type,
+ *          standard::name and the thunar_search_query_get_attributes().
+ *
+ * Checks whether the file matches the metadata filters of @query. This
+ * is cheap compared to creating a #ThunarFile, so the search job checks
+ * it before doing anything else with the file.
+ *
+ * This function can be called from any thread.
+ *
+ * Return value: %TRUE if the file passes all filters of @query.
+ **/
+gboolean
+thunar_search_query_match_info (const ThunarSearchQuery *query,
+                                GFileInfo               *info)
+{
+  const gchar *content_type;
+  GFileType    type;
+  gboolean     matched;
+  guint64      size;
+  gint64       mtime;
+  gchar       *guessed_type = NULL;
+  gchar       *mime_type;
+
+  _thunar_return_val_if_fail (query != NULL, FALSE);
+  _thunar_return_val_if_fail (G_IS_FILE_INFO (info), FALSE);
+
+  if (query->filters == 0)
+    return TRUE;
+
+  type = g_file_info_get_file_type (info);
+
+  if ((query->filters & FILTER_FILE_TYPE) != 0 && type != query->file_type)
+    return FALSE;
+
+  if ((query->filters & FILTER_SIZE) != 0)
+    {
+      if (type == G_FILE_TYPE_DIRECTORY)
+        return FALSE;
+
+      size = g_file_info_get_attribute_uint64 (info, G_FILE_ATTRIBUTE_STANDARD_SIZE);
+      if (size < query->min_size || size > query->max_size)
+        return FALSE;
+    }
+
+  if ((query->filters & FILTER_MTIME) != 0)
+    {
+      if (!g_file_info_has_attribute (info, G_FILE_ATTRIBUTE_TIME_MODIFIED))
+        return FALSE;
+
+      mtime = (gint64) g_file_info_get_attribute_uint64 (info, G_FILE_ATTRIBUTE_TIME_MODIFIED);
+      if (mtime < query->min_mtime || mtime >= query->max_mtime)
+        return FALSE;
+    }
+
+  if ((query->filters & FILTER_MIME_TYPE) != 0)
+    {
+      /* the fast content type is guessed from the name only, which keeps
+       * the search from reading the contents of every file */
+      content_type = g_file_info_get_attribute_string (info, G_FILE_ATTRIBUTE_STANDARD_FAST_CONTENT_TYPE);
+      if (content_type == NULL)
+        content_type = guessed_type = g_content_type_guess (g_file_info_get_name (info), NULL, 0, NULL);
+
+      mime_type = g_content_type_get_mime_type (content_type);
+      matched = (mime_type != NULL && g_pattern_spec_match_string (query->mime_spec, mime_type));
+      g_free (mime_type);
+      g_free (guessed_type);
+
+      if (!matched)
+        return FALSE;
+    }
+
+  return TRUE;
+}
+
+
+
+/**
+ * thunar_search_query_match_file:
+ * @query : a #ThunarSearchQuery.
+ * @root  : the searched folder or %NULL.
+ * @file  : a #ThunarFile.
+ *
+ * Convenience wrapper around thunar_search_query_match_info() and
+ * thunar_search_query_match(), which determines the relative path of
+ * @file below @root itself.
+ *
+ * Return value: %TRUE if @file matches @query.
+ **/
+gboolean
+thunar_search_query_match_file (const ThunarSearchQuery *query,
+                                GFile                   *root,
+                                ThunarFile              *file)
+{
+  GFileInfo *info;
+  gchar     *relative_path = NULL;
+  gchar     *relative_display_path = NULL;
+  gboolean   matched;
+
+  _thunar_return_val_if_fail (query != NULL, FALSE);
+  _thunar_return_val_if_fail (root == NULL || G_IS_FILE (root), FALSE);
+  _thunar_return_val_if_fail (THUNAR_IS_FILE (file), FALSE);
+
+  if (root != NULL && thunar_search_query_is_path_glob (query))
+    {
+      relative_path = g_file_get_relative_path (root, thunar_file_get_file (file));
+      if (relative_path != NULL)
+        relative_display_path = g_filename_display_name (relative_path);
+    }
+
+  info = thunar_file_get_info (file);
+  matched = (info != NULL || query->filters == 0)
+            && (info == NULL || thunar_search_query_match_info (query, info))
+            && thunar_search_query_match (query, thunar_file_get_display_name (file), relative_display_path);
+
+  g_free (relative_display_path);
+  g_free (relative_path);
+
+  return matched;
+}
+
+
+
+/**
+ * thunar_search_query_may_descend:
+ * @query        : a #ThunarSearchQuery.
+ * @display_name : the display name of a directory.
+ * @depth        : the number of path components between the searched
+ *                 folder and the directory (0 for direct children).
+ *
+ * Checks whether any file below the directory can possibly match @query.
+ * Only wildcard patterns containing a '/' allow to skip directories, e.g.
+ * the pattern "src/main.?" never matches anything inside "build" or
+ * "src/po", so the search doesn't need to enumerate those at all.
+ *
+ * This function can be called from any thread.
+ *
+ * Return value: %FALSE if the directory can be skipped.
+ **/
+gboolean
+thunar_search_query_may_descend (const ThunarSearchQuery *query,
+                                 const gchar             *display_name,
+                                 guint                    depth)
+{
+  gboolean matched;
+  gchar   *name_n;
+
+  _thunar_return_val_if_fail (query != NULL, TRUE);
+
+  if (!thunar_search_query_is_path_glob (query))
+    return TRUE;
+
+  /* without "**", matches are exactly n_components deep */
+  if (query->n_fixed == query->n_components && depth + 1 >= query->n_components)
+    return FALSE;
+
+  /* everything below the first "**" component may match */
+  if (depth >= query->n_fixed)
+    return TRUE;
+
+  name_n = thunar_g_utf8_normalize_for_search (display_name, TRUE, TRUE);
+  if (G_UNLIKELY (name_n == NULL))
+    return FALSE;
+
+  matched = g_pattern_spec_match_string (query->components[depth], name_n);
+  g_free (name_n);
+
+  return matched;
+}
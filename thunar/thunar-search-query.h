@@ -0,0 +1,70 @@
+/* vi:set et ai sw=2 sts=2 ts=2: */
+/*-
+ * Copyright (c) 2026 The Xfce Development Team
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+ * Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef __THUNAR_SEARCH_QUERY_H__
+#define __THUNAR_SEARCH_QUERY_H__
+
+#include "thunar/thunar-enum-types.h"
+#include "thunar/thunar-file.h"
+
+G_BEGIN_DECLS;
+
+typedef struct _ThunarSearchQuery ThunarSearchQuery;
+
+#define THUNAR_TYPE_SEARCH_QUERY (thunar_search_query_get_type ())
+
+GType
+thunar_search_query_get_type (void);
+
+ThunarSearchQuery *
+thunar_search_query_new (const gchar     *query,
+                         ThunarSearchMode mode,
+                         GError         **error) G_GNUC_MALLOC;
+ThunarSearchQuery *
+thunar_search_query_ref (ThunarSearchQuery *query);
+void
+thunar_search_query_unref (ThunarSearchQuery *query);
+
+ThunarSearchMode
+thunar_search_query_get_mode (const ThunarSearchQuery *query);
+
+gboolean
+thunar_search_query_uses_relative_path (const ThunarSearchQuery *query);
+
+gboolean
+thunar_search_query_match (const ThunarSearchQuery *query,
+                           const gchar             *display_name,
+                           const gchar             *relative_path);
+const gchar *
+thunar_search_query_get_attributes (const ThunarSearchQuery *query);
+gboolean
+thunar_search_query_match_info (const ThunarSearchQuery *query,
+                                GFileInfo               *info);
+gboolean
+thunar_search_query_match_file (const ThunarSearchQuery *query,
+                                GFile                   *root,
+                                ThunarFile              *file);
+gboolean
+thunar_search_query_may_descend (const ThunarSearchQuery *query,
+                                 const gchar             *display_name,
+                                 guint                    depth);
+
+G_END_DECLS;
+
+#endif /* !__THUNAR_SEARCH_QUERY_H__ */
@@ -0,0 +1,495 @@
+/* vi:set et ai sw=2 sts=2 ts=2: */
+/*-
+ * Copyright (c) 2026 The Xfce Development Team
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+ * Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "thunar/thunar-deep-count-cache.h"
+#include "thunar/thunar-deep-count-job.h"
+#include "thunar/thunar-private.h"
+#include "thunar/thunar-size-engine.h"
+
+
+
+/* Signal identifiers */
+enum
+{
+  FILE_PROGRESS,
+  FILE_SIZED,
+  LAST_SIGNAL,
+};
+
+/* number of directories counted at the same time */
+#define THUNAR_SIZE_ENGINE_MAX_JOBS 2
+
+/* number of threads used by each of the deep count jobs, the sizes
+ * are determined in the background and should not saturate the disk */
+#define THUNAR_SIZE_ENGINE_JOB_THREADS 2
+
+
+
+typedef struct _ThunarSizeEngineRequest ThunarSizeEngineRequest;
+
+
+
+static void
+thunar_size_engine_finalize (GObject *object);
+static void
+thunar_size_engine_request_free (gpointer data);
+static void
+thunar_size_engine_start_jobs (ThunarSizeEngine *engine);
+static void
+thunar_size_engine_status_update (ThunarJob               *job,
+                                  guint64                  total_size,
+                                  guint64                  total_size_on_disk,
+                                  guint                    file_count,
+                                  guint                    directory_count,
+                                  guint                    unreadable_directory_count,
+                                  ThunarSizeEngineRequest *request);
+static void
+thunar_size_engine_error (ThunarJob               *job,
+                          const GError            *error,
+                          ThunarSizeEngineRequest *request);
+static void
+thunar_size_engine_finished (ThunarJob               *job,
+                             ThunarSizeEngineRequest *request);
+static void
+thunar_size_engine_file_changed (ThunarFile       *file,
+                                 ThunarSizeEngine *engine);
+static void
+thunar_size_engine_directory_changed (GFile   *directory,
+                                      gpointer user_data);
+
+
+
+struct _ThunarSizeEngineClass
+{
+  GObjectClass __parent__;
+};
+
+struct _ThunarSizeEngine
+{
+  GObject __parent__;
+
+  /* directories waiting to be counted, most important first */
+  GQueue pending;
+
+  /* the counts in progress (ThunarFile -> ThunarSizeEngineRequest) */
+  GHashTable *running;
+
+  /* directories already counted by this engine, counted again once
+   * they or anything below them changes */
+  GHashTable *done;
+
+  /* the files of the last thunar_size_engine_request(), only those
+   * are counted again after a change */
+  GHashTable *wanted;
+};
+
+/* a single deep count started by the engine */
+struct _ThunarSizeEngineRequest
+{
+  ThunarSizeEngine *engine;
+  ThunarFile       *file;
+  ThunarJob        *job;
+  guint64           total_size;
+  gboolean          failed;
+
+  /* something below the directory changed while it was counted */
+  gboolean          stale;
+};
+
+
+
+static guint engine_signals[LAST_SIGNAL];
+
+
+
+G_DEFINE_TYPE (ThunarSizeEngine, thunar_size_engine, G_TYPE_OBJECT)
+
+
+
+static void
+thunar_size_engine_class_init (ThunarSizeEngineClass *klass)
+{
+  GObjectClass *gobject_class;
+
+  gobject_class = G_OBJECT_CLASS (klass);
+  gobject_class->finalize = thunar_size_engine_finalize;
+
+  /**
+   * ThunarSizeEngine::file-progress:
+   * @engine : a #ThunarSizeEngine.
+   * @file   : the #ThunarFile being counted.
+   *
+   * Emitted periodically while @file is counted, the size found
+   * so far is returned by thunar_size_engine_get_partial_size().
+   **/
+  engine_signals[FILE_PROGRESS] =
+  g_signal_new (I_ ("file-progress"),
+                G_TYPE_FROM_CLASS (klass),
+                G_SIGNAL_RUN_LAST,
+                0, NULL, NULL,
+                g_cclosure_marshal_VOID__OBJECT,
+                G_TYPE_NONE, 1, THUNAR_TYPE_FILE);
+
+  /**
+   * ThunarSizeEngine::file-sized:
+   * @engine : a #ThunarSizeEngine.
+   * @file   : the #ThunarFile whose total size is now known.
+   *
+   * Emitted once the total size of @file was determined and stored
+   * with thunar_file_set_total_size().
+   **/
+  engine_signals[FILE_SIZED] =
+  g_signal_new (I_ ("file-sized"),
+                G_TYPE_FROM_CLASS (klass),
+                G_SIGNAL_RUN_LAST,
+                0, NULL, NULL,
+                g_cclosure_marshal_VOID__OBJECT,
+                G_TYPE_NONE, 1, THUNAR_TYPE_FILE);
+}
+
+
+
+static void
+thunar_size_engine_init (ThunarSizeEngine *engine)
+{
+  g_queue_init (&engine->pending);
+  engine->running = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, thunar_size_engine_request_free);
+  engine->done = g_hash_table_new_full (g_direct_hash, g_direct_equal, g_object_unref, NULL);
+  engine->wanted = g_hash_table_new_full (g_direct_hash, g_direct_equal, g_object_unref, NULL);
+
+  thunar_deep_count_cache_add_notify (thunar_size_engine_directory_changed, engine);
+}
+
+
+
+static void
+thunar_size_engine_finalize (GObject *object)
+{
+  ThunarSizeEngine *engine = THUNAR_SIZE_ENGINE (object);
+
+  thunar_deep_count_cache_remove_notify (thunar_size_engine_directory_changed, engine);
+
+  thunar_size_engine_clear (engine);
+
+  g_hash_table_destroy (engine->running);
+  g_hash_table_destroy (engine->done);
+  g_hash_table_destroy (engine->wanted);
+
+  (*G_OBJECT_CLASS (thunar_size_engine_parent_class)->finalize) (object);
+}
+
+
+
+/* cancels the count if it is still running */
+static void
+thunar_size_engine_request_free (gpointer data)
+{
+  ThunarSizeEngineRequest *request = data;
+
+  g_signal_handlers_disconnect_by_data (request->job, request);
+  thunar_job_cancel (request->job);
+  g_object_unref (request->job);
+  g_object_unref (request->file);
+  g_slice_free (ThunarSizeEngineRequest, request);
+}
+
+
+
+static void
+thunar_size_engine_start_jobs (ThunarSizeEngine *engine)
+{
+  ThunarSizeEngineRequest *request;
+  ThunarDeepCountJob      *job;
+  ThunarFile              *file;
+  GList                    files = { NULL, NULL, NULL };
+
+  while (g_hash_table_size (engine->running) < THUNAR_SIZE_ENGINE_MAX_JOBS
+         && !g_queue_is_empty (&engine->pending))
+    {
+      file = g_queue_pop_head (&engine->pending);
+
+      files.data = file;
+      job = thunar_deep_count_job_new (&files, G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS);
+      thunar_deep_count_job_set_max_threads (job, THUNAR_SIZE_ENGINE_JOB_THREADS);
+
+      /* the request takes over the reference of the queue */
+      request = g_slice_new0 (ThunarSizeEngineRequest);
+      request->engine = engine;
+      request->file = file;
+      request->job = THUNAR_JOB (job);
+      g_hash_table_insert (engine->running, file, request);
+
+      g_signal_connect (job, "status-update", G_CALLBACK (thunar_size_engine_status_update), request);
+      g_signal_connect (job, "error", G_CALLBACK (thunar_size_engine_error), request);
+      g_signal_connect (job, "finished", G_CALLBACK (thunar_size_engine_finished), request);
+
+      thunar_job_launch (THUNAR_JOB (job));
+    }
+}
+
+
+
+static void
+thunar_size_engine_status_update (ThunarJob               *job,
+                                  guint64                  total_size,
+                                  guint64                  total_size_on_disk,
+                                  guint                    file_count,
+                                  guint                    directory_count,
+                                  guint                    unreadable_directory_count,
+                                  ThunarSizeEngineRequest *request)
+{
+  /* the last update of the job carries the final result */
+  request->total_size = total_size;
+
+  g_signal_emit (request->engine, engine_signals[FILE_PROGRESS], 0, request->file);
+}
+
+
+
+static void
+thunar_size_engine_error (ThunarJob               *job,
+                          const GError            *error,
+                          ThunarSizeEngineRequest *request)
+{
+  request->failed = TRUE;
+}
+
+
+
+static void
+thunar_size_engine_finished (ThunarJob               *job,
+                             ThunarSizeEngineRequest *request)
+{
+  ThunarSizeEngine *engine = request->engine;
+  ThunarFile       *file = g_object_ref (request->file);
+  gboolean          stale = request->stale;
+  gboolean          sized = FALSE;
+
+  if (!request->failed && !thunar_job_is_cancelled (job))
+    {
+      /* a stale size is still shown until the next count finishes */
+      thunar_file_set_total_size (file, MIN (request->total_size, G_MAXINT64));
+      if (!stale)
+        {
+          g_hash_table_add (engine->done, g_object_ref (file));
+          g_signal_connect (file, "changed", G_CALLBACK (thunar_size_engine_file_changed), engine);
+        }
+      sized = TRUE;
+    }
+
+  /* releases the request, the job is kept alive by the emission */
+  g_hash_table_remove (engine->running, file);
+
+  if (stale && g_hash_table_contains (engine->wanted, file))
+    g_queue_push_head (&engine->pending, g_object_ref (file));
+
+  if (sized)
+    g_signal_emit (engine, engine_signals[FILE_SIZED], 0, file);
+  g_object_unref (file);
+
+  thunar_size_engine_start_jobs (engine);
+}
+
+
+
+static void
+thunar_size_engine_file_changed (ThunarFile       *file,
+                                 ThunarSizeEngine *engine)
+{
+  /* the contents of the directory may have changed as well, forget
+   * its cached listing, which updates the counts containing it */
+  thunar_deep_count_cache_invalidate (thunar_file_get_file (file));
+}
+
+
+
+/* whether the count of @file includes @directory */
+static gboolean
+thunar_size_engine_contains (ThunarFile *file,
+                             GFile      *directory)
+{
+  GFile *location = thunar_file_get_file (file);
+
+  return g_file_equal (location, directory) || g_file_has_prefix (directory, location);
+}
+
+
+
+static void
+thunar_size_engine_directory_changed (GFile   *directory,
+                                      gpointer user_data)
+{
+  ThunarSizeEngineRequest *request;
+  ThunarSizeEngine        *engine = THUNAR_SIZE_ENGINE (user_data);
+  GHashTableIter           iter;
+  ThunarFile              *file;
+  GList                   *stale = NULL;
+  GList                   *lp;
+
+  /* counts in progress are finished and then started again, that
+   * way a burst of changes does not restart them all the time */
+  g_hash_table_iter_init (&iter, engine->running);
+  while (g_hash_table_iter_next (&iter, (gpointer *) &file, (gpointer *) &request))
+    if (thunar_size_engine_contains (file, directory))
+      request->stale = TRUE;
+
+  g_hash_table_iter_init (&iter, engine->done);
+  while (g_hash_table_iter_next (&iter, (gpointer *) &file, NULL))
+    if (thunar_size_engine_contains (file, directory))
+      {
+        g_signal_handlers_disconnect_by_func (file, thunar_size_engine_file_changed, engine);
+        stale = g_list_prepend (stale, g_object_ref (file));
+        g_hash_table_iter_remove (&iter);
+      }
+
+  /* rows that are no longer shown are counted once they are
+   * requested again */
+  for (lp = stale; lp != NULL; lp = lp->next)
+    {
+      file = THUNAR_FILE (lp->data);
+      if (thunar_file_is_directory (file)
+          && g_hash_table_contains (engine->wanted, file)
+          && g_queue_find (&engine->pending, file) == NULL)
+        g_queue_push_head (&engine->pending, g_object_ref (file));
+    }
+  g_list_free_full (stale, g_object_unref);
+
+  thunar_size_engine_start_jobs (engine);
+}
+
+
+
+/**
+ * thunar_size_engine_new:
+ *
+ * Allocates a new #ThunarSizeEngine, which determines the total
+ * size of directories in the background.
+ *
+ * Return value: the newly allocated #ThunarSizeEngine.
+ **/
+ThunarSizeEngine *
+thunar_size_engine_new (void)
+{
+  return g_object_new (THUNAR_TYPE_SIZE_ENGINE, NULL);
+}
+
+
+
+/**
+ * thunar_size_engine_request:
+ * @engine : a #ThunarSizeEngine.
+ * @files  : a #GList of #ThunarFile<!---->s, most important first.
+ *
+ * Replaces the set of files the @engine should determine the total
+ * size of. Directories already counted are skipped until they or
+ * a folder below them changes, counts of directories no longer
+ * contained in @files are cancelled. Results are reported with the
+ * "file-sized" signal.
+ **/
+void
+thunar_size_engine_request (ThunarSizeEngine *engine,
+                            GList            *files)
+{
+  GHashTableIter iter;
+  ThunarFile    *file;
+  GList         *lp;
+
+  _thunar_return_if_fail (THUNAR_IS_SIZE_ENGINE (engine));
+
+  g_hash_table_remove_all (engine->wanted);
+  for (lp = files; lp != NULL; lp = lp->next)
+    g_hash_table_add (engine->wanted, g_object_ref (lp->data));
+
+  /* stop counting what scrolled out of view */
+  g_hash_table_iter_init (&iter, engine->running);
+  while (g_hash_table_iter_next (&iter, (gpointer *) &file, NULL))
+    if (!g_hash_table_contains (engine->wanted, file))
+      g_hash_table_iter_remove (&iter);
+
+  g_queue_clear_full (&engine->pending, g_object_unref);
+
+  for (lp = files; lp != NULL; lp = lp->next)
+    {
+      file = THUNAR_FILE (lp->data);
+
+      /* count each directory only once, mountables are not mounted */
+      if (!thunar_file_is_directory (file)
+          || thunar_file_is_mountable (file)
+          || g_hash_table_contains (engine->done, file)
+          || g_hash_table_contains (engine->running, file))
+        continue;
+
+      g_queue_push_tail (&engine->pending, g_object_ref (file));
+    }
+
+  thunar_size_engine_start_jobs (engine);
+}
+
+
+
+/**
+ * thunar_size_engine_clear:
+ * @engine : a #ThunarSizeEngine.
+ *
+ * Cancels all counts and forgets which directories were counted,
+ * to be called when the folder shown by the view changes.
+ **/
+void
+thunar_size_engine_clear (ThunarSizeEngine *engine)
+{
+  GHashTableIter iter;
+  ThunarFile    *file;
+
+  _thunar_return_if_fail (THUNAR_IS_SIZE_ENGINE (engine));
+
+  g_queue_clear_full (&engine->pending, g_object_unref);
+  g_hash_table_remove_all (engine->running);
+
+  g_hash_table_iter_init (&iter, engine->done);
+  while (g_hash_table_iter_next (&iter, (gpointer *) &file, NULL))
+    g_signal_handlers_disconnect_by_func (file, thunar_size_engine_file_changed, engine);
+  g_hash_table_remove_all (engine->done);
+  g_hash_table_remove_all (engine->wanted);
+}
+
+
+
+/**
+ * thunar_size_engine_get_partial_size:
+ * @engine : a #ThunarSizeEngine.
+ * @file   : a #ThunarFile.
+ *
+ * Returns the size found so far for @file while it is still counted.
+ *
+ * Return value: the size in bytes, or -1 if @file is not being counted.
+ **/
+gint64
+thunar_size_engine_get_partial_size (ThunarSizeEngine *engine,
+                                     ThunarFile       *file)
+{
+  ThunarSizeEngineRequest *request;
+
+  _thunar_return_val_if_fail (THUNAR_IS_SIZE_ENGINE (engine), -1);
+
+  request = g_hash_table_lookup (engine->running, file);
+  if (request == NULL)
+    return -1;
+
+  return MIN (request->total_size, G_MAXINT64);
+}
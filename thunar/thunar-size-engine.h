@@ -0,0 +1,54 @@
+/* vi:set et ai sw=2 sts=2 ts=2: */
+/*-
+ * Copyright (c) 2026 The Xfce Development Team
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+ * Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef __THUNAR_SIZE_ENGINE_H__
+#define __THUNAR_SIZE_ENGINE_H__
+
+#include "thunar/thunar-file.h"
+
+G_BEGIN_DECLS;
+
+typedef struct _ThunarSizeEngineClass ThunarSizeEngineClass;
+typedef struct _ThunarSizeEngine      ThunarSizeEngine;
+
+#define THUNAR_TYPE_SIZE_ENGINE (thunar_size_engine_get_type ())
+#define THUNAR_SIZE_ENGINE(obj) (G_TYPE_CHECK_INSTANCE_CAST ((obj), THUNAR_TYPE_SIZE_ENGINE, ThunarSizeEngine))
+#define THUNAR_SIZE_ENGINE_CLASS(klass) (G_TYPE_CHECK_CLASS_CAST ((klass), THUNAR_TYPE_SIZE_ENGINE, ThunarSizeEngineClass))
+#define THUNAR_IS_SIZE_ENGINE(obj) (G_TYPE_CHECK_INSTANCE_TYPE ((obj), THUNAR_TYPE_SIZE_ENGINE))
+#define THUNAR_IS_SIZE_ENGINE_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), THUNAR_TYPE_SIZE_ENGINE))
+#define THUNAR_SIZE_ENGINE_GET_CLASS(obj) (G_TYPE_INSTANCE_GET_CLASS ((obj), THUNAR_TYPE_SIZE_ENGINE, ThunarSizeEngineClass))
+
+GType
+thunar_size_engine_get_type (void);
+
+ThunarSizeEngine *
+thunar_size_engine_new (void) G_GNUC_MALLOC;
+
+void
+thunar_size_engine_request (ThunarSizeEngine *engine,
+                            GList            *files);
+void
+thunar_size_engine_clear (ThunarSizeEngine *engine);
+gint64
+thunar_size_engine_get_partial_size (ThunarSizeEngine *engine,
+                                     ThunarFile       *file);
+
+G_END_DECLS;
+
+#endif /* !__THUNAR_SIZE_ENGINE_H__ */
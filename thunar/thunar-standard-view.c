@@ -314,6 +314,10 @@ static void
 thunar_standard_view_search_done (ThunarTreeViewModel *model,
                                   ThunarStandardView  *standard_view);
 static void
+thunar_standard_view_search_error (ThunarTreeViewModel *model,
+                                   const GError        *error,
+                                   ThunarStandardView  *standard_view);
+static void
 thunar_standard_view_sort_column_changed (GtkTreeSortable    *tree_sortable,
                                           ThunarStandardView *standard_view);
 static void
@@ -477,6 +481,9 @@ struct _ThunarStandardViewPrivate
    * we don't want to show the spinner when the search query is empty (i.e. "") */
   gboolean searching;
 
+  /* why the current search query could not be used, if it could not */
+  gchar *search_error;
+
   /* used to restore the view type after a search is completed */
   GType type;
 
@@ -1207,6 +1214,7 @@ thunar_standard_view_constructed (GObject *object)
   g_signal_connect (G_OBJECT (standard_view->model), "rows-reordered", G_CALLBACK (thunar_standard_view_rows_reordered), standard_view);
   g_signal_connect (G_OBJECT (standard_view->model), "error", G_CALLBACK (thunar_standard_view_error), standard_view);
   g_signal_connect (G_OBJECT (standard_view->model), "search-done", G_CALLBACK (thunar_standard_view_search_done), standard_view);
+  g_signal_connect (G_OBJECT (standard_view->model), "search-error", G_CALLBACK (thunar_standard_view_search_error), standard_view);
   g_object_bind_property (G_OBJECT (standard_view->preferences), "misc-case-sensitive", G_OBJECT (standard_view->model), "case-sensitive", G_BINDING_SYNC_CREATE);
   g_object_bind_property (G_OBJECT (standard_view->preferences), "misc-date-style", G_OBJECT (standard_view->model), "date-style", G_BINDING_SYNC_CREATE);
   g_object_bind_property (G_OBJECT (standard_view->preferences), "misc-date-custom-style", G_OBJECT (standard_view->model), "date-custom-style", G_BINDING_SYNC_CREATE);
@@ -1379,6 +1387,7 @@ thunar_standard_view_finalize (GObject *object)
   g_mutex_clear (&standard_view->priv->statusbar_text_mutex);
 
   g_free (standard_view->priv->search_query);
+  g_free (standard_view->priv->search_error);
 
   /* release the scroll_to_files hash table */
   g_hash_table_destroy (standard_view->priv->scroll_to_files);
@@ -2772,7 +2781,10 @@ thunar_standard_view_update_statusbar_text_idle (gpointer data)
 
           g_object_get (G_OBJECT (standard_view->model), "num-files", &num_files, NULL);
 
-          statusbar_text = g_strdup_printf (ngettext ("%d file found", "%d files found", num_files), num_files);
+          if (standard_view->priv->search_error != NULL)
+            statusbar_text = g_strdup_printf (_("Invalid search query: %s"), standard_view->priv->search_error);
+          else
+            statusbar_text = g_strdup_printf (ngettext ("%d file found", "%d files found", num_files), num_files);
           thunar_standard_view_set_statusbar_text (standard_view, statusbar_text);
           g_free (statusbar_text);
 
@@ -4285,6 +4297,24 @@ thunar_standard_view_search_done (ThunarTreeViewModel *model,
 
 
 
+static void
+thunar_standard_view_search_error (ThunarTreeViewModel *model,
+                                   const GError        *error,
+                                   ThunarStandardView  *standard_view)
+{
+  _thunar_return_if_fail (THUNAR_IS_TREE_VIEW_MODEL (model));
+  _thunar_return_if_fail (THUNAR_IS_STANDARD_VIEW (standard_view));
+  _thunar_return_if_fail (standard_view->model == model);
+
+  /* shown in the statusbar instead of the number of files found */
+  g_free (standard_view->priv->search_error);
+  standard_view->priv->search_error = g_strdup (error->message);
+
+  thunar_standard_view_update_statusbar_text (standard_view);
+}
+
+
+
 static void
 thunar_standard_view_sort_column_changed (GtkTreeSortable    *tree_sortable,
                                           ThunarStandardView *standard_view)
@@ -5029,6 +5059,7 @@ thunar_standard_view_set_searching (ThunarStandardView *standard_view,
   /* save the new query (used for switching between views) */
   g_free (standard_view->priv->search_query);
   standard_view->priv->search_query = g_strdup (search_query);
+  g_clear_pointer (&standard_view->priv->search_error, g_free);
 
   /* initiate the search */
   /* set_folder() can emit a large number of row-deleted signals for large folders,
@@ -5054,7 +5085,8 @@ thunar_standard_view_set_searching (ThunarStandardView *standard_view,
 
   if (search_query != NULL && g_strcmp0 (search_query, "") != 0)
     {
-      standard_view->priv->searching = TRUE;
+      /* no spinner if the query was rejected and nothing is searched */
+      standard_view->priv->searching = (standard_view->priv->search_error == NULL);
       /* disable expandable folders when searching */
       if (tree_view != NULL)
         {
@@ -5157,8 +5189,10 @@ thunar_standard_view_highlight_option_changed (ThunarStandardView *standard_view
 
   if (GTK_IS_TREE_VIEW (view))
     layout = GTK_CELL_LAYOUT (gtk_tree_view_get_column (GTK_TREE_VIEW (view), THUNAR_COLUMN_NAME));
-  else
+  else if (GTK_IS_CELL_LAYOUT (view))
     layout = GTK_CELL_LAYOUT (view);
+  else
+    return; /* the view draws its items without cell renderers */
 
   g_object_get (G_OBJECT (THUNAR_STANDARD_VIEW (standard_view)->preferences), "misc-highlighting-enabled", &show_highlight, NULL);
 
@@ -5365,11 +5399,27 @@ void
 thunar_standard_view_select_first_file (ThunarStandardView *standard_view)
 {
   GtkWidget        *child = gtk_bin_get_child (GTK_BIN (standard_view));
-  GtkTreeModel     *tree_model = gtk_tree_view_get_model (GTK_TREE_VIEW (child));
-  GtkTreeSelection *selection = gtk_tree_view_get_selection (GTK_TREE_VIEW (child));
+  GtkTreeModel     *tree_model;
+  GtkTreeSelection *selection;
   GtkTreeIter       iter;
   GtkTreePath      *path;
 
+  /* views which are no tree views select through the class methods */
+  if (!GTK_IS_TREE_VIEW (child))
+    {
+      if (gtk_tree_model_get_iter_first (GTK_TREE_MODEL (standard_view->model), &iter))
+        {
+          path = gtk_tree_model_get_path (GTK_TREE_MODEL (standard_view->model), &iter);
+          (*THUNAR_STANDARD_VIEW_GET_CLASS (standard_view)->set_cursor) (standard_view, path, FALSE);
+          (*THUNAR_STANDARD_VIEW_GET_CLASS (standard_view)->select_path) (standard_view, path);
+          gtk_tree_path_free (path);
+        }
+      return;
+    }
+
+  tree_model = gtk_tree_view_get_model (GTK_TREE_VIEW (child));
+  selection = gtk_tree_view_get_selection (GTK_TREE_VIEW (child));
+
   if (gtk_tree_model_get_iter_first (tree_model, &iter))
     {
       path = gtk_tree_model_get_path (GTK_TREE_MODEL (tree_model), &iter);
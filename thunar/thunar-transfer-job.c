@@ -21,22 +21,50 @@
 
 #include "thunar/thunar-application.h"
 #include "thunar/thunar-gio-extensions.h"
+#include "thunar/thunar-io-copy.h"
 #include "thunar/thunar-io-jobs-util.h"
-#include "thunar/thunar-io-scan-directory.h"
 #include "thunar/thunar-job-operation-history.h"
 #include "thunar/thunar-job.h"
 #include "thunar/thunar-preferences.h"
 #include "thunar/thunar-private.h"
 #include "thunar/thunar-thumbnail-cache.h"
 #include "thunar/thunar-transfer-job.h"
+#include "thunar/thunar-transfer-journal.h"
+#include "thunar/thunar-transfer-scheduler.h"
 
 #include <gio/gio.h>
 
 
 
-/* seconds before we show the transfer rate + remaining time */
+/* seconds of samples before we show the transfer rate + remaining time */
 #define MINIMUM_TRANSFER_TIME (2 * G_USEC_PER_SEC) /* 2 seconds */
 
+/* the transfer rate is averaged over this many samples of the progress,
+ * taken every THUNAR_TRANSFER_JOB_SAMPLE_INTERVAL, which makes 10 seconds */
+#define RATE_WINDOW_SAMPLES 20
+
+/* maximum number of files the scanner lists ahead of the copy */
+#define MAX_SCANNED_AHEAD (1 << 16)
+
+/* progress steps larger than the chunks actually read and written, those are
+ * clones or holes of sparse files and don't count against the bandwidth limit */
+#define THROTTLE_MAX_STEP (16 * 1024 * 1024)
+
+/* a throttled copy checks for changes of the limit, pause and cancel this often */
+#define THROTTLE_MAX_SLEEP (100 * 1000) /* 100ms */
+
+/* the data of a journaled *.partial~ file is synced this often, so the
+ * copy resumes from there if Thunar dies */
+#define JOURNAL_CHECKPOINT_SIZE (256 * 1024 * 1024)
+
+/* what is known about the files to transfer, gathered once while the folders
+ * are listed so the files don't have to be queried again before the copy */
+#define TRANSFER_NODE_ATTRIBUTES \
+  G_FILE_ATTRIBUTE_STANDARD_NAME "," G_FILE_ATTRIBUTE_STANDARD_SIZE "," G_FILE_ATTRIBUTE_STANDARD_COPY_NAME "," \
+  G_FILE_ATTRIBUTE_STANDARD_DISPLAY_NAME "," G_FILE_ATTRIBUTE_STANDARD_TYPE "," \
+  G_FILE_ATTRIBUTE_TIME_MODIFIED "," G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC "," \
+  G_FILE_ATTRIBUTE_UNIX_DEVICE "," G_FILE_ATTRIBUTE_UNIX_INODE "," G_FILE_ATTRIBUTE_UNIX_NLINK
+
 
 
 /* Property identifiers */
@@ -47,11 +75,30 @@ enum
   PROP_PARALLEL_COPY_MODE,
   PROP_TRANSFER_USE_PARTIAL,
   PROP_TRANSFER_VERIFY_FILE,
+  PROP_MAX_PARALLEL_FILES,
+  PROP_TRANSFER_REFLINK_MODE,
+  PROP_TRANSFER_CHECKSUM_FILES,
+  PROP_TRANSFER_PIPELINED,
+  PROP_BANDWIDTH_LIMIT,
+  PROP_IO_PRIORITY,
+  PROP_TRANSFER_JOURNAL,
+  PROP_TRANSFER_HARD_LINKS,
 };
 
+/* how far the children of a directory node are collected */
+typedef enum
+{
+  THUNAR_TRANSFER_NODE_UNLISTED,
+  THUNAR_TRANSFER_NODE_LISTING,
+  THUNAR_TRANSFER_NODE_LISTED_AHEAD,
+  THUNAR_TRANSFER_NODE_LISTED,
+} ThunarTransferNodeScanState;
+
 
 
-typedef struct _ThunarTransferNode ThunarTransferNode;
+typedef struct _ThunarTransferNode     ThunarTransferNode;
+typedef struct _ThunarTransferProgress ThunarTransferProgress;
+typedef struct _ThunarTransferLinkKey  ThunarTransferLinkKey;
 
 
 
@@ -79,8 +126,29 @@ thunar_transfer_job_create_new_node (ThunarTransferJob *job,
                                      GFile             *source_file,
                                      GFileInfo         *source_file_info,
                                      GFile             *target_file);
+static void
+thunar_transfer_job_copy_node (ThunarTransferJob  *job,
+                               ThunarJobOperation *operation,
+                               ThunarTransferNode *node,
+                               GError            **error);
+static void
+thunar_transfer_node_reparent_target_recursive (ThunarTransferNode *node,
+                                                GFile              *new_target_parent);
+static guint
+thunar_transfer_link_key_hash (gconstpointer key);
+static gboolean
+thunar_transfer_link_key_equal (gconstpointer a,
+                                gconstpointer b);
+static void
+thunar_transfer_link_copy_free (gpointer data);
 
 
+typedef struct
+{
+  gint64  time;     /* monotonic us */
+  guint64 progress; /* byte */
+} ThunarTransferRateSample;
+
 struct _ThunarTransferJobClass
 {
   ThunarJobClass __parent__;
@@ -93,26 +161,85 @@ struct _ThunarTransferJob
   ThunarTransferJobType type;
 
   /* List of type ThunarTransferNode */
-  GList   *transfer_node_list;
-  gchar   *source_device_fs_id;
-  gboolean is_source_device_local;
-  gchar   *target_device_fs_id;
-  gboolean is_target_device_local;
-
-  gint64  start_time;          /* us(microseconds) */
-  gint64  last_update_time;    /* us */
-  guint64 last_total_progress; /* byte */
-
+  GList                *transfer_node_list;
+  ThunarTransferDevice *source_device;
+  gboolean              is_source_device_local;
+  ThunarTransferDevice *target_device;
+  gboolean              is_target_device_local;
+
+  /* counted by the scanning and copying threads without a lock, using
+   * thunar_transfer_job_atomic_add() and thunar_transfer_job_atomic_get() */
   guint64 total_size;     /* byte */
   guint64 total_progress; /* byte */
-  guint64 file_progress;  /* byte */
-  guint64 transfer_rate;  /* byte/s */
+
+  /* the progress sampled by the main loop for the transfer rate, a ring
+   * buffer with the newest sample at rate_sample_index */
+  ThunarTransferRateSample rate_samples[RATE_WINDOW_SAMPLES];
+  guint                    n_rate_samples;
+  guint                    rate_sample_index;
+
+  /* no bytes arrived within the window, so the remaining time is unknown */
+  gboolean rate_stalled;
+
+  /* regular files are copied by a pool of worker threads while the job
+   * thread walks the tree and creates the directories, if enabled */
+  GThreadPool        *file_pool;
+  ThunarJobOperation *file_pool_operation;
+  GError             *file_pool_error;
+
+  /* protects the progress, the job operation and the file_pool_error */
+  GMutex mutex;
+
+  /* makes sure only one worker asks the user at a time */
+  GMutex ask_mutex;
+
+  /* in pipelined mode, the scanner thread lists the folders ahead of the
+   * copy, while the copy lists the folders the scanner did not reach yet */
+  GThread *scan_thread;
+  gboolean scan_stop;
+  guint    n_scanned_ahead;
+
+  /* protects the scan state and the child nodes of all nodes, and the
+   * target files of nodes which are not copied yet */
+  GMutex scan_mutex;
+  GCond  scan_cond;
+
+  /* bytes expected to be free on the target and reserved by the running
+   * copies, only checked if the free space is not known upfront */
+  guint64  space_left;
+  guint64  space_reserved;
+  gboolean reserve_space;
+
+  /* token bucket of the bandwidth limit, in bytes, shared by all copying
+   * threads and protected by the mutex, the limit is 0 if unlimited and
+   * is also read atomically to skip the lock if so */
+  guint64 bandwidth_limit;
+  gdouble throttle_tokens;
+  gint64  throttle_time;
+
+  /* the ThunarIoPriority of the copying threads, accessed atomically
+   * since it can be changed while the job runs */
+  gint io_priority;
+
+  /* the journal of a copy, to resume the copy if Thunar dies */
+  ThunarTransferJournal *journal;
+
+  /* the copies of files with more than one hard link, by ThunarTransferLinkKey
+   * of the source, the copy is %NULL while it is written, protected by the mutex */
+  GHashTable *hard_links;
+  GCond       hard_link_cond;
 
   ThunarPreferences     *preferences;
   gboolean               file_size_binary;
   ThunarParallelCopyMode parallel_copy_mode;
   ThunarUsePartialMode   transfer_use_partial;
   ThunarVerifyFileMode   transfer_verify_file;
+  guint                  max_parallel_files;
+  ThunarReflinkMode      transfer_reflink_mode;
+  gboolean               transfer_checksum_files;
+  gboolean               transfer_pipelined;
+  gboolean               transfer_journal;
+  gboolean               transfer_hard_links;
 };
 
 struct _ThunarTransferNode
@@ -122,7 +249,16 @@ struct _ThunarTransferNode
   GFile     *target_file;
 
   /* List of type <ThunarTransferNode> */
-  GList *child_nodes;
+  GList                      *child_nodes;
+  ThunarTransferNodeScanState scan_state;
+
+  /* bytes copied so far of this node */
+  guint64 file_progress;
+
+  /* the devices of the source and the target, inherited from the
+   * top level node, or %NULL if unknown */
+  ThunarTransferDevice *source_device;
+  ThunarTransferDevice *target_device;
 
   /*
    * Previous response for this transfer node for thunar_job_ask_for_action (or 0, if no nothing was asked yet)
@@ -130,6 +266,44 @@ struct _ThunarTransferNode
    * (e.g. relevant when cop+del is done instead of move)
    */
   ThunarJobResponse ask_for_action_response;
+
+  /* when a move falls back to copy and delete, the source of a node is
+   * deleted once the node and all its children are copied: the folder
+   * node of the node, the node and its children not done yet, and whether
+   * the source has to be kept since some child was not moved, the latter
+   * two are accessed atomically by the copying threads */
+  ThunarTransferNode *parent;
+  gint                n_unfinished;
+  gint                keep_source;
+};
+
+struct _ThunarTransferProgress
+{
+  ThunarTransferJob  *job;
+  ThunarTransferNode *node;
+
+  /* whether the transfer scheduler admitted the copy of the node */
+  gboolean has_slot;
+
+  /* the I/O priority applied to the copying thread, and the priority
+   * of the thread before */
+  gint io_priority;
+  gint previous_io_priority;
+
+  /* the *.partial~ file of a journaled copy, and the bytes of it
+   * recorded in the journal */
+  GFile  *target_file;
+  GFile  *partial_file;
+  guint64 checkpoint;
+
+  /* whether the copy is yet to be recorded as started in the journal */
+  gboolean journal_pending;
+};
+
+struct _ThunarTransferLinkKey
+{
+  guint64 device;
+  guint64 inode;
 };
 
 
@@ -138,6 +312,34 @@ G_DEFINE_TYPE (ThunarTransferJob, thunar_transfer_job, THUNAR_TYPE_JOB)
 
 
 
+/* GLib only offers atomic operations on 32 bit integers, the byte counters
+ * use the builtins of the compiler, the counters don't order other memory */
+static inline void
+thunar_transfer_job_atomic_add (guint64 *counter,
+                                gint64   n_bytes)
+{
+  __atomic_fetch_add (counter, (guint64) n_bytes, __ATOMIC_RELAXED);
+}
+
+
+
+static inline guint64
+thunar_transfer_job_atomic_get (guint64 *counter)
+{
+  return __atomic_load_n (counter, __ATOMIC_RELAXED);
+}
+
+
+
+static inline void
+thunar_transfer_job_atomic_set (guint64 *counter,
+                                guint64  value)
+{
+  __atomic_store_n (counter, value, __ATOMIC_RELAXED);
+}
+
+
+
 static void
 thunar_transfer_job_class_init (ThunarTransferJobClass *klass)
 {
@@ -207,6 +409,118 @@ thunar_transfer_job_class_init (ThunarTransferJobClass *klass)
                                                       THUNAR_TYPE_VERIFY_FILE_MODE,
                                                       THUNAR_VERIFY_FILE_MODE_DISABLED,
                                                       G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * ThunarTransferJob:max-parallel-files:
+   *
+   * The maximum number of regular files copied at the same time
+   * between local folders, 1 to copy one file after another.
+   **/
+  g_object_class_install_property (gobject_class,
+                                   PROP_MAX_PARALLEL_FILES,
+                                   g_param_spec_uint ("max-parallel-files",
+                                                      "MaxParallelFiles",
+                                                      NULL,
+                                                      1, 64,
+                                                      1,
+                                                      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * ThunarTransferJob:transfer-reflink-mode:
+   *
+   * Whether copies of local files share the data with the original.
+   **/
+  g_object_class_install_property (gobject_class,
+                                   PROP_TRANSFER_REFLINK_MODE,
+                                   g_param_spec_enum ("transfer-reflink-mode",
+                                                      "TransferReflinkMode",
+                                                      NULL,
+                                                      THUNAR_TYPE_REFLINK_MODE,
+                                                      THUNAR_REFLINK_MODE_AUTO,
+                                                      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * ThunarTransferJob:transfer-checksum-files:
+   *
+   * Whether to write a checksum file next to each copied local file.
+   **/
+  g_object_class_install_property (gobject_class,
+                                   PROP_TRANSFER_CHECKSUM_FILES,
+                                   g_param_spec_boolean ("transfer-checksum-files",
+                                                         "TransferChecksumFiles",
+                                                         NULL,
+                                                         FALSE,
+                                                         G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * ThunarTransferJob:transfer-pipelined:
+   *
+   * Whether to start copying while the folders are still scanned.
+   **/
+  g_object_class_install_property (gobject_class,
+                                   PROP_TRANSFER_PIPELINED,
+                                   g_param_spec_boolean ("transfer-pipelined",
+                                                         "TransferPipelined",
+                                                         NULL,
+                                                         FALSE,
+                                                         G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * ThunarTransferJob:bandwidth-limit:
+   *
+   * The maximum number of bytes copied per second, or 0 for no limit.
+   * Can be changed while the job is running.
+   **/
+  g_object_class_install_property (gobject_class,
+                                   PROP_BANDWIDTH_LIMIT,
+                                   g_param_spec_uint64 ("bandwidth-limit",
+                                                        "BandwidthLimit",
+                                                        NULL,
+                                                        0, G_MAXUINT64,
+                                                        0,
+                                                        G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * ThunarTransferJob:io-priority:
+   *
+   * The I/O priority of the copies of local files. Can be changed while
+   * the job is running.
+   **/
+  g_object_class_install_property (gobject_class,
+                                   PROP_IO_PRIORITY,
+                                   g_param_spec_enum ("io-priority",
+                                                      "IoPriority",
+                                                      NULL,
+                                                      THUNAR_TYPE_IO_PRIORITY,
+                                                      THUNAR_IO_PRIORITY_NORMAL,
+                                                      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * ThunarTransferJob:transfer-journal:
+   *
+   * Whether copies keep a journal, so they can be resumed if Thunar dies.
+   **/
+  g_object_class_install_property (gobject_class,
+                                   PROP_TRANSFER_JOURNAL,
+                                   g_param_spec_boolean ("transfer-journal",
+                                                         "TransferJournal",
+                                                         NULL,
+                                                         FALSE,
+                                                         G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * ThunarTransferJob:transfer-hard-links:
+   *
+   * Whether files with more than one hard link are copied once, with
+   * the other links recreated as links of the copy.
+   **/
+  g_object_class_install_property (gobject_class,
+                                   PROP_TRANSFER_HARD_LINKS,
+                                   g_param_spec_boolean ("transfer-hard-links",
+                                                         "TransferHardLinks",
+                                                         NULL,
+                                                         FALSE,
+                                                         G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 }
 
 
@@ -214,6 +528,10 @@ thunar_transfer_job_class_init (ThunarTransferJobClass *klass)
 static void
 thunar_transfer_job_init (ThunarTransferJob *job)
 {
+  guint budget_rotational;
+  guint budget_solid_state;
+  guint budget_remote;
+
   job->preferences = thunar_preferences_get ();
   g_object_bind_property (job->preferences, "misc-file-size-binary",
                           job, "file-size-binary",
@@ -227,20 +545,63 @@ thunar_transfer_job_init (ThunarTransferJob *job)
   g_object_bind_property (job->preferences, "misc-transfer-verify-file",
                           job, "transfer-verify-file",
                           G_BINDING_SYNC_CREATE);
+  g_object_bind_property (job->preferences, "misc-transfer-parallel-files",
+                          job, "max-parallel-files",
+                          G_BINDING_SYNC_CREATE);
+  g_object_bind_property (job->preferences, "misc-transfer-reflink-mode",
+                          job, "transfer-reflink-mode",
+                          G_BINDING_SYNC_CREATE);
+  g_object_bind_property (job->preferences, "misc-transfer-checksum-files",
+                          job, "transfer-checksum-files",
+                          G_BINDING_SYNC_CREATE);
+  g_object_bind_property (job->preferences, "misc-transfer-pipelined",
+                          job, "transfer-pipelined",
+                          G_BINDING_SYNC_CREATE);
+  g_object_bind_property (job->preferences, "misc-transfer-journal",
+                          job, "transfer-journal",
+                          G_BINDING_SYNC_CREATE);
+  g_object_bind_property (job->preferences, "misc-transfer-preserve-hard-links",
+                          job, "transfer-hard-links",
+                          G_BINDING_SYNC_CREATE);
+
+  /* the budgets are shared by all jobs, pick up changes with each new job */
+  g_object_get (job->preferences,
+                "misc-transfer-budget-rotational", &budget_rotational,
+                "misc-transfer-budget-solid-state", &budget_solid_state,
+                "misc-transfer-budget-remote", &budget_remote,
+                NULL);
+  thunar_transfer_scheduler_set_budgets (budget_rotational, budget_solid_state, budget_remote);
+
+  g_mutex_init (&job->mutex);
+  g_mutex_init (&job->ask_mutex);
+  g_mutex_init (&job->scan_mutex);
+  g_cond_init (&job->scan_cond);
+  g_cond_init (&job->hard_link_cond);
 
   job->type = 0;
   job->transfer_node_list = NULL;
-  job->source_device_fs_id = NULL;
+  job->source_device = NULL;
   job->is_source_device_local = FALSE;
-  job->target_device_fs_id = NULL;
+  job->target_device = NULL;
   job->is_target_device_local = FALSE;
   job->total_size = 0;
   job->total_progress = 0;
-  job->file_progress = 0;
-  job->last_update_time = 0;
-  job->last_total_progress = 0;
-  job->transfer_rate = 0;
-  job->start_time = 0;
+  job->n_rate_samples = 0;
+  job->rate_sample_index = 0;
+  job->rate_stalled = FALSE;
+  job->scan_thread = NULL;
+  job->scan_stop = FALSE;
+  job->n_scanned_ahead = 0;
+  job->space_left = 0;
+  job->space_reserved = 0;
+  job->reserve_space = FALSE;
+  job->bandwidth_limit = 0;
+  job->throttle_tokens = 0;
+  job->throttle_time = 0;
+  job->io_priority = THUNAR_IO_PRIORITY_NORMAL;
+  job->journal = NULL;
+  job->hard_links = g_hash_table_new_full (thunar_transfer_link_key_hash, thunar_transfer_link_key_equal,
+                                           g_free, thunar_transfer_link_copy_free);
 }
 
 
@@ -252,9 +613,17 @@ thunar_transfer_job_finalize (GObject *object)
 
   g_list_free_full (job->transfer_node_list, thunar_transfer_node_free);
 
-  g_free (job->source_device_fs_id);
-  g_free (job->target_device_fs_id);
+  /* the job was never launched */
+  if (job->journal != NULL)
+    thunar_transfer_journal_remove (job->journal);
 
+  g_mutex_clear (&job->mutex);
+  g_mutex_clear (&job->ask_mutex);
+  g_mutex_clear (&job->scan_mutex);
+  g_cond_clear (&job->scan_cond);
+  g_cond_clear (&job->hard_link_cond);
+
+  g_hash_table_destroy (job->hard_links);
   g_object_unref (job->preferences);
 
   (*G_OBJECT_CLASS (thunar_transfer_job_parent_class)->finalize) (object);
@@ -284,6 +653,32 @@ thunar_transfer_job_get_property (GObject    *object,
     case PROP_TRANSFER_VERIFY_FILE:
       g_value_set_enum (value, job->transfer_verify_file);
       break;
+    case PROP_MAX_PARALLEL_FILES:
+      g_value_set_uint (value, job->max_parallel_files);
+      break;
+    case PROP_TRANSFER_REFLINK_MODE:
+      g_value_set_enum (value, job->transfer_reflink_mode);
+      break;
+    case PROP_TRANSFER_CHECKSUM_FILES:
+      g_value_set_boolean (value, job->transfer_checksum_files);
+      break;
+    case PROP_TRANSFER_PIPELINED:
+      g_value_set_boolean (value, job->transfer_pipelined);
+      break;
+    case PROP_BANDWIDTH_LIMIT:
+      g_mutex_lock (&job->mutex);
+      g_value_set_uint64 (value, job->bandwidth_limit);
+      g_mutex_unlock (&job->mutex);
+      break;
+    case PROP_IO_PRIORITY:
+      g_value_set_enum (value, g_atomic_int_get (&job->io_priority));
+      break;
+    case PROP_TRANSFER_JOURNAL:
+      g_value_set_boolean (value, job->transfer_journal);
+      break;
+    case PROP_TRANSFER_HARD_LINKS:
+      g_value_set_boolean (value, job->transfer_hard_links);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -314,6 +709,35 @@ thunar_transfer_job_set_property (GObject      *object,
     case PROP_TRANSFER_VERIFY_FILE:
       job->transfer_verify_file = g_value_get_enum (value);
       break;
+    case PROP_MAX_PARALLEL_FILES:
+      job->max_parallel_files = g_value_get_uint (value);
+      break;
+    case PROP_TRANSFER_REFLINK_MODE:
+      job->transfer_reflink_mode = g_value_get_enum (value);
+      break;
+    case PROP_TRANSFER_CHECKSUM_FILES:
+      job->transfer_checksum_files = g_value_get_boolean (value);
+      break;
+    case PROP_TRANSFER_PIPELINED:
+      job->transfer_pipelined = g_value_get_boolean (value);
+      break;
+    case PROP_BANDWIDTH_LIMIT:
+      /* a new limit starts with an empty bucket */
+      g_mutex_lock (&job->mutex);
+      thunar_transfer_job_atomic_set (&job->bandwidth_limit, g_value_get_uint64 (value));
+      job->throttle_tokens = 0;
+      job->throttle_time = 0;
+      g_mutex_unlock (&job->mutex);
+      break;
+    case PROP_IO_PRIORITY:
+      g_atomic_int_set (&job->io_priority, g_value_get_enum (value));
+      break;
+    case PROP_TRANSFER_JOURNAL:
+      job->transfer_journal = g_value_get_boolean (value);
+      break;
+    case PROP_TRANSFER_HARD_LINKS:
+      job->transfer_hard_links = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -322,6 +746,105 @@ thunar_transfer_job_set_property (GObject      *object,
 
 
 
+static guint
+thunar_transfer_link_key_hash (gconstpointer key)
+{
+  const ThunarTransferLinkKey *k = key;
+
+  return g_int64_hash (&k->inode) ^ g_int64_hash (&k->device);
+}
+
+
+
+static gboolean
+thunar_transfer_link_key_equal (gconstpointer a,
+                                gconstpointer b)
+{
+  const ThunarTransferLinkKey *ka = a;
+  const ThunarTransferLinkKey *kb = b;
+
+  return ka->inode == kb->inode && ka->device == kb->device;
+}
+
+
+
+static void
+thunar_transfer_link_copy_free (gpointer data)
+{
+  if (data != NULL)
+    g_object_unref (data);
+}
+
+
+
+/* looks for a copy of another hard link of the source of @node, waiting if
+ * the copy is written meanwhile, returns %NULL if @node is the first link
+ * to be copied, the caller must report the copy with
+ * thunar_transfer_job_hard_link_copied() then */
+static GFile *
+thunar_transfer_job_hard_link_lookup (ThunarTransferJob  *job,
+                                      ThunarTransferNode *node)
+{
+  ThunarTransferLinkKey  key;
+  ThunarTransferLinkKey *new_key;
+  GFile                 *copy;
+  gpointer               value;
+
+  key.device = g_file_info_get_attribute_uint32 (node->source_file_info, G_FILE_ATTRIBUTE_UNIX_DEVICE);
+  key.inode = g_file_info_get_attribute_uint64 (node->source_file_info, G_FILE_ATTRIBUTE_UNIX_INODE);
+
+  g_mutex_lock (&job->mutex);
+
+  /* another thread of the job copies the file, which takes a while, so
+   * check for cancellation in between */
+  while (g_hash_table_lookup_extended (job->hard_links, &key, NULL, &value)
+         && value == NULL
+         && !thunar_job_is_cancelled (THUNAR_JOB (job)))
+    g_cond_wait_until (&job->hard_link_cond, &job->mutex, g_get_monotonic_time () + THROTTLE_MAX_SLEEP);
+
+  if (g_hash_table_lookup_extended (job->hard_links, &key, NULL, &value))
+    copy = (value != NULL) ? g_object_ref (value) : NULL;
+  else
+    {
+      /* the first link, the others wait for it */
+      new_key = g_new (ThunarTransferLinkKey, 1);
+      *new_key = key;
+      g_hash_table_insert (job->hard_links, new_key, NULL);
+      copy = NULL;
+    }
+
+  g_mutex_unlock (&job->mutex);
+
+  return copy;
+}
+
+
+
+/* reports the copy of the first hard link of a file, or %NULL if it was not
+ * copied, so the next link is copied instead */
+static void
+thunar_transfer_job_hard_link_copied (ThunarTransferJob  *job,
+                                      ThunarTransferNode *node,
+                                      GFile              *copy)
+{
+  ThunarTransferLinkKey key;
+
+  key.device = g_file_info_get_attribute_uint32 (node->source_file_info, G_FILE_ATTRIBUTE_UNIX_DEVICE);
+  key.inode = g_file_info_get_attribute_uint64 (node->source_file_info, G_FILE_ATTRIBUTE_UNIX_INODE);
+
+  g_mutex_lock (&job->mutex);
+
+  if (copy != NULL)
+    g_hash_table_replace (job->hard_links, g_memdup2 (&key, sizeof (key)), g_object_ref (copy));
+  else
+    g_hash_table_remove (job->hard_links, &key);
+
+  g_cond_broadcast (&job->hard_link_cond);
+  g_mutex_unlock (&job->mutex);
+}
+
+
+
 static void
 thunar_transfer_job_check_pause (ThunarTransferJob *job)
 {
@@ -334,59 +857,122 @@ thunar_transfer_job_check_pause (ThunarTransferJob *job)
 
 
 
+/* takes @n_bytes from the token bucket of the bandwidth limit and waits
+ * until the bucket is refilled, if it was overdrawn */
 static void
-thunar_transfer_job_progress (goffset  current_num_bytes,
-                              goffset  total_num_bytes,
-                              gpointer user_data)
+thunar_transfer_job_throttle (ThunarTransferJob *job,
+                              guint64            n_bytes)
 {
-  ThunarTransferJob *job = user_data;
-  guint64            new_percentage;
-  gint64             current_time;
-  gint64             expired_time;
-  guint64            transfer_rate;
+  gint64  current_time;
+  gdouble wait_time;
 
   _thunar_return_if_fail (THUNAR_IS_TRANSFER_JOB (job));
 
-  thunar_transfer_job_check_pause (job);
+  /* the common case, without taking the lock */
+  if (thunar_transfer_job_atomic_get (&job->bandwidth_limit) == 0)
+    return;
+
+  g_mutex_lock (&job->mutex);
+  if (job->bandwidth_limit > 0)
+    job->throttle_tokens -= n_bytes;
+  g_mutex_unlock (&job->mutex);
 
-  if (G_LIKELY (job->total_size > 0))
+  while (!thunar_job_is_cancelled (THUNAR_JOB (job)))
     {
-      /* update total progress */
-      job->total_progress += (current_num_bytes - job->file_progress);
+      g_mutex_lock (&job->mutex);
+
+      if (job->bandwidth_limit == 0)
+        {
+          g_mutex_unlock (&job->mutex);
+          break;
+        }
 
-      /* update file progress */
-      job->file_progress = current_num_bytes;
+      /* refill the bucket for the time passed, allowing a burst of
+       * a quarter of a second after the job was idle */
+      current_time = g_get_monotonic_time ();
+      if (job->throttle_time > 0)
+        {
+          job->throttle_tokens += (gdouble) (current_time - job->throttle_time) * job->bandwidth_limit / G_USEC_PER_SEC;
+          job->throttle_tokens = MIN (job->throttle_tokens, job->bandwidth_limit / 4.0);
+        }
+      job->throttle_time = current_time;
 
-      /* compute the new percentage after the progress we've made */
-      new_percentage = (job->total_progress * 100.0) / job->total_size;
+      /* the time until the overdrawn bucket is refilled */
+      wait_time = -job->throttle_tokens * G_USEC_PER_SEC / job->bandwidth_limit;
 
-      /* get current time */
-      current_time = g_get_real_time ();
-      expired_time = current_time - job->last_update_time;
+      g_mutex_unlock (&job->mutex);
 
-      /* notify callers not more then every 500ms */
-      /* force update after transfer when it took more than (approx.) 500ms */
-      /* the actual code checks if (file size [byte]) > (transfer rate [byte/s]) * (0.5 [s]) */
-      /* which means that the file is bigger than what is transferred in 500ms on average */
-      if (expired_time > (500 * 1000)
-          || (current_num_bytes == total_num_bytes && total_num_bytes > (goffset) (job->transfer_rate / 2)))
-        {
-          /* calculate the transfer rate in the last expired time */
-          transfer_rate = (job->total_progress - job->last_total_progress) / ((gfloat) expired_time / G_USEC_PER_SEC);
+      if (wait_time <= 0)
+        break;
 
-          /* take the average of the last 10 rates (5 sec), so the output is less jumpy */
-          if (job->transfer_rate > 0)
-            job->transfer_rate = ((job->transfer_rate * 10) + transfer_rate) / 11;
-          else
-            job->transfer_rate = transfer_rate;
+      /* wait in slices, the limit may be changed meanwhile */
+      g_usleep (MIN (wait_time, THROTTLE_MAX_SLEEP));
+      thunar_transfer_job_check_pause (job);
+    }
+}
+
+
+
+static void
+thunar_transfer_job_progress (goffset  current_num_bytes,
+                              goffset  total_num_bytes,
+                              gpointer user_data)
+{
+  ThunarTransferProgress *progress = user_data;
+  ThunarTransferJob      *job = progress->job;
+  gint64                  n_bytes;
+  gint                    io_priority;
 
-          /* emit the percent signal */
-          thunar_job_percent (THUNAR_JOB (job), new_percentage);
+  _thunar_return_if_fail (THUNAR_IS_TRANSFER_JOB (job));
+
+  /* the priority was changed while the file is copied */
+  io_priority = g_atomic_int_get (&job->io_priority);
+  if (G_UNLIKELY (io_priority != progress->io_priority))
+    {
+      thunar_io_copy_restore_io_priority (progress->previous_io_priority);
+      progress->previous_io_priority = thunar_io_copy_set_io_priority (io_priority);
+      progress->io_priority = io_priority;
+    }
 
-          /* update internals */
-          job->last_update_time = current_time;
-          job->last_total_progress = job->total_progress;
+  if (G_UNLIKELY (thunar_job_is_paused (THUNAR_JOB (job))))
+    {
+      if (progress->has_slot)
+        {
+          /* let the transfers of other jobs use the devices meanwhile */
+          thunar_transfer_scheduler_release (progress->node->source_device, progress->node->target_device);
+          thunar_transfer_job_check_pause (job);
+          progress->has_slot = thunar_transfer_scheduler_acquire (progress->node->source_device, progress->node->target_device,
+                                                                  thunar_job_get_cancellable (THUNAR_JOB (job)));
         }
+      else
+        thunar_transfer_job_check_pause (job);
+    }
+
+  /* the target was created, either exclusively or because the user agreed
+   * to overwrite it, otherwise the copy would have failed before */
+  if (G_UNLIKELY (progress->journal_pending))
+    {
+      thunar_transfer_journal_add_started (job->journal, progress->target_file, progress->node->source_file);
+      progress->journal_pending = FALSE;
+    }
+
+  /* only count the progress, the main loop samples it for the percentage
+   * and the transfer rate, see thunar_transfer_job_sample() */
+  n_bytes = current_num_bytes - progress->node->file_progress;
+  progress->node->file_progress = current_num_bytes;
+  thunar_transfer_job_atomic_add (&job->total_progress, n_bytes);
+
+  /* slow down if the job exceeds its bandwidth limit */
+  if (n_bytes > 0 && n_bytes <= THROTTLE_MAX_STEP)
+    thunar_transfer_job_throttle (job, n_bytes);
+
+  if (progress->partial_file != NULL
+      && current_num_bytes < total_num_bytes
+      && (guint64) current_num_bytes >= progress->checkpoint + JOURNAL_CHECKPOINT_SIZE)
+    {
+      thunar_transfer_journal_add_checkpoint (job->journal, progress->target_file, progress->partial_file,
+                                              current_num_bytes, progress->node->source_file);
+      progress->checkpoint = current_num_bytes;
     }
 }
 
@@ -398,7 +984,7 @@ thunar_transfer_job_query_default_info (ThunarTransferJob *job,
                                         GError           **error)
 {
   return g_file_query_info (file,
-                            G_FILE_ATTRIBUTE_STANDARD_SIZE "," G_FILE_ATTRIBUTE_STANDARD_COPY_NAME "," G_FILE_ATTRIBUTE_STANDARD_DISPLAY_NAME "," G_FILE_ATTRIBUTE_STANDARD_TYPE,
+                            TRANSFER_NODE_ATTRIBUTES,
                             G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS,
                             thunar_job_get_cancellable (THUNAR_JOB (job)),
                             error);
@@ -420,10 +1006,15 @@ thunar_transfer_job_create_new_node (ThunarTransferJob *job,
   new_node->source_file_info = g_object_ref (source_file_info);
   new_node->target_file = NULL;
   new_node->child_nodes = NULL;
+  new_node->scan_state = THUNAR_TRANSFER_NODE_UNLISTED;
   new_node->ask_for_action_response = 0;
+  new_node->parent = NULL;
+  new_node->n_unfinished = 1;
+  new_node->keep_source = FALSE;
 
-  /* Update the total size of the file operation */
-  job->total_size += g_file_info_get_attribute_uint64 (source_file_info, G_FILE_ATTRIBUTE_STANDARD_SIZE);
+  /* Update the total size of the file operation, the scanner adds
+   * nodes while the copy is running */
+  thunar_transfer_job_atomic_add (&job->total_size, g_file_info_get_attribute_uint64 (source_file_info, G_FILE_ATTRIBUTE_STANDARD_SIZE));
 
   /* rename the target file, in case the used fs does not support the desired name */
   if (thunar_g_file_fs_uses_fat_name_scheme (target_file))
@@ -443,15 +1034,107 @@ thunar_transfer_job_create_new_node (ThunarTransferJob *job,
 
 
 
+/* lists the immediate children of the directory @node as new nodes, the
+ * target files of the children are created below @target_parent */
+static GList *
+thunar_transfer_job_list_children (ThunarTransferJob  *job,
+                                   ThunarTransferNode *node,
+                                   GFile              *target_parent,
+                                   GError            **error)
+{
+  GFileEnumerator *enumerator;
+  GFileInfo       *child_info;
+  GFile           *child_file;
+  GError          *err = NULL;
+  GList           *child_nodes = NULL;
+  guint            n_children = 0;
+  gboolean         should_use_copy_name;
+
+  /* the enumerator returns all the transfer needs about the children, so
+   * there is no need for a round-trip per child, which is slow on remote
+   * file systems */
+  enumerator = g_file_enumerate_children (node->source_file, TRANSFER_NODE_ATTRIBUTES,
+                                          G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS,
+                                          thunar_job_get_cancellable (THUNAR_JOB (job)),
+                                          &err);
+  if (G_UNLIKELY (enumerator == NULL))
+    {
+      g_propagate_error (error, err);
+      return NULL;
+    }
+
+  should_use_copy_name = G_UNLIKELY (!g_file_is_native (node->source_file));
+
+  /* create a node for each child */
+  while (err == NULL)
+    {
+      g_autofree gchar *child_base_name = NULL;
+      g_autoptr (GFile) target_file = NULL;
+      ThunarTransferNode *child_node;
+
+      thunar_transfer_job_check_pause (job);
+
+      child_info = g_file_enumerator_next_file (enumerator, thunar_job_get_cancellable (THUNAR_JOB (job)), &err);
+      if (child_info == NULL)
+        break;
+
+      child_file = g_file_enumerator_get_child (enumerator, child_info);
+      n_children++;
+
+      /* guess the target file for this node */
+      if (should_use_copy_name)
+        {
+          child_base_name = g_strdup (g_file_info_get_attribute_string (child_info, G_FILE_ATTRIBUTE_STANDARD_COPY_NAME));
+          /* copy name is NULLable, so use display name for fallback */
+          if (child_base_name == NULL)
+            child_base_name = g_strdup (g_file_info_get_attribute_string (child_info, G_FILE_ATTRIBUTE_STANDARD_DISPLAY_NAME));
+        }
+      else
+        child_base_name = g_file_get_basename (child_file);
+
+      if (G_LIKELY (child_base_name != NULL))
+        {
+          target_file = g_file_get_child (target_parent, child_base_name);
+          child_node = thunar_transfer_job_create_new_node (job, child_file, child_info, target_file);
+          child_node->source_device = node->source_device;
+          child_node->target_device = node->target_device;
+
+          /* add the child node into the list of child nodes */
+          child_nodes = g_list_prepend (child_nodes, child_node);
+        }
+      else
+        {
+          /* Actually this should never happen */
+          gchar *uri = g_file_get_uri (child_file);
+          g_warning ("Failed to read basename of source file: %s", uri);
+          g_free (uri);
+        }
+
+      g_object_unref (child_file);
+      g_object_unref (child_info);
+    }
+
+  g_object_unref (enumerator);
+
+  /* append Children to number of total files */
+  g_mutex_lock (&job->mutex);
+  thunar_job_set_n_total_files (THUNAR_JOB (job), thunar_job_get_n_total_files (THUNAR_JOB (job)) + n_children);
+  g_mutex_unlock (&job->mutex);
+
+  if (G_UNLIKELY (err != NULL))
+    g_propagate_error (error, err);
+
+  return g_list_reverse (child_nodes);
+}
+
+
+
 static gboolean
 thunar_transfer_job_collect_subfiles_recursively (ThunarTransferJob  *job,
                                                   ThunarTransferNode *node,
                                                   GError            **error)
 {
-  guint               n_total_files;
-  GError             *err = NULL;
-  GList              *file_list;
-  GList              *lp;
+  GError *err = NULL;
 
   _thunar_return_val_if_fail (THUNAR_IS_TRANSFER_JOB (job), FALSE);
   _thunar_return_val_if_fail (node != NULL && G_IS_FILE (node->source_file), FALSE);
@@ -467,82 +1150,95 @@ thunar_transfer_job_collect_subfiles_recursively (ThunarTransferJob  *job,
   /* check if we have a directory here */
   if (g_file_info_get_file_type (node->source_file_info) == G_FILE_TYPE_DIRECTORY)
     {
-      gboolean should_use_copy_name;
+      node->child_nodes = thunar_transfer_job_list_children (job, node, node->target_file, &err);
+      node->scan_state = THUNAR_TRANSFER_NODE_LISTED;
 
-      /* scan the directory for immediate children */
-      file_list = thunar_io_scan_directory (THUNAR_JOB (job), node->source_file,
-                                            G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS,
-                                            FALSE, FALSE, FALSE, NULL, &err);
+      /* collect the child nodes */
+      for (GList *lp = node->child_nodes; err == NULL && lp != NULL; lp = lp->next)
+        thunar_transfer_job_collect_subfiles_recursively (job, lp->data, &err);
+    }
 
-      /* append Children to number of total files */
-      n_total_files = thunar_job_get_n_total_files (THUNAR_JOB (job)) + g_list_length (file_list);
+  if (G_UNLIKELY (err != NULL))
+    {
+      g_propagate_error (error, err);
+      return FALSE;
+    }
 
-      thunar_job_set_n_total_files (THUNAR_JOB (job), n_total_files);
+  return TRUE;
+}
 
-      should_use_copy_name = G_UNLIKELY (!g_file_is_native (node->source_file));
 
-      /* add children to the transfer node */
-      for (lp = file_list; err == NULL && lp != NULL; lp = lp->next)
-        {
-          g_autofree gchar *child_base_name = NULL;
-          g_autoptr (GFileInfo) child_info = NULL;
-          g_autoptr (GFile) target_file = NULL;
-          ThunarTransferNode *child_node;
 
-          thunar_transfer_job_check_pause (job);
+/* takes over the children listed for @node, must be called with scan_mutex
+ * held, the target of @node may have been renamed while it was listed */
+static void
+thunar_transfer_job_set_child_nodes (ThunarTransferJob          *job,
+                                     ThunarTransferNode         *node,
+                                     GList                      *child_nodes,
+                                     GFile                      *target_parent,
+                                     ThunarTransferNodeScanState scan_state)
+{
+  node->child_nodes = child_nodes;
+  node->scan_state = scan_state;
 
-          /* query file info */
-          child_info = thunar_transfer_job_query_default_info (job, lp->data, &err);
+  if (node->target_file != NULL && node->target_file != target_parent)
+    for (GList *lp = child_nodes; lp != NULL; lp = lp->next)
+      thunar_transfer_node_reparent_target_recursive (lp->data, node->target_file);
 
-          if (child_info == NULL)
-            {
-              if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED))
-                {
-                  g_clear_error (&err);
-                  break;
-                }
-              else
-                {
-                  gchar *uri = g_file_get_uri (lp->data);
-                  g_warning ("Failed to query file info from file: %s. Error: %s", uri, err->message);
-                  g_free (uri);
-                  g_clear_error (&err);
-                  continue;
-                }
-            }
+  if (scan_state == THUNAR_TRANSFER_NODE_LISTED_AHEAD)
+    job->n_scanned_ahead += g_list_length (child_nodes);
 
-          /* guess the target file for this node */
-          if (should_use_copy_name)
-            {
-              child_base_name = g_strdup (g_file_info_get_attribute_string (child_info, G_FILE_ATTRIBUTE_STANDARD_COPY_NAME));
-              /* copy name is NULLable, so use display name for fallback */
-              if (child_base_name == NULL)
-                child_base_name = g_strdup (g_file_info_get_attribute_string (child_info, G_FILE_ATTRIBUTE_STANDARD_DISPLAY_NAME));
-            }
-          else
-            child_base_name = g_file_get_basename (lp->data);
+  g_cond_broadcast (&job->scan_cond);
+}
 
-          if (child_base_name == NULL)
-            {
-              /* Actually this should never happen */
-              g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_IO, "Failed to read basename of source file");
-              continue;
-            }
 
-          target_file = g_file_get_child (node->target_file, child_base_name);
-          child_node = thunar_transfer_job_create_new_node (job, lp->data, child_info, target_file);
 
-          /* add the child node into the list of child nodes */
-          node->child_nodes = g_list_append (node->child_nodes, child_node);
+/* makes sure the immediate children of @node are collected, to be called
+ * right before they are copied, waits if the scanner is listing @node */
+static gboolean
+thunar_transfer_job_collect_children (ThunarTransferJob  *job,
+                                      ThunarTransferNode *node,
+                                      GError            **error)
+{
+  GFile  *target_parent;
+  GList  *child_nodes;
+  GError *err = NULL;
+
+  if (g_file_info_get_file_type (node->source_file_info) != G_FILE_TYPE_DIRECTORY)
+    return TRUE;
 
-          /* collect the child node */
-          thunar_transfer_job_collect_subfiles_recursively (job, child_node, &err);
+  g_mutex_lock (&job->scan_mutex);
+
+  while (node->scan_state == THUNAR_TRANSFER_NODE_LISTING)
+    g_cond_wait (&job->scan_cond, &job->scan_mutex);
+
+  if (node->scan_state != THUNAR_TRANSFER_NODE_UNLISTED)
+    {
+      /* give the scanner room for the next folders */
+      if (node->scan_state == THUNAR_TRANSFER_NODE_LISTED_AHEAD)
+        {
+          job->n_scanned_ahead -= g_list_length (node->child_nodes);
+          node->scan_state = THUNAR_TRANSFER_NODE_LISTED;
+          g_cond_broadcast (&job->scan_cond);
         }
 
-      /* release the child files */
-      thunar_g_list_free_full (file_list);
+      g_mutex_unlock (&job->scan_mutex);
+      return TRUE;
     }
 
+  /* the copy caught up with the scanner, list the folder here */
+  node->scan_state = THUNAR_TRANSFER_NODE_LISTING;
+  target_parent = g_object_ref (node->target_file);
+  g_mutex_unlock (&job->scan_mutex);
+
+  child_nodes = thunar_transfer_job_list_children (job, node, target_parent, &err);
+
+  g_mutex_lock (&job->scan_mutex);
+  thunar_transfer_job_set_child_nodes (job, node, child_nodes, target_parent, THUNAR_TRANSFER_NODE_LISTED);
+  g_mutex_unlock (&job->scan_mutex);
+
+  g_object_unref (target_parent);
+
   if (G_UNLIKELY (err != NULL))
     {
       g_propagate_error (error, err);
@@ -554,23 +1250,271 @@ thunar_transfer_job_collect_subfiles_recursively (ThunarTransferJob  *job,
 
 
 
+/* gives the budget of the folders the scanner listed below @node back
+ * and keeps it from listing more, for nodes which are not copied, must
+ * be called with scan_mutex held */
+static void
+thunar_transfer_job_drop_scanned_ahead (ThunarTransferJob  *job,
+                                        ThunarTransferNode *node)
+{
+  if (g_file_info_get_file_type (node->source_file_info) != G_FILE_TYPE_DIRECTORY)
+    return;
+
+  while (node->scan_state == THUNAR_TRANSFER_NODE_LISTING)
+    g_cond_wait (&job->scan_cond, &job->scan_mutex);
+
+  if (node->scan_state == THUNAR_TRANSFER_NODE_LISTED_AHEAD)
+    job->n_scanned_ahead -= g_list_length (node->child_nodes);
+  node->scan_state = THUNAR_TRANSFER_NODE_LISTED;
+
+  for (GList *lp = node->child_nodes; lp != NULL; lp = lp->next)
+    thunar_transfer_job_drop_scanned_ahead (job, lp->data);
+}
+
+
+
+/* walks the folders in the order they are copied and lists them ahead of
+ * the copy, so the copy starts right away and the totals grow meanwhile */
+static gpointer
+thunar_transfer_job_scan_thread (gpointer data)
+{
+  ThunarTransferJob  *job = THUNAR_TRANSFER_JOB (data);
+  ThunarTransferNode *node;
+  GQueue              pending = G_QUEUE_INIT;
+  GFile              *target_parent;
+  GList              *child_nodes;
+  GList              *lp;
+  GError             *err = NULL;
+
+  for (lp = g_list_last (job->transfer_node_list); lp != NULL; lp = lp->prev)
+    g_queue_push_head (&pending, lp->data);
+
+  while ((node = g_queue_pop_head (&pending)) != NULL)
+    {
+      if (g_file_info_get_file_type (node->source_file_info) != G_FILE_TYPE_DIRECTORY)
+        continue;
+
+      g_mutex_lock (&job->scan_mutex);
+
+      /* don't run too far ahead of the copy */
+      while (!job->scan_stop
+             && (job->n_scanned_ahead >= MAX_SCANNED_AHEAD
+                 || node->scan_state == THUNAR_TRANSFER_NODE_LISTING))
+        g_cond_wait (&job->scan_cond, &job->scan_mutex);
+
+      if (job->scan_stop || thunar_job_is_cancelled (THUNAR_JOB (job)))
+        {
+          g_mutex_unlock (&job->scan_mutex);
+          break;
+        }
+
+      /* skipped folders have no target anymore */
+      if (node->scan_state == THUNAR_TRANSFER_NODE_UNLISTED && node->target_file != NULL)
+        {
+          node->scan_state = THUNAR_TRANSFER_NODE_LISTING;
+          target_parent = g_object_ref (node->target_file);
+          g_mutex_unlock (&job->scan_mutex);
+
+          child_nodes = thunar_transfer_job_list_children (job, node, target_parent, &err);
+
+          g_mutex_lock (&job->scan_mutex);
+          if (G_LIKELY (err == NULL))
+            thunar_transfer_job_set_child_nodes (job, node, child_nodes, target_parent, THUNAR_TRANSFER_NODE_LISTED_AHEAD);
+          else
+            {
+              /* leave the folder to the copy, which reports the error */
+              g_list_free_full (child_nodes, thunar_transfer_node_free);
+              node->scan_state = THUNAR_TRANSFER_NODE_UNLISTED;
+              g_cond_broadcast (&job->scan_cond);
+              g_clear_error (&err);
+            }
+
+          g_object_unref (target_parent);
+        }
+
+      /* continue with the children of this folder, in their order */
+      for (lp = g_list_last (node->child_nodes); lp != NULL; lp = lp->prev)
+        g_queue_push_head (&pending, lp->data);
+
+      g_mutex_unlock (&job->scan_mutex);
+    }
+
+  g_queue_clear (&pending);
+
+  return NULL;
+}
+
+
+
+/* sets the target of @node, the scanner reads the targets of the folders
+ * it lists, the old target is released */
+static void
+thunar_transfer_job_set_target_file (ThunarTransferJob  *job,
+                                     ThunarTransferNode *node,
+                                     GFile              *target_file)
+{
+  GFile *old_target_file;
+
+  g_mutex_lock (&job->scan_mutex);
+  old_target_file = node->target_file;
+  node->target_file = (target_file != NULL) ? g_object_ref (target_file) : NULL;
+  g_mutex_unlock (&job->scan_mutex);
+
+  if (old_target_file != NULL)
+    g_object_unref (old_target_file);
+}
+
+
+
+static gboolean
+thunar_transfer_job_ask_no_space (ThunarTransferJob *transfer_job,
+                                  GFile             *dest,
+                                  guint64            missing_size)
+{
+  GFileInfo *dest_info;
+  gchar     *dest_name = NULL;
+  gchar     *size_string;
+  gboolean   succeed;
+
+  /* some info about the file */
+  dest_info = g_file_query_info (dest, G_FILE_ATTRIBUTE_STANDARD_DISPLAY_NAME, 0,
+                                 thunar_job_get_cancellable (THUNAR_JOB (transfer_job)),
+                                 NULL);
+  if (dest_info != NULL)
+    {
+      dest_name = g_strdup (g_file_info_get_display_name (dest_info));
+      g_object_unref (G_OBJECT (dest_info));
+    }
+
+  if (dest_name == NULL)
+    {
+      gchar *base_name = g_file_get_basename (dest);
+      dest_name = g_filename_display_name (base_name);
+      g_free (base_name);
+    }
+
+  size_string = g_format_size_full (missing_size,
+                                    transfer_job->file_size_binary ? G_FORMAT_SIZE_IEC_UNITS : G_FORMAT_SIZE_DEFAULT);
+  succeed = thunar_job_ask_no_size (THUNAR_JOB (transfer_job),
+                                    _("Error while copying to \"%s\": %s more space is "
+                                      "required to copy to the destination"),
+                                    dest_name, size_string);
+  g_free (size_string);
+  g_free (dest_name);
+
+  return succeed;
+}
+
+
+
+/* reserves the space for the copy of @node on the target, while the total
+ * size is not known upfront, the free space is only queried again once
+ * the copies so far used up what was free the last time */
+static void
+thunar_transfer_job_reserve_space (ThunarTransferJob  *job,
+                                   ThunarTransferNode *node,
+                                   GFile              *target_file)
+{
+  GFileInfo *filesystem_info;
+  GFile     *dest;
+  guint64    size;
+  guint64    free_space;
+  guint64    missing_size = 0;
+
+  size = g_file_info_get_attribute_uint64 (node->source_file_info, G_FILE_ATTRIBUTE_STANDARD_SIZE);
+
+  g_mutex_lock (&job->mutex);
+  job->space_reserved += size;
+  if (!job->reserve_space || size <= job->space_left)
+    {
+      job->space_left -= MIN (size, job->space_left);
+      g_mutex_unlock (&job->mutex);
+      return;
+    }
+  g_mutex_unlock (&job->mutex);
+
+  dest = g_file_get_parent (target_file);
+  filesystem_info = g_file_query_filesystem_info (dest, G_FILE_ATTRIBUTE_FILESYSTEM_FREE,
+                                                  thunar_job_get_cancellable (THUNAR_JOB (job)),
+                                                  NULL);
+
+  g_mutex_lock (&job->mutex);
+  if (filesystem_info != NULL && g_file_info_has_attribute (filesystem_info, G_FILE_ATTRIBUTE_FILESYSTEM_FREE))
+    {
+      /* the running copies did not write all of their data yet */
+      free_space = g_file_info_get_attribute_uint64 (filesystem_info, G_FILE_ATTRIBUTE_FILESYSTEM_FREE);
+      job->space_left = free_space - MIN (free_space, job->space_reserved - size);
+
+      /* ask only once, if the user continues the copies fail as soon as the space runs out */
+      if (size > job->space_left && job->reserve_space)
+        {
+          missing_size = size - job->space_left;
+          job->reserve_space = FALSE;
+        }
+
+      job->space_left -= MIN (size, job->space_left);
+    }
+  else
+    {
+      /* unable to query the info, this could happen on some backends */
+      job->reserve_space = FALSE;
+    }
+  g_mutex_unlock (&job->mutex);
+
+  if (missing_size > 0)
+    {
+      g_mutex_lock (&job->ask_mutex);
+      thunar_transfer_job_ask_no_space (job, dest, missing_size);
+      g_mutex_unlock (&job->ask_mutex);
+    }
+
+  if (filesystem_info != NULL)
+    g_object_unref (filesystem_info);
+  g_object_unref (dest);
+}
+
+
+
+/* the copy of @node is written completely, or failed */
+static void
+thunar_transfer_job_release_space (ThunarTransferJob  *job,
+                                   ThunarTransferNode *node)
+{
+  guint64 size;
+
+  size = g_file_info_get_attribute_uint64 (node->source_file_info, G_FILE_ATTRIBUTE_STANDARD_SIZE);
+
+  g_mutex_lock (&job->mutex);
+  job->space_reserved -= MIN (size, job->space_reserved);
+  g_mutex_unlock (&job->mutex);
+}
+
+
+
 static gboolean
 ttj_copy_file (ThunarTransferJob  *job,
                ThunarJobOperation *operation,
-               GFile              *source_file,
+               ThunarTransferNode *node,
                GFile              *target_file,
                GFileCopyFlags      copy_flags,
                GError            **error)
 {
-  GFileInfo *info;
-  GFileType  source_type;
-  GFileType  target_type;
-  gboolean   target_exists;
-  gboolean   use_partial;
-  gboolean   verify_file;
-  gboolean   add_to_operation = TRUE;
-  gboolean   success;
-  GError    *err = NULL;
+  ThunarTransferProgress progress = { job, node, FALSE, THUNAR_IO_PRIORITY_NORMAL, -1, target_file, NULL, 0, FALSE };
+  GFile                 *source_file = node->source_file;
+  GFileInfo             *info;
+  GFileType              source_type;
+  gboolean               target_exists;
+  gboolean               use_partial;
+  gboolean               verify_file;
+  gboolean               add_to_operation = TRUE;
+  gboolean               success;
+  gboolean               first_link = FALSE;
+  gboolean               linked = FALSE;
+  GFile                 *link_copy;
+  GFile                 *checksum_file = NULL;
+  gchar                 *checksum = NULL;
+  guint64                source_size;
+  GError                *err = NULL;
 
   _thunar_return_val_if_fail (THUNAR_IS_TRANSFER_JOB (job), FALSE);
   _thunar_return_val_if_fail (G_IS_FILE (source_file), FALSE);
@@ -578,28 +1522,49 @@ ttj_copy_file (ThunarTransferJob  *job,
   _thunar_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
   /* reset the file progress */
-  job->file_progress = 0;
+  node->file_progress = 0;
 
   if (thunar_job_set_error_if_cancelled (THUNAR_JOB (job), error))
     return FALSE;
   thunar_transfer_job_check_pause (job);
 
-  source_type = g_file_query_file_type (source_file, G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS,
-                                        thunar_job_get_cancellable (THUNAR_JOB (job)));
+  /* the type is known from collecting the node, the target is only looked
+   * at if the copy failed because it exists, since most targets don't */
+  source_type = g_file_info_get_file_type (node->source_file_info);
+  source_size = g_file_info_get_size (node->source_file_info);
 
-  if (thunar_job_set_error_if_cancelled (THUNAR_JOB (job), error))
-    return FALSE;
-  thunar_transfer_job_check_pause (job);
+  if (job->journal != NULL)
+    {
+      /* the interrupted copy this job resumes got this file done already,
+       * the contents of folders are still looked at */
+      if (thunar_transfer_journal_is_completed (job->journal, target_file, source_size))
+        {
+          if (source_type == G_FILE_TYPE_REGULAR)
+            {
+              thunar_transfer_job_atomic_add (&job->total_progress, source_size);
+              node->file_progress = source_size;
+            }
 
-  target_type = g_file_query_file_type (target_file, G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS,
-                                        thunar_job_get_cancellable (THUNAR_JOB (job)));
+          if (operation != NULL)
+            {
+              g_mutex_lock (&job->mutex);
+              thunar_job_operation_add (operation, source_file, target_file);
+              g_mutex_unlock (&job->mutex);
+            }
 
-  if (thunar_job_set_error_if_cancelled (THUNAR_JOB (job), error))
-    return FALSE;
-  thunar_transfer_job_check_pause (job);
+          return TRUE;
+        }
+
+      /* the target is an incomplete copy, which is not worth asking about */
+      if (source_type == G_FILE_TYPE_REGULAR && thunar_transfer_journal_is_started (job->journal, target_file))
+        copy_flags |= G_FILE_COPY_OVERWRITE;
+    }
 
   /* check if the target is a symlink and we are in overwrite mode */
-  if (target_type == G_FILE_TYPE_SYMBOLIC_LINK && (copy_flags & G_FILE_COPY_OVERWRITE) != 0)
+  if ((copy_flags & G_FILE_COPY_OVERWRITE) != 0
+      && g_file_query_file_type (target_file, G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS,
+                                 thunar_job_get_cancellable (THUNAR_JOB (job)))
+         == G_FILE_TYPE_SYMBOLIC_LINK)
     {
       /* try to delete the symlink */
       if (!g_file_delete (target_file, thunar_job_get_cancellable (THUNAR_JOB (job)), &err))
@@ -621,11 +1586,6 @@ ttj_copy_file (ThunarTransferJob  *job,
       use_partial = FALSE;
     }
 
-  /* try to copy the file */
-  success = thunar_g_file_copy (source_file, target_file, copy_flags, use_partial,
-                                thunar_job_get_cancellable (THUNAR_JOB (job)),
-                                thunar_transfer_job_progress, job, &err);
-
   switch (job->transfer_verify_file)
     {
     case THUNAR_VERIFY_FILE_MODE_REMOTE_ONLY:
@@ -639,24 +1599,132 @@ ttj_copy_file (ThunarTransferJob  *job,
     }
 
   /* Only verify when the file is a regular file */
-  verify_file = verify_file && (g_file_query_file_type (source_file, G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS, thunar_job_get_cancellable (THUNAR_JOB (job))) == G_FILE_TYPE_REGULAR);
+  verify_file = verify_file && source_type == G_FILE_TYPE_REGULAR;
+
+  /* files with more than one hard link are copied once, the other links
+   * are linked to that copy. This may wait for the thread copying the
+   * first link, so it must happen before taking a slot of the scheduler:
+   * the first link may need that slot to continue after a pause */
+  if (job->transfer_hard_links
+      && source_type == G_FILE_TYPE_REGULAR
+      && g_file_info_get_attribute_uint32 (node->source_file_info, G_FILE_ATTRIBUTE_UNIX_NLINK) > 1
+      && g_file_is_native (source_file) && g_file_is_native (target_file))
+    {
+      link_copy = thunar_transfer_job_hard_link_lookup (job, node);
+      first_link = (link_copy == NULL);
+      if (link_copy != NULL)
+        {
+          linked = thunar_io_copy_hard_link (link_copy, target_file, copy_flags, &err);
+          g_object_unref (link_copy);
+
+          /* the target file system cannot link these files, copy instead */
+          if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED))
+            g_clear_error (&err);
+        }
+    }
+
+  /* the data of regular files is only copied once both devices have room for
+   * another file, the budgets are shared with the transfers of other jobs */
+  if (source_type == G_FILE_TYPE_REGULAR)
+    {
+      /* the user may cancel if the target runs out of space */
+      thunar_transfer_job_reserve_space (job, node, target_file);
+      if (thunar_job_set_error_if_cancelled (THUNAR_JOB (job), error))
+        {
+          thunar_transfer_job_release_space (job, node);
+          if (first_link)
+            thunar_transfer_job_hard_link_copied (job, node, NULL);
+          g_clear_error (&err);
+          return FALSE;
+        }
+
+      /* linking another copy writes no data */
+      if (!linked && err == NULL)
+        progress.has_slot = thunar_transfer_scheduler_try_acquire (node->source_device, node->target_device);
+
+      if (!linked && err == NULL && !progress.has_slot)
+        {
+          /* parallel copies of the same job wait silently */
+          if (job->file_pool == NULL)
+            thunar_job_info_message (THUNAR_JOB (job), _("Waiting for other transfers on the same device..."));
+
+          progress.has_slot = thunar_transfer_scheduler_acquire (node->source_device, node->target_device,
+                                                                 thunar_job_get_cancellable (THUNAR_JOB (job)));
+          if (!progress.has_slot)
+            {
+              thunar_transfer_job_release_space (job, node);
+              if (first_link)
+                thunar_transfer_job_hard_link_copied (job, node, NULL);
+              thunar_job_set_error_if_cancelled (THUNAR_JOB (job), error);
+              return FALSE;
+            }
+
+          if (job->file_pool == NULL)
+            thunar_job_info_message (THUNAR_JOB (job), "%s", g_file_info_get_display_name (node->source_file_info));
+        }
+    }
 
-  if (verify_file && err == NULL)
+  if (job->journal != NULL && source_type == G_FILE_TYPE_REGULAR)
     {
-      gboolean is_equal;
-      thunar_job_info_message (THUNAR_JOB (job), _("Verifying file contents..."));
-      is_equal = thunar_g_file_compare_contents (source_file, target_file,
-                                                 thunar_job_get_cancellable (THUNAR_JOB (job)), &err);
+      /* recorded once the copy got the target, an existing file of the
+       * user must never be taken for a started copy when resuming */
+      progress.journal_pending = TRUE;
 
-      /* if the copied file is corrupted and yet no error*/
-      if (!is_equal && err == NULL)
+      /* only the data of local *.partial~ files is synced and continued,
+       * as long as the source did not change since */
+      if (use_partial && g_file_is_native (target_file))
         {
-          err = g_error_new (G_FILE_ERROR,
-                             G_FILE_ERROR_AGAIN,
-                             "Copied file does not match with the original");
+          progress.partial_file = thunar_g_file_get_partial (target_file);
+          progress.checkpoint = thunar_transfer_journal_get_checkpoint (job->journal, target_file, source_file);
         }
     }
 
+  if (linked)
+    {
+      success = TRUE;
+      thunar_transfer_job_progress (source_size, source_size, &progress);
+    }
+  else if (err != NULL)
+    {
+      success = FALSE;
+    }
+  else
+    {
+      /* the priority sticks to the thread, which may copy for another job next */
+      progress.io_priority = g_atomic_int_get (&job->io_priority);
+      progress.previous_io_priority = thunar_io_copy_set_io_priority (progress.io_priority);
+
+      /* try to copy the file, local files are verified while being copied */
+      success = thunar_g_file_copy (source_file, target_file, copy_flags, use_partial,
+                                    progress.partial_file != NULL, progress.checkpoint,
+                                    job->transfer_reflink_mode, verify_file,
+                                    thunar_job_get_cancellable (THUNAR_JOB (job)),
+                                    thunar_transfer_job_progress, &progress,
+                                    job->transfer_checksum_files ? &checksum : NULL, &err);
+
+      thunar_io_copy_restore_io_priority (progress.previous_io_priority);
+
+      /* let the other links of the file wait no longer */
+      if (first_link)
+        thunar_transfer_job_hard_link_copied (job, node, success ? target_file : NULL);
+    }
+
+  g_clear_object (&progress.partial_file);
+
+  if (source_type == G_FILE_TYPE_REGULAR)
+    thunar_transfer_job_release_space (job, node);
+
+  if (progress.has_slot)
+    thunar_transfer_scheduler_release (node->source_device, node->target_device);
+
+  /* export the checksum of local copies, failing to do so is not an error,
+   * an existing checksum file is kept */
+  if (success && checksum != NULL)
+    {
+      checksum_file = thunar_io_copy_write_checksum_file (target_file, checksum, thunar_job_get_cancellable (THUNAR_JOB (job)), NULL);
+      g_free (checksum);
+    }
+
   /**
    * MR !127 notes:
    * (Discussion: https://gitlab.xfce.org/xfce/thunar/-/merge_requests/127)
@@ -669,11 +1737,25 @@ ttj_copy_file (ThunarTransferJob  *job,
    **/
   if (G_UNLIKELY (err == NULL && !g_file_is_native (source_file)))
     {
-      info = g_file_query_info (source_file, G_FILE_ATTRIBUTE_TIME_MODIFIED, G_FILE_QUERY_INFO_NONE,
-                                thunar_job_get_cancellable (THUNAR_JOB (job)), &err);
+      /* the modification time is usually known from collecting the node */
+      if (g_file_info_has_attribute (node->source_file_info, G_FILE_ATTRIBUTE_TIME_MODIFIED))
+        {
+          info = g_file_info_new ();
+          g_file_info_set_attribute_uint64 (info, G_FILE_ATTRIBUTE_TIME_MODIFIED,
+                                            g_file_info_get_attribute_uint64 (node->source_file_info, G_FILE_ATTRIBUTE_TIME_MODIFIED));
+          if (g_file_info_has_attribute (node->source_file_info, G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC))
+            g_file_info_set_attribute_uint32 (info, G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC,
+                                              g_file_info_get_attribute_uint32 (node->source_file_info, G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC));
+        }
+      else
+        {
+          info = g_file_query_info (source_file, G_FILE_ATTRIBUTE_TIME_MODIFIED, G_FILE_QUERY_INFO_NONE,
+                                    thunar_job_get_cancellable (THUNAR_JOB (job)), &err);
+        }
 
-      g_file_set_attributes_from_info (target_file, info, G_FILE_QUERY_INFO_NONE,
-                                       thunar_job_get_cancellable (THUNAR_JOB (job)), &err);
+      if (info != NULL)
+        g_file_set_attributes_from_info (target_file, info, G_FILE_QUERY_INFO_NONE,
+                                         thunar_job_get_cancellable (THUNAR_JOB (job)), &err);
       g_clear_object (&info);
     }
 
@@ -695,7 +1777,9 @@ ttj_copy_file (ThunarTransferJob  *job,
       if (err->code == G_IO_ERROR_WOULD_MERGE
           || (err->code == G_IO_ERROR_EXISTS
               && source_type == G_FILE_TYPE_DIRECTORY
-              && target_type == G_FILE_TYPE_DIRECTORY))
+              && g_file_query_file_type (target_file, G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS,
+                                         thunar_job_get_cancellable (THUNAR_JOB (job)))
+                 == G_FILE_TYPE_DIRECTORY))
         {
           /* we tried to overwrite a directory with a directory. Propagate the error, so that the user can decide what to do */
 
@@ -753,8 +1837,13 @@ ttj_copy_file (ThunarTransferJob  *job,
         }
     }
 
+  /* the data must be on the disk before the journal skips the file when resuming */
+  if (err == NULL && job->journal != NULL && source_type == G_FILE_TYPE_REGULAR)
+    thunar_io_copy_sync (target_file, &err);
+
   if (G_UNLIKELY (err != NULL))
     {
+      g_clear_object (&checksum_file);
       g_propagate_error (error, err);
       return FALSE;
     }
@@ -762,11 +1851,25 @@ ttj_copy_file (ThunarTransferJob  *job,
     {
       if (operation != NULL && add_to_operation)
         {
+          g_mutex_lock (&job->mutex);
+
           if (copy_flags & G_FILE_COPY_OVERWRITE)
             thunar_job_operation_overwrite (operation, target_file);
 
           thunar_job_operation_add (operation, source_file, target_file);
+
+          /* undoing the copy deletes the checksum file as well */
+          if (checksum_file != NULL)
+            thunar_job_operation_add_created (operation, checksum_file);
+
+          g_mutex_unlock (&job->mutex);
         }
+
+      g_clear_object (&checksum_file);
+
+      if (job->journal != NULL)
+        thunar_transfer_journal_add_completed (job->journal, target_file, source_size);
+
       return TRUE;
     }
 }
@@ -824,11 +1927,11 @@ thunar_transfer_job_copy_file (ThunarTransferJob  *job,
       if (err == NULL)
         {
           /* try to copy the file from source file to the duplicate file */
-          if (ttj_copy_file (job, operation, node->source_file, target, copy_flags, &err))
+          if (ttj_copy_file (job, operation, node, target, copy_flags, &err))
             {
               /* update the target file */
-              g_object_unref (node->target_file);
-              node->target_file = g_object_ref (target);
+              thunar_transfer_job_set_target_file (job, node, target);
+              g_object_unref (target);
               return;
             }
           else /* go to error case */
@@ -843,7 +1946,11 @@ thunar_transfer_job_copy_file (ThunarTransferJob  *job,
 
           /* if necessary, ask the user whether to replace / rename / merge */
           if (node->ask_for_action_response == 0)
-            node->ask_for_action_response = thunar_job_ask_for_action (THUNAR_JOB (job), node->source_file, dest_file, &err);
+            {
+              g_mutex_lock (&job->ask_mutex);
+              node->ask_for_action_response = thunar_job_ask_for_action (THUNAR_JOB (job), node->source_file, dest_file, &err);
+              g_mutex_unlock (&job->ask_mutex);
+            }
 
           if (err != NULL)
             break;
@@ -909,7 +2016,7 @@ thunar_transfer_node_reparent_target_recursive (ThunarTransferNode *node,
 
 
 
-static void
+static gboolean
 thunar_transfer_job_remove_node (ThunarTransferJob  *job,
                                  ThunarTransferNode *node)
 {
@@ -917,8 +2024,8 @@ thunar_transfer_job_remove_node (ThunarTransferJob  *job,
   g_autoptr (ThunarApplication) application = NULL;
   GError           *err = NULL;
 
-  _thunar_return_if_fail (THUNAR_IS_TRANSFER_JOB (job));
-  _thunar_return_if_fail (node != NULL && G_IS_FILE (node->source_file));
+  _thunar_return_val_if_fail (THUNAR_IS_TRANSFER_JOB (job), FALSE);
+  _thunar_return_val_if_fail (node != NULL && G_IS_FILE (node->source_file), FALSE);
 
   application = thunar_application_get ();
   thumbnail_cache = thunar_application_get_thumbnail_cache (application);
@@ -927,22 +2034,26 @@ thunar_transfer_job_remove_node (ThunarTransferJob  *job,
     {
       thunar_transfer_job_check_pause (job);
 
-      if (g_file_delete (node->source_file,
-                         thunar_job_get_cancellable (THUNAR_JOB (job)),
-                         &err))
+      /* the copy has to be on the disk before the source is gone */
+      if ((node->target_file == NULL || thunar_io_copy_sync (node->target_file, &err))
+          && g_file_delete (node->source_file,
+                            thunar_job_get_cancellable (THUNAR_JOB (job)),
+                            &err))
         {
           /* notify the thumbnail cache of the delete operation */
           thunar_thumbnail_cache_delete_file (thumbnail_cache, node->source_file);
-          return;
+          return TRUE;
         }
       else
         {
           ThunarJobResponse skip_response;
 
           /* ask the user to retry */
+          g_mutex_lock (&job->ask_mutex);
           skip_response = thunar_job_ask_skip (THUNAR_JOB (job), _("Failed to move file \"%s\": %s"),
                                                g_file_info_get_display_name (node->source_file_info),
                                                err->message);
+          g_mutex_unlock (&job->ask_mutex);
 
           /* reset the error */
           g_clear_error (&err);
@@ -951,13 +2062,117 @@ thunar_transfer_job_remove_node (ThunarTransferJob  *job,
           if (G_UNLIKELY (skip_response == THUNAR_JOB_RESPONSE_RETRY))
             continue;
 
-          return;
+          return FALSE;
         }
     }
 }
 
 
 
+/* makes @node the folder node of @child, so the source of @node is only
+ * deleted after @child was moved, see thunar_transfer_job_release_node() */
+static void
+thunar_transfer_node_hold (ThunarTransferNode *node,
+                           ThunarTransferNode *child)
+{
+  child->parent = node;
+  g_atomic_int_inc (&node->n_unfinished);
+}
+
+
+
+/* to be called once @node or a child held by it is done, @moved tells whether
+ * it was moved, the sources of @node and its folder nodes are deleted as soon
+ * as all their children are moved, from the bottom up */
+static void
+thunar_transfer_job_release_node (ThunarTransferJob  *job,
+                                  ThunarTransferNode *node,
+                                  gboolean            moved)
+{
+  if (job->type != THUNAR_TRANSFER_JOB_MOVE)
+    return;
+
+  for (; node != NULL; node = node->parent)
+    {
+      if (!moved)
+        g_atomic_int_set (&node->keep_source, TRUE);
+
+      if (!g_atomic_int_dec_and_test (&node->n_unfinished))
+        return;
+
+      moved = !g_atomic_int_get (&node->keep_source)
+              && !thunar_job_is_cancelled (THUNAR_JOB (job))
+              && thunar_transfer_job_remove_node (job, node);
+    }
+}
+
+
+
+/* takes ownership of @error, only the first error is kept */
+static void
+thunar_transfer_job_take_file_pool_error (ThunarTransferJob *job,
+                                          GError            *error)
+{
+  g_mutex_lock (&job->mutex);
+  if (job->file_pool_error == NULL)
+    job->file_pool_error = error;
+  else
+    g_error_free (error);
+  g_mutex_unlock (&job->mutex);
+}
+
+
+
+static gboolean
+thunar_transfer_job_file_pool_failed (ThunarTransferJob *job)
+{
+  gboolean failed;
+
+  g_mutex_lock (&job->mutex);
+  failed = (job->file_pool_error != NULL);
+  g_mutex_unlock (&job->mutex);
+
+  return failed;
+}
+
+
+
+static void
+thunar_transfer_job_file_pool_copy (gpointer data,
+                                    gpointer user_data)
+{
+  ThunarTransferNode *node = data;
+  ThunarTransferJob  *job = THUNAR_TRANSFER_JOB (user_data);
+  GError             *err = NULL;
+
+  /* don't start any further copies once the job failed */
+  if (thunar_job_is_cancelled (THUNAR_JOB (job)) || thunar_transfer_job_file_pool_failed (job))
+    return;
+
+  thunar_transfer_job_copy_node (job, job->file_pool_operation, node, &err);
+  if (G_UNLIKELY (err != NULL))
+    thunar_transfer_job_take_file_pool_error (job, err);
+}
+
+
+
+/* hands a regular file over to the file pool, if there is one,
+ * directories are always copied by the job thread to keep their order */
+static gboolean
+thunar_transfer_job_file_pool_push (ThunarTransferJob  *job,
+                                    ThunarTransferNode *node)
+{
+  if (job->file_pool == NULL
+      || g_file_info_get_file_type (node->source_file_info) == G_FILE_TYPE_DIRECTORY)
+    return FALSE;
+
+  g_thread_pool_push (job->file_pool, node, NULL);
+
+  return TRUE;
+}
+
+
+
 static void
 thunar_transfer_job_copy_node (ThunarTransferJob  *job,
                                ThunarJobOperation *operation,
@@ -991,9 +2206,21 @@ retry_copy:
       /* A directory was skipped, because it's files have to be merged */
       if (node->ask_for_action_response == THUNAR_JOB_RESPONSE_MERGE)
         {
+          /* the scanner may not have reached the folder yet */
+          if (!thunar_transfer_job_collect_children (job, node, &err))
+            {
+              g_propagate_error (error, err);
+              return;
+            }
+
           /* Let's copy the children */
-          for (GList *lp = node->child_nodes; lp != NULL; lp = lp->next)
+          for (GList *lp = node->child_nodes; lp != NULL && !thunar_transfer_job_file_pool_failed (job); lp = lp->next)
             {
+              thunar_transfer_node_hold (node, lp->data);
+
+              if (thunar_transfer_job_file_pool_push (job, lp->data))
+                continue;
+
               thunar_transfer_job_copy_node (job, operation, lp->data, &err);
               if (G_UNLIKELY (err != NULL))
                 {
@@ -1001,6 +2228,9 @@ retry_copy:
                   return;
                 }
             }
+
+          /* remove the source folder once it is empty, if we are on copy+remove fallback for move */
+          thunar_transfer_job_release_node (job, node, !thunar_transfer_job_file_pool_failed (job));
         }
       else if (node->ask_for_action_response != THUNAR_JOB_RESPONSE_SKIP)
         {
@@ -1009,12 +2239,25 @@ retry_copy:
                                             node->source_file,
                                             node->target_file);
 
-          for (GList *lp = node->child_nodes; lp != NULL; lp = lp->next)
+          /* the scanner may not have reached the folder yet */
+          if (!thunar_transfer_job_collect_children (job, node, &err))
+            {
+              g_propagate_error (error, err);
+              return;
+            }
+
+          for (GList *lp = node->child_nodes; lp != NULL && !thunar_transfer_job_file_pool_failed (job); lp = lp->next)
             {
               /* Update the target file for all children recursively */
+              g_mutex_lock (&job->scan_mutex);
               thunar_transfer_node_reparent_target_recursive (lp->data, node->target_file);
+              g_mutex_unlock (&job->scan_mutex);
 
               /* And copy them as well */
+              thunar_transfer_node_hold (node, lp->data);
+              if (thunar_transfer_job_file_pool_push (job, lp->data))
+                continue;
+
               thunar_transfer_job_copy_node (job, operation, lp->data, &err);
               if (G_UNLIKELY (err != NULL))
                 {
@@ -1023,11 +2266,21 @@ retry_copy:
                 }
             }
 
-          thunar_transfer_job_check_pause (job);
-
-          /* try to remove the source directory if we are on copy+remove fallback for move */
-          if (job->type == THUNAR_TRANSFER_JOB_MOVE)
-            thunar_transfer_job_remove_node (job, node);
+          /* remove the source once the children are moved, if we are on
+           * copy+remove fallback for move, files copied by the file pool
+           * are removed right after they are copied */
+          thunar_transfer_job_release_node (job, node, !thunar_transfer_job_file_pool_failed (job));
+        }
+      else
+        {
+          /* the folders below are not copied, let the scanner move on */
+          g_mutex_lock (&job->scan_mutex);
+          thunar_transfer_job_drop_scanned_ahead (job, node);
+          g_cond_broadcast (&job->scan_cond);
+          g_mutex_unlock (&job->scan_mutex);
+
+          /* the source is kept, and so are the folders of it */
+          thunar_transfer_job_release_node (job, node, FALSE);
         }
     }
   else
@@ -1038,8 +2291,10 @@ retry_copy:
           ThunarJobResponse skip_response;
 
           /* ask the user to skip this node and all subnodes */
+          g_mutex_lock (&job->ask_mutex);
           skip_response = thunar_job_ask_skip (THUNAR_JOB (job), _("Failed to copy file \"%s\": %s"),
                                                g_file_info_get_display_name (node->source_file_info), err->message);
+          g_mutex_unlock (&job->ask_mutex);
 
           /* reset the error */
           g_clear_error (&err);
@@ -1048,14 +2303,20 @@ retry_copy:
           if (G_UNLIKELY (skip_response == THUNAR_JOB_RESPONSE_RETRY))
             {
               /* reset progress for that file to prevent counting it twice */
-              job->total_progress -= job->file_progress;
-              job->file_progress = 0;
+              thunar_transfer_job_atomic_add (&job->total_progress, -(gint64) node->file_progress);
+              node->file_progress = 0;
               goto retry_copy;
             }
 
+          /* the folders below are not copied, let the scanner move on */
+          g_mutex_lock (&job->scan_mutex);
+          thunar_transfer_job_drop_scanned_ahead (job, node);
+          g_cond_broadcast (&job->scan_cond);
+          g_mutex_unlock (&job->scan_mutex);
+
           /* drop the target file, so that it will not be listed as 'new file' */
-          g_object_unref (node->target_file);
-          node->target_file = NULL;
+          thunar_transfer_job_set_target_file (job, node, NULL);
+          thunar_transfer_job_release_node (job, node, FALSE);
         }
     }
 
@@ -1071,15 +2332,16 @@ thunar_transfer_job_check_free_space (ThunarTransferJob *transfer_job,
                                       GError           **error)
 {
   GFileInfo *filesystem_info;
+  guint64    total_size;
   guint64    free_space;
   GFile     *dest;
   gboolean   succeed = TRUE;
-  gchar     *size_string;
 
   _thunar_return_val_if_fail (THUNAR_IS_TRANSFER_JOB (transfer_job), FALSE);
 
   /* total size is nul, should be fine */
-  if (transfer_job->total_size == 0)
+  total_size = thunar_transfer_job_atomic_get (&transfer_job->total_size);
+  if (total_size == 0)
     return TRUE;
 
   /* for all actions in thunar use the same target directory so
@@ -1101,36 +2363,12 @@ thunar_transfer_job_check_free_space (ThunarTransferJob *transfer_job,
   if (g_file_info_has_attribute (filesystem_info, G_FILE_ATTRIBUTE_FILESYSTEM_FREE))
     {
       free_space = g_file_info_get_attribute_uint64 (filesystem_info, G_FILE_ATTRIBUTE_FILESYSTEM_FREE);
-      if (transfer_job->total_size > free_space)
+      if (total_size > free_space)
         {
-          GFileInfo *dest_info;
-          gchar     *dest_name = NULL;
-
-          /* some info about the file */
-          dest_info = g_file_query_info (dest, G_FILE_ATTRIBUTE_STANDARD_DISPLAY_NAME, 0,
-                                         thunar_job_get_cancellable (THUNAR_JOB (transfer_job)),
-                                         NULL);
-          if (dest_info != NULL)
-            {
-              dest_name = g_strdup (g_file_info_get_display_name (dest_info));
-              g_object_unref (G_OBJECT (dest_info));
-            }
-
-          if (dest_name == NULL)
-            {
-              gchar *base_name = g_file_get_basename (dest);
-              dest_name = g_filename_display_name (base_name);
-              g_free (base_name);
-            }
+          succeed = thunar_transfer_job_ask_no_space (transfer_job, dest, total_size - free_space);
 
-          size_string = g_format_size_full (transfer_job->total_size - free_space,
-                                            transfer_job->file_size_binary ? G_FORMAT_SIZE_IEC_UNITS : G_FORMAT_SIZE_DEFAULT);
-          succeed = thunar_job_ask_no_size (THUNAR_JOB (transfer_job),
-                                            _("Error while copying to \"%s\": %s more space is "
-                                               "required to copy to the destination"),
-                                            dest_name, size_string);
-          g_free (size_string);
-          g_free (dest_name);
+          /* the user knows, don't ask again while copying */
+          transfer_job->reserve_space = FALSE;
         }
     }
 
@@ -1240,9 +2478,10 @@ thunar_transfer_job_move_file_with_rename (ThunarJob          *job,
                                            GFileCopyFlags      flags,
                                            GError            **error)
 {
-  gboolean move_rename_successful = FALSE;
-  gint     n_rename = 1;
-  GFile   *renamed_file;
+  ThunarTransferJob *transfer_job = THUNAR_TRANSFER_JOB (job);
+  gboolean           move_rename_successful = FALSE;
+  gint               n_rename = 1;
+  GFile             *renamed_file;
 
   while (TRUE)
     {
@@ -1270,7 +2509,11 @@ thunar_transfer_job_move_file_with_rename (ThunarJob          *job,
 
       /* Log the operation if the move and rename were successful and logging is enabled */
       if (operation != NULL)
-        thunar_job_operation_add (operation, node->source_file, renamed_file);
+        {
+          g_mutex_lock (&transfer_job->mutex);
+          thunar_job_operation_add (operation, node->source_file, renamed_file);
+          g_mutex_unlock (&transfer_job->mutex);
+        }
 
       g_object_unref (renamed_file);
       return move_rename_successful;
@@ -1302,7 +2545,12 @@ thunar_transfer_job_move_file (ThunarJob            *job,
     {
       g_clear_error (error);
       if (node->ask_for_action_response == 0)
-        node->ask_for_action_response = thunar_job_ask_for_action (THUNAR_JOB (job), node->source_file, node->target_file, NULL);
+        {
+          /* copies of merged folders may ask at the same time */
+          g_mutex_lock (&transfer_job->ask_mutex);
+          node->ask_for_action_response = thunar_job_ask_for_action (THUNAR_JOB (job), node->source_file, node->target_file, NULL);
+          g_mutex_unlock (&transfer_job->ask_mutex);
+        }
 
       /* if the user chose to overwrite then try to do so */
       if (node->ask_for_action_response == THUNAR_JOB_RESPONSE_REPLACE)
@@ -1317,8 +2565,10 @@ thunar_transfer_job_move_file (ThunarJob            *job,
 
           if (operation != NULL && move_successful)
             {
+              g_mutex_lock (&transfer_job->mutex);
               thunar_job_operation_overwrite (operation, node->target_file);
               thunar_job_operation_add (operation, node->source_file, node->target_file);
+              g_mutex_unlock (&transfer_job->mutex);
             }
         }
       /* if the user chose to rename then try to do so */
@@ -1334,10 +2584,13 @@ thunar_transfer_job_move_file (ThunarJob            *job,
           thunar_transfer_job_collect_subfiles_recursively (THUNAR_TRANSFER_JOB (job), node, error);
 
           for (GList *lp = node->child_nodes; lp != NULL; lp = lp->next)
-            thunar_transfer_job_move_file (job, operation, lp->data, move_flags, thumbnail_cache, error);
+            {
+              thunar_transfer_node_hold (node, lp->data);
+              thunar_transfer_job_move_file (job, operation, lp->data, move_flags, thumbnail_cache, error);
+            }
 
-          /* Remove the folder itself */
-          thunar_transfer_job_remove_node (THUNAR_TRANSFER_JOB (job), node);
+          /* Remove the folder itself, once the files copied instead are done */
+          thunar_transfer_job_release_node (transfer_job, node, TRUE);
         }
       /* if the user chose to cancel then abort all remaining file moves */
       else if (node->ask_for_action_response == THUNAR_JOB_RESPONSE_CANCEL)
@@ -1355,7 +2608,11 @@ thunar_transfer_job_move_file (ThunarJob            *job,
   else
     {
       if (operation != NULL)
-        thunar_job_operation_add (operation, node->source_file, node->target_file);
+        {
+          g_mutex_lock (&transfer_job->mutex);
+          thunar_job_operation_add (operation, node->source_file, node->target_file);
+          g_mutex_unlock (&transfer_job->mutex);
+        }
     }
 
   if (*error == NULL)
@@ -1367,6 +2624,10 @@ thunar_transfer_job_move_file (ThunarJob            *job,
                                             node->source_file,
                                             node->target_file);
         }
+
+      /* the source is gone or skipped, a merged folder is released above */
+      if (node->ask_for_action_response != THUNAR_JOB_RESPONSE_MERGE)
+        thunar_transfer_job_release_node (transfer_job, node->parent, move_successful);
     }
   /* prepare for the fallback copy and delete if appropriate */
   else if (!thunar_job_is_cancelled (job) && (((*error)->code == G_IO_ERROR_NOT_SUPPORTED) || ((*error)->code == G_IO_ERROR_WOULD_MERGE) || ((*error)->code == G_IO_ERROR_WOULD_RECURSE)))
@@ -1378,10 +2639,13 @@ thunar_transfer_job_move_file (ThunarJob            *job,
                                    "Collecting files for copying..."),
                                g_file_info_get_display_name (node->source_file_info));
 
-      if (!thunar_transfer_job_collect_subfiles_recursively (transfer_job, node, error))
+      /* in pipelined mode, the folders are listed right before they are copied */
+      if (!transfer_job->transfer_pipelined
+          && !thunar_transfer_job_collect_subfiles_recursively (transfer_job, node, error))
         return FALSE;
 
-      /* removal will be done by copy operation after copy was sucessfull */
+      /* removal will be done by copy operation after copy was sucessfull,
+       * file by file and for the folders once they are empty */
       thunar_transfer_job_copy_node (transfer_job, operation, node, error);
     }
   return TRUE;
@@ -1389,24 +2653,29 @@ thunar_transfer_job_move_file (ThunarJob            *job,
 
 
 
+/* whether the running jobs use up the budget of @device, a job is only
+ * counted once even if it transfers files within @device */
 static gboolean
-thunar_transfer_job_device_id_in_job_list (const char *device_fs_id,
-                                           GList      *jobs)
+thunar_transfer_job_device_is_busy (ThunarTransferDevice *device,
+                                    GList                *jobs)
 {
   ThunarTransferJob *job;
+  guint              n_jobs = 0;
+
+  if (device == NULL)
+    return FALSE;
 
-  for (GList *ljobs = jobs; device_fs_id != NULL && ljobs != NULL; ljobs = ljobs->next)
+  for (GList *ljobs = jobs; ljobs != NULL; ljobs = ljobs->next)
     {
       if (THUNAR_IS_TRANSFER_JOB (ljobs->data))
         {
           job = THUNAR_TRANSFER_JOB (ljobs->data);
-          if (g_strcmp0 (device_fs_id, job->source_device_fs_id) == 0)
-            return TRUE;
-          if (g_strcmp0 (device_fs_id, job->target_device_fs_id) == 0)
-            return TRUE;
+          if (job->source_device == device || job->target_device == device)
+            n_jobs++;
         }
     }
-  return FALSE;
+
+  return n_jobs >= thunar_transfer_scheduler_get_budget (device);
 }
 
 
@@ -1415,60 +2684,19 @@ static void
 thunar_transfer_job_fill_source_device_info (ThunarTransferJob *transfer_job,
                                              GFile             *file)
 {
-  /* query device filesystem id (unique string)
-   * The source exists and can be queried directly. */
-  GFileInfo *file_info = g_file_query_info (file,
-                                            G_FILE_ATTRIBUTE_ID_FILESYSTEM,
-                                            G_FILE_QUERY_INFO_NONE,
-                                            thunar_job_get_cancellable (THUNAR_JOB (transfer_job)),
-                                            NULL);
-  if (file_info != NULL)
-    {
-      g_free (transfer_job->source_device_fs_id);
-      transfer_job->source_device_fs_id = g_strdup (g_file_info_get_attribute_string (file_info, G_FILE_ATTRIBUTE_ID_FILESYSTEM));
-      g_object_unref (file_info);
-    }
+  transfer_job->source_device = thunar_transfer_scheduler_lookup_device (file, thunar_job_get_cancellable (THUNAR_JOB (transfer_job)));
   transfer_job->is_source_device_local = thunar_g_file_is_on_local_device (file);
 }
 
 
+
 static void
 thunar_transfer_job_fill_target_device_info (ThunarTransferJob *transfer_job,
                                              GFile             *file)
 {
-  /*
-   * To query the device id it should be done on an existing file/directory.
-   * Usually the target file does not exist yet and so the parent directory
-   * will be queried, and so on until reaching root directory if necessary.
-   * Normally it will end in the worst case to the mounted filesystem root,
-   * because that always exists. */
-  GFile     *target_file = g_object_ref (file); /* start with target file */
-  GFile     *target_parent;
-  GFileInfo *file_info;
-  while (target_file != NULL)
-    {
-      /* query device id */
-      file_info = g_file_query_info (target_file,
-                                     G_FILE_ATTRIBUTE_ID_FILESYSTEM,
-                                     G_FILE_QUERY_INFO_NONE,
-                                     thunar_job_get_cancellable (THUNAR_JOB (transfer_job)),
-                                     NULL);
-      if (file_info != NULL)
-        {
-          g_free (transfer_job->target_device_fs_id);
-          transfer_job->target_device_fs_id = g_strdup (g_file_info_get_attribute_string (file_info, G_FILE_ATTRIBUTE_ID_FILESYSTEM));
-          g_object_unref (file_info);
-          break;
-        }
-      else /* target file or parent directory does not exist (yet) */
-        {
-          /* query the parent directory */
-          target_parent = g_file_get_parent (target_file);
-          g_object_unref (target_file);
-          target_file = target_parent;
-        }
-    }
-  g_object_unref (target_file);
+  /* usually the target file does not exist yet, the lookup falls back
+   * to the closest existing parent directory */
+  transfer_job->target_device = thunar_transfer_scheduler_lookup_device (file, thunar_job_get_cancellable (THUNAR_JOB (transfer_job)));
   transfer_job->is_target_device_local = thunar_g_file_is_on_local_device (file);
 }
 
@@ -1514,7 +2742,7 @@ thunar_transfer_job_determine_copy_behavior (ThunarTransferJob *transfer_job,
        * OR
        * - tgt device is not local and tgt device appears in another job
        */
-      if (g_strcmp0 (transfer_job->source_device_fs_id, transfer_job->target_device_fs_id) != 0)
+      if (transfer_job->source_device != transfer_job->target_device)
         {
           *always_parallel_copy_p = FALSE;
           /* freeze when either src or tgt device appears on another job */
@@ -1553,8 +2781,16 @@ thunar_transfer_job_determine_copy_behavior (ThunarTransferJob *transfer_job,
 
 /**
  * thunar_transfer_job_can_start:
+ * @transfer_job     : a #ThunarTransferJob.
+ * @running_job_list : the jobs which are currently running.
  *
+ * Decides whether @transfer_job may run next to the @running_job_list,
+ * depending on the parallel copy mode. A device is busy once the running
+ * jobs using it exhaust its budget. Regardless of this, the transfer
+ * scheduler admits the files of all running jobs one by one, so a device
+ * is never used by more transfers than its budget allows.
  *
+ * Return value: %TRUE if @transfer_job can start, %FALSE if it has to wait.
  **/
 gboolean
 thunar_transfer_job_can_start (ThunarTransferJob *transfer_job,
@@ -1583,9 +2819,9 @@ thunar_transfer_job_can_start (ThunarTransferJob *transfer_job,
 
   if (should_freeze_on_any_other_job && running_job_list != NULL)
     return FALSE;
-  if (freeze_if_src_busy && thunar_transfer_job_device_id_in_job_list (transfer_job->source_device_fs_id, running_job_list))
+  if (freeze_if_src_busy && thunar_transfer_job_device_is_busy (transfer_job->source_device, running_job_list))
     return FALSE;
-  if (freeze_if_tgt_busy && thunar_transfer_job_device_id_in_job_list (transfer_job->target_device_fs_id, running_job_list))
+  if (freeze_if_tgt_busy && thunar_transfer_job_device_is_busy (transfer_job->target_device, running_job_list))
     return FALSE;
 
   return TRUE;
@@ -1608,6 +2844,58 @@ thunar_transfer_node_append_target_files_recursive (ThunarTransferNode *node,
 
 
 
+static gboolean
+thunar_transfer_node_has_same_parents (ThunarTransferNode *node,
+                                       ThunarTransferNode *other)
+{
+  GFile   *parent;
+  GFile   *other_parent;
+  gboolean same_parents = FALSE;
+
+  parent = g_file_get_parent (node->source_file);
+  other_parent = g_file_get_parent (other->source_file);
+  if (parent != NULL && other_parent != NULL)
+    same_parents = g_file_equal (parent, other_parent);
+  g_clear_object (&parent);
+  g_clear_object (&other_parent);
+
+  if (same_parents)
+    {
+      parent = g_file_get_parent (node->target_file);
+      other_parent = g_file_get_parent (other->target_file);
+      same_parents = parent != NULL && other_parent != NULL && g_file_equal (parent, other_parent);
+      g_clear_object (&parent);
+      g_clear_object (&other_parent);
+    }
+
+  return same_parents;
+}
+
+
+
+static gboolean
+thunar_transfer_job_use_file_pool (ThunarTransferJob *transfer_job)
+{
+  ThunarTransferNode *node;
+
+  /* moves only copy if they fall back to copy and delete */
+  if ((transfer_job->type != THUNAR_TRANSFER_JOB_COPY && transfer_job->type != THUNAR_TRANSFER_JOB_MOVE)
+      || transfer_job->max_parallel_files < 2)
+    return FALSE;
+
+  /* latency of remote files is better hidden by parallel jobs */
+  for (GList *lp = transfer_job->transfer_node_list; lp != NULL; lp = lp->next)
+    {
+      node = lp->data;
+      if (!g_file_is_native (node->source_file) || !g_file_is_native (node->target_file))
+        return FALSE;
+    }
+
+  return TRUE;
+}
+
+
+
 static gboolean
 thunar_transfer_job_execute (ThunarJob *job,
                              GError   **error)
@@ -1619,6 +2907,8 @@ thunar_transfer_job_execute (ThunarJob *job,
   ThunarJobOperation   *operation = NULL;
   GError               *err = NULL;
   GList                *lp, *lp_next;
+  GList                *source_file_list = NULL;
+  GList                *target_file_list = NULL;
   g_autolist (GFile) new_files_list = NULL;
 
   _thunar_return_val_if_fail (THUNAR_IS_TRANSFER_JOB (job), FALSE);
@@ -1627,6 +2917,11 @@ thunar_transfer_job_execute (ThunarJob *job,
   if (thunar_job_set_error_if_cancelled (job, error))
     return FALSE;
 
+  /* copies start while the folders are scanned, so the space required is
+   * only known bit by bit */
+  transfer_job->reserve_space = (transfer_job->type != THUNAR_TRANSFER_JOB_LINK && transfer_job->type != THUNAR_TRANSFER_JOB_TRASH
+                                 && transfer_job->transfer_pipelined);
+
   /* Check if the target filesystem has enough free space */
   if (!thunar_transfer_job_check_free_space (transfer_job, &err))
     {
@@ -1637,9 +2932,6 @@ thunar_transfer_job_execute (ThunarJob *job,
         }
     }
 
-  /* transfer starts now */
-  transfer_job->start_time = g_get_real_time ();
-
   thunar_job_info_message (job, _("Collecting files..."));
 
   /* take a reference on the thumbnail cache */
@@ -1658,6 +2950,56 @@ thunar_transfer_job_execute (ThunarJob *job,
         operation = NULL;
     }
 
+  if (thunar_transfer_job_use_file_pool (transfer_job))
+    {
+      /* shared threads, since the pool only lives as long as the job */
+      transfer_job->file_pool = g_thread_pool_new (thunar_transfer_job_file_pool_copy, transfer_job,
+                                                   transfer_job->max_parallel_files, FALSE, NULL);
+      transfer_job->file_pool_operation = operation;
+    }
+
+  for (lp = transfer_job->transfer_node_list; lp != NULL; lp = lp->next)
+    {
+      node = lp->data;
+
+      /* all files below the node are expected to share its devices, like
+       * the files selected in the same folder */
+      if (lp->prev != NULL && thunar_transfer_node_has_same_parents (node, lp->prev->data))
+        {
+          node->source_device = ((ThunarTransferNode *) lp->prev->data)->source_device;
+          node->target_device = ((ThunarTransferNode *) lp->prev->data)->target_device;
+        }
+      else
+        {
+          node->source_device = thunar_transfer_scheduler_lookup_device (node->source_file, thunar_job_get_cancellable (job));
+          node->target_device = thunar_transfer_scheduler_lookup_device (node->target_file, thunar_job_get_cancellable (job));
+        }
+    }
+
+  /* keep track of the copy, so it can be resumed if Thunar dies, unless
+   * the job resumes an interrupted copy already */
+  if (transfer_job->type == THUNAR_TRANSFER_JOB_COPY && transfer_job->transfer_journal && transfer_job->journal == NULL)
+    {
+      for (lp = transfer_job->transfer_node_list; lp != NULL; lp = lp->next)
+        {
+          node = lp->data;
+          source_file_list = g_list_prepend (source_file_list, node->source_file);
+          target_file_list = g_list_prepend (target_file_list, node->target_file);
+        }
+      source_file_list = g_list_reverse (source_file_list);
+      target_file_list = g_list_reverse (target_file_list);
+
+      /* copy without journal if it cannot be written */
+      transfer_job->journal = thunar_transfer_journal_new (source_file_list, target_file_list, NULL);
+
+      g_list_free (source_file_list);
+      g_list_free (target_file_list);
+    }
+
+  /* list the folders ahead of the copy instead of collecting them upfront */
+  if (transfer_job->type == THUNAR_TRANSFER_JOB_COPY && transfer_job->transfer_pipelined)
+    transfer_job->scan_thread = g_thread_new ("ThunarTransferScan", thunar_transfer_job_scan_thread, transfer_job);
+
   for (lp = transfer_job->transfer_node_list;
        lp != NULL && err == NULL;
        lp = lp_next)
@@ -1690,15 +3032,57 @@ thunar_transfer_job_execute (ThunarJob *job,
         }
       else if (transfer_job->type == THUNAR_TRANSFER_JOB_COPY)
         {
-          /* For copy, always collect all subnodes recursively */
-          if (!thunar_transfer_job_collect_subfiles_recursively (THUNAR_TRANSFER_JOB (job), node, &err))
+          /* For copy, always collect all subnodes recursively, unless
+           * they are collected while copying */
+          if (transfer_job->scan_thread == NULL
+              && !thunar_transfer_job_collect_subfiles_recursively (THUNAR_TRANSFER_JOB (job), node, &err))
             break;
 
           thunar_transfer_job_copy_node (transfer_job, operation, node, &err);
         }
 
-      /* append new files for that node */
-      new_files_list = thunar_transfer_node_append_target_files_recursive (node, new_files_list);
+      /* stop once one of the parallel copies failed */
+      if (transfer_job->file_pool != NULL && thunar_transfer_job_file_pool_failed (transfer_job))
+        break;
+    }
+
+  if (transfer_job->file_pool != NULL)
+    {
+      /* queued copies are skipped if the job failed already */
+      if (err != NULL)
+        thunar_transfer_job_take_file_pool_error (transfer_job, err);
+
+      /* wait for the remaining copies */
+      g_thread_pool_free (transfer_job->file_pool, FALSE, TRUE);
+      transfer_job->file_pool = NULL;
+      transfer_job->file_pool_operation = NULL;
+
+      err = transfer_job->file_pool_error;
+      transfer_job->file_pool_error = NULL;
+    }
+
+  if (transfer_job->scan_thread != NULL)
+    {
+      /* the scanner is still busy if the copy failed */
+      g_mutex_lock (&transfer_job->scan_mutex);
+      transfer_job->scan_stop = TRUE;
+      g_cond_broadcast (&transfer_job->scan_cond);
+      g_mutex_unlock (&transfer_job->scan_mutex);
+
+      g_thread_join (transfer_job->scan_thread);
+      transfer_job->scan_thread = NULL;
+    }
+
+  if (transfer_job->journal != NULL)
+    {
+      /* a cancelled copy is offered to be resumed the next time Thunar
+       * starts, until the user discards it, the copy finished or failed
+       * otherwise and there is nothing to resume */
+      if (thunar_job_is_cancelled (job))
+        thunar_transfer_journal_close (transfer_job->journal);
+      else
+        thunar_transfer_journal_remove (transfer_job->journal);
+      transfer_job->journal = NULL;
     }
 
   /* release the thumbnail cache */
@@ -1714,6 +3098,10 @@ thunar_transfer_job_execute (ThunarJob *job,
     }
   else
     {
+      /* collect the new files of all nodes */
+      for (lp = transfer_job->transfer_node_list; lp != NULL; lp = lp->next)
+        new_files_list = thunar_transfer_node_append_target_files_recursive (lp->data, new_files_list);
+
       /* emit the "new-files" signal */
       thunar_job_new_files (THUNAR_JOB (job), new_files_list);
 
@@ -1799,33 +3187,127 @@ thunar_transfer_job_new (GList                *source_node_list,
 
 
 
+/**
+ * thunar_transfer_job_set_journal:
+ * @job     : a #ThunarTransferJob.
+ * @journal : (transfer full): the #ThunarTransferJournal of an interrupted copy.
+ *
+ * Lets the copy @job resume the interrupted copy of @journal, the @job
+ * must have been created from the plan of the @journal. The files the
+ * interrupted copy completed are skipped.
+ **/
+void
+thunar_transfer_job_set_journal (ThunarTransferJob     *job,
+                                 ThunarTransferJournal *journal)
+{
+  _thunar_return_if_fail (THUNAR_IS_TRANSFER_JOB (job));
+  _thunar_return_if_fail (job->type == THUNAR_TRANSFER_JOB_COPY);
+  _thunar_return_if_fail (job->journal == NULL);
+
+  job->journal = journal;
+}
+
+
+
+/**
+ * thunar_transfer_job_sample:
+ * @job : a #ThunarTransferJob.
+ *
+ * Samples the progress of @job for the transfer rate shown by
+ * thunar_transfer_job_get_status(). The copying threads only count
+ * the progress, this is supposed to be called from the main loop every
+ * %THUNAR_TRANSFER_JOB_SAMPLE_INTERVAL milliseconds while @job runs.
+ *
+ * Return value: the percentage of @job which is done, or -1 if neither
+ *               the progress nor the transfer rate changed since the
+ *               last sample.
+ **/
+gdouble
+thunar_transfer_job_sample (ThunarTransferJob *job)
+{
+  ThunarTransferRateSample *sample;
+  ThunarTransferRateSample *oldest;
+  guint64                   total_size;
+  guint64                   total_progress;
+  gboolean                  changed;
+  gboolean                  was_stalled;
+
+  _thunar_return_val_if_fail (THUNAR_IS_TRANSFER_JOB (job), -1);
+
+  total_size = thunar_transfer_job_atomic_get (&job->total_size);
+  total_progress = thunar_transfer_job_atomic_get (&job->total_progress);
+
+  /* the window starts with the transfer, not while the job is queued or scanning */
+  if (total_size == 0 || total_progress == 0)
+    return -1;
+
+  /* the samples are kept while nothing changed, so the rate drops while stalled */
+  changed = job->n_rate_samples == 0 || job->rate_samples[job->rate_sample_index].progress != total_progress;
+
+  job->rate_sample_index = (job->rate_sample_index + 1) % RATE_WINDOW_SAMPLES;
+  job->n_rate_samples = MIN (job->n_rate_samples + 1, RATE_WINDOW_SAMPLES);
+  sample = &job->rate_samples[job->rate_sample_index];
+  sample->time = g_get_monotonic_time ();
+  sample->progress = total_progress;
+
+  /* while stalled the rate drops with every sample, so the remaining time
+   * is recomputed until the window holds no progress and it is unknown */
+  oldest = &job->rate_samples[(job->rate_sample_index + RATE_WINDOW_SAMPLES + 1 - job->n_rate_samples) % RATE_WINDOW_SAMPLES];
+  was_stalled = job->rate_stalled;
+  job->rate_stalled = (job->n_rate_samples > 1 && oldest->progress == total_progress);
+
+  if (!changed && was_stalled && job->rate_stalled)
+    return -1;
+
+  return MIN (total_progress * 100.0 / total_size, 100.0);
+}
+
+
+
 gchar *
 thunar_transfer_job_get_status (ThunarTransferJob *job)
 {
-  gchar   *total_size_str;
-  gchar   *total_progress_str;
-  gchar   *transfer_rate_str;
-  GString *status;
-  gulong   remaining_time;
+  ThunarTransferRateSample *newest;
+  ThunarTransferRateSample *oldest;
+  gchar                    *total_size_str;
+  gchar                    *total_progress_str;
+  gchar                    *transfer_rate_str;
+  GString                  *status;
+  gulong                    remaining_time;
+  guint64                   total_size;
+  guint64                   total_progress;
+  guint64                   transfer_rate = 0;
 
   _thunar_return_val_if_fail (THUNAR_IS_TRANSFER_JOB (job), NULL);
 
+  /* the progress is counted by the copying threads */
+  total_size = thunar_transfer_job_atomic_get (&job->total_size);
+  total_progress = thunar_transfer_job_atomic_get (&job->total_progress);
+
+  /* the average transfer rate over the window of samples, after 2 seconds */
+  if (job->n_rate_samples > 1)
+    {
+      newest = &job->rate_samples[job->rate_sample_index];
+      oldest = &job->rate_samples[(job->rate_sample_index + RATE_WINDOW_SAMPLES + 1 - job->n_rate_samples) % RATE_WINDOW_SAMPLES];
+      if (newest->time - oldest->time >= MINIMUM_TRANSFER_TIME && newest->progress > oldest->progress)
+        transfer_rate = (newest->progress - oldest->progress) * G_USEC_PER_SEC / (newest->time - oldest->time);
+    }
+
   status = g_string_sized_new (100);
 
   /* transfer status like "22.6MB of 134.1MB" */
-  total_size_str = g_format_size_full (job->total_size, job->file_size_binary ? G_FORMAT_SIZE_IEC_UNITS : G_FORMAT_SIZE_DEFAULT);
-  total_progress_str = g_format_size_full (job->total_progress, job->file_size_binary ? G_FORMAT_SIZE_IEC_UNITS : G_FORMAT_SIZE_DEFAULT);
+  total_size_str = g_format_size_full (total_size, job->file_size_binary ? G_FORMAT_SIZE_IEC_UNITS : G_FORMAT_SIZE_DEFAULT);
+  total_progress_str = g_format_size_full (total_progress, job->file_size_binary ? G_FORMAT_SIZE_IEC_UNITS : G_FORMAT_SIZE_DEFAULT);
   g_string_append_printf (status, _("%s of %s"), total_progress_str, total_size_str);
   g_free (total_size_str);
   g_free (total_progress_str);
 
-  /* show time and transfer rate after 10 seconds */
-  if (job->transfer_rate > 0
-      && (job->last_update_time - job->start_time) > MINIMUM_TRANSFER_TIME)
+  /* show time and transfer rate */
+  if (transfer_rate > 0)
     {
       /* remaining time based on the transfer speed */
-      transfer_rate_str = g_format_size_full (job->transfer_rate, job->file_size_binary ? G_FORMAT_SIZE_IEC_UNITS : G_FORMAT_SIZE_DEFAULT);
-      remaining_time = (job->total_size - job->total_progress) / job->transfer_rate;
+      transfer_rate_str = g_format_size_full (transfer_rate, job->file_size_binary ? G_FORMAT_SIZE_IEC_UNITS : G_FORMAT_SIZE_DEFAULT);
+      remaining_time = (total_size - MIN (total_size, total_progress)) / transfer_rate;
 
       if (remaining_time > 0)
         {
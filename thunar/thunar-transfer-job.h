@@ -21,6 +21,8 @@
 #ifndef __THUNAR_TRANSFER_JOB_H__
 #define __THUNAR_TRANSFER_JOB_H__
 
+#include "thunar/thunar-transfer-journal.h"
+
 #include <glib-object.h>
 
 G_BEGIN_DECLS
@@ -38,6 +40,9 @@ typedef enum /*< enum >*/
   THUNAR_TRANSFER_JOB_TRASH,
 } ThunarTransferJobType;
 
+/* how often the progress of a running transfer job is sampled, in milliseconds */
+#define THUNAR_TRANSFER_JOB_SAMPLE_INTERVAL 500
+
 typedef struct _ThunarTransferJobPrivate ThunarTransferJobPrivate;
 typedef struct _ThunarTransferJobClass   ThunarTransferJobClass;
 typedef struct _ThunarTransferJob        ThunarTransferJob;
@@ -57,6 +62,13 @@ thunar_transfer_job_new (GList                *source_file_list,
                          GList                *target_file_list,
                          ThunarTransferJobType type) G_GNUC_MALLOC G_GNUC_WARN_UNUSED_RESULT;
 
+void
+thunar_transfer_job_set_journal (ThunarTransferJob     *job,
+                                 ThunarTransferJournal *journal);
+
+gdouble
+thunar_transfer_job_sample (ThunarTransferJob *job);
+
 gchar *
 thunar_transfer_job_get_status (ThunarTransferJob *job);
 
@@ -0,0 +1,900 @@
+/* vi:set et ai sw=2 sts=2 ts=2: */
+/*-
+ * Copyright (c) 2026 The Xfce Development Team
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+ * Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef HAVE_ERRNO_H
+#include <errno.h>
+#endif
+#ifdef HAVE_FCNTL_H
+#include <fcntl.h>
+#endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+#ifdef HAVE_SYS_FILE_H
+#include <sys/file.h>
+#endif
+#ifdef HAVE_SYS_STAT_H
+#include <sys/stat.h>
+#endif
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+#include "thunar/thunar-gio-extensions.h"
+#include "thunar/thunar-private.h"
+#include "thunar/thunar-transfer-journal.h"
+
+#include <glib/gstdio.h>
+#include <libxfce4util/libxfce4util.h>
+
+
+
+/* the journals live in $XDG_CACHE_HOME/Thunar/transfers/ */
+#define THUNAR_TRANSFER_JOURNAL_DIRECTORY "Thunar/transfers/"
+#define THUNAR_TRANSFER_JOURNAL_HEADER    "thunar-transfer-journal 1"
+
+/* entries are written in batches, once enough of them piled up or
+ * the last batch is older than the interval */
+#define THUNAR_TRANSFER_JOURNAL_FLUSH_SIZE     (64 * 1024)
+#define THUNAR_TRANSFER_JOURNAL_FLUSH_INTERVAL (1 * G_USEC_PER_SEC)
+
+
+
+typedef struct _ThunarTransferJournalEntry ThunarTransferJournalEntry;
+
+
+
+static gboolean
+thunar_transfer_journal_lock (gint     fd,
+                              GError **error);
+static void
+thunar_transfer_journal_flush (ThunarTransferJournal *journal,
+                               gboolean               sync);
+static void
+thunar_transfer_journal_append (ThunarTransferJournal *journal,
+                                gboolean               sync,
+                                const gchar           *format,
+                                ...) G_GNUC_PRINTF (3, 4);
+static ThunarTransferJournalEntry *
+thunar_transfer_journal_lookup (ThunarTransferJournal *journal,
+                                GFile                 *target_file);
+static void
+thunar_transfer_journal_entry_free (gpointer data);
+static gchar *
+thunar_transfer_journal_get_identity (GFile *source_file);
+
+
+
+/* what an interrupted transfer did with a target file */
+struct _ThunarTransferJournalEntry
+{
+  gboolean completed;
+
+  /* the size of the completed file */
+  guint64 size;
+
+  /* the bytes of the partial file known to be on the disk */
+  guint64 checkpoint;
+
+  /* the source the partial file was copied from, see
+   * thunar_transfer_journal_get_identity() */
+  gchar *identity;
+};
+
+/* The journal is a text file with one entry per line:
+ *
+ *   node <source-uri> <target-uri>          the top level files of the transfer
+ *   begin                                   the end of the list of top level files
+ *   start <target-uri> <source-id>          a file is being copied
+ *   done <target-uri> <size>                a file (or folder) was copied completely
+ *   part <target-uri> <offset> <source-id>  the *.partial~ of a file is on the disk up to offset
+ *
+ * URIs are escaped, so they never contain spaces. The source-id identifies
+ * the contents of the source file, it is "-" for files not on the disk. */
+struct _ThunarTransferJournal
+{
+  gchar *path;
+  gint   fd;
+
+  /* the top level files of the transfer */
+  GList *source_file_list;
+  GList *target_file_list;
+
+  /* what the interrupted transfer did, by target uri */
+  GHashTable *entries;
+  guint       n_completed;
+
+  /* entries not written yet, protected by the mutex since
+   * the parallel copies of a job add entries as well */
+  GString *buffer;
+  gint64   last_flush_time;
+  GMutex   mutex;
+};
+
+
+
+/* makes sure only one transfer uses the journal at a time, the lock is
+ * released by the kernel if Thunar dies */
+static gboolean
+thunar_transfer_journal_lock (gint     fd,
+                              GError **error)
+{
+#ifdef HAVE_SYS_FILE_H
+  if (flock (fd, LOCK_EX | LOCK_NB) != 0)
+    {
+      g_set_error (error, G_IO_ERROR, errno == EWOULDBLOCK ? G_IO_ERROR_BUSY : g_io_error_from_errno (errno),
+                   "The transfer journal is in use: %s", g_strerror (errno));
+      return FALSE;
+    }
+#endif
+
+  return TRUE;
+}
+
+
+
+/* must be called with the mutex held */
+static void
+thunar_transfer_journal_flush (ThunarTransferJournal *journal,
+                               gboolean               sync)
+{
+  const gchar *data = journal->buffer->str;
+  gsize        length = journal->buffer->len;
+  gssize       n;
+
+  /* the journal is only an aid, so writing is silently given up on errors */
+  while (length > 0)
+    {
+      n = write (journal->fd, data, length);
+      if (n < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          break;
+        }
+
+      data += n;
+      length -= n;
+    }
+
+  if (sync)
+    g_fsync (journal->fd);
+
+  g_string_truncate (journal->buffer, 0);
+  journal->last_flush_time = g_get_monotonic_time ();
+}
+
+
+
+static void
+thunar_transfer_journal_append (ThunarTransferJournal *journal,
+                                gboolean               sync,
+                                const gchar           *format,
+                                ...)
+{
+  va_list args;
+
+  g_mutex_lock (&journal->mutex);
+
+  va_start (args, format);
+  g_string_append_vprintf (journal->buffer, format, args);
+  va_end (args);
+
+  if (sync
+      || journal->buffer->len >= THUNAR_TRANSFER_JOURNAL_FLUSH_SIZE
+      || g_get_monotonic_time () - journal->last_flush_time >= THUNAR_TRANSFER_JOURNAL_FLUSH_INTERVAL)
+    thunar_transfer_journal_flush (journal, TRUE);
+
+  g_mutex_unlock (&journal->mutex);
+}
+
+
+
+static ThunarTransferJournalEntry *
+thunar_transfer_journal_lookup (ThunarTransferJournal *journal,
+                                GFile                 *target_file)
+{
+  ThunarTransferJournalEntry *entry;
+  gchar                      *uri;
+
+  /* nothing to look up for new transfers */
+  if (journal->entries == NULL)
+    return NULL;
+
+  uri = g_file_get_uri (target_file);
+  entry = g_hash_table_lookup (journal->entries, uri);
+  g_free (uri);
+
+  return entry;
+}
+
+
+
+static void
+thunar_transfer_journal_entry_free (gpointer data)
+{
+  ThunarTransferJournalEntry *entry = data;
+
+  g_free (entry->identity);
+  g_free (entry);
+}
+
+
+
+/* identifies the contents of a local @source_file by the device, inode,
+ * size and modification time, so a *.partial~ copy is only continued if
+ * the source did not change since, or %NULL if not a local file */
+static gchar *
+thunar_transfer_journal_get_identity (GFile *source_file)
+{
+  const gchar *path;
+  struct stat  statb;
+
+  path = g_file_peek_path (source_file);
+  if (path == NULL || stat (path, &statb) != 0)
+    return NULL;
+
+  return g_strdup_printf ("%" G_GUINT64_FORMAT ":%" G_GUINT64_FORMAT ":%" G_GUINT64_FORMAT ":%" G_GINT64_FORMAT ".%09ld",
+                          (guint64) statb.st_dev, (guint64) statb.st_ino, (guint64) statb.st_size,
+                          (gint64) statb.st_mtim.tv_sec, (glong) statb.st_mtim.tv_nsec);
+}
+
+
+
+/**
+ * thunar_transfer_journal_new:
+ * @source_file_list : the top level #GFile<!---->s to transfer.
+ * @target_file_list : the matching target #GFile<!---->s.
+ * @error            : return location for errors or %NULL.
+ *
+ * Starts a new journal for a transfer of @source_file_list to
+ * @target_file_list, so the transfer can be resumed with
+ * thunar_transfer_journal_load() if Thunar dies before it completed.
+ *
+ * Return value: (transfer full) (nullable): the new #ThunarTransferJournal,
+ *               or %NULL on error.
+ **/
+ThunarTransferJournal *
+thunar_transfer_journal_new (GList   *source_file_list,
+                             GList   *target_file_list,
+                             GError **error)
+{
+  ThunarTransferJournal *journal;
+  gchar                 *directory;
+  gchar                 *path;
+  gchar                 *source_uri;
+  gchar                 *target_uri;
+  GList                 *sp, *tp;
+  gint                   fd;
+
+  _thunar_return_val_if_fail (g_list_length (source_file_list) == g_list_length (target_file_list), NULL);
+  _thunar_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  directory = xfce_resource_save_location (XFCE_RESOURCE_CACHE, THUNAR_TRANSFER_JOURNAL_DIRECTORY, TRUE);
+  if (G_UNLIKELY (directory == NULL))
+    {
+      g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_FAILED,
+                           "Failed to create the folder for transfer journals");
+      return NULL;
+    }
+
+  path = g_build_filename (directory, "transfer-XXXXXX.journal", NULL);
+  g_free (directory);
+
+  fd = g_mkstemp_full (path, O_WRONLY | O_APPEND | O_CLOEXEC, 0600);
+  if (G_UNLIKELY (fd < 0))
+    {
+      g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errno),
+                   "Failed to create the transfer journal: %s", g_strerror (errno));
+      g_free (path);
+      return NULL;
+    }
+
+  if (!thunar_transfer_journal_lock (fd, error))
+    {
+      close (fd);
+      g_unlink (path);
+      g_free (path);
+      return NULL;
+    }
+
+  journal = g_slice_new0 (ThunarTransferJournal);
+  journal->path = path;
+  journal->fd = fd;
+  journal->source_file_list = thunar_g_list_copy_deep (source_file_list);
+  journal->target_file_list = thunar_g_list_copy_deep (target_file_list);
+  journal->buffer = g_string_new (THUNAR_TRANSFER_JOURNAL_HEADER "\n");
+  g_mutex_init (&journal->mutex);
+
+  /* the plan of the transfer, not synced since short transfers should not
+   * wait for the disk, the following batches are synced */
+  for (sp = source_file_list, tp = target_file_list; sp != NULL; sp = sp->next, tp = tp->next)
+    {
+      source_uri = g_file_get_uri (sp->data);
+      target_uri = g_file_get_uri (tp->data);
+      g_string_append_printf (journal->buffer, "node %s %s\n", source_uri, target_uri);
+      g_free (target_uri);
+      g_free (source_uri);
+    }
+  g_string_append (journal->buffer, "begin\n");
+
+  g_mutex_lock (&journal->mutex);
+  thunar_transfer_journal_flush (journal, FALSE);
+  g_mutex_unlock (&journal->mutex);
+
+  return journal;
+}
+
+
+
+/**
+ * thunar_transfer_journal_load:
+ * @path  : the path of a journal, as returned by thunar_transfer_journal_list_interrupted().
+ * @error : return location for errors or %NULL.
+ *
+ * Loads the journal of an interrupted transfer. Resuming the transfer
+ * adds to the same journal.
+ *
+ * Return value: (transfer full) (nullable): the #ThunarTransferJournal,
+ *               or %NULL on error.
+ **/
+ThunarTransferJournal *
+thunar_transfer_journal_load (const gchar *path,
+                              GError     **error)
+{
+  ThunarTransferJournalEntry *entry;
+  ThunarTransferJournal      *journal;
+  gboolean                    has_begin = FALSE;
+  gchar                     **lines;
+  gchar                     **fields;
+  gchar                      *contents;
+  gsize                       length;
+  guint64                     number;
+  guint                       n;
+  gint                        fd;
+
+  _thunar_return_val_if_fail (path != NULL, NULL);
+  _thunar_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  fd = g_open (path, O_WRONLY | O_APPEND | O_CLOEXEC, 0);
+  if (G_UNLIKELY (fd < 0))
+    {
+      g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errno),
+                   "Failed to open the transfer journal: %s", g_strerror (errno));
+      return NULL;
+    }
+
+  if (!thunar_transfer_journal_lock (fd, error))
+    {
+      close (fd);
+      return NULL;
+    }
+
+  if (!g_file_get_contents (path, &contents, &length, error))
+    {
+      close (fd);
+      return NULL;
+    }
+
+  journal = g_slice_new0 (ThunarTransferJournal);
+  journal->path = g_strdup (path);
+  journal->fd = fd;
+  journal->entries = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, thunar_transfer_journal_entry_free);
+  journal->buffer = g_string_new (NULL);
+  g_mutex_init (&journal->mutex);
+
+  /* the last line is cut off if Thunar died while writing it */
+  if (length > 0 && contents[length - 1] != '\n')
+    g_string_append_c (journal->buffer, '\n');
+
+  lines = g_strsplit (contents, "\n", -1);
+  g_free (contents);
+
+  if (g_strcmp0 (lines[0], THUNAR_TRANSFER_JOURNAL_HEADER) != 0)
+    {
+      g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Not a transfer journal");
+      goto failed;
+    }
+
+  for (n = 1; lines[n] != NULL; n++)
+    {
+      fields = g_strsplit (lines[n], " ", 4);
+
+      if (!has_begin)
+        {
+          if (g_strcmp0 (fields[0], "begin") == 0)
+            has_begin = TRUE;
+          else if (g_strcmp0 (fields[0], "node") == 0 && g_strv_length (fields) == 3)
+            {
+              journal->source_file_list = g_list_prepend (journal->source_file_list, g_file_new_for_uri (fields[1]));
+              journal->target_file_list = g_list_prepend (journal->target_file_list, g_file_new_for_uri (fields[2]));
+            }
+        }
+      else if (fields[0] != NULL && fields[1] != NULL && *fields[1] != '\0')
+        {
+          /* an entry may be cut off, so numbers are only taken if valid */
+          entry = g_hash_table_lookup (journal->entries, fields[1]);
+          if (entry == NULL)
+            {
+              entry = g_new0 (ThunarTransferJournalEntry, 1);
+              g_hash_table_insert (journal->entries, g_strdup (fields[1]), entry);
+            }
+
+          if (g_strcmp0 (fields[0], "done") == 0 && fields[2] != NULL
+              && g_ascii_string_to_unsigned (fields[2], 10, 0, G_MAXUINT64, &number, NULL))
+            {
+              if (!entry->completed)
+                journal->n_completed++;
+              entry->completed = TRUE;
+              entry->size = number;
+            }
+          else if (g_strcmp0 (fields[0], "start") == 0 && fields[2] != NULL)
+            {
+              /* the data of another source cannot be continued */
+              if (g_strcmp0 (entry->identity, fields[2]) != 0)
+                entry->checkpoint = 0;
+              g_free (entry->identity);
+              entry->identity = g_strdup (fields[2]);
+            }
+          else if (g_strcmp0 (fields[0], "part") == 0 && fields[2] != NULL && fields[3] != NULL
+                   && g_ascii_string_to_unsigned (fields[2], 10, 0, G_MAXUINT64, &number, NULL))
+            {
+              entry->checkpoint = number;
+              g_free (entry->identity);
+              entry->identity = g_strdup (fields[3]);
+            }
+        }
+
+      g_strfreev (fields);
+    }
+
+  if (!has_begin || journal->source_file_list == NULL)
+    {
+      /* Thunar died before the transfer started */
+      g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "The transfer journal is incomplete");
+      g_strfreev (lines);
+      thunar_transfer_journal_remove (journal);
+      return NULL;
+    }
+
+  g_strfreev (lines);
+
+  journal->source_file_list = g_list_reverse (journal->source_file_list);
+  journal->target_file_list = g_list_reverse (journal->target_file_list);
+
+  return journal;
+
+failed:
+  g_strfreev (lines);
+
+  /* keep the file untouched, it might be from a newer version of Thunar */
+  g_string_truncate (journal->buffer, 0);
+  thunar_transfer_journal_close (journal);
+
+  return NULL;
+}
+
+
+
+/**
+ * thunar_transfer_journal_close:
+ * @journal : a #ThunarTransferJournal.
+ *
+ * Releases the journal, but keeps it on the disk, so the transfer is
+ * found by thunar_transfer_journal_list_interrupted() again.
+ **/
+void
+thunar_transfer_journal_close (ThunarTransferJournal *journal)
+{
+  _thunar_return_if_fail (journal != NULL);
+
+  if (journal->buffer->len > 0)
+    {
+      g_mutex_lock (&journal->mutex);
+      thunar_transfer_journal_flush (journal, TRUE);
+      g_mutex_unlock (&journal->mutex);
+    }
+
+  /* closing the file releases the lock */
+  close (journal->fd);
+
+  thunar_g_list_free_full (journal->source_file_list);
+  thunar_g_list_free_full (journal->target_file_list);
+
+  if (journal->entries != NULL)
+    g_hash_table_destroy (journal->entries);
+
+  g_string_free (journal->buffer, TRUE);
+  g_mutex_clear (&journal->mutex);
+  g_free (journal->path);
+
+  g_slice_free (ThunarTransferJournal, journal);
+}
+
+
+
+/**
+ * thunar_transfer_journal_remove:
+ * @journal : a #ThunarTransferJournal.
+ *
+ * Deletes the journal from the disk and releases it, to be called once
+ * the transfer finished, failed or was cancelled by the user, since it
+ * cannot be resumed then.
+ **/
+void
+thunar_transfer_journal_remove (ThunarTransferJournal *journal)
+{
+  _thunar_return_if_fail (journal != NULL);
+
+  g_unlink (journal->path);
+
+  /* nothing worth to write anymore */
+  g_string_truncate (journal->buffer, 0);
+  thunar_transfer_journal_close (journal);
+}
+
+
+
+/**
+ * thunar_transfer_journal_discard:
+ * @journal : a #ThunarTransferJournal.
+ *
+ * Deletes the *.partial~ files the interrupted transfer of the @journal
+ * left behind, and the @journal itself, to be called if the user does
+ * not want to resume the transfer.
+ **/
+void
+thunar_transfer_journal_discard (ThunarTransferJournal *journal)
+{
+  ThunarTransferJournalEntry *entry;
+  GHashTableIter              iter;
+  const gchar                *uri;
+  GFile                      *target_file;
+  GFile                      *partial_file;
+
+  _thunar_return_if_fail (journal != NULL);
+
+  if (journal->entries != NULL)
+    {
+      g_hash_table_iter_init (&iter, journal->entries);
+      while (g_hash_table_iter_next (&iter, (gpointer *) &uri, (gpointer *) &entry))
+        {
+          if (entry->completed)
+            continue;
+
+          /* the copy without *.partial~ was removed when it failed */
+          target_file = g_file_new_for_uri (uri);
+          partial_file = thunar_g_file_get_partial (target_file);
+          if (g_file_peek_path (partial_file) != NULL)
+            g_unlink (g_file_peek_path (partial_file));
+          g_object_unref (partial_file);
+          g_object_unref (target_file);
+        }
+    }
+
+  thunar_transfer_journal_remove (journal);
+}
+
+
+
+/**
+ * thunar_transfer_journal_list_interrupted:
+ *
+ * Looks for journals of transfers which were interrupted because Thunar
+ * died. Journals of transfers which are still running are not included.
+ *
+ * Return value: (transfer full): a %NULL-terminated array of the paths
+ *               of the journals, free with g_strfreev().
+ **/
+gchar **
+thunar_transfer_journal_list_interrupted (void)
+{
+  GPtrArray   *paths;
+  GDir        *dir;
+  const gchar *name;
+  gchar       *directory;
+  gchar       *path;
+  gint         fd;
+
+  paths = g_ptr_array_new ();
+
+  directory = xfce_resource_save_location (XFCE_RESOURCE_CACHE, THUNAR_TRANSFER_JOURNAL_DIRECTORY, FALSE);
+  dir = (directory != NULL) ? g_dir_open (directory, 0, NULL) : NULL;
+  if (dir != NULL)
+    {
+      while ((name = g_dir_read_name (dir)) != NULL)
+        {
+          if (!g_str_has_suffix (name, ".journal"))
+            continue;
+
+          /* the running transfers hold a lock on their journal */
+          path = g_build_filename (directory, name, NULL);
+          fd = g_open (path, O_RDONLY | O_CLOEXEC, 0);
+          if (fd >= 0 && thunar_transfer_journal_lock (fd, NULL))
+            g_ptr_array_add (paths, path);
+          else
+            g_free (path);
+
+          if (fd >= 0)
+            close (fd);
+        }
+
+      g_dir_close (dir);
+    }
+
+  g_free (directory);
+  g_ptr_array_add (paths, NULL);
+
+  return (gchar **) g_ptr_array_free (paths, FALSE);
+}
+
+
+
+/**
+ * thunar_transfer_journal_get_plan:
+ * @journal          : a #ThunarTransferJournal.
+ * @source_file_list : (out) (transfer none): return location for the top level files to transfer.
+ * @target_file_list : (out) (transfer none): return location for the matching targets.
+ *
+ * Returns the files the transfer of the @journal was started with.
+ **/
+void
+thunar_transfer_journal_get_plan (ThunarTransferJournal *journal,
+                                  GList                **source_file_list,
+                                  GList                **target_file_list)
+{
+  _thunar_return_if_fail (journal != NULL);
+
+  *source_file_list = journal->source_file_list;
+  *target_file_list = journal->target_file_list;
+}
+
+
+
+/**
+ * thunar_transfer_journal_get_n_completed:
+ * @journal : a #ThunarTransferJournal.
+ *
+ * Return value: the number of files and folders the interrupted transfer
+ *               of the @journal completed.
+ **/
+guint
+thunar_transfer_journal_get_n_completed (ThunarTransferJournal *journal)
+{
+  _thunar_return_val_if_fail (journal != NULL, 0);
+
+  return journal->n_completed;
+}
+
+
+
+/**
+ * thunar_transfer_journal_is_completed:
+ * @journal     : a #ThunarTransferJournal.
+ * @target_file : the target of a file to transfer.
+ * @size        : the size of the source file.
+ *
+ * Checks whether the interrupted transfer completed the copy to
+ * @target_file. The copy is only trusted if it is still there and
+ * has the @size of the source.
+ *
+ * Return value: %TRUE if @target_file needs not to be copied again.
+ **/
+gboolean
+thunar_transfer_journal_is_completed (ThunarTransferJournal *journal,
+                                      GFile                 *target_file,
+                                      guint64                size)
+{
+  ThunarTransferJournalEntry *entry;
+  GFileInfo                  *info;
+  gboolean                    completed;
+
+  _thunar_return_val_if_fail (journal != NULL, FALSE);
+  _thunar_return_val_if_fail (G_IS_FILE (target_file), FALSE);
+
+  entry = thunar_transfer_journal_lookup (journal, target_file);
+  if (entry == NULL || !entry->completed || entry->size != size)
+    return FALSE;
+
+  info = g_file_query_info (target_file, G_FILE_ATTRIBUTE_STANDARD_TYPE "," G_FILE_ATTRIBUTE_STANDARD_SIZE,
+                            G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS, NULL, NULL);
+  if (info == NULL)
+    return FALSE;
+
+  /* the size of folders and links is not what was copied */
+  completed = (g_file_info_get_file_type (info) != G_FILE_TYPE_REGULAR
+               || (guint64) g_file_info_get_size (info) == size);
+  g_object_unref (info);
+
+  return completed;
+}
+
+
+
+/**
+ * thunar_transfer_journal_is_started:
+ * @journal     : a #ThunarTransferJournal.
+ * @target_file : the target of a file to transfer.
+ *
+ * Return value: %TRUE if the interrupted transfer started to copy to
+ *               @target_file, so an existing @target_file is an
+ *               incomplete copy.
+ **/
+gboolean
+thunar_transfer_journal_is_started (ThunarTransferJournal *journal,
+                                    GFile                 *target_file)
+{
+  ThunarTransferJournalEntry *entry;
+
+  _thunar_return_val_if_fail (journal != NULL, FALSE);
+  _thunar_return_val_if_fail (G_IS_FILE (target_file), FALSE);
+
+  entry = thunar_transfer_journal_lookup (journal, target_file);
+
+  return entry != NULL && !entry->completed;
+}
+
+
+
+/**
+ * thunar_transfer_journal_get_checkpoint:
+ * @journal     : a #ThunarTransferJournal.
+ * @target_file : the target of a file to transfer.
+ * @source_file : the source of the file to transfer.
+ *
+ * The *.partial~ file is only continued if @source_file still has the
+ * device, inode, size and modification time it had when the data was
+ * copied, otherwise the copy has to start from the beginning.
+ *
+ * Return value: the number of bytes of the *.partial~ file of @target_file
+ *               which are known to be on the disk, or 0.
+ **/
+guint64
+thunar_transfer_journal_get_checkpoint (ThunarTransferJournal *journal,
+                                        GFile                 *target_file,
+                                        GFile                 *source_file)
+{
+  ThunarTransferJournalEntry *entry;
+  gchar                      *identity;
+  guint64                     checkpoint = 0;
+
+  _thunar_return_val_if_fail (journal != NULL, 0);
+  _thunar_return_val_if_fail (G_IS_FILE (target_file), 0);
+  _thunar_return_val_if_fail (G_IS_FILE (source_file), 0);
+
+  entry = thunar_transfer_journal_lookup (journal, target_file);
+  if (entry == NULL || entry->completed || entry->checkpoint == 0)
+    return 0;
+
+  identity = thunar_transfer_journal_get_identity (source_file);
+  if (identity != NULL && g_strcmp0 (identity, entry->identity) == 0)
+    checkpoint = entry->checkpoint;
+  g_free (identity);
+
+  return checkpoint;
+}
+
+
+
+/**
+ * thunar_transfer_journal_add_started:
+ * @journal     : a #ThunarTransferJournal.
+ * @target_file : the target of the file which is copied now.
+ * @source_file : the source of the file which is copied now.
+ *
+ * Records that @target_file is about to be written with the contents
+ * of @source_file.
+ **/
+void
+thunar_transfer_journal_add_started (ThunarTransferJournal *journal,
+                                     GFile                 *target_file,
+                                     GFile                 *source_file)
+{
+  gchar *identity;
+  gchar *uri;
+
+  _thunar_return_if_fail (journal != NULL);
+  _thunar_return_if_fail (G_IS_FILE (target_file));
+  _thunar_return_if_fail (G_IS_FILE (source_file));
+
+  uri = g_file_get_uri (target_file);
+  identity = thunar_transfer_journal_get_identity (source_file);
+  thunar_transfer_journal_append (journal, FALSE, "start %s %s\n", uri, identity != NULL ? identity : "-");
+  g_free (identity);
+  g_free (uri);
+}
+
+
+
+/**
+ * thunar_transfer_journal_add_completed:
+ * @journal     : a #ThunarTransferJournal.
+ * @target_file : the target of the file which was copied.
+ * @size        : the size of the file.
+ *
+ * Records that @target_file was copied completely, or that the folder
+ * @target_file was created.
+ **/
+void
+thunar_transfer_journal_add_completed (ThunarTransferJournal *journal,
+                                       GFile                 *target_file,
+                                       guint64                size)
+{
+  gchar *uri;
+
+  _thunar_return_if_fail (journal != NULL);
+  _thunar_return_if_fail (G_IS_FILE (target_file));
+
+  uri = g_file_get_uri (target_file);
+  thunar_transfer_journal_append (journal, FALSE, "done %s %" G_GUINT64_FORMAT "\n", uri, size);
+  g_free (uri);
+}
+
+
+
+/**
+ * thunar_transfer_journal_add_checkpoint:
+ * @journal      : a #ThunarTransferJournal.
+ * @target_file  : the target of the file which is copied.
+ * @partial_file : the *.partial~ file the data is written to.
+ * @offset       : the number of bytes written to @partial_file.
+ * @source_file  : the source of the file which is copied.
+ *
+ * Makes sure the first @offset bytes of @partial_file are on the disk and
+ * records that, so an interrupted copy to @target_file can be continued
+ * from there as long as @source_file does not change.
+ **/
+void
+thunar_transfer_journal_add_checkpoint (ThunarTransferJournal *journal,
+                                        GFile                 *target_file,
+                                        GFile                 *partial_file,
+                                        guint64                offset,
+                                        GFile                 *source_file)
+{
+  const gchar *path;
+  gchar       *identity;
+  gchar       *uri;
+  gint         fd;
+
+  _thunar_return_if_fail (journal != NULL);
+  _thunar_return_if_fail (G_IS_FILE (target_file));
+  _thunar_return_if_fail (G_IS_FILE (partial_file));
+  _thunar_return_if_fail (G_IS_FILE (source_file));
+
+  /* only the data of local files can be synced */
+  path = g_file_peek_path (partial_file);
+  if (path == NULL)
+    return;
+
+  fd = g_open (path, O_WRONLY | O_CLOEXEC | O_NOFOLLOW, 0);
+  if (fd < 0)
+    return;
+
+  /* data of a source which is not on the disk cannot be checked later */
+  identity = thunar_transfer_journal_get_identity (source_file);
+  if (identity != NULL && g_fsync (fd) == 0)
+    {
+      uri = g_file_get_uri (target_file);
+      thunar_transfer_journal_append (journal, TRUE, "part %s %" G_GUINT64_FORMAT " %s\n", uri, offset, identity);
+      g_free (uri);
+    }
+  g_free (identity);
+
+  close (fd);
+}
@@ -0,0 +1,82 @@
+/* vi:set et ai sw=2 sts=2 ts=2: */
+/*-
+ * Copyright (c) 2026 The Xfce Development Team
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+ * Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef __THUNAR_TRANSFER_JOURNAL_H__
+#define __THUNAR_TRANSFER_JOURNAL_H__
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ThunarTransferJournal ThunarTransferJournal;
+
+ThunarTransferJournal *
+thunar_transfer_journal_new (GList   *source_file_list,
+                             GList   *target_file_list,
+                             GError **error) G_GNUC_MALLOC;
+ThunarTransferJournal *
+thunar_transfer_journal_load (const gchar *path,
+                              GError     **error) G_GNUC_MALLOC;
+void
+thunar_transfer_journal_close (ThunarTransferJournal *journal);
+void
+thunar_transfer_journal_remove (ThunarTransferJournal *journal);
+void
+thunar_transfer_journal_discard (ThunarTransferJournal *journal);
+
+gchar **
+thunar_transfer_journal_list_interrupted (void);
+
+void
+thunar_transfer_journal_get_plan (ThunarTransferJournal *journal,
+                                  GList                **source_file_list,
+                                  GList                **target_file_list);
+guint
+thunar_transfer_journal_get_n_completed (ThunarTransferJournal *journal);
+
+gboolean
+thunar_transfer_journal_is_completed (ThunarTransferJournal *journal,
+                                      GFile                 *target_file,
+                                      guint64                size);
+gboolean
+thunar_transfer_journal_is_started (ThunarTransferJournal *journal,
+                                    GFile                 *target_file);
+guint64
+thunar_transfer_journal_get_checkpoint (ThunarTransferJournal *journal,
+                                        GFile                 *target_file,
+                                        GFile                 *source_file);
+
+void
+thunar_transfer_journal_add_started (ThunarTransferJournal *journal,
+                                     GFile                 *target_file,
+                                     GFile                 *source_file);
+void
+thunar_transfer_journal_add_completed (ThunarTransferJournal *journal,
+                                       GFile                 *target_file,
+                                       guint64                size);
+void
+thunar_transfer_journal_add_checkpoint (ThunarTransferJournal *journal,
+                                        GFile                 *target_file,
+                                        GFile                 *partial_file,
+                                        guint64                offset,
+                                        GFile                 *source_file);
+
+G_END_DECLS
+
+#endif /* !__THUNAR_TRANSFER_JOURNAL_H__ */
@@ -0,0 +1,508 @@
+/* vi:set et ai sw=2 sts=2 ts=2: */
+/*-
+ * Copyright (c) 2026 The Xfce Development Team
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+ * Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifdef HAVE_SYS_TYPES_H
+#include <sys/types.h>
+#endif
+#ifdef HAVE_SYS_STAT_H
+#include <sys/stat.h>
+#endif
+#ifdef HAVE_SYS_SYSMACROS_H
+#include <sys/sysmacros.h>
+#endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+#include "thunar/thunar-gio-extensions.h"
+#include "thunar/thunar-private.h"
+#include "thunar/thunar-transfer-scheduler.h"
+
+
+
+/* how often a transfer waiting for a device checks for cancellation */
+#define THUNAR_TRANSFER_SCHEDULER_WAIT_INTERVAL (100 * G_TIME_SPAN_MILLISECOND)
+
+
+
+typedef enum
+{
+  THUNAR_TRANSFER_DEVICE_ROTATIONAL,
+  THUNAR_TRANSFER_DEVICE_SOLID_STATE,
+  THUNAR_TRANSFER_DEVICE_REMOTE,
+  THUNAR_TRANSFER_DEVICE_N_KINDS,
+} ThunarTransferDeviceKind;
+
+
+
+typedef struct
+{
+  ThunarTransferDevice *device;
+  GFile                *file;
+  guint32               unix_device;
+  gboolean              has_unix_device;
+} ThunarTransferClassify;
+
+
+
+#ifdef HAVE_SYS_SYSMACROS_H
+static gboolean
+thunar_transfer_scheduler_read_rotational (dev_t     device,
+                                           gboolean *is_rotational);
+static gboolean
+thunar_transfer_scheduler_lookup_backing_device (dev_t  device,
+                                                 dev_t *backing_device);
+#endif
+static ThunarTransferDeviceKind
+thunar_transfer_scheduler_classify (ThunarTransferClassify *classify);
+static void
+thunar_transfer_scheduler_classify_thread (gpointer data,
+                                           gpointer user_data);
+static gboolean
+thunar_transfer_scheduler_has_slot (ThunarTransferDevice *source_device,
+                                    ThunarTransferDevice *target_device);
+static void
+thunar_transfer_scheduler_take_slot (ThunarTransferDevice *source_device,
+                                     ThunarTransferDevice *target_device);
+
+
+
+/* a file system known to the scheduler, devices are never freed so
+ * jobs can hold on to them without taking a reference */
+struct _ThunarTransferDevice
+{
+  gchar                   *filesystem_id;
+  ThunarTransferDeviceKind kind;
+
+  /* the number of files currently transferred from or to the device */
+  guint n_active;
+};
+
+
+
+/* the devices by filesystem id and the maximum number of files transferred
+ * from or to a device of each kind at once, shared by all transfer jobs
+ * and only accessed with scheduler_mutex held */
+static GHashTable  *scheduler_devices = NULL;
+static guint        scheduler_budgets[THUNAR_TRANSFER_DEVICE_N_KINDS] = { 1, 4, 1 };
+static GMutex       scheduler_mutex;
+static GCond        scheduler_cond;
+
+/* detects the kind of new devices, off the main thread */
+static GThreadPool *scheduler_classify_pool = NULL;
+
+
+
+#ifdef HAVE_SYS_SYSMACROS_H
+static gboolean
+thunar_transfer_scheduler_read_rotational (dev_t     device,
+                                           gboolean *is_rotational)
+{
+  gboolean succeed = FALSE;
+  gchar   *contents;
+  gchar   *paths[2];
+  gsize    n;
+
+  /* partitions have no queue of their own, it belongs to the whole disk */
+  paths[0] = g_strdup_printf ("/sys/dev/block/%u:%u/queue/rotational", major (device), minor (device));
+  paths[1] = g_strdup_printf ("/sys/dev/block/%u:%u/../queue/rotational", major (device), minor (device));
+
+  for (n = 0; n < G_N_ELEMENTS (paths) && !succeed; n++)
+    {
+      if (g_file_get_contents (paths[n], &contents, NULL, NULL))
+        {
+          *is_rotational = (contents[0] == '1');
+          succeed = TRUE;
+          g_free (contents);
+        }
+    }
+
+  g_free (paths[0]);
+  g_free (paths[1]);
+
+  return succeed;
+}
+
+
+
+/* file systems like btrfs report an anonymous device number (major 0)
+ * which has no entry in sysfs, so find the block device they are
+ * mounted from in the mount table of the process */
+static gboolean
+thunar_transfer_scheduler_lookup_backing_device (dev_t  device,
+                                                 dev_t *backing_device)
+{
+  struct stat statb;
+  gboolean    succeed = FALSE;
+  gchar      *contents;
+  gchar     **lines;
+  gchar     **fields;
+  gchar      *separator;
+  gchar      *numbers;
+  gchar      *match;
+  guint       n;
+
+  if (!g_file_get_contents ("/proc/self/mountinfo", &contents, NULL, NULL))
+    return FALSE;
+
+  /* lines look like "36 35 0:32 / /home rw,relatime shared:1 - btrfs /dev/sda2 rw",
+   * the optional fields end at " - ", followed by the type and the source */
+  numbers = g_strdup_printf (" %u:%u ", major (device), minor (device));
+  lines = g_strsplit (contents, "\n", -1);
+  for (n = 0; lines[n] != NULL && !succeed; n++)
+    {
+      separator = strstr (lines[n], " - ");
+      match = strstr (lines[n], numbers);
+      if (separator == NULL || match == NULL || match > separator)
+        continue;
+
+      fields = g_strsplit (separator + 3, " ", 3);
+      if (g_strv_length (fields) >= 2
+          && fields[1][0] == '/'
+          && stat (fields[1], &statb) == 0
+          && S_ISBLK (statb.st_mode))
+        {
+          *backing_device = statb.st_rdev;
+          succeed = TRUE;
+        }
+      g_strfreev (fields);
+    }
+
+  g_strfreev (lines);
+  g_free (numbers);
+  g_free (contents);
+
+  return succeed;
+}
+#endif
+
+
+
+static ThunarTransferDeviceKind
+thunar_transfer_scheduler_classify (ThunarTransferClassify *classify)
+{
+#ifdef HAVE_SYS_SYSMACROS_H
+  gboolean is_rotational;
+  dev_t    device;
+  dev_t    backing_device;
+
+  if (classify->has_unix_device)
+    {
+      device = classify->unix_device;
+      if (thunar_transfer_scheduler_read_rotational (device, &is_rotational)
+          || (thunar_transfer_scheduler_lookup_backing_device (device, &backing_device)
+              && thunar_transfer_scheduler_read_rotational (backing_device, &is_rotational)))
+        return is_rotational ? THUNAR_TRANSFER_DEVICE_ROTATIONAL : THUNAR_TRANSFER_DEVICE_SOLID_STATE;
+    }
+#endif
+
+  /* not backed by a block device, like FUSE or network file systems
+   * which can be unmounted, or tmpfs which cannot */
+  return thunar_g_file_is_on_local_device (classify->file) ? THUNAR_TRANSFER_DEVICE_SOLID_STATE : THUNAR_TRANSFER_DEVICE_REMOTE;
+}
+
+
+
+static void
+thunar_transfer_scheduler_classify_thread (gpointer data,
+                                           gpointer user_data)
+{
+  ThunarTransferClassify  *classify = data;
+  ThunarTransferDeviceKind kind;
+
+  kind = thunar_transfer_scheduler_classify (classify);
+
+  g_mutex_lock (&scheduler_mutex);
+  classify->device->kind = kind;
+
+  /* a larger budget may admit waiting transfers */
+  g_cond_broadcast (&scheduler_cond);
+  g_mutex_unlock (&scheduler_mutex);
+
+  g_object_unref (classify->file);
+  g_free (classify);
+}
+
+
+
+/* must be called with scheduler_mutex held */
+static gboolean
+thunar_transfer_scheduler_has_slot (ThunarTransferDevice *source_device,
+                                    ThunarTransferDevice *target_device)
+{
+  if (source_device != NULL && source_device->n_active >= scheduler_budgets[source_device->kind])
+    return FALSE;
+  if (target_device != NULL && target_device != source_device && target_device->n_active >= scheduler_budgets[target_device->kind])
+    return FALSE;
+
+  return TRUE;
+}
+
+
+
+/* must be called with scheduler_mutex held */
+static void
+thunar_transfer_scheduler_take_slot (ThunarTransferDevice *source_device,
+                                     ThunarTransferDevice *target_device)
+{
+  if (source_device != NULL)
+    source_device->n_active++;
+  if (target_device != NULL && target_device != source_device)
+    target_device->n_active++;
+}
+
+
+
+/**
+ * thunar_transfer_scheduler_set_budgets:
+ * @rotational  : the budget of hard disks.
+ * @solid_state : the budget of SSDs and other local devices.
+ * @remote      : the budget of network shares and other remote locations.
+ *
+ * Sets the number of files which are transferred from or to a single
+ * device at the same time, for each kind of device. Applies to all
+ * transfer jobs.
+ **/
+void
+thunar_transfer_scheduler_set_budgets (guint rotational,
+                                       guint solid_state,
+                                       guint remote)
+{
+  g_mutex_lock (&scheduler_mutex);
+  scheduler_budgets[THUNAR_TRANSFER_DEVICE_ROTATIONAL] = MAX (rotational, 1);
+  scheduler_budgets[THUNAR_TRANSFER_DEVICE_SOLID_STATE] = MAX (solid_state, 1);
+  scheduler_budgets[THUNAR_TRANSFER_DEVICE_REMOTE] = MAX (remote, 1);
+
+  /* a larger budget may admit waiting transfers */
+  g_cond_broadcast (&scheduler_cond);
+  g_mutex_unlock (&scheduler_mutex);
+}
+
+
+
+/**
+ * thunar_transfer_scheduler_lookup_device:
+ * @file        : a #GFile.
+ * @cancellable : (nullable): optional #GCancellable object.
+ *
+ * Looks up the device @file is stored on. If @file does not exist (yet),
+ * like the target of a transfer, the device of the closest existing
+ * parent folder is used. The kind of a local device is detected in the
+ * background the first time it is seen, until then it is treated like a
+ * hard disk. The result is kept for the lifetime of the process.
+ *
+ * Return value: (transfer none) (nullable): the #ThunarTransferDevice of
+ *               @file, or %NULL if it cannot be determined.
+ **/
+ThunarTransferDevice *
+thunar_transfer_scheduler_lookup_device (GFile        *file,
+                                         GCancellable *cancellable)
+{
+  ThunarTransferClassify *classify = NULL;
+  ThunarTransferDevice   *device = NULL;
+  const gchar            *filesystem_id;
+  GFileInfo              *info = NULL;
+  GFile                  *parent;
+
+  _thunar_return_val_if_fail (G_IS_FILE (file), NULL);
+
+  for (file = g_object_ref (file); file != NULL; file = parent)
+    {
+      info = g_file_query_info (file, G_FILE_ATTRIBUTE_ID_FILESYSTEM "," G_FILE_ATTRIBUTE_UNIX_DEVICE,
+                                G_FILE_QUERY_INFO_NONE, cancellable, NULL);
+      if (info != NULL)
+        break;
+
+      parent = g_file_get_parent (file);
+      g_object_unref (file);
+    }
+
+  if (info == NULL)
+    return NULL;
+
+  filesystem_id = g_file_info_get_attribute_string (info, G_FILE_ATTRIBUTE_ID_FILESYSTEM);
+  if (G_LIKELY (filesystem_id != NULL))
+    {
+      g_mutex_lock (&scheduler_mutex);
+      if (G_UNLIKELY (scheduler_devices == NULL))
+        scheduler_devices = g_hash_table_new (g_str_hash, g_str_equal);
+
+      device = g_hash_table_lookup (scheduler_devices, filesystem_id);
+      if (device == NULL)
+        {
+          device = g_new0 (ThunarTransferDevice, 1);
+          device->filesystem_id = g_strdup (filesystem_id);
+          g_hash_table_insert (scheduler_devices, device->filesystem_id, device);
+
+          if (g_file_is_native (file))
+            {
+              /* reading sysfs and the mount table might block for a while and
+               * this is called from the main thread, so detect the kind in the
+               * background and start with the smallest budget meanwhile */
+              device->kind = THUNAR_TRANSFER_DEVICE_ROTATIONAL;
+
+              classify = g_new0 (ThunarTransferClassify, 1);
+              classify->device = device;
+              classify->file = g_object_ref (file);
+              classify->has_unix_device = g_file_info_has_attribute (info, G_FILE_ATTRIBUTE_UNIX_DEVICE);
+              if (classify->has_unix_device)
+                classify->unix_device = g_file_info_get_attribute_uint32 (info, G_FILE_ATTRIBUTE_UNIX_DEVICE);
+
+              if (G_UNLIKELY (scheduler_classify_pool == NULL))
+                scheduler_classify_pool = g_thread_pool_new (thunar_transfer_scheduler_classify_thread, NULL, 1, FALSE, NULL);
+            }
+          else
+            {
+              device->kind = THUNAR_TRANSFER_DEVICE_REMOTE;
+            }
+        }
+      g_mutex_unlock (&scheduler_mutex);
+
+      if (classify != NULL)
+        g_thread_pool_push (scheduler_classify_pool, classify, NULL);
+    }
+
+  g_object_unref (info);
+  g_object_unref (file);
+
+  return device;
+}
+
+
+
+/**
+ * thunar_transfer_scheduler_get_budget:
+ * @device : a #ThunarTransferDevice.
+ *
+ * Return value: the number of files which may be transferred from or
+ *               to @device at the same time.
+ **/
+guint
+thunar_transfer_scheduler_get_budget (ThunarTransferDevice *device)
+{
+  guint budget;
+
+  _thunar_return_val_if_fail (device != NULL, 1);
+
+  g_mutex_lock (&scheduler_mutex);
+  budget = scheduler_budgets[device->kind];
+  g_mutex_unlock (&scheduler_mutex);
+
+  return budget;
+}
+
+
+
+/**
+ * thunar_transfer_scheduler_try_acquire:
+ * @source_device : (nullable): the #ThunarTransferDevice of the source.
+ * @target_device : (nullable): the #ThunarTransferDevice of the target.
+ *
+ * Admits the transfer of a single file from @source_device to
+ * @target_device, if the budgets of both devices allow it. Unknown
+ * (%NULL) devices are not limited.
+ *
+ * Return value: %TRUE if the transfer was admitted, it must be followed
+ *               by a call to thunar_transfer_scheduler_release().
+ **/
+gboolean
+thunar_transfer_scheduler_try_acquire (ThunarTransferDevice *source_device,
+                                       ThunarTransferDevice *target_device)
+{
+  gboolean admitted;
+
+  g_mutex_lock (&scheduler_mutex);
+  admitted = thunar_transfer_scheduler_has_slot (source_device, target_device);
+  if (admitted)
+    thunar_transfer_scheduler_take_slot (source_device, target_device);
+  g_mutex_unlock (&scheduler_mutex);
+
+  return admitted;
+}
+
+
+
+/**
+ * thunar_transfer_scheduler_acquire:
+ * @source_device : (nullable): the #ThunarTransferDevice of the source.
+ * @target_device : (nullable): the #ThunarTransferDevice of the target.
+ * @cancellable   : (nullable): optional #GCancellable object.
+ *
+ * Like thunar_transfer_scheduler_try_acquire(), but waits until the
+ * budgets of both devices allow the transfer. Both devices are admitted
+ * at once, so transfers waiting for each other's devices cannot block
+ * each other.
+ *
+ * Return value: %TRUE if the transfer was admitted, %FALSE if @cancellable
+ *               was cancelled meanwhile.
+ **/
+gboolean
+thunar_transfer_scheduler_acquire (ThunarTransferDevice *source_device,
+                                   ThunarTransferDevice *target_device,
+                                   GCancellable         *cancellable)
+{
+  gboolean admitted = FALSE;
+  gint64   end_time;
+
+  g_mutex_lock (&scheduler_mutex);
+
+  while (!g_cancellable_is_cancelled (cancellable))
+    {
+      if (thunar_transfer_scheduler_has_slot (source_device, target_device))
+        {
+          thunar_transfer_scheduler_take_slot (source_device, target_device);
+          admitted = TRUE;
+          break;
+        }
+
+      end_time = g_get_monotonic_time () + THUNAR_TRANSFER_SCHEDULER_WAIT_INTERVAL;
+      g_cond_wait_until (&scheduler_cond, &scheduler_mutex, end_time);
+    }
+
+  g_mutex_unlock (&scheduler_mutex);
+
+  return admitted;
+}
+
+
+
+/**
+ * thunar_transfer_scheduler_release:
+ * @source_device : (nullable): the #ThunarTransferDevice of the source.
+ * @target_device : (nullable): the #ThunarTransferDevice of the target.
+ *
+ * Ends a transfer admitted by thunar_transfer_scheduler_acquire() or
+ * thunar_transfer_scheduler_try_acquire(), so waiting transfers on the
+ * same devices can continue.
+ **/
+void
+thunar_transfer_scheduler_release (ThunarTransferDevice *source_device,
+                                   ThunarTransferDevice *target_device)
+{
+  g_mutex_lock (&scheduler_mutex);
+
+  if (source_device != NULL)
+    source_device->n_active--;
+  if (target_device != NULL && target_device != source_device)
+    target_device->n_active--;
+
+  g_cond_broadcast (&scheduler_cond);
+  g_mutex_unlock (&scheduler_mutex);
+}
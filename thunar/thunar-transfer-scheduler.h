@@ -0,0 +1,54 @@
+/* vi:set et ai sw=2 sts=2 ts=2: */
+/*-
+ * Copyright (c) 2026 The Xfce Development Team
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+ * Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef __THUNAR_TRANSFER_SCHEDULER_H__
+#define __THUNAR_TRANSFER_SCHEDULER_H__
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ThunarTransferDevice ThunarTransferDevice;
+
+void
+thunar_transfer_scheduler_set_budgets (guint rotational,
+                                       guint solid_state,
+                                       guint remote);
+
+ThunarTransferDevice *
+thunar_transfer_scheduler_lookup_device (GFile        *file,
+                                         GCancellable *cancellable);
+guint
+thunar_transfer_scheduler_get_budget (ThunarTransferDevice *device);
+
+gboolean
+thunar_transfer_scheduler_try_acquire (ThunarTransferDevice *source_device,
+                                       ThunarTransferDevice *target_device);
+gboolean
+thunar_transfer_scheduler_acquire (ThunarTransferDevice *source_device,
+                                   ThunarTransferDevice *target_device,
+                                   GCancellable         *cancellable);
+void
+thunar_transfer_scheduler_release (ThunarTransferDevice *source_device,
+                                   ThunarTransferDevice *target_device);
+
+G_END_DECLS
+
+#endif /* !__THUNAR_TRANSFER_SCHEDULER_H__ */
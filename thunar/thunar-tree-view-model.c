@@ -55,7 +55,9 @@
 #include "thunar/thunar-io-jobs.h"
 #include "thunar/thunar-preferences.h"
 #include "thunar/thunar-private.h"
+#include "thunar/thunar-search-query.h"
 #include "thunar/thunar-simple-job.h"
+#include "thunar/thunar-size-engine.h"
 #include "thunar/thunar-tree-view-model.h"
 #include "thunar/thunar-user.h"
 #include "thunar/thunar-util.h"
@@ -295,6 +297,9 @@ static void
 thunar_tree_view_model_file_count_callback (ThunarJob           *job,
                                             ThunarTreeViewModel *model);
 static void
+thunar_tree_view_model_refresh_file (ThunarTreeViewModel *model,
+                                     ThunarFile          *file);
+static void
 thunar_tree_view_model_node_destroy (Node *node);
 static void
 thunar_tree_view_model_dir_files_changed (Node       *node,
@@ -317,6 +322,8 @@ struct _ThunarTreeViewModelClass
   void (*error) (ThunarTreeViewModel *model,
                  const GError        *error);
   void (*search_done) (void);
+  void (*search_error) (ThunarTreeViewModel *model,
+                        const GError        *error);
 };
 
 
@@ -357,7 +364,7 @@ struct _ThunarTreeViewModel
   gint n_visible_files;
   gint loading;
 
-  gchar **search_terms;
+  ThunarSearchQuery *search_query;
 
   ThunarJob *search_job;
   GList     *search_files;
@@ -372,6 +379,9 @@ struct _ThunarTreeViewModel
   /* The 'is_empty' values of this GHashtable are filled by the 'check_empty_job' */
   /* As such, do not access the GHashTable while the job is running */
   GHashTable *files_for_empty_check;
+
+  /* determines the recursive sizes shown in the total size column */
+  ThunarSizeEngine *size_engine;
 };
 
 
@@ -643,6 +653,23 @@ thunar_tree_view_model_class_init (ThunarTreeViewModelClass *klass)
                 NULL, NULL,
                 NULL,
                 G_TYPE_NONE, 0);
+
+  /**
+   * ThunarTreeViewModel::search-error:
+   * @store : a #ThunarTreeViewModel.
+   * @error : a #GError that describes the problem.
+   *
+   * Emitted when the search query cannot be used, in
+   * which case no search is started.
+   **/
+  model_signals[THUNAR_TREE_VIEW_MODEL_SEARCH_ERROR] =
+  g_signal_new (I_ ("search-error"),
+                G_TYPE_FROM_CLASS (gobject_class),
+                G_SIGNAL_RUN_LAST,
+                G_STRUCT_OFFSET (ThunarTreeViewModelClass, search_error),
+                NULL, NULL,
+                g_cclosure_marshal_VOID__POINTER,
+                G_TYPE_NONE, 1, G_TYPE_POINTER);
 }
 
 
@@ -658,7 +685,7 @@ thunar_tree_view_model_init (ThunarTreeViewModel *model)
   model->search_job = NULL;
   model->update_search_results_timeout_id = 0;
 
-  model->search_terms = NULL;
+  model->search_query = NULL;
   model->search_files = NULL;
   g_mutex_init (&model->mutex_add_search_files);
 
@@ -672,6 +699,9 @@ thunar_tree_view_model_init (ThunarTreeViewModel *model)
                                                         g_direct_equal,
                                                         (GDestroyNotify) g_object_unref,
                                                         g_free);
+
+  model->size_engine = thunar_size_engine_new ();
+  g_signal_connect_swapped (model->size_engine, "file-sized", G_CALLBACK (thunar_tree_view_model_refresh_file), model);
 }
 
 
@@ -751,8 +781,11 @@ thunar_tree_view_model_finalize (GObject *object)
 
   g_hash_table_destroy (model->files_for_empty_check);
 
+  g_signal_handlers_disconnect_by_data (model->size_engine, model);
+  g_object_unref (model->size_engine);
+
   g_free (model->date_custom_style);
-  g_strfreev (model->search_terms);
+  g_clear_pointer (&model->search_query, thunar_search_query_unref);
 
   g_hash_table_destroy (model->subdirs);
 
@@ -948,6 +981,8 @@ thunar_tree_view_model_get_sort_column_id (GtkTreeSortable *sortable,
     *sort_column_id = THUNAR_COLUMN_OWNER;
   else if (model->sort_func == thunar_cmp_files_by_group)
     *sort_column_id = THUNAR_COLUMN_GROUP;
+  else if (model->sort_func == thunar_cmp_files_by_total_size)
+    *sort_column_id = THUNAR_COLUMN_TOTAL_SIZE;
   else
     _thunar_assert_not_reached ();
 
@@ -1032,6 +1067,10 @@ thunar_tree_view_model_set_sort_column_id (GtkTreeSortable *sortable,
       model->sort_func = thunar_cmp_files_by_type;
       break;
 
+    case THUNAR_COLUMN_TOTAL_SIZE:
+      model->sort_func = thunar_cmp_files_by_total_size;
+      break;
+
     default:
       _thunar_assert_not_reached ();
     }
@@ -1147,6 +1186,9 @@ thunar_tree_view_model_get_column_type (GtkTreeModel *model,
     case THUNAR_COLUMN_TYPE:
       return G_TYPE_STRING;
 
+    case THUNAR_COLUMN_TOTAL_SIZE:
+      return G_TYPE_STRING;
+
     case THUNAR_COLUMN_FILE:
       return THUNAR_TYPE_FILE;
 
@@ -1248,6 +1290,7 @@ thunar_tree_view_model_get_value (GtkTreeModel *model,
   ThunarUser   *user = NULL;
   ThunarFolder *folder;
   gint32        item_count;
+  gint64        total_size;
   GFile        *g_file;
   GFile        *g_file_parent = NULL;
   gchar        *str = NULL;
@@ -1532,6 +1575,24 @@ thunar_tree_view_model_get_value (GtkTreeModel *model,
       g_value_take_string (value, thunar_file_get_content_type_desc (file, TRUE));
       break;
 
+    case THUNAR_COLUMN_TOTAL_SIZE:
+      g_value_init (value, G_TYPE_STRING);
+      if (file == NULL || thunar_file_is_mountable (file))
+        {
+          g_value_set_static_string (value, "");
+          break;
+        }
+
+      /* folders stay empty until the size engine counted them */
+      total_size = thunar_file_get_total_size (file);
+      if (total_size < 0)
+        {
+          g_value_set_static_string (value, "");
+          break;
+        }
+      g_value_take_string (value, g_format_size_full (total_size, THUNAR_TREE_VIEW_MODEL (model)->file_size_binary ? G_FORMAT_SIZE_IEC_UNITS : G_FORMAT_SIZE_DEFAULT));
+      break;
+
     case THUNAR_COLUMN_FILE:
       g_value_init (value, THUNAR_TYPE_FILE);
       g_value_set_object (value, file);
@@ -1858,7 +1919,9 @@ thunar_tree_view_model_set_folder (ThunarTreeViewModel *model,
                                    gchar               *search_query)
 {
   ThunarTreeViewModel *_model;
-  gchar               *search_query_normalized;
+  ThunarPreferences   *preferences;
+  ThunarSearchMode     search_mode;
+  GError              *error = NULL;
 
   _thunar_return_if_fail (THUNAR_IS_TREE_VIEW_MODEL (model));
 
@@ -1877,6 +1940,8 @@ thunar_tree_view_model_set_folder (ThunarTreeViewModel *model,
   thunar_tree_view_model_cleanup_model (_model);
   _model->root = NULL;
 
+  thunar_size_engine_clear (_model->size_engine);
+
   if (g_hash_table_size (_model->subdirs) > 0)
     g_hash_table_remove_all (_model->subdirs);
 
@@ -1905,14 +1970,24 @@ thunar_tree_view_model_set_folder (ThunarTreeViewModel *model,
       /* mark the current folder as ready */
       _model->root->loaded = TRUE;
 
-      search_query_normalized = thunar_g_utf8_normalize_for_search (search_query, TRUE, TRUE);
-      g_strfreev (_model->search_terms);
-      _model->search_terms = thunar_util_split_search_query (search_query_normalized, NULL);
-      if (_model->search_terms != NULL)
+      preferences = thunar_preferences_get ();
+      g_object_get (G_OBJECT (preferences), "misc-search-mode", &search_mode, NULL);
+      g_object_unref (preferences);
+
+      /* compile the query once, it is shared with the search job */
+      g_clear_pointer (&_model->search_query, thunar_search_query_unref);
+      _model->search_query = thunar_search_query_new (search_query, search_mode, &error);
+      if (_model->search_query == NULL)
+        {
+          /* let the view tell the user why there are no results */
+          g_signal_emit_by_name (G_OBJECT (model), "search-error", error);
+          g_error_free (error);
+        }
+      else
         {
           /* search the current folder
            * start a new recursive_search_job */
-          _model->search_job = thunar_io_jobs_search_directory (THUNAR_TREE_VIEW_MODEL (_model), search_query_normalized, thunar_folder_get_corresponding_file (folder));
+          _model->search_job = thunar_io_jobs_search_directory (THUNAR_TREE_VIEW_MODEL (_model), _model->search_query, thunar_folder_get_corresponding_file (folder));
           g_signal_connect (_model->search_job, "error", G_CALLBACK (_thunar_tree_view_model_search_error), NULL);
           g_signal_connect (_model->search_job, "finished", G_CALLBACK (_thunar_tree_view_model_search_finished), _model);
           thunar_job_launch (THUNAR_JOB (_model->search_job));
@@ -1920,7 +1995,6 @@ thunar_tree_view_model_set_folder (ThunarTreeViewModel *model,
           /* add new results to the model every X ms */
           _model->update_search_results_timeout_id = g_timeout_add (500, G_SOURCE_FUNC (thunar_tree_view_model_update_search_files), _model);
         }
-      g_free (search_query_normalized);
     }
 
   /* notify listeners that we have a new folder */
@@ -2320,6 +2394,26 @@ _thunar_tree_view_model_node_check_empty_job_finished (ThunarTreeViewModel *mode
 
 
 
+/**
+ * thunar_tree_view_model_request_total_sizes:
+ * @model : a #ThunarTreeViewModel
+ * @files : the #ThunarFile<!---->s of the visible rows, or %NULL
+ *
+ * Determines the total size of the folders in @files in the background,
+ * the rows are updated as soon as a size is known. Counts of folders
+ * which are no longer in @files are cancelled.
+ **/
+void
+thunar_tree_view_model_request_total_sizes (ThunarTreeViewModel *model,
+                                            GList               *files)
+{
+  _thunar_return_if_fail (THUNAR_IS_TREE_VIEW_MODEL (model));
+
+  thunar_size_engine_request (model->size_engine, files);
+}
+
+
+
 /**
  * thunar_tree_view_model_update_expand_arrows:
  * @model : a #ThunarTreeViewModel
@@ -3052,9 +3146,6 @@ thunar_tree_view_model_file_count_callback (ThunarJob           *job,
 {
   GArray     *param_values;
   ThunarFile *file;
-  ThunarFile *parent;
-  GHashTable *files;
-  Node       *parent_node;
 
   if (job == NULL)
     return;
@@ -3065,6 +3156,20 @@ thunar_tree_view_model_file_count_callback (ThunarJob           *job,
   if (file == NULL)
     return;
 
+  thunar_tree_view_model_refresh_file (model, file);
+}
+
+
+
+/* emits row-changed for @file, which also moves it to its new sort position */
+static void
+thunar_tree_view_model_refresh_file (ThunarTreeViewModel *model,
+                                     ThunarFile          *file)
+{
+  ThunarFile *parent;
+  GHashTable *files;
+  Node       *parent_node;
+
   parent = thunar_file_get_parent (file, NULL);
   if (parent == NULL)
     return;
@@ -3354,18 +3459,12 @@ static gboolean
 _thunar_tree_view_model_matches_search_terms (ThunarTreeViewModel *model,
                                               ThunarFile          *file)
 {
-  gboolean matched;
-  gchar   *name_n;
-
-  name_n = (gchar *) thunar_file_get_display_name (file);
-  if (name_n == NULL)
+  if (model->search_query == NULL)
     return FALSE;
 
-  name_n = thunar_g_utf8_normalize_for_search (name_n, TRUE, TRUE);
-  matched = thunar_util_search_terms_match (model->search_terms, name_n);
-  g_free (name_n);
-
-  return matched;
+  return thunar_search_query_match_file (model->search_query,
+                                         model->root != NULL ? thunar_file_get_file (model->root->file) : NULL,
+                                         file);
 }
 
 
@@ -36,6 +36,7 @@ typedef enum ThunarTreeViewModelSignals
 {
   THUNAR_TREE_VIEW_MODEL_ERROR,
   THUNAR_TREE_VIEW_MODEL_SEARCH_DONE,
+  THUNAR_TREE_VIEW_MODEL_SEARCH_ERROR,
   THUNAR_TREE_VIEW_MODEL_LAST_SIGNAL,
 } ThunarTreeViewModelSignals;
 
@@ -117,6 +118,9 @@ gboolean
 thunar_tree_view_model_update_expand_arrows (ThunarTreeViewModel *model,
                                              GList               *files,
                                              gboolean             force);
+void
+thunar_tree_view_model_request_total_sizes (ThunarTreeViewModel *model,
+                                            GList               *files);
 G_END_DECLS;
 
 #endif /* !__THUNAR_TREE_VIEW_MODEL_H__ */
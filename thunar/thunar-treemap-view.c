@@ -0,0 +1,361 @@
+/* vi:set et ai sw=2 sts=2 ts=2: */
+/*-
+ * Copyright (c) 2026 The Xfce Development Team
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+ * Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "thunar/thunar-action-manager.h"
+#include "thunar/thunar-private.h"
+#include "thunar/thunar-standard-view.h"
+#include "thunar/thunar-treemap-view.h"
+#include "thunar/thunar-treemap.h"
+#include "thunar/thunar-window.h"
+
+
+
+static GList *
+thunar_treemap_view_get_selected_items (ThunarStandardView *standard_view);
+static void
+thunar_treemap_view_select_all (ThunarStandardView *standard_view);
+static void
+thunar_treemap_view_unselect_all (ThunarStandardView *standard_view);
+static void
+thunar_treemap_view_selection_invert (ThunarStandardView *standard_view);
+static void
+thunar_treemap_view_select_path (ThunarStandardView *standard_view,
+                                 GtkTreePath        *path);
+static void
+thunar_treemap_view_set_cursor (ThunarStandardView *standard_view,
+                                GtkTreePath        *path,
+                                gboolean            start_editing);
+static void
+thunar_treemap_view_scroll_to_path (ThunarStandardView *standard_view,
+                                    GtkTreePath        *path,
+                                    gboolean            use_align,
+                                    gfloat              row_align,
+                                    gfloat              col_align);
+static GtkTreePath *
+thunar_treemap_view_get_path_at_pos (ThunarStandardView *standard_view,
+                                     gint                x,
+                                     gint                y);
+static gboolean
+thunar_treemap_view_get_visible_range (ThunarStandardView *standard_view,
+                                       GtkTreePath       **start_path,
+                                       GtkTreePath       **end_path);
+static void
+thunar_treemap_view_highlight_path (ThunarStandardView *standard_view,
+                                    GtkTreePath        *path);
+static void
+thunar_treemap_view_queue_redraw (ThunarStandardView *standard_view);
+static void
+thunar_treemap_view_block_selection_changed (ThunarStandardView *standard_view);
+static void
+thunar_treemap_view_unblock_selection_changed (ThunarStandardView *standard_view);
+static gboolean
+thunar_treemap_view_button_press_event (ThunarTreemap     *treemap,
+                                        GdkEventButton    *event,
+                                        ThunarTreemapView *treemap_view);
+static void
+thunar_treemap_view_item_activated (ThunarTreemap     *treemap,
+                                    GtkTreePath       *path,
+                                    ThunarTreemapView *treemap_view);
+
+
+
+struct _ThunarTreemapViewClass
+{
+  ThunarStandardViewClass __parent__;
+};
+
+struct _ThunarTreemapView
+{
+  ThunarStandardView __parent__;
+};
+
+
+
+G_DEFINE_TYPE (ThunarTreemapView, thunar_treemap_view, THUNAR_TYPE_STANDARD_VIEW)
+
+
+
+static void
+thunar_treemap_view_class_init (ThunarTreemapViewClass *klass)
+{
+  ThunarStandardViewClass *thunarstandard_view_class;
+
+  thunarstandard_view_class = THUNAR_STANDARD_VIEW_CLASS (klass);
+  thunarstandard_view_class->get_selected_items = thunar_treemap_view_get_selected_items;
+  thunarstandard_view_class->select_all = thunar_treemap_view_select_all;
+  thunarstandard_view_class->unselect_all = thunar_treemap_view_unselect_all;
+  thunarstandard_view_class->selection_invert = thunar_treemap_view_selection_invert;
+  thunarstandard_view_class->select_path = thunar_treemap_view_select_path;
+  thunarstandard_view_class->set_cursor = thunar_treemap_view_set_cursor;
+  thunarstandard_view_class->scroll_to_path = thunar_treemap_view_scroll_to_path;
+  thunarstandard_view_class->get_path_at_pos = thunar_treemap_view_get_path_at_pos;
+  thunarstandard_view_class->get_visible_range = thunar_treemap_view_get_visible_range;
+  thunarstandard_view_class->highlight_path = thunar_treemap_view_highlight_path;
+  thunarstandard_view_class->queue_redraw = thunar_treemap_view_queue_redraw;
+  thunarstandard_view_class->block_selection = thunar_treemap_view_block_selection_changed;
+  thunarstandard_view_class->unblock_selection = thunar_treemap_view_unblock_selection_changed;
+  thunarstandard_view_class->zoom_level_property_name = "last-treemap-view-zoom-level";
+}
+
+
+
+static void
+thunar_treemap_view_init (ThunarTreemapView *treemap_view)
+{
+  GtkWidget *view;
+
+  /* create the real view */
+  view = thunar_treemap_new ();
+  g_signal_connect (G_OBJECT (view), "button-press-event", G_CALLBACK (thunar_treemap_view_button_press_event), treemap_view);
+  g_signal_connect (G_OBJECT (view), "item-activated", G_CALLBACK (thunar_treemap_view_item_activated), treemap_view);
+  g_signal_connect_swapped (G_OBJECT (view), "selection-changed", G_CALLBACK (thunar_standard_view_selection_changed), treemap_view);
+  gtk_container_add (GTK_CONTAINER (treemap_view), view);
+  gtk_widget_show (view);
+
+  /* the treemap always fills the visible area */
+  gtk_scrolled_window_set_policy (GTK_SCROLLED_WINDOW (treemap_view), GTK_POLICY_NEVER, GTK_POLICY_NEVER);
+
+  /* Set the type of model to be used by the view */
+  g_object_set (G_OBJECT (THUNAR_STANDARD_VIEW (treemap_view)), "model-type", THUNAR_TYPE_TREE_VIEW_MODEL, NULL);
+}
+
+
+
+static GList *
+thunar_treemap_view_get_selected_items (ThunarStandardView *standard_view)
+{
+  return thunar_treemap_get_selected_items (THUNAR_TREEMAP (gtk_bin_get_child (GTK_BIN (standard_view))));
+}
+
+
+
+static void
+thunar_treemap_view_select_all (ThunarStandardView *standard_view)
+{
+  _thunar_return_if_fail (THUNAR_IS_TREEMAP_VIEW (standard_view));
+  thunar_treemap_select_all (THUNAR_TREEMAP (gtk_bin_get_child (GTK_BIN (standard_view))));
+}
+
+
+
+static void
+thunar_treemap_view_unselect_all (ThunarStandardView *standard_view)
+{
+  _thunar_return_if_fail (THUNAR_IS_TREEMAP_VIEW (standard_view));
+  thunar_treemap_unselect_all (THUNAR_TREEMAP (gtk_bin_get_child (GTK_BIN (standard_view))));
+}
+
+
+
+static void
+thunar_treemap_view_selection_invert (ThunarStandardView *standard_view)
+{
+  _thunar_return_if_fail (THUNAR_IS_TREEMAP_VIEW (standard_view));
+  thunar_treemap_selection_invert (THUNAR_TREEMAP (gtk_bin_get_child (GTK_BIN (standard_view))));
+}
+
+
+
+static void
+thunar_treemap_view_select_path (ThunarStandardView *standard_view,
+                                 GtkTreePath        *path)
+{
+  _thunar_return_if_fail (THUNAR_IS_TREEMAP_VIEW (standard_view));
+  thunar_treemap_select_path (THUNAR_TREEMAP (gtk_bin_get_child (GTK_BIN (standard_view))), path);
+}
+
+
+
+static void
+thunar_treemap_view_set_cursor (ThunarStandardView *standard_view,
+                                GtkTreePath        *path,
+                                gboolean            start_editing)
+{
+  _thunar_return_if_fail (THUNAR_IS_TREEMAP_VIEW (standard_view));
+
+  /* there is no cursor and no inline editing, just select the item */
+  thunar_treemap_select_path (THUNAR_TREEMAP (gtk_bin_get_child (GTK_BIN (standard_view))), path);
+}
+
+
+
+static void
+thunar_treemap_view_scroll_to_path (ThunarStandardView *standard_view,
+                                    GtkTreePath        *path,
+                                    gboolean            use_align,
+                                    gfloat              row_align,
+                                    gfloat              col_align)
+{
+  /* all items are visible at once, nothing to scroll */
+}
+
+
+
+static GtkTreePath *
+thunar_treemap_view_get_path_at_pos (ThunarStandardView *standard_view,
+                                     gint                x,
+                                     gint                y)
+{
+  _thunar_return_val_if_fail (THUNAR_IS_TREEMAP_VIEW (standard_view), NULL);
+  return thunar_treemap_get_path_at_pos (THUNAR_TREEMAP (gtk_bin_get_child (GTK_BIN (standard_view))), x, y);
+}
+
+
+
+static gboolean
+thunar_treemap_view_get_visible_range (ThunarStandardView *standard_view,
+                                       GtkTreePath       **start_path,
+                                       GtkTreePath       **end_path)
+{
+  _thunar_return_val_if_fail (THUNAR_IS_TREEMAP_VIEW (standard_view), FALSE);
+  return thunar_treemap_get_visible_range (THUNAR_TREEMAP (gtk_bin_get_child (GTK_BIN (standard_view))), start_path, end_path);
+}
+
+
+
+static void
+thunar_treemap_view_highlight_path (ThunarStandardView *standard_view,
+                                    GtkTreePath        *path)
+{
+  _thunar_return_if_fail (THUNAR_IS_TREEMAP_VIEW (standard_view));
+  thunar_treemap_set_drop_highlight (THUNAR_TREEMAP (gtk_bin_get_child (GTK_BIN (standard_view))), path);
+}
+
+
+
+static void
+thunar_treemap_view_queue_redraw (ThunarStandardView *standard_view)
+{
+  _thunar_return_if_fail (THUNAR_IS_TREEMAP_VIEW (standard_view));
+  gtk_widget_queue_draw (gtk_bin_get_child (GTK_BIN (standard_view)));
+}
+
+
+
+static void
+thunar_treemap_view_block_selection_changed (ThunarStandardView *view)
+{
+  _thunar_return_if_fail (THUNAR_IS_STANDARD_VIEW (view));
+
+  g_signal_handlers_block_by_func (G_OBJECT (gtk_bin_get_child (GTK_BIN (view))),
+                                   thunar_standard_view_selection_changed, view);
+}
+
+
+
+static void
+thunar_treemap_view_unblock_selection_changed (ThunarStandardView *view)
+{
+  _thunar_return_if_fail (THUNAR_IS_STANDARD_VIEW (view));
+
+  g_signal_handlers_unblock_by_func (G_OBJECT (gtk_bin_get_child (GTK_BIN (view))),
+                                     thunar_standard_view_selection_changed, view);
+}
+
+
+
+static gboolean
+thunar_treemap_view_button_press_event (ThunarTreemap     *treemap,
+                                        GdkEventButton    *event,
+                                        ThunarTreemapView *treemap_view)
+{
+  GtkTreePath *path;
+  GtkWidget   *window;
+
+  /* give focus to the clicked view */
+  window = gtk_widget_get_toplevel (GTK_WIDGET (treemap_view));
+  thunar_window_focus_view (THUNAR_WINDOW (window), GTK_WIDGET (treemap_view));
+
+  if (event->type == GDK_BUTTON_PRESS && event->button == 3)
+    {
+      /* open the context menu on right clicks */
+      path = thunar_treemap_get_path_at_pos (treemap, event->x, event->y);
+      if (path != NULL)
+        {
+          /* select the path on which the user clicked if not selected yet */
+          if (!thunar_treemap_path_is_selected (treemap, path))
+            {
+              /* we don't unselect all other items if Control is active */
+              if ((event->state & GDK_CONTROL_MASK) == 0)
+                thunar_treemap_unselect_all (treemap);
+              thunar_treemap_select_path (treemap, path);
+            }
+          gtk_tree_path_free (path);
+
+          /* queue the menu popup */
+          thunar_standard_view_queue_popup (THUNAR_STANDARD_VIEW (treemap_view), event);
+        }
+      else if ((event->state & gtk_accelerator_get_default_mod_mask ()) == 0)
+        {
+          /* user clicked on an empty area, so we unselect everything
+           * to make sure that the folder context menu is opened.
+           */
+          thunar_treemap_unselect_all (treemap);
+
+          /* open the context menu */
+          thunar_standard_view_context_menu (THUNAR_STANDARD_VIEW (treemap_view));
+        }
+
+      return TRUE;
+    }
+  else if (event->type == GDK_BUTTON_PRESS && event->button == 2)
+    {
+      /* unselect all currently selected items */
+      thunar_treemap_unselect_all (treemap);
+
+      /* determine the path to the item that was middle-clicked */
+      path = thunar_treemap_get_path_at_pos (treemap, event->x, event->y);
+      if (path != NULL)
+        {
+          /* select only the path to the item on which the user clicked */
+          thunar_treemap_select_path (treemap, path);
+
+          /* try to open the path as new window/tab, if possible */
+          _thunar_standard_view_open_on_middle_click (THUNAR_STANDARD_VIEW (treemap_view), path, event->state);
+
+          /* cleanup */
+          gtk_tree_path_free (path);
+        }
+
+      /* don't run the default handler here */
+      return TRUE;
+    }
+
+  return FALSE;
+}
+
+
+
+static void
+thunar_treemap_view_item_activated (ThunarTreemap     *treemap,
+                                    GtkTreePath       *path,
+                                    ThunarTreemapView *treemap_view)
+{
+  GtkWidget *window;
+
+  _thunar_return_if_fail (THUNAR_IS_TREEMAP_VIEW (treemap_view));
+
+  /* make sure only the activated item is selected, folders are
+   * entered through the window, so the history keeps working */
+  thunar_treemap_unselect_all (treemap);
+  thunar_treemap_select_path (treemap, path);
+
+  window = gtk_widget_get_toplevel (GTK_WIDGET (treemap_view));
+  thunar_action_manager_activate_selected_files (thunar_window_get_action_manager (THUNAR_WINDOW (window)), THUNAR_ACTION_MANAGER_CHANGE_DIRECTORY, NULL, TRUE);
+}
@@ -0,0 +1,42 @@
+/* vi:set et ai sw=2 sts=2 ts=2: */
+/*-
+ * Copyright (c) 2026 The Xfce Development Team
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+ * Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef __THUNAR_TREEMAP_VIEW_H__
+#define __THUNAR_TREEMAP_VIEW_H__
+
+#include "thunar/thunar-standard-view.h"
+
+G_BEGIN_DECLS;
+
+typedef struct _ThunarTreemapViewClass ThunarTreemapViewClass;
+typedef struct _ThunarTreemapView      ThunarTreemapView;
+
+#define THUNAR_TYPE_TREEMAP_VIEW (thunar_treemap_view_get_type ())
+#define THUNAR_TREEMAP_VIEW(obj) (G_TYPE_CHECK_INSTANCE_CAST ((obj), THUNAR_TYPE_TREEMAP_VIEW, ThunarTreemapView))
+#define THUNAR_TREEMAP_VIEW_CLASS(klass) (G_TYPE_CHECK_CLASS_CAST ((klass), THUNAR_TYPE_TREEMAP_VIEW, ThunarTreemapViewClass))
+#define THUNAR_IS_TREEMAP_VIEW(obj) (G_TYPE_CHECK_INSTANCE_TYPE ((obj), THUNAR_TYPE_TREEMAP_VIEW))
+#define THUNAR_IS_TREEMAP_VIEW_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), THUNAR_TYPE_TREEMAP_VIEW))
+#define THUNAR_TREEMAP_VIEW_GET_CLASS(obj) (G_TYPE_INSTANCE_GET_CLASS ((obj), THUNAR_TYPE_TREEMAP_VIEW, ThunarTreemapViewClass))
+
+GType
+thunar_treemap_view_get_type (void);
+
+G_END_DECLS;
+
+#endif /* !__THUNAR_TREEMAP_VIEW_H__ */
@@ -0,0 +1,1347 @@
+/* vi:set et ai sw=2 sts=2 ts=2: */
+/*-
+ * Copyright (c) 2026 The Xfce Development Team
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+ * Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "thunar/thunar-enum-types.h"
+#include "thunar/thunar-file.h"
+#include "thunar/thunar-private.h"
+#include "thunar/thunar-size-engine.h"
+#include "thunar/thunar-tree-view-model.h"
+#include "thunar/thunar-treemap.h"
+
+#include <libxfce4util/libxfce4util.h>
+
+
+
+/* Property identifiers */
+enum
+{
+  PROP_0,
+  PROP_MODEL,
+  PROP_SINGLE_CLICK,
+  PROP_SINGLE_CLICK_TIMEOUT,
+  PROP_HADJUSTMENT,
+  PROP_VADJUSTMENT,
+  PROP_HSCROLL_POLICY,
+  PROP_VSCROLL_POLICY,
+};
+
+/* Signal identifiers */
+enum
+{
+  ITEM_ACTIVATED,
+  SELECTION_CHANGED,
+  LAST_SIGNAL,
+};
+
+/* minimum interval in ms between two layouts while folders are counted */
+#define THUNAR_TREEMAP_RELAYOUT_INTERVAL 250
+
+/* tiles smaller than this (in pixels) don't get a label */
+#define THUNAR_TREEMAP_LABEL_MIN_WIDTH  48
+#define THUNAR_TREEMAP_LABEL_MIN_HEIGHT 20
+
+
+
+typedef struct _ThunarTreemapItem ThunarTreemapItem;
+
+
+
+static void
+thunar_treemap_finalize (GObject *object);
+static void
+thunar_treemap_get_property (GObject    *object,
+                             guint       prop_id,
+                             GValue     *value,
+                             GParamSpec *pspec);
+static void
+thunar_treemap_set_property (GObject      *object,
+                             guint         prop_id,
+                             const GValue *value,
+                             GParamSpec   *pspec);
+static void
+thunar_treemap_realize (GtkWidget *widget);
+static void
+thunar_treemap_size_allocate (GtkWidget     *widget,
+                              GtkAllocation *allocation);
+static gboolean
+thunar_treemap_draw (GtkWidget *widget,
+                     cairo_t   *cr);
+static gboolean
+thunar_treemap_button_press_event (GtkWidget      *widget,
+                                   GdkEventButton *event);
+static gboolean
+thunar_treemap_button_release_event (GtkWidget      *widget,
+                                     GdkEventButton *event);
+static gboolean
+thunar_treemap_query_tooltip (GtkWidget  *widget,
+                              gint        x,
+                              gint        y,
+                              gboolean    keyboard_mode,
+                              GtkTooltip *tooltip);
+static void
+thunar_treemap_set_model (ThunarTreemap *treemap,
+                          GtkTreeModel  *model);
+static void
+thunar_treemap_set_adjustment (ThunarTreemap  *treemap,
+                               GtkAdjustment **adjustment_return,
+                               GtkAdjustment  *adjustment);
+static void
+thunar_treemap_update_adjustments (ThunarTreemap *treemap);
+static void
+thunar_treemap_folder_changed (ThunarTreemap *treemap);
+static void
+thunar_treemap_queue_rebuild (ThunarTreemap *treemap);
+static gboolean
+thunar_treemap_rebuild (gpointer user_data);
+static void
+thunar_treemap_queue_layout (ThunarTreemap *treemap);
+static gboolean
+thunar_treemap_layout_timeout (gpointer user_data);
+static void
+thunar_treemap_layout (ThunarTreemap *treemap);
+static gint
+thunar_treemap_item_at_pos (ThunarTreemap *treemap,
+                            gdouble        x,
+                            gdouble        y);
+
+
+
+struct _ThunarTreemapClass
+{
+  GtkWidgetClass __parent__;
+};
+
+struct _ThunarTreemap
+{
+  GtkWidget __parent__;
+
+  GtkTreeModel *model;
+
+  /* the toplevel rows of the model, in model order */
+  GArray *items;
+
+  /* selected #ThunarFile<!---->s, survives rebuilds of the items */
+  GHashTable *selection;
+
+  /* counts the folders in the background */
+  ThunarSizeEngine *size_engine;
+
+  guint rebuild_idle_id;
+  guint layout_timeout_id;
+  gboolean layout_pending;
+
+  /* row which is highlighted as drop target, -1 if none */
+  gint drop_highlight;
+
+  /* item under the pointer on button press, for single-click activation */
+  gint     press_item;
+  gboolean single_click;
+  guint    single_click_timeout;
+
+  /* the view is never scrolled, but a GtkScrolledWindow needs a GtkScrollable */
+  GtkAdjustment *hadjustment;
+  GtkAdjustment *vadjustment;
+};
+
+struct _ThunarTreemapItem
+{
+  ThunarFile *file;
+
+  /* size used for the layout, and whether it is still being counted */
+  gint64   size;
+  gboolean counting;
+
+  /* tile of the item in widget coordinates, empty if too small */
+  gdouble x, y, width, height;
+};
+
+
+
+static guint treemap_signals[LAST_SIGNAL];
+
+
+
+G_DEFINE_TYPE_WITH_CODE (ThunarTreemap, thunar_treemap, GTK_TYPE_WIDGET, G_IMPLEMENT_INTERFACE (GTK_TYPE_SCROLLABLE, NULL))
+
+
+
+static void
+thunar_treemap_class_init (ThunarTreemapClass *klass)
+{
+  GtkWidgetClass *gtkwidget_class;
+  GObjectClass   *gobject_class;
+
+  gobject_class = G_OBJECT_CLASS (klass);
+  gobject_class->finalize = thunar_treemap_finalize;
+  gobject_class->get_property = thunar_treemap_get_property;
+  gobject_class->set_property = thunar_treemap_set_property;
+
+  gtkwidget_class = GTK_WIDGET_CLASS (klass);
+  gtkwidget_class->realize = thunar_treemap_realize;
+  gtkwidget_class->size_allocate = thunar_treemap_size_allocate;
+  gtkwidget_class->draw = thunar_treemap_draw;
+  gtkwidget_class->button_press_event = thunar_treemap_button_press_event;
+  gtkwidget_class->button_release_event = thunar_treemap_button_release_event;
+  gtkwidget_class->query_tooltip = thunar_treemap_query_tooltip;
+
+  /**
+   * ThunarTreemap:model:
+   *
+   * The #ThunarTreeViewModel whose toplevel rows are shown.
+   **/
+  g_object_class_install_property (gobject_class,
+                                   PROP_MODEL,
+                                   g_param_spec_object ("model", "model", "model",
+                                                        GTK_TYPE_TREE_MODEL,
+                                                        G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * ThunarTreemap:single-click:
+   *
+   * Whether items are activated with a single click.
+   **/
+  g_object_class_install_property (gobject_class,
+                                   PROP_SINGLE_CLICK,
+                                   g_param_spec_boolean ("single-click", "single-click", "single-click",
+                                                         FALSE,
+                                                         G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * ThunarTreemap:single-click-timeout:
+   *
+   * Unused, the treemap does not select items on hover.
+   **/
+  g_object_class_install_property (gobject_class,
+                                   PROP_SINGLE_CLICK_TIMEOUT,
+                                   g_param_spec_uint ("single-click-timeout", "single-click-timeout", "single-click-timeout",
+                                                      0, G_MAXUINT, 0,
+                                                      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_override_property (gobject_class, PROP_HADJUSTMENT, "hadjustment");
+  g_object_class_override_property (gobject_class, PROP_VADJUSTMENT, "vadjustment");
+  g_object_class_override_property (gobject_class, PROP_HSCROLL_POLICY, "hscroll-policy");
+  g_object_class_override_property (gobject_class, PROP_VSCROLL_POLICY, "vscroll-policy");
+
+  /**
+   * ThunarTreemap::item-activated:
+   * @treemap : a #ThunarTreemap.
+   * @path    : the #GtkTreePath of the activated item.
+   *
+   * Emitted when an item is double clicked, or clicked once
+   * in single-click mode.
+   **/
+  treemap_signals[ITEM_ACTIVATED] =
+  g_signal_new (I_ ("item-activated"),
+                G_TYPE_FROM_CLASS (klass),
+                G_SIGNAL_RUN_LAST,
+                0, NULL, NULL,
+                g_cclosure_marshal_VOID__BOXED,
+                G_TYPE_NONE, 1, GTK_TYPE_TREE_PATH);
+
+  /**
+   * ThunarTreemap::selection-changed:
+   * @treemap : a #ThunarTreemap.
+   *
+   * Emitted whenever the set of selected items changes.
+   **/
+  treemap_signals[SELECTION_CHANGED] =
+  g_signal_new (I_ ("selection-changed"),
+                G_TYPE_FROM_CLASS (klass),
+                G_SIGNAL_RUN_LAST,
+                0, NULL, NULL,
+                g_cclosure_marshal_VOID__VOID,
+                G_TYPE_NONE, 0);
+}
+
+
+
+static void
+thunar_treemap_init (ThunarTreemap *treemap)
+{
+  gtk_widget_set_has_window (GTK_WIDGET (treemap), TRUE);
+  gtk_widget_set_can_focus (GTK_WIDGET (treemap), TRUE);
+  gtk_widget_set_has_tooltip (GTK_WIDGET (treemap), TRUE);
+
+  treemap->items = g_array_new (FALSE, TRUE, sizeof (ThunarTreemapItem));
+  treemap->selection = g_hash_table_new_full (g_direct_hash, g_direct_equal, g_object_unref, NULL);
+  treemap->drop_highlight = -1;
+  treemap->press_item = -1;
+
+  treemap->size_engine = thunar_size_engine_new ();
+  g_signal_connect_swapped (treemap->size_engine, "file-progress", G_CALLBACK (thunar_treemap_queue_layout), treemap);
+  g_signal_connect_swapped (treemap->size_engine, "file-sized", G_CALLBACK (thunar_treemap_queue_layout), treemap);
+}
+
+
+
+static void
+thunar_treemap_clear_items (ThunarTreemap *treemap)
+{
+  guint n;
+
+  for (n = 0; n < treemap->items->len; n++)
+    if (g_array_index (treemap->items, ThunarTreemapItem, n).file != NULL)
+      g_object_unref (g_array_index (treemap->items, ThunarTreemapItem, n).file);
+  g_array_set_size (treemap->items, 0);
+}
+
+
+
+static void
+thunar_treemap_finalize (GObject *object)
+{
+  ThunarTreemap *treemap = THUNAR_TREEMAP (object);
+
+  if (treemap->model != NULL)
+    {
+      g_signal_handlers_disconnect_by_data (treemap->model, treemap);
+      g_object_unref (treemap->model);
+    }
+
+  if (treemap->rebuild_idle_id != 0)
+    g_source_remove (treemap->rebuild_idle_id);
+  if (treemap->layout_timeout_id != 0)
+    g_source_remove (treemap->layout_timeout_id);
+
+  g_signal_handlers_disconnect_by_data (treemap->size_engine, treemap);
+  g_object_unref (treemap->size_engine);
+
+  thunar_treemap_clear_items (treemap);
+  g_array_free (treemap->items, TRUE);
+  g_hash_table_destroy (treemap->selection);
+
+  g_clear_object (&treemap->hadjustment);
+  g_clear_object (&treemap->vadjustment);
+
+  (*G_OBJECT_CLASS (thunar_treemap_parent_class)->finalize) (object);
+}
+
+
+
+static void
+thunar_treemap_get_property (GObject    *object,
+                             guint       prop_id,
+                             GValue     *value,
+                             GParamSpec *pspec)
+{
+  ThunarTreemap *treemap = THUNAR_TREEMAP (object);
+
+  switch (prop_id)
+    {
+    case PROP_MODEL:
+      g_value_set_object (value, treemap->model);
+      break;
+
+    case PROP_SINGLE_CLICK:
+      g_value_set_boolean (value, treemap->single_click);
+      break;
+
+    case PROP_SINGLE_CLICK_TIMEOUT:
+      g_value_set_uint (value, treemap->single_click_timeout);
+      break;
+
+    case PROP_HADJUSTMENT:
+      g_value_set_object (value, treemap->hadjustment);
+      break;
+
+    case PROP_VADJUSTMENT:
+      g_value_set_object (value, treemap->vadjustment);
+      break;
+
+    case PROP_HSCROLL_POLICY:
+    case PROP_VSCROLL_POLICY:
+      g_value_set_enum (value, GTK_SCROLL_MINIMUM);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+    }
+}
+
+
+
+static void
+thunar_treemap_set_property (GObject      *object,
+                             guint         prop_id,
+                             const GValue *value,
+                             GParamSpec   *pspec)
+{
+  ThunarTreemap *treemap = THUNAR_TREEMAP (object);
+
+  switch (prop_id)
+    {
+    case PROP_MODEL:
+      thunar_treemap_set_model (treemap, g_value_get_object (value));
+      break;
+
+    case PROP_SINGLE_CLICK:
+      treemap->single_click = g_value_get_boolean (value);
+      break;
+
+    case PROP_SINGLE_CLICK_TIMEOUT:
+      treemap->single_click_timeout = g_value_get_uint (value);
+      break;
+
+    case PROP_HADJUSTMENT:
+      thunar_treemap_set_adjustment (treemap, &treemap->hadjustment, g_value_get_object (value));
+      break;
+
+    case PROP_VADJUSTMENT:
+      thunar_treemap_set_adjustment (treemap, &treemap->vadjustment, g_value_get_object (value));
+      break;
+
+    case PROP_HSCROLL_POLICY:
+    case PROP_VSCROLL_POLICY:
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+    }
+}
+
+
+
+static void
+thunar_treemap_realize (GtkWidget *widget)
+{
+  GdkWindowAttr attributes;
+  GtkAllocation allocation;
+  GdkWindow    *window;
+
+  gtk_widget_set_realized (widget, TRUE);
+  gtk_widget_get_allocation (widget, &allocation);
+
+  attributes.window_type = GDK_WINDOW_CHILD;
+  attributes.x = allocation.x;
+  attributes.y = allocation.y;
+  attributes.width = allocation.width;
+  attributes.height = allocation.height;
+  attributes.wclass = GDK_INPUT_OUTPUT;
+  attributes.visual = gtk_widget_get_visual (widget);
+  attributes.event_mask = gtk_widget_get_events (widget)
+                          | GDK_EXPOSURE_MASK
+                          | GDK_BUTTON_PRESS_MASK
+                          | GDK_BUTTON_RELEASE_MASK
+                          | GDK_POINTER_MOTION_MASK
+                          | GDK_SCROLL_MASK
+                          | GDK_SMOOTH_SCROLL_MASK
+                          | GDK_KEY_PRESS_MASK
+                          | GDK_KEY_RELEASE_MASK;
+
+  window = gdk_window_new (gtk_widget_get_parent_window (widget), &attributes, GDK_WA_X | GDK_WA_Y | GDK_WA_VISUAL);
+  gtk_widget_set_window (widget, window);
+  gtk_widget_register_window (widget, window);
+}
+
+
+
+static void
+thunar_treemap_size_allocate (GtkWidget     *widget,
+                              GtkAllocation *allocation)
+{
+  ThunarTreemap *treemap = THUNAR_TREEMAP (widget);
+
+  gtk_widget_set_allocation (widget, allocation);
+
+  if (gtk_widget_get_realized (widget))
+    gdk_window_move_resize (gtk_widget_get_window (widget), allocation->x, allocation->y, allocation->width, allocation->height);
+
+  thunar_treemap_update_adjustments (treemap);
+  thunar_treemap_layout (treemap);
+}
+
+
+
+static void
+thunar_treemap_item_color (ThunarTreemapItem *item,
+                           GdkRGBA           *color)
+{
+  const gchar *content_type;
+  gdouble      hue;
+  gdouble      saturation;
+  gdouble      r, g, b;
+
+  /* folders share one color, files are colored by their type */
+  if (thunar_file_is_directory (item->file))
+    {
+      hue = 0.6;
+      saturation = 0.35;
+    }
+  else
+    {
+      content_type = thunar_file_get_content_type (item->file);
+      hue = (content_type != NULL) ? (g_str_hash (content_type) % 360) / 360.0 : 0.0;
+      saturation = (content_type != NULL) ? 0.45 : 0.0;
+    }
+
+  gtk_hsv_to_rgb (hue, saturation, 0.85, &r, &g, &b);
+  color->red = r;
+  color->green = g;
+  color->blue = b;
+
+  /* folders still being counted are drawn faded */
+  color->alpha = item->counting ? 0.5 : 1.0;
+}
+
+
+
+static gboolean
+thunar_treemap_draw (GtkWidget *widget,
+                     cairo_t   *cr)
+{
+  ThunarTreemap     *treemap = THUNAR_TREEMAP (widget);
+  ThunarTreemapItem *item;
+  GtkStyleContext   *context;
+  PangoLayout       *layout;
+  GdkRectangle       clip;
+  GdkRGBA            color;
+  GdkRGBA            selected_color;
+  gboolean           file_size_binary = FALSE;
+  gchar             *size_string;
+  gchar             *text;
+  guint              n;
+
+  context = gtk_widget_get_style_context (widget);
+  gtk_render_background (context, cr, 0, 0, gtk_widget_get_allocated_width (widget), gtk_widget_get_allocated_height (widget));
+
+  if (!gtk_style_context_lookup_color (context, "theme_selected_bg_color", &selected_color))
+    gdk_rgba_parse (&selected_color, "#3584e4");
+
+  if (THUNAR_IS_TREE_VIEW_MODEL (treemap->model))
+    file_size_binary = thunar_tree_view_model_get_file_size_binary (THUNAR_TREE_VIEW_MODEL (treemap->model));
+
+  if (!gdk_cairo_get_clip_rectangle (cr, &clip))
+    return FALSE;
+
+  layout = gtk_widget_create_pango_layout (widget, NULL);
+  pango_layout_set_ellipsize (layout, PANGO_ELLIPSIZE_MIDDLE);
+
+  cairo_set_line_width (cr, 1.0);
+
+  for (n = 0; n < treemap->items->len; n++)
+    {
+      item = &g_array_index (treemap->items, ThunarTreemapItem, n);
+
+      /* skip tiles that are invisible or outside the area to redraw */
+      if (item->width < 1.0 || item->height < 1.0
+          || item->x > clip.x + clip.width || item->x + item->width < clip.x
+          || item->y > clip.y + clip.height || item->y + item->height < clip.y)
+        continue;
+
+      thunar_treemap_item_color (item, &color);
+      gdk_cairo_set_source_rgba (cr, &color);
+      cairo_rectangle (cr, item->x, item->y, item->width, item->height);
+      cairo_fill_preserve (cr);
+      cairo_set_source_rgba (cr, 0.0, 0.0, 0.0, 0.35);
+      cairo_stroke (cr);
+
+      if (g_hash_table_contains (treemap->selection, item->file) || (gint) n == treemap->drop_highlight)
+        {
+          gdk_cairo_set_source_rgba (cr, &selected_color);
+          cairo_set_line_width (cr, 3.0);
+          cairo_rectangle (cr, item->x + 1.5, item->y + 1.5, MAX (item->width - 3.0, 0.0), MAX (item->height - 3.0, 0.0));
+          cairo_stroke (cr);
+          cairo_set_line_width (cr, 1.0);
+        }
+
+      if (item->width < THUNAR_TREEMAP_LABEL_MIN_WIDTH || item->height < THUNAR_TREEMAP_LABEL_MIN_HEIGHT)
+        continue;
+
+      /* name and size, the size only if there is room for a second line */
+      size_string = g_format_size_full (item->size, file_size_binary ? G_FORMAT_SIZE_IEC_UNITS : G_FORMAT_SIZE_DEFAULT);
+      if (item->height >= 2 * THUNAR_TREEMAP_LABEL_MIN_HEIGHT)
+        text = g_strdup_printf ("%s\n%s", thunar_file_get_display_name (item->file), size_string);
+      else
+        text = g_strdup (thunar_file_get_display_name (item->file));
+      g_free (size_string);
+
+      pango_layout_set_text (layout, text, -1);
+      pango_layout_set_width (layout, (item->width - 8) * PANGO_SCALE);
+      pango_layout_set_height (layout, (item->height - 4) * PANGO_SCALE);
+      g_free (text);
+
+      cairo_save (cr);
+      cairo_rectangle (cr, item->x, item->y, item->width, item->height);
+      cairo_clip (cr);
+      cairo_set_source_rgba (cr, 0.0, 0.0, 0.0, 0.87);
+      cairo_move_to (cr, item->x + 4, item->y + 2);
+      pango_cairo_show_layout (cr, layout);
+      cairo_restore (cr);
+    }
+
+  g_object_unref (layout);
+
+  return FALSE;
+}
+
+
+
+static gboolean
+thunar_treemap_button_press_event (GtkWidget      *widget,
+                                   GdkEventButton *event)
+{
+  ThunarTreemap *treemap = THUNAR_TREEMAP (widget);
+  ThunarFile    *file;
+  GtkTreePath   *path;
+  gint           n;
+
+  if (!gtk_widget_has_focus (widget))
+    gtk_widget_grab_focus (widget);
+
+  if (event->button != 1)
+    return FALSE;
+
+  n = thunar_treemap_item_at_pos (treemap, event->x, event->y);
+
+  if (event->type == GDK_2BUTTON_PRESS)
+    {
+      if (n >= 0 && !treemap->single_click)
+        {
+          path = gtk_tree_path_new_from_indices (n, -1);
+          g_signal_emit (treemap, treemap_signals[ITEM_ACTIVATED], 0, path);
+          gtk_tree_path_free (path);
+        }
+      return TRUE;
+    }
+
+  if (event->type != GDK_BUTTON_PRESS)
+    return FALSE;
+
+  treemap->press_item = n;
+
+  if (n < 0)
+    {
+      /* clicks on empty areas clear the selection */
+      if ((event->state & (GDK_CONTROL_MASK | GDK_SHIFT_MASK)) == 0)
+        thunar_treemap_unselect_all (treemap);
+      return TRUE;
+    }
+
+  file = g_array_index (treemap->items, ThunarTreemapItem, n).file;
+  if ((event->state & GDK_CONTROL_MASK) != 0)
+    {
+      /* toggle the clicked item */
+      if (!g_hash_table_remove (treemap->selection, file))
+        g_hash_table_add (treemap->selection, g_object_ref (file));
+    }
+  else if ((event->state & GDK_SHIFT_MASK) == 0 && !g_hash_table_contains (treemap->selection, file))
+    {
+      /* keep a selection the user is about to drag */
+      g_hash_table_remove_all (treemap->selection);
+      g_hash_table_add (treemap->selection, g_object_ref (file));
+    }
+  else if (!g_hash_table_contains (treemap->selection, file))
+    g_hash_table_add (treemap->selection, g_object_ref (file));
+
+  gtk_widget_queue_draw (widget);
+  g_signal_emit (treemap, treemap_signals[SELECTION_CHANGED], 0);
+
+  /* let the drag source see the press */
+  return FALSE;
+}
+
+
+
+static gboolean
+thunar_treemap_button_release_event (GtkWidget      *widget,
+                                     GdkEventButton *event)
+{
+  ThunarTreemap *treemap = THUNAR_TREEMAP (widget);
+  GtkTreePath   *path;
+  gint           n;
+
+  if (event->button != 1 || treemap->press_item < 0)
+    return FALSE;
+
+  n = thunar_treemap_item_at_pos (treemap, event->x, event->y);
+  if (n != treemap->press_item)
+    return FALSE;
+
+  if (treemap->single_click && (event->state & gtk_accelerator_get_default_mod_mask ()) == 0)
+    {
+      path = gtk_tree_path_new_from_indices (n, -1);
+      g_signal_emit (treemap, treemap_signals[ITEM_ACTIVATED], 0, path);
+      gtk_tree_path_free (path);
+    }
+  else if ((event->state & gtk_accelerator_get_default_mod_mask ()) == 0
+           && g_hash_table_size (treemap->selection) > 1)
+    {
+      /* a plain click on a multi-selection that was not dragged selects just that item */
+      g_hash_table_remove_all (treemap->selection);
+      g_hash_table_add (treemap->selection, g_object_ref (g_array_index (treemap->items, ThunarTreemapItem, n).file));
+      gtk_widget_queue_draw (widget);
+      g_signal_emit (treemap, treemap_signals[SELECTION_CHANGED], 0);
+    }
+
+  treemap->press_item = -1;
+
+  return FALSE;
+}
+
+
+
+static gboolean
+thunar_treemap_query_tooltip (GtkWidget  *widget,
+                              gint        x,
+                              gint        y,
+                              gboolean    keyboard_mode,
+                              GtkTooltip *tooltip)
+{
+  ThunarTreemap     *treemap = THUNAR_TREEMAP (widget);
+  ThunarTreemapItem *item;
+  gboolean           file_size_binary = FALSE;
+  gchar             *size_string;
+  gchar             *text;
+  gint               n;
+
+  n = thunar_treemap_item_at_pos (treemap, x, y);
+  if (n < 0)
+    return FALSE;
+
+  if (THUNAR_IS_TREE_VIEW_MODEL (treemap->model))
+    file_size_binary = thunar_tree_view_model_get_file_size_binary (THUNAR_TREE_VIEW_MODEL (treemap->model));
+
+  item = &g_array_index (treemap->items, ThunarTreemapItem, n);
+  size_string = g_format_size_full (item->size, file_size_binary ? G_FORMAT_SIZE_IEC_UNITS : G_FORMAT_SIZE_DEFAULT);
+  if (item->counting)
+    /* TRANSLATORS: the size of a folder that is still being counted, e.g. "at least 3.2 GB" */
+    text = g_strdup_printf (_("%s\nat least %s"), thunar_file_get_display_name (item->file), size_string);
+  else
+    text = g_strdup_printf ("%s\n%s", thunar_file_get_display_name (item->file), size_string);
+  gtk_tooltip_set_text (tooltip, text);
+  g_free (size_string);
+  g_free (text);
+
+  return TRUE;
+}
+
+
+
+static void
+thunar_treemap_set_model (ThunarTreemap *treemap,
+                          GtkTreeModel  *model)
+{
+  if (treemap->model == model)
+    return;
+
+  if (treemap->model != NULL)
+    {
+      g_signal_handlers_disconnect_by_data (treemap->model, treemap);
+      g_object_unref (treemap->model);
+    }
+
+  treemap->model = model;
+
+  if (model != NULL)
+    {
+      g_object_ref (model);
+      g_signal_connect_swapped (model, "row-inserted", G_CALLBACK (thunar_treemap_queue_rebuild), treemap);
+      g_signal_connect_swapped (model, "row-deleted", G_CALLBACK (thunar_treemap_queue_rebuild), treemap);
+      g_signal_connect_swapped (model, "row-changed", G_CALLBACK (thunar_treemap_queue_rebuild), treemap);
+      g_signal_connect_swapped (model, "rows-reordered", G_CALLBACK (thunar_treemap_queue_rebuild), treemap);
+      g_signal_connect_swapped (model, "notify::folder", G_CALLBACK (thunar_treemap_folder_changed), treemap);
+    }
+
+  thunar_size_engine_clear (treemap->size_engine);
+
+  /* the paths of the items change with the model, rebuild right away */
+  if (treemap->rebuild_idle_id != 0)
+    g_source_remove (treemap->rebuild_idle_id);
+  treemap->rebuild_idle_id = 0;
+  thunar_treemap_rebuild (treemap);
+
+  g_object_notify (G_OBJECT (treemap), "model");
+}
+
+
+
+static void
+thunar_treemap_set_adjustment (ThunarTreemap  *treemap,
+                               GtkAdjustment **adjustment_return,
+                               GtkAdjustment  *adjustment)
+{
+  if (*adjustment_return == adjustment)
+    return;
+
+  g_clear_object (adjustment_return);
+  if (adjustment != NULL)
+    *adjustment_return = g_object_ref_sink (adjustment);
+
+  thunar_treemap_update_adjustments (treemap);
+}
+
+
+
+/* the treemap always fits into the allocation, so there is nothing to scroll */
+static void
+thunar_treemap_update_adjustments (ThunarTreemap *treemap)
+{
+  gint width = gtk_widget_get_allocated_width (GTK_WIDGET (treemap));
+  gint height = gtk_widget_get_allocated_height (GTK_WIDGET (treemap));
+
+  if (treemap->hadjustment != NULL)
+    gtk_adjustment_configure (treemap->hadjustment, 0, 0, width, 1, width, width);
+  if (treemap->vadjustment != NULL)
+    gtk_adjustment_configure (treemap->vadjustment, 0, 0, height, 1, height, height);
+}
+
+
+
+static void
+thunar_treemap_folder_changed (ThunarTreemap *treemap)
+{
+  /* forget the counts of the previous folder */
+  thunar_size_engine_clear (treemap->size_engine);
+  thunar_treemap_queue_rebuild (treemap);
+}
+
+
+
+static void
+thunar_treemap_queue_rebuild (ThunarTreemap *treemap)
+{
+  /* rows change in bursts while a folder is loaded */
+  if (treemap->rebuild_idle_id == 0)
+    treemap->rebuild_idle_id = g_idle_add_full (G_PRIORITY_LOW, thunar_treemap_rebuild, treemap, NULL);
+}
+
+
+
+static gboolean
+thunar_treemap_rebuild (gpointer user_data)
+{
+  ThunarTreemap    *treemap = THUNAR_TREEMAP (user_data);
+  ThunarTreemapItem item = { NULL, 0, FALSE, 0.0, 0.0, 0.0, 0.0 };
+  GHashTableIter    iter;
+  GHashTable       *files;
+  GtkTreeIter       tree_iter;
+  ThunarFile       *file;
+  GList            *directories = NULL;
+  gboolean          selection_changed = FALSE;
+  gboolean          valid;
+
+  treemap->rebuild_idle_id = 0;
+
+  thunar_treemap_clear_items (treemap);
+  treemap->drop_highlight = -1;
+  treemap->press_item = -1;
+
+  files = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+  valid = (treemap->model != NULL) && gtk_tree_model_iter_children (treemap->model, &tree_iter, NULL);
+  for (; valid; valid = gtk_tree_model_iter_next (treemap->model, &tree_iter))
+    {
+      gtk_tree_model_get (treemap->model, &tree_iter, THUNAR_COLUMN_FILE, &file, -1);
+
+      /* the model has a placeholder row while loading, keep the
+       * indices in sync with the rows nevertheless */
+      item.file = file;
+      g_array_append_val (treemap->items, item);
+      if (file == NULL)
+        continue;
+
+      g_hash_table_add (files, file);
+      if (thunar_file_is_directory (file))
+        directories = g_list_prepend (directories, file);
+    }
+
+  /* drop selected files which are gone */
+  g_hash_table_iter_init (&iter, treemap->selection);
+  while (g_hash_table_iter_next (&iter, (gpointer *) &file, NULL))
+    if (!g_hash_table_contains (files, file))
+      {
+        g_hash_table_iter_remove (&iter);
+        selection_changed = TRUE;
+      }
+
+  /* count all folders, the engine skips those already counted */
+  thunar_size_engine_request (treemap->size_engine, g_list_reverse (directories));
+  g_list_free (directories);
+  g_hash_table_destroy (files);
+
+  thunar_treemap_layout (treemap);
+
+  if (selection_changed)
+    g_signal_emit (treemap, treemap_signals[SELECTION_CHANGED], 0);
+
+  return G_SOURCE_REMOVE;
+}
+
+
+
+static void
+thunar_treemap_queue_layout (ThunarTreemap *treemap)
+{
+  /* partial sizes arrive several times a second for every folder,
+   * so the layout is rate-limited while counting */
+  if (treemap->layout_timeout_id == 0)
+    {
+      thunar_treemap_layout (treemap);
+      treemap->layout_timeout_id = g_timeout_add (THUNAR_TREEMAP_RELAYOUT_INTERVAL, thunar_treemap_layout_timeout, treemap);
+    }
+  else
+    treemap->layout_pending = TRUE;
+}
+
+
+
+static gboolean
+thunar_treemap_layout_timeout (gpointer user_data)
+{
+  ThunarTreemap *treemap = THUNAR_TREEMAP (user_data);
+
+  if (treemap->layout_pending)
+    {
+      treemap->layout_pending = FALSE;
+      thunar_treemap_layout (treemap);
+      return G_SOURCE_CONTINUE;
+    }
+
+  treemap->layout_timeout_id = 0;
+  return G_SOURCE_REMOVE;
+}
+
+
+
+static gint
+thunar_treemap_compare_items (gconstpointer a,
+                              gconstpointer b,
+                              gpointer      user_data)
+{
+  const ThunarTreemapItem *item_a = *(ThunarTreemapItem *const *) a;
+  const ThunarTreemapItem *item_b = *(ThunarTreemapItem *const *) b;
+
+  /* largest first */
+  if (item_a->size > item_b->size)
+    return -1;
+  else if (item_a->size < item_b->size)
+    return 1;
+  return 0;
+}
+
+
+
+/* the worst aspect ratio of a row of tiles along a side of length @side,
+ * for a row with the total area @sum and the largest and smallest
+ * areas @max and @min */
+static gdouble
+thunar_treemap_worst_ratio (gdouble side,
+                            gdouble sum,
+                            gdouble max,
+                            gdouble min)
+{
+  gdouble side2 = side * side;
+  gdouble sum2 = sum * sum;
+
+  return MAX ((side2 * max) / sum2, sum2 / (side2 * min));
+}
+
+
+
+/* squarified treemap layout (Bruls, Huizing, van Wijk), @items must be
+ * sorted by size, largest first */
+static void
+thunar_treemap_squarify (ThunarTreemapItem **items,
+                         guint               n_items,
+                         gdouble             total,
+                         gdouble             x,
+                         gdouble             y,
+                         gdouble             width,
+                         gdouble             height)
+{
+  gdouble scale;
+  gdouble side;
+  gdouble sum;
+  gdouble worst;
+  gdouble next_worst;
+  gdouble area;
+  gdouble thickness;
+  gdouble offset;
+  guint   start;
+  guint   end;
+  guint   n;
+
+  if (n_items == 0 || total <= 0.0 || width <= 0.0 || height <= 0.0)
+    return;
+
+  /* converts a size into an area in pixels */
+  scale = (width * height) / total;
+
+  for (start = 0; start < n_items; start = end)
+    {
+      /* the remaining items are too small to be seen */
+      if (width < 1.0 || height < 1.0)
+        break;
+
+      side = MIN (width, height);
+
+      /* grow the row as long as its worst aspect ratio improves */
+      sum = items[start]->size * scale;
+      worst = thunar_treemap_worst_ratio (side, sum, sum, sum);
+      for (end = start + 1; end < n_items; end++)
+        {
+          area = items[end]->size * scale;
+          next_worst = thunar_treemap_worst_ratio (side, sum + area, items[start]->size * scale, area);
+          if (next_worst > worst)
+            break;
+          sum += area;
+          worst = next_worst;
+        }
+
+      /* place the row along the shorter side of the remaining rectangle */
+      thickness = sum / side;
+      offset = 0.0;
+      for (n = start; n < end; n++)
+        {
+          area = items[n]->size * scale;
+          if (width >= height)
+            {
+              items[n]->x = x;
+              items[n]->y = y + offset;
+              items[n]->width = thickness;
+              items[n]->height = area / thickness;
+              offset += items[n]->height;
+            }
+          else
+            {
+              items[n]->x = x + offset;
+              items[n]->y = y;
+              items[n]->width = area / thickness;
+              items[n]->height = thickness;
+              offset += items[n]->width;
+            }
+        }
+
+      if (width >= height)
+        {
+          x += thickness;
+          width -= thickness;
+        }
+      else
+        {
+          y += thickness;
+          height -= thickness;
+        }
+    }
+}
+
+
+
+static void
+thunar_treemap_layout (ThunarTreemap *treemap)
+{
+  ThunarTreemapItem  *item;
+  ThunarTreemapItem **sorted;
+  gint64              partial_size;
+  gdouble             total = 0.0;
+  guint               n_sorted = 0;
+  guint               n;
+
+  sorted = g_new (ThunarTreemapItem *, MAX (treemap->items->len, 1));
+
+  for (n = 0; n < treemap->items->len; n++)
+    {
+      item = &g_array_index (treemap->items, ThunarTreemapItem, n);
+      item->x = item->y = item->width = item->height = 0.0;
+
+      if (item->file == NULL)
+        continue;
+
+      /* folders counted before keep their size while they are counted again */
+      item->size = thunar_file_get_total_size (item->file);
+      partial_size = thunar_size_engine_get_partial_size (treemap->size_engine, item->file);
+      item->counting = (item->size < 0 && partial_size >= 0);
+      if (item->size < 0)
+        item->size = MAX (partial_size, 0);
+
+      if (item->size > 0)
+        {
+          sorted[n_sorted++] = item;
+          total += item->size;
+        }
+    }
+
+  g_qsort_with_data (sorted, n_sorted, sizeof (ThunarTreemapItem *), thunar_treemap_compare_items, NULL);
+
+  thunar_treemap_squarify (sorted, n_sorted, total, 0.0, 0.0,
+                           gtk_widget_get_allocated_width (GTK_WIDGET (treemap)),
+                           gtk_widget_get_allocated_height (GTK_WIDGET (treemap)));
+
+  g_free (sorted);
+
+  gtk_widget_queue_draw (GTK_WIDGET (treemap));
+}
+
+
+
+static gint
+thunar_treemap_item_at_pos (ThunarTreemap *treemap,
+                            gdouble        x,
+                            gdouble        y)
+{
+  ThunarTreemapItem *item;
+  guint              n;
+
+  for (n = 0; n < treemap->items->len; n++)
+    {
+      item = &g_array_index (treemap->items, ThunarTreemapItem, n);
+      if (item->width >= 1.0 && item->height >= 1.0
+          && x >= item->x && x < item->x + item->width
+          && y >= item->y && y < item->y + item->height)
+        return n;
+    }
+
+  return -1;
+}
+
+
+
+/* returns the index of the item for @path, or -1 */
+static gint
+thunar_treemap_index_for_path (ThunarTreemap *treemap,
+                               GtkTreePath   *path)
+{
+  gint index;
+
+  if (path == NULL || gtk_tree_path_get_depth (path) != 1)
+    return -1;
+
+  index = gtk_tree_path_get_indices (path)[0];
+  if (index < 0 || (guint) index >= treemap->items->len
+      || g_array_index (treemap->items, ThunarTreemapItem, index).file == NULL)
+    return -1;
+
+  return index;
+}
+
+
+
+/**
+ * thunar_treemap_new:
+ *
+ * Allocates a new #ThunarTreemap, which shows the toplevel rows of
+ * its model as tiles whose area is proportional to their size, with
+ * folders sized by their content.
+ *
+ * Return value: the newly allocated #ThunarTreemap.
+ **/
+GtkWidget *
+thunar_treemap_new (void)
+{
+  return g_object_new (THUNAR_TYPE_TREEMAP, NULL);
+}
+
+
+
+/**
+ * thunar_treemap_get_selected_items:
+ * @treemap : a #ThunarTreemap.
+ *
+ * Return value: a #GList of #GtkTreePath<!---->s of the selected items,
+ *               to be freed with gtk_tree_path_free() and g_list_free().
+ **/
+GList *
+thunar_treemap_get_selected_items (ThunarTreemap *treemap)
+{
+  ThunarTreemapItem *item;
+  GList             *paths = NULL;
+  guint              n;
+
+  _thunar_return_val_if_fail (THUNAR_IS_TREEMAP (treemap), NULL);
+
+  if (g_hash_table_size (treemap->selection) == 0)
+    return NULL;
+
+  for (n = treemap->items->len; n > 0; n--)
+    {
+      item = &g_array_index (treemap->items, ThunarTreemapItem, n - 1);
+      if (item->file != NULL && g_hash_table_contains (treemap->selection, item->file))
+        paths = g_list_prepend (paths, gtk_tree_path_new_from_indices (n - 1, -1));
+    }
+
+  return paths;
+}
+
+
+
+void
+thunar_treemap_select_all (ThunarTreemap *treemap)
+{
+  ThunarTreemapItem *item;
+  guint              n;
+
+  _thunar_return_if_fail (THUNAR_IS_TREEMAP (treemap));
+
+  for (n = 0; n < treemap->items->len; n++)
+    {
+      item = &g_array_index (treemap->items, ThunarTreemapItem, n);
+      if (item->file != NULL && !g_hash_table_contains (treemap->selection, item->file))
+        g_hash_table_add (treemap->selection, g_object_ref (item->file));
+    }
+
+  gtk_widget_queue_draw (GTK_WIDGET (treemap));
+  g_signal_emit (treemap, treemap_signals[SELECTION_CHANGED], 0);
+}
+
+
+
+void
+thunar_treemap_unselect_all (ThunarTreemap *treemap)
+{
+  _thunar_return_if_fail (THUNAR_IS_TREEMAP (treemap));
+
+  if (g_hash_table_size (treemap->selection) == 0)
+    return;
+
+  g_hash_table_remove_all (treemap->selection);
+
+  gtk_widget_queue_draw (GTK_WIDGET (treemap));
+  g_signal_emit (treemap, treemap_signals[SELECTION_CHANGED], 0);
+}
+
+
+
+void
+thunar_treemap_selection_invert (ThunarTreemap *treemap)
+{
+  ThunarTreemapItem *item;
+  guint              n;
+
+  _thunar_return_if_fail (THUNAR_IS_TREEMAP (treemap));
+
+  for (n = 0; n < treemap->items->len; n++)
+    {
+      item = &g_array_index (treemap->items, ThunarTreemapItem, n);
+      if (item->file != NULL && !g_hash_table_remove (treemap->selection, item->file))
+        g_hash_table_add (treemap->selection, g_object_ref (item->file));
+    }
+
+  gtk_widget_queue_draw (GTK_WIDGET (treemap));
+  g_signal_emit (treemap, treemap_signals[SELECTION_CHANGED], 0);
+}
+
+
+
+void
+thunar_treemap_select_path (ThunarTreemap *treemap,
+                            GtkTreePath   *path)
+{
+  ThunarFile *file;
+  gint        index;
+
+  _thunar_return_if_fail (THUNAR_IS_TREEMAP (treemap));
+
+  /* the rows may have been added since the last rebuild */
+  if (treemap->rebuild_idle_id != 0)
+    {
+      g_source_remove (treemap->rebuild_idle_id);
+      thunar_treemap_rebuild (treemap);
+    }
+
+  index = thunar_treemap_index_for_path (treemap, path);
+  if (index < 0)
+    return;
+
+  file = g_array_index (treemap->items, ThunarTreemapItem, index).file;
+  if (g_hash_table_contains (treemap->selection, file))
+    return;
+
+  g_hash_table_add (treemap->selection, g_object_ref (file));
+
+  gtk_widget_queue_draw (GTK_WIDGET (treemap));
+  g_signal_emit (treemap, treemap_signals[SELECTION_CHANGED], 0);
+}
+
+
+
+gboolean
+thunar_treemap_path_is_selected (ThunarTreemap *treemap,
+                                 GtkTreePath   *path)
+{
+  gint index;
+
+  _thunar_return_val_if_fail (THUNAR_IS_TREEMAP (treemap), FALSE);
+
+  index = thunar_treemap_index_for_path (treemap, path);
+  if (index < 0)
+    return FALSE;
+
+  return g_hash_table_contains (treemap->selection, g_array_index (treemap->items, ThunarTreemapItem, index).file);
+}
+
+
+
+/**
+ * thunar_treemap_get_path_at_pos:
+ * @treemap : a #ThunarTreemap.
+ * @x       : the x coordinate in the widget.
+ * @y       : the y coordinate in the widget.
+ *
+ * Return value: the #GtkTreePath of the tile at the position, or %NULL.
+ **/
+GtkTreePath *
+thunar_treemap_get_path_at_pos (ThunarTreemap *treemap,
+                                gint           x,
+                                gint           y)
+{
+  gint index;
+
+  _thunar_return_val_if_fail (THUNAR_IS_TREEMAP (treemap), NULL);
+
+  index = thunar_treemap_item_at_pos (treemap, x, y);
+  if (index < 0)
+    return NULL;
+
+  return gtk_tree_path_new_from_indices (index, -1);
+}
+
+
+
+gboolean
+thunar_treemap_get_visible_range (ThunarTreemap *treemap,
+                                  GtkTreePath  **start_path,
+                                  GtkTreePath  **end_path)
+{
+  _thunar_return_val_if_fail (THUNAR_IS_TREEMAP (treemap), FALSE);
+
+  /* all items are always visible, even though some are tiny */
+  if (treemap->items->len == 0)
+    return FALSE;
+
+  if (start_path != NULL)
+    *start_path = gtk_tree_path_new_first ();
+  if (end_path != NULL)
+    *end_path = gtk_tree_path_new_from_indices (treemap->items->len - 1, -1);
+
+  return TRUE;
+}
+
+
+
+void
+thunar_treemap_set_drop_highlight (ThunarTreemap *treemap,
+                                   GtkTreePath   *path)
+{
+  _thunar_return_if_fail (THUNAR_IS_TREEMAP (treemap));
+
+  treemap->drop_highlight = thunar_treemap_index_for_path (treemap, path);
+  gtk_widget_queue_draw (GTK_WIDGET (treemap));
+}
@@ -0,0 +1,72 @@
+/* vi:set et ai sw=2 sts=2 ts=2: */
+/*-
+ * Copyright (c) 2026 The Xfce Development Team
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+ * Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef __THUNAR_TREEMAP_H__
+#define __THUNAR_TREEMAP_H__
+
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS;
+
+typedef struct _ThunarTreemapClass ThunarTreemapClass;
+typedef struct _ThunarTreemap      ThunarTreemap;
+
+#define THUNAR_TYPE_TREEMAP (thunar_treemap_get_type ())
+#define THUNAR_TREEMAP(obj) (G_TYPE_CHECK_INSTANCE_CAST ((obj), THUNAR_TYPE_TREEMAP, ThunarTreemap))
+#define THUNAR_TREEMAP_CLASS(klass) (G_TYPE_CHECK_CLASS_CAST ((klass), THUNAR_TYPE_TREEMAP, ThunarTreemapClass))
+#define THUNAR_IS_TREEMAP(obj) (G_TYPE_CHECK_INSTANCE_TYPE ((obj), THUNAR_TYPE_TREEMAP))
+#define THUNAR_IS_TREEMAP_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), THUNAR_TYPE_TREEMAP))
+#define THUNAR_TREEMAP_GET_CLASS(obj) (G_TYPE_INSTANCE_GET_CLASS ((obj), THUNAR_TYPE_TREEMAP, ThunarTreemapClass))
+
+GType
+thunar_treemap_get_type (void);
+
+GtkWidget *
+thunar_treemap_new (void) G_GNUC_MALLOC;
+
+GList *
+thunar_treemap_get_selected_items (ThunarTreemap *treemap);
+void
+thunar_treemap_select_all (ThunarTreemap *treemap);
+void
+thunar_treemap_unselect_all (ThunarTreemap *treemap);
+void
+thunar_treemap_selection_invert (ThunarTreemap *treemap);
+void
+thunar_treemap_select_path (ThunarTreemap *treemap,
+                            GtkTreePath   *path);
+gboolean
+thunar_treemap_path_is_selected (ThunarTreemap *treemap,
+                                 GtkTreePath   *path);
+
+GtkTreePath *
+thunar_treemap_get_path_at_pos (ThunarTreemap *treemap,
+                                gint           x,
+                                gint           y);
+gboolean
+thunar_treemap_get_visible_range (ThunarTreemap *treemap,
+                                  GtkTreePath  **start_path,
+                                  GtkTreePath  **end_path);
+void
+thunar_treemap_set_drop_highlight (ThunarTreemap *treemap,
+                                   GtkTreePath   *path);
+
+G_END_DECLS;
+
+#endif /* !__THUNAR_TREEMAP_H__ */
@@ -36,6 +36,7 @@
 #include "thunar/thunar-details-view.h"
 #include "thunar/thunar-device-monitor.h"
 #include "thunar/thunar-dialogs.h"
+#include "thunar/thunar-duplicates-dialog.h"
 #include "thunar/thunar-gio-extensions.h"
 #include "thunar/thunar-gobject-extensions.h"
 #include "thunar/thunar-gtk-extensions.h"
@@ -58,6 +59,7 @@
 #include "thunar/thunar-thumbnailer.h"
 #include "thunar/thunar-toolbar-order-editor.h"
 #include "thunar/thunar-tree-pane.h"
+#include "thunar/thunar-treemap-view.h"
 #include "thunar/thunar-util.h"
 #include "thunar/thunar-window.h"
 
@@ -290,6 +292,10 @@ thunar_window_action_icon_view (ThunarWindow *window);
 static gboolean
 thunar_window_action_compact_view (ThunarWindow *window);
 static gboolean
+thunar_window_action_treemap_view (ThunarWindow *window);
+static gboolean
+thunar_window_action_find_duplicates (ThunarWindow *window);
+static gboolean
 thunar_window_action_show_toolbar_editor (ThunarWindow *window);
 static gboolean
 thunar_window_action_show_context_menu_order_editor (ThunarWindow *window);
@@ -627,6 +633,7 @@ struct _ThunarWindow
   GtkWidget *location_toolbar_item_icon_view;
   GtkWidget *location_toolbar_item_detailed_view;
   GtkWidget *location_toolbar_item_compact_view;
+  GtkWidget *location_toolbar_item_treemap_view;
   GtkWidget *location_toolbar_item_view_switcher;
   GtkWidget *location_toolbar_item_search;
   GtkWidget *location_toolbar_item_show_hidden;
@@ -711,6 +718,7 @@ static XfceGtkActionEntry thunar_window_action_entries[] =
     { THUNAR_WINDOW_ACTION_VIEW_AS_ICONS,                  "<Actions>/ThunarWindow/view-as-icons",                   "<Primary>1",           XFCE_GTK_RADIO_MENU_ITEM, N_ ("_Icon View"),             N_ ("Display folder content in an icon view"),                                       "view-grid",               G_CALLBACK (thunar_window_action_icon_view),          },
     { THUNAR_WINDOW_ACTION_VIEW_AS_DETAILED_LIST,          "<Actions>/ThunarWindow/view-as-detailed-list",           "<Primary>2",           XFCE_GTK_RADIO_MENU_ITEM, N_ ("_List View"),             N_ ("Display folder content in a detailed list view"),                               "view-list",               G_CALLBACK (thunar_window_action_detailed_view),      },
     { THUNAR_WINDOW_ACTION_VIEW_AS_COMPACT_LIST,           "<Actions>/ThunarWindow/view-as-compact-list",            "<Primary>3",           XFCE_GTK_RADIO_MENU_ITEM, N_ ("_Compact View"),          N_ ("Display folder content in a compact list view"),                                "view-compact",            G_CALLBACK (thunar_window_action_compact_view),       },
+    { THUNAR_WINDOW_ACTION_VIEW_AS_TREEMAP,                "<Actions>/ThunarWindow/view-as-treemap",                 "<Primary>4",           XFCE_GTK_RADIO_MENU_ITEM, N_ ("_Treemap View"),          N_ ("Display folder content as a map of the disk usage"),                            "drive-harddisk",          G_CALLBACK (thunar_window_action_treemap_view),       },
 
     { THUNAR_WINDOW_ACTION_GO_MENU,                        "<Actions>/ThunarWindow/go-menu",                         "",                     XFCE_GTK_MENU_ITEM,       N_ ("_Go"),                    NULL,                                                                                NULL,                      NULL                                                  },
     { THUNAR_WINDOW_ACTION_OPEN_FILE_SYSTEM,               "<Actions>/ThunarWindow/open-file-system",                "",                     XFCE_GTK_IMAGE_MENU_ITEM, N_ ("F_ile System"),           N_ ("Browse the file system"),                                                       "drive-harddisk",          G_CALLBACK (thunar_window_action_open_file_system),   },
@@ -743,6 +751,7 @@ static XfceGtkActionEntry thunar_window_action_entries[] =
 
     { THUNAR_WINDOW_ACTION_SEARCH,                         "<Actions>/ThunarWindow/search",                          "<Primary>f",           XFCE_GTK_IMAGE_MENU_ITEM, N_ ("_Search for Files..."),   N_ ("Search for a specific file in the current folder and Recent"),                  "system-search",           G_CALLBACK (thunar_window_action_search),              },
     { THUNAR_WINDOW_ACTION_SEARCH_ALT,                     "<Actions>/ThunarWindow/search-alt",                      "Search",               XFCE_GTK_IMAGE_MENU_ITEM, NULL,                          NULL,                                                                                NULL,                      G_CALLBACK (thunar_window_action_search),              },
+    { THUNAR_WINDOW_ACTION_FIND_DUPLICATES,                "<Actions>/ThunarWindow/find-duplicates",                 "",                     XFCE_GTK_IMAGE_MENU_ITEM, N_ ("Find _Duplicates..."),    N_ ("Search the current folder for files with identical contents"),                  "edit-copy",               G_CALLBACK (thunar_window_action_find_duplicates),     },
     { THUNAR_WINDOW_ACTION_STOP_SEARCH,                    "<Actions>/ThunarWindow/stop-search",                     "Escape",               XFCE_GTK_MENU_ITEM,       N_ ("Stop search for files"),  NULL,                                                                                "",                        G_CALLBACK (thunar_window_action_stop_search),         },
 
     { THUNAR_WINDOW_ACTION_MENU,                           "<Actions>/Thunarwindow/menu",                            "",                     XFCE_GTK_IMAGE_MENU_ITEM, N_ ("Menu"),                   N_ ("Show the menu"),                                                                "open-menu",               G_CALLBACK (thunar_window_action_menu),                },
@@ -1263,6 +1272,7 @@ thunar_window_init (ThunarWindow *window)
   g_type_ensure (THUNAR_TYPE_ICON_VIEW);
   g_type_ensure (THUNAR_TYPE_DETAILS_VIEW);
   g_type_ensure (THUNAR_TYPE_COMPACT_VIEW);
+  g_type_ensure (THUNAR_TYPE_TREEMAP_VIEW);
 
   /* update window icon whenever preferences change */
   g_signal_connect_swapped (G_OBJECT (window->preferences), "notify::misc-change-window-icon", G_CALLBACK (thunar_window_update_window_icon), window);
@@ -1705,6 +1715,10 @@ thunar_window_update_view_menu (ThunarWindow *window,
                                                           G_OBJECT (window), window->view_type == THUNAR_TYPE_COMPACT_VIEW, GTK_MENU_SHELL (menu));
   if (window->search_mode == TRUE)
     gtk_widget_set_sensitive (item, FALSE);
+  item = xfce_gtk_toggle_menu_item_new_from_action_entry (get_action_entry (THUNAR_WINDOW_ACTION_VIEW_AS_TREEMAP),
+                                                          G_OBJECT (window), window->view_type == THUNAR_TYPE_TREEMAP_VIEW, GTK_MENU_SHELL (menu));
+  if (window->search_mode == TRUE)
+    gtk_widget_set_sensitive (item, FALSE);
 
   gtk_widget_show_all (GTK_WIDGET (menu));
 
@@ -1777,6 +1791,7 @@ thunar_window_update_go_menu (ThunarWindow *window,
   xfce_gtk_menu_append_separator (GTK_MENU_SHELL (menu));
   xfce_gtk_menu_item_new_from_action_entry (get_action_entry (THUNAR_WINDOW_ACTION_OPEN_LOCATION), G_OBJECT (window), GTK_MENU_SHELL (menu));
   xfce_gtk_menu_item_new_from_action_entry (get_action_entry (THUNAR_WINDOW_ACTION_SEARCH), G_OBJECT (window), GTK_MENU_SHELL (menu));
+  xfce_gtk_menu_item_new_from_action_entry (get_action_entry (THUNAR_WINDOW_ACTION_FIND_DUPLICATES), G_OBJECT (window), GTK_MENU_SHELL (menu));
   gtk_widget_show_all (GTK_WIDGET (menu));
 
   thunar_window_redirect_menu_tooltips_to_statusbar (window, GTK_MENU (menu));
@@ -2517,6 +2532,7 @@ thunar_window_switch_current_view (ThunarWindow *window,
   thunar_window_create_view_binding (window, new_view, "searching", window, "searching", G_BINDING_SYNC_CREATE);
   thunar_window_create_view_binding (window, new_view, "search-mode-active", window->location_toolbar_item_icon_view, "sensitive", G_BINDING_SYNC_CREATE | G_BINDING_INVERT_BOOLEAN);
   thunar_window_create_view_binding (window, new_view, "search-mode-active", window->location_toolbar_item_compact_view, "sensitive", G_BINDING_SYNC_CREATE | G_BINDING_INVERT_BOOLEAN);
+  thunar_window_create_view_binding (window, new_view, "search-mode-active", window->location_toolbar_item_treemap_view, "sensitive", G_BINDING_SYNC_CREATE | G_BINDING_INVERT_BOOLEAN);
   thunar_window_create_view_binding (window, new_view, "search-mode-active", window->location_toolbar_item_view_switcher, "sensitive", G_BINDING_SYNC_CREATE | G_BINDING_INVERT_BOOLEAN);
   thunar_window_create_view_binding (window, new_view, "selected-files", window->action_mgr, "selected-files", G_BINDING_SYNC_CREATE);
   thunar_window_create_view_binding (window, new_view, "zoom-level", window, "zoom-level", G_BINDING_SYNC_CREATE | G_BINDING_BIDIRECTIONAL);
@@ -2562,6 +2578,7 @@ thunar_window_switch_current_view (ThunarWindow *window,
   g_signal_handlers_block_by_func (window->location_toolbar_item_detailed_view, get_action_entry (THUNAR_WINDOW_ACTION_VIEW_AS_DETAILED_LIST)->callback, window);
   g_signal_handlers_block_by_func (window->location_toolbar_item_compact_view, get_action_entry (THUNAR_WINDOW_ACTION_VIEW_AS_COMPACT_LIST)->callback, window);
   g_signal_handlers_block_by_func (window->location_toolbar_item_icon_view, get_action_entry (THUNAR_WINDOW_ACTION_VIEW_AS_ICONS)->callback, window);
+  g_signal_handlers_block_by_func (window->location_toolbar_item_treemap_view, get_action_entry (THUNAR_WINDOW_ACTION_VIEW_AS_TREEMAP)->callback, window);
 
   if (window->view_type == THUNAR_TYPE_DETAILS_VIEW)
     gtk_toggle_tool_button_set_active (GTK_TOGGLE_TOOL_BUTTON (window->location_toolbar_item_detailed_view), TRUE);
@@ -2569,10 +2586,13 @@ thunar_window_switch_current_view (ThunarWindow *window,
     gtk_toggle_tool_button_set_active (GTK_TOGGLE_TOOL_BUTTON (window->location_toolbar_item_compact_view), TRUE);
   else if (window->view_type == THUNAR_TYPE_ICON_VIEW)
     gtk_toggle_tool_button_set_active (GTK_TOGGLE_TOOL_BUTTON (window->location_toolbar_item_icon_view), TRUE);
+  else if (window->view_type == THUNAR_TYPE_TREEMAP_VIEW)
+    gtk_toggle_tool_button_set_active (GTK_TOGGLE_TOOL_BUTTON (window->location_toolbar_item_treemap_view), TRUE);
 
   g_signal_handlers_unblock_by_func (window->location_toolbar_item_detailed_view, get_action_entry (THUNAR_WINDOW_ACTION_VIEW_AS_DETAILED_LIST)->callback, window);
   g_signal_handlers_unblock_by_func (window->location_toolbar_item_compact_view, get_action_entry (THUNAR_WINDOW_ACTION_VIEW_AS_COMPACT_LIST)->callback, window);
   g_signal_handlers_unblock_by_func (window->location_toolbar_item_icon_view, get_action_entry (THUNAR_WINDOW_ACTION_VIEW_AS_ICONS)->callback, window);
+  g_signal_handlers_unblock_by_func (window->location_toolbar_item_treemap_view, get_action_entry (THUNAR_WINDOW_ACTION_VIEW_AS_TREEMAP)->callback, window);
 
   thunar_window_view_switcher_update (window);
 
@@ -4611,6 +4631,18 @@ thunar_window_action_compact_view (ThunarWindow *window)
 
 
 
+static gboolean
+thunar_window_action_treemap_view (ThunarWindow *window)
+{
+  if (window->search_mode == FALSE)
+    thunar_window_action_view_changed (window, THUNAR_TYPE_TREEMAP_VIEW);
+
+  /* required in case of shortcut activation, in order to signal that the accel key got handled */
+  return TRUE;
+}
+
+
+
 static void
 thunar_window_replace_view (ThunarWindow *window,
                             GtkWidget    *view_to_replace,
@@ -5396,6 +5428,32 @@ thunar_window_action_show_highlight (ThunarWindow *window)
 
 
 
+static gboolean
+thunar_window_action_find_duplicates (ThunarWindow *window)
+{
+  GtkWidget         *dialog;
+  ThunarApplication *application;
+
+  _thunar_return_val_if_fail (THUNAR_IS_WINDOW (window), FALSE);
+
+  if (G_UNLIKELY (window->current_directory == NULL))
+    return TRUE;
+
+  /* allocate and display a duplicates dialog for the current folder */
+  dialog = thunar_duplicates_dialog_new (GTK_WINDOW (window), thunar_file_get_file (window->current_directory));
+  gtk_widget_show (dialog);
+
+  /* ...and let the application take care of it */
+  application = thunar_application_get ();
+  thunar_application_take_window (application, GTK_WINDOW (dialog));
+  g_object_unref (G_OBJECT (application));
+
+  /* required in case of shortcut activation, in order to signal that the accel key got handled */
+  return TRUE;
+}
+
+
+
 gboolean
 thunar_window_action_search (ThunarWindow *window)
 {
@@ -7086,6 +7144,23 @@ thunar_window_view_switcher_update (ThunarWindow *window)
     }
   g_free (icon_name);
 
+  action_entry = *(get_action_entry (THUNAR_WINDOW_ACTION_VIEW_AS_TREEMAP));
+  action_entry.menu_item_type = XFCE_GTK_IMAGE_MENU_ITEM;
+  icon_name = thunar_window_toolbar_get_icon_name (window, "drive-harddisk");
+  action_entry.menu_item_icon_name = icon_name;
+  view_switcher_item = xfce_gtk_menu_item_new_from_action_entry (&action_entry, G_OBJECT (window), GTK_MENU_SHELL (view_switcher_menu));
+  gtk_widget_set_tooltip_markup (view_switcher_item, action_entry.menu_item_tooltip_text);
+  gtk_widget_show (view_switcher_item);
+
+  if (window->view_type == THUNAR_TYPE_TREEMAP_VIEW)
+    {
+      gtk_widget_set_sensitive (view_switcher_item, FALSE);
+      gtk_image_set_from_icon_name (GTK_IMAGE (image),
+                                    icon_name,
+                                    gtk_tool_item_get_icon_size (toolbar_item));
+    }
+  g_free (icon_name);
+
   gtk_menu_button_set_popup (GTK_MENU_BUTTON (menu_button), view_switcher_menu);
 
   g_list_free (children);
@@ -7150,6 +7225,7 @@ thunar_window_location_toolbar_create (ThunarWindow *window)
   window->location_toolbar_item_icon_view = thunar_window_create_toolbar_radio_item_from_action (window, THUNAR_WINDOW_ACTION_VIEW_AS_ICONS, window->view_type == THUNAR_TYPE_ICON_VIEW, NULL, item_order++);
   window->location_toolbar_item_detailed_view = thunar_window_create_toolbar_radio_item_from_action (window, THUNAR_WINDOW_ACTION_VIEW_AS_DETAILED_LIST, window->view_type == THUNAR_TYPE_DETAILS_VIEW, GTK_RADIO_TOOL_BUTTON (window->location_toolbar_item_icon_view), item_order++);
   window->location_toolbar_item_compact_view = thunar_window_create_toolbar_radio_item_from_action (window, THUNAR_WINDOW_ACTION_VIEW_AS_COMPACT_LIST, window->view_type == THUNAR_TYPE_COMPACT_VIEW, GTK_RADIO_TOOL_BUTTON (window->location_toolbar_item_icon_view), item_order++);
+  window->location_toolbar_item_treemap_view = thunar_window_create_toolbar_radio_item_from_action (window, THUNAR_WINDOW_ACTION_VIEW_AS_TREEMAP, window->view_type == THUNAR_TYPE_TREEMAP_VIEW, GTK_RADIO_TOOL_BUTTON (window->location_toolbar_item_icon_view), item_order++);
   window->location_toolbar_item_view_switcher = thunar_window_create_toolbar_view_switcher (window, item_order++);
 
   g_signal_connect (window->location_toolbar_item_back, "button-press-event", G_CALLBACK (thunar_window_history_clicked), window);
@@ -7165,6 +7241,7 @@ thunar_window_location_toolbar_create (ThunarWindow *window)
   g_signal_connect_swapped (window->location_toolbar_item_icon_view, "toggled", get_action_entry (THUNAR_WINDOW_ACTION_VIEW_AS_ICONS)->callback, window);
   g_signal_connect_swapped (window->location_toolbar_item_detailed_view, "toggled", get_action_entry (THUNAR_WINDOW_ACTION_VIEW_AS_DETAILED_LIST)->callback, window);
   g_signal_connect_swapped (window->location_toolbar_item_compact_view, "toggled", get_action_entry (THUNAR_WINDOW_ACTION_VIEW_AS_COMPACT_LIST)->callback, window);
+  g_signal_connect_swapped (window->location_toolbar_item_treemap_view, "toggled", get_action_entry (THUNAR_WINDOW_ACTION_VIEW_AS_TREEMAP)->callback, window);
 
   thunar_window_view_switcher_update (window);
 
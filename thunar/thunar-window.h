@@ -84,6 +84,7 @@ typedef enum
   THUNAR_WINDOW_ACTION_VIEW_AS_ICONS,
   THUNAR_WINDOW_ACTION_VIEW_AS_DETAILED_LIST,
   THUNAR_WINDOW_ACTION_VIEW_AS_COMPACT_LIST,
+  THUNAR_WINDOW_ACTION_VIEW_AS_TREEMAP,
   THUNAR_WINDOW_ACTION_GO_MENU,
   THUNAR_WINDOW_ACTION_OPEN_PARENT,
   THUNAR_WINDOW_ACTION_BACK,
@@ -111,6 +112,7 @@ typedef enum
   THUNAR_WINDOW_ACTION_SWITCH_NEXT_TAB_ALT,
   THUNAR_WINDOW_ACTION_SEARCH,
   THUNAR_WINDOW_ACTION_SEARCH_ALT,
+  THUNAR_WINDOW_ACTION_FIND_DUPLICATES,
   THUNAR_WINDOW_ACTION_STOP_SEARCH,
   THUNAR_WINDOW_ACTION_MENU,
 